@@ -22,6 +22,14 @@
  *
  */
 
+/* On Linux we need GNU extensions to set the CPU affinity of the
+ * worker pool threads, this has to be defined before including any
+ * header:
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#	define _GNU_SOURCE
+#endif
+
 /* Include standard C libs headers */
 #include <assert.h>
 #include <stddef.h>
@@ -42,7 +50,9 @@
 #	ifndef _POSIX_C_SOURCE
 #		define _POSIX_C_SOURCE 200112L
 #	endif // _POSIX_C_SOURCE
-#	define __USE_UNIX98
+#	ifndef __USE_UNIX98
+#		define __USE_UNIX98
+#	endif // __USE_UNIX98
 #	endif // macOS
 #endif // OS_TYPE
 
@@ -53,10 +63,20 @@
 #	if ( !defined(macOS) )
 #		include <malloc.h>
 #	endif
-#	if (CPU_TYPE == x86_64)
-//#		include <xmmintrin.h>
-#	endif
 #endif // OS_TYPE
+
+// SIMD intrinsics (SSE2 is always available on x86_64, while
+// AVX2 and AVX-512 kernels are compiled using target attributes
+// and selected at runtime, see p_kernels_select):
+#if (CPU_TYPE == x86_64) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#	include <emmintrin.h>
+#	define ZVECT_SIMD_SSE2 1
+#	if defined(__GNUC__) || defined(__clang__)
+#		include <immintrin.h>
+#		define ZVECT_SIMD_DISPATCH 1
+#		define ZVECT_TARGET(x) __attribute__((target(x)))
+#	endif
+#endif
 #if (ZVECT_THREAD_SAFE == 1)
 #	if MUTEX_TYPE == 1
 #		if ( !defined(macOS) )
@@ -65,12 +85,21 @@
 #			include <dispatch/dispatch.h>
 #		endif
 #		include <pthread.h>
+#		include <unistd.h>
 #	elif MUTEX_TYPE == 2
 #		include <windows.h>
 #		include <psapi.h>
 #	endif // MUTEX_TYPE
 #endif // ZVECT_THREAD_SAFE
 
+// The worker pool (used by the parallel functions)
+// is available only when we can use pthreads:
+#if (ZVECT_THREAD_SAFE == 1) && (MUTEX_TYPE == 1)
+#	define ZVECT_WORKER_POOL 1
+#else
+#	define ZVECT_WORKER_POOL 0
+#endif
+
 // Local Defines/Macros:
 
 // Declare Vector status flags:
@@ -134,6 +163,12 @@ struct ZVECT_PACKING p_vector
 					//   It contains bits that set Secure
 					//   Wipe, Auto Shrink, Pass Items By
 					//   Ref etc.
+	uint32_t generation;		// - Incremented every time the storage
+					//   is reallocated or reorganised, so
+					//   views can detect they are stale.
+	zvect_index gap_at;		// - Gap position (index of the first
+					//   item after it) and length, for
+	zvect_index gap_len;		//   ZV_GAP_BUFFER vectors.
 	size_t data_size;		// - User DataType size.
 					//   This should be 2 bytes size on a
 					//   16-bit system, 4 bytes on a 32
@@ -176,11 +211,17 @@ struct ZVECT_PACKING p_vector
 					//   function (optional) needed only
 					//   for Secure Wiping special
 					//   structures.
+	struct p_tombs *tombs;		// - Lazy deletes tombstones (only
+					//   for ZV_LAZY_DELETE vectors).
+	struct p_tree *tree;		// - Items tree (only for ZV_TREE
+					//   vectors, see P_TREE_MIN_ITEMS).
 #ifdef ZVECT_DMF_EXTENSIONS
-	zvect_index balance;		// - Used by the Adaptive Binary Search
-					//   to improve performance.
-	zvect_index bottom;		// - Used to optimise Adaptive Binary
-					//   Search.
+	bsearch_cursor ord_hint;	// - Adaptive Binary Search hints used
+					//   by vect_add_ordered (searches use
+					//   their own cursors, so they never
+					//   write to the vector).
+	struct p_hindex *hindex;	// - Hash index (optional, see
+					//   vect_hindex_create).
 #endif  // ZVECT_DMF_EXTENSIONS
 	volatile uint32_t status;	// - Internal vector Status Flags
 								//   - first 24 bits used for general
@@ -366,6 +407,9 @@ static void p_throw_error(const zvect_retval error_code,
 			case ZVERR_OPNOTALLOWED:
 				message=(char *)safe_strncpy("Operation not allowed.\n\0", msg_len);
 				break;
+			case ZVERR_VIEWSTALE:
+				message=(char *)safe_strncpy("The vector of this view has been reallocated.\n\0", msg_len);
+				break;
 			default:
 				message=(char *)safe_strncpy("Unknown error.\n\0", msg_len);
 				break;
@@ -390,6 +434,884 @@ int vect_get_last_error(const_vector const v)
 
 /*---------------------------------------------------------------------------*/
 
+/*---------------------------------------------------------------------------*/
+// CPU features detection and bulk kernels dispatch:
+
+/*
+ * Bulk kernels are the inner loops used by many ZVector functions.
+ * Each kernel has a portable scalar version and (on x86_64) most of
+ * them have SSE2, AVX2 and AVX-512 versions. The best version for
+ * the CPU we are running on is selected once by p_init_zvect (and
+ * can be changed with vect_set_cpu_features, useful for
+ * benchmarking). Until then the scalar versions are used.
+ */
+struct p_kernels {
+	// Please note: there are no kernels for plain moves and
+	// wipes, the C library memmove and memset are already
+	// optimised for the CPU in use (see tests/04PTest006.c).
+	// Set n pointer slots to value:
+	void (*fill_ptrs)(void **dst, void *value, size_t n);
+	// Fixed-width key search over item pointers:
+	zvect_index (*find_bytes)(void * const *data, zvect_index n,
+				  const void *key, size_t offset,
+				  size_t key_len);
+	// Numeric reductions over contiguous arrays:
+	double (*sum_f64)(const double *a, size_t n);
+	int64_t (*sum_i64)(const int64_t *a, size_t n);
+	double (*min_f64)(const double *a, size_t n);
+	double (*max_f64)(const double *a, size_t n);
+};
+
+static uint32_t p_cpu_detected = 0;	// - Features supported by the CPU
+static uint32_t p_cpu_active = 0;	// - Features used by the kernels
+
+// Compiler barrier, used to make sure secure wipes are not
+// removed by the optimiser (the memory is generally freed
+// right after being wiped):
+#if defined(__GNUC__) || defined(__clang__)
+#	define P_WIPE_BARRIER(ptr) __asm__ __volatile__("" : : "r"(ptr) : "memory")
+#else
+#	define P_WIPE_BARRIER(ptr) UNUSED(ptr)
+#endif
+
+static inline unsigned int p_ctz32(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_ctz(x);
+#else
+	unsigned int n = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+static inline uint32_t p_load_u32(const void *item, size_t offset)
+{
+	uint32_t value;
+	memcpy(&value, (const uint8_t *)item + offset, sizeof(value));
+	return value;
+}
+
+static inline uint64_t p_load_u64(const void *item, size_t offset)
+{
+	uint64_t value;
+	memcpy(&value, (const uint8_t *)item + offset, sizeof(value));
+	return value;
+}
+
+// Scalar kernels:
+
+static void p_fill_ptrs_scalar(void **dst, void *value, size_t n)
+{
+	for (register size_t i = 0; i < n; i++)
+		dst[i] = value;
+}
+
+/*
+ * The find_bytes kernels return the index of the first item in
+ * data[0..n) whose bytes [offset, offset + key_len) match key, or
+ * n if there is no match. Items are stored by pointer, so the
+ * SIMD versions gather the key field of a group of items into
+ * a register and compare the whole group at once.
+ */
+static zvect_index p_find_bytes_scalar(void * const *data, zvect_index n,
+				       const void *key, size_t offset,
+				       size_t key_len)
+{
+	zvect_index i = 0;
+
+	if (key_len == sizeof(uint32_t)) {
+		const uint32_t k = p_load_u32(key, 0);
+		for (; i < n; i++)
+			if (p_load_u32(data[i], offset) == k)
+				return i;
+	} else if (key_len == sizeof(uint64_t)) {
+		const uint64_t k = p_load_u64(key, 0);
+		for (; i < n; i++)
+			if (p_load_u64(data[i], offset) == k)
+				return i;
+	} else {
+		const uint8_t first = *((const uint8_t *)key);
+		for (; i < n; i++) {
+			const uint8_t *field = (const uint8_t *)data[i] + offset;
+			if (*field == first && !memcmp(field, key, key_len))
+				return i;
+		}
+	}
+
+	return n;
+}
+
+static double p_sum_f64_scalar(const double *a, size_t n)
+{
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		s0 += a[i];
+		s1 += a[i + 1];
+		s2 += a[i + 2];
+		s3 += a[i + 3];
+	}
+	for (; i < n; i++)
+		s0 += a[i];
+	return (s0 + s1) + (s2 + s3);
+}
+
+static int64_t p_sum_i64_scalar(const int64_t *a, size_t n)
+{
+	// Use unsigned arithmetic, so overflows wrap around
+	// (like they do in the SIMD versions):
+	uint64_t s = 0;
+	for (register size_t i = 0; i < n; i++)
+		s += (uint64_t)a[i];
+	return (int64_t)s;
+}
+
+static double p_min_f64_scalar(const double *a, size_t n)
+{
+	double m = a[0];
+	for (register size_t i = 1; i < n; i++)
+		if (a[i] < m)
+			m = a[i];
+	return m;
+}
+
+static double p_max_f64_scalar(const double *a, size_t n)
+{
+	double m = a[0];
+	for (register size_t i = 1; i < n; i++)
+		if (a[i] > m)
+			m = a[i];
+	return m;
+}
+
+#if defined(ZVECT_SIMD_SSE2)
+// SSE2 kernels:
+
+static void p_fill_ptrs_sse2(void **dst, void *value, size_t n)
+{
+	const __m128i v = _mm_set1_epi64x((long long)(uintptr_t)value);
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2)
+		_mm_storeu_si128((__m128i *)(dst + i), v);
+	for (; i < n; i++)
+		dst[i] = value;
+}
+
+static zvect_index p_find_bytes_sse2(void * const *data, zvect_index n,
+				     const void *key, size_t offset,
+				     size_t key_len)
+{
+	zvect_index i = 0;
+
+	if (key_len == sizeof(uint32_t)) {
+		const __m128i k = _mm_set1_epi32((int)p_load_u32(key, 0));
+		for (; i + 4 <= n; i += 4) {
+			const __m128i f = _mm_set_epi32((int)p_load_u32(data[i + 3], offset),
+							(int)p_load_u32(data[i + 2], offset),
+							(int)p_load_u32(data[i + 1], offset),
+							(int)p_load_u32(data[i], offset));
+			uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(f, k)));
+			if (mask)
+				return i + p_ctz32(mask);
+		}
+	} else if (key_len == sizeof(uint64_t)) {
+		// SSE2 has no 64 bit compare, so compare the two 32 bit
+		// halves and require both of them to match:
+		const __m128i k = _mm_set1_epi64x((long long)p_load_u64(key, 0));
+		for (; i + 2 <= n; i += 2) {
+			const __m128i f = _mm_set_epi64x((long long)p_load_u64(data[i + 1], offset),
+							 (long long)p_load_u64(data[i], offset));
+			uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(f, k)));
+			if ((mask & 0x3) == 0x3)
+				return i;
+			if ((mask & 0xC) == 0xC)
+				return i + 1;
+		}
+	}
+
+	return i + p_find_bytes_scalar(data + i, n - i, key, offset, key_len);
+}
+
+static double p_sum_f64_sse2(const double *a, size_t n)
+{
+	__m128d s0 = _mm_setzero_pd();
+	__m128d s1 = _mm_setzero_pd();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		s0 = _mm_add_pd(s0, _mm_loadu_pd(a + i));
+		s1 = _mm_add_pd(s1, _mm_loadu_pd(a + i + 2));
+	}
+	double r[2];
+	_mm_storeu_pd(r, _mm_add_pd(s0, s1));
+	double s = r[0] + r[1];
+	for (; i < n; i++)
+		s += a[i];
+	return s;
+}
+
+static int64_t p_sum_i64_sse2(const int64_t *a, size_t n)
+{
+	__m128i s0 = _mm_setzero_si128();
+	__m128i s1 = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		s0 = _mm_add_epi64(s0, _mm_loadu_si128((const __m128i *)(a + i)));
+		s1 = _mm_add_epi64(s1, _mm_loadu_si128((const __m128i *)(a + i + 2)));
+	}
+	uint64_t r[2];
+	_mm_storeu_si128((__m128i *)r, _mm_add_epi64(s0, s1));
+	uint64_t s = r[0] + r[1];
+	for (; i < n; i++)
+		s += (uint64_t)a[i];
+	return (int64_t)s;
+}
+
+static double p_min_f64_sse2(const double *a, size_t n)
+{
+	if (n < 2)
+		return a[0];
+	__m128d m = _mm_loadu_pd(a);
+	size_t i = 2;
+	for (; i + 2 <= n; i += 2)
+		m = _mm_min_pd(m, _mm_loadu_pd(a + i));
+	double r[2];
+	_mm_storeu_pd(r, m);
+	double res = (r[1] < r[0]) ? r[1] : r[0];
+	for (; i < n; i++)
+		if (a[i] < res)
+			res = a[i];
+	return res;
+}
+
+static double p_max_f64_sse2(const double *a, size_t n)
+{
+	if (n < 2)
+		return a[0];
+	__m128d m = _mm_loadu_pd(a);
+	size_t i = 2;
+	for (; i + 2 <= n; i += 2)
+		m = _mm_max_pd(m, _mm_loadu_pd(a + i));
+	double r[2];
+	_mm_storeu_pd(r, m);
+	double res = (r[1] > r[0]) ? r[1] : r[0];
+	for (; i < n; i++)
+		if (a[i] > res)
+			res = a[i];
+	return res;
+}
+#endif // ZVECT_SIMD_SSE2
+
+#if defined(ZVECT_SIMD_DISPATCH)
+// AVX2 kernels:
+
+ZVECT_TARGET("avx2")
+static void p_fill_ptrs_avx2(void **dst, void *value, size_t n)
+{
+	const __m256i v = _mm256_set1_epi64x((long long)(uintptr_t)value);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm256_storeu_si256((__m256i *)(dst + i), v);
+	for (; i < n; i++)
+		dst[i] = value;
+}
+
+ZVECT_TARGET("avx2")
+static zvect_index p_find_bytes_avx2(void * const *data, zvect_index n,
+				     const void *key, size_t offset,
+				     size_t key_len)
+{
+	zvect_index i = 0;
+
+	if (key_len == sizeof(uint32_t)) {
+		const __m256i k = _mm256_set1_epi32((int)p_load_u32(key, 0));
+		for (; i + 8 <= n; i += 8) {
+			const __m256i f = _mm256_set_epi32((int)p_load_u32(data[i + 7], offset),
+							   (int)p_load_u32(data[i + 6], offset),
+							   (int)p_load_u32(data[i + 5], offset),
+							   (int)p_load_u32(data[i + 4], offset),
+							   (int)p_load_u32(data[i + 3], offset),
+							   (int)p_load_u32(data[i + 2], offset),
+							   (int)p_load_u32(data[i + 1], offset),
+							   (int)p_load_u32(data[i], offset));
+			uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(f, k)));
+			if (mask)
+				return i + p_ctz32(mask);
+		}
+	} else if (key_len == sizeof(uint64_t)) {
+		const __m256i k = _mm256_set1_epi64x((long long)p_load_u64(key, 0));
+		for (; i + 4 <= n; i += 4) {
+			const __m256i f = _mm256_set_epi64x((long long)p_load_u64(data[i + 3], offset),
+							    (long long)p_load_u64(data[i + 2], offset),
+							    (long long)p_load_u64(data[i + 1], offset),
+							    (long long)p_load_u64(data[i], offset));
+			uint32_t mask = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(f, k)));
+			if (mask)
+				return i + p_ctz32(mask);
+		}
+	}
+
+	return i + p_find_bytes_scalar(data + i, n - i, key, offset, key_len);
+}
+
+ZVECT_TARGET("avx2")
+static double p_sum_f64_avx2(const double *a, size_t n)
+{
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+		s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+	}
+	double r[4];
+	_mm256_storeu_pd(r, _mm256_add_pd(s0, s1));
+	double s = (r[0] + r[1]) + (r[2] + r[3]);
+	for (; i < n; i++)
+		s += a[i];
+	return s;
+}
+
+ZVECT_TARGET("avx2")
+static int64_t p_sum_i64_avx2(const int64_t *a, size_t n)
+{
+	__m256i s0 = _mm256_setzero_si256();
+	__m256i s1 = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		s0 = _mm256_add_epi64(s0, _mm256_loadu_si256((const __m256i *)(a + i)));
+		s1 = _mm256_add_epi64(s1, _mm256_loadu_si256((const __m256i *)(a + i + 4)));
+	}
+	uint64_t r[4];
+	_mm256_storeu_si256((__m256i *)r, _mm256_add_epi64(s0, s1));
+	uint64_t s = (r[0] + r[1]) + (r[2] + r[3]);
+	for (; i < n; i++)
+		s += (uint64_t)a[i];
+	return (int64_t)s;
+}
+
+ZVECT_TARGET("avx2")
+static double p_min_f64_avx2(const double *a, size_t n)
+{
+	if (n < 4)
+		return p_min_f64_scalar(a, n);
+	__m256d m = _mm256_loadu_pd(a);
+	size_t i = 4;
+	for (; i + 4 <= n; i += 4)
+		m = _mm256_min_pd(m, _mm256_loadu_pd(a + i));
+	double r[4];
+	_mm256_storeu_pd(r, m);
+	double res = p_min_f64_scalar(r, 4);
+	for (; i < n; i++)
+		if (a[i] < res)
+			res = a[i];
+	return res;
+}
+
+ZVECT_TARGET("avx2")
+static double p_max_f64_avx2(const double *a, size_t n)
+{
+	if (n < 4)
+		return p_max_f64_scalar(a, n);
+	__m256d m = _mm256_loadu_pd(a);
+	size_t i = 4;
+	for (; i + 4 <= n; i += 4)
+		m = _mm256_max_pd(m, _mm256_loadu_pd(a + i));
+	double r[4];
+	_mm256_storeu_pd(r, m);
+	double res = p_max_f64_scalar(r, 4);
+	for (; i < n; i++)
+		if (a[i] > res)
+			res = a[i];
+	return res;
+}
+
+// AVX-512 kernels:
+
+ZVECT_TARGET("avx512f")
+static void p_fill_ptrs_avx512(void **dst, void *value, size_t n)
+{
+	const __m512i v = _mm512_set1_epi64((long long)(uintptr_t)value);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm512_storeu_si512((void *)(dst + i), v);
+	for (; i < n; i++)
+		dst[i] = value;
+}
+
+ZVECT_TARGET("avx512f")
+static zvect_index p_find_bytes_avx512(void * const *data, zvect_index n,
+				       const void *key, size_t offset,
+				       size_t key_len)
+{
+	zvect_index i = 0;
+
+	if (key_len == sizeof(uint32_t)) {
+		const __m512i k = _mm512_set1_epi32((int)p_load_u32(key, 0));
+		int f[16];
+		for (; i + 16 <= n; i += 16) {
+			for (int j = 0; j < 16; j++)
+				f[j] = (int)p_load_u32(data[i + j], offset);
+			uint32_t mask = (uint32_t)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512((const void *)f), k);
+			if (mask)
+				return i + p_ctz32(mask);
+		}
+	} else if (key_len == sizeof(uint64_t)) {
+		const __m512i k = _mm512_set1_epi64((long long)p_load_u64(key, 0));
+		long long f[8];
+		for (; i + 8 <= n; i += 8) {
+			for (int j = 0; j < 8; j++)
+				f[j] = (long long)p_load_u64(data[i + j], offset);
+			uint32_t mask = (uint32_t)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512((const void *)f), k);
+			if (mask)
+				return i + p_ctz32(mask);
+		}
+	}
+
+	return i + p_find_bytes_scalar(data + i, n - i, key, offset, key_len);
+}
+
+ZVECT_TARGET("avx512f")
+static double p_sum_f64_avx512(const double *a, size_t n)
+{
+	__m512d s0 = _mm512_setzero_pd();
+	__m512d s1 = _mm512_setzero_pd();
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		s0 = _mm512_add_pd(s0, _mm512_loadu_pd(a + i));
+		s1 = _mm512_add_pd(s1, _mm512_loadu_pd(a + i + 8));
+	}
+	double r[8];
+	_mm512_storeu_pd(r, _mm512_add_pd(s0, s1));
+	double s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));
+	for (; i < n; i++)
+		s += a[i];
+	return s;
+}
+
+ZVECT_TARGET("avx512f")
+static int64_t p_sum_i64_avx512(const int64_t *a, size_t n)
+{
+	__m512i s0 = _mm512_setzero_si512();
+	__m512i s1 = _mm512_setzero_si512();
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		s0 = _mm512_add_epi64(s0, _mm512_loadu_si512((const void *)(a + i)));
+		s1 = _mm512_add_epi64(s1, _mm512_loadu_si512((const void *)(a + i + 8)));
+	}
+	uint64_t r[8];
+	_mm512_storeu_si512((void *)r, _mm512_add_epi64(s0, s1));
+	uint64_t s = 0;
+	for (int j = 0; j < 8; j++)
+		s += r[j];
+	for (; i < n; i++)
+		s += (uint64_t)a[i];
+	return (int64_t)s;
+}
+
+ZVECT_TARGET("avx512f")
+static double p_min_f64_avx512(const double *a, size_t n)
+{
+	if (n < 8)
+		return p_min_f64_scalar(a, n);
+	__m512d m = _mm512_loadu_pd(a);
+	size_t i = 8;
+	for (; i + 8 <= n; i += 8)
+		m = _mm512_min_pd(m, _mm512_loadu_pd(a + i));
+	double r[8];
+	_mm512_storeu_pd(r, m);
+	double res = p_min_f64_scalar(r, 8);
+	for (; i < n; i++)
+		if (a[i] < res)
+			res = a[i];
+	return res;
+}
+
+ZVECT_TARGET("avx512f")
+static double p_max_f64_avx512(const double *a, size_t n)
+{
+	if (n < 8)
+		return p_max_f64_scalar(a, n);
+	__m512d m = _mm512_loadu_pd(a);
+	size_t i = 8;
+	for (; i + 8 <= n; i += 8)
+		m = _mm512_max_pd(m, _mm512_loadu_pd(a + i));
+	double r[8];
+	_mm512_storeu_pd(r, m);
+	double res = p_max_f64_scalar(r, 8);
+	for (; i < n; i++)
+		if (a[i] > res)
+			res = a[i];
+	return res;
+}
+#endif // ZVECT_SIMD_DISPATCH
+
+static struct p_kernels p_kern = {
+	p_fill_ptrs_scalar, p_find_bytes_scalar, p_sum_f64_scalar,
+	p_sum_i64_scalar, p_min_f64_scalar, p_max_f64_scalar
+};
+
+/*
+ * Typed kernels work on the contiguous arrays of the typed
+ * vectors (see vect_create_typed), one set of kernels for each
+ * ZVECT_TYPES. They are written as plain C loops over P_TLANES
+ * independent accumulators (or lanes), which the compiler turns
+ * into SIMD instructions, and are compiled once more for every
+ * instruction set we dispatch to (using target attributes).
+ * The double and int64 reductions already available above are
+ * used as they are.
+ * Please note: min, max and find_eq are never called with
+ * n == 0, and NaN values give undefined results.
+ */
+#define P_TLANES 16
+
+struct p_typed_kernels {
+	void (*sum)(const void *a, size_t n, void *res);
+	void (*min)(const void *a, size_t n, void *res);
+	void (*max)(const void *a, size_t n, void *res);
+	void (*dot)(const void *a, const void *b, size_t n, void *res);
+	void (*scale)(void *a, size_t n, const void *factor);
+	void (*add)(void *a, const void *b, size_t n);
+	size_t (*count_if)(const void *a, size_t n, uint32_t op, const void *value);
+	size_t (*find_eq)(const void *a, size_t n, const void *value);
+};
+
+// Sum (ACC is the accumulator type, RES the result type):
+#define P_TSUM(NAME, ATTR, T, ACC, RES)						\
+ATTR static void NAME(const void *p, size_t n, void *res)		\
+{									\
+	const T *a = (const T *)p;					\
+	ACC s[P_TLANES];						\
+	size_t i = 0;							\
+	int j;								\
+	for (j = 0; j < P_TLANES; j++)					\
+		s[j] = 0;						\
+	for (; i + P_TLANES <= n; i += P_TLANES)			\
+		for (j = 0; j < P_TLANES; j++)				\
+			s[j] += (ACC)a[i + j];				\
+	for (j = 1; j < P_TLANES; j++)					\
+		s[0] += s[j];						\
+	for (; i < n; i++)						\
+		s[0] += (ACC)a[i];					\
+	*((RES *)res) = (RES)s[0];					\
+}
+
+// Min and max (OP is < for min and > for max):
+#define P_TMINMAX(NAME, ATTR, T, OP)					\
+ATTR static void NAME(const void *p, size_t n, void *res)		\
+{									\
+	const T *a = (const T *)p;					\
+	T m[P_TLANES];							\
+	size_t i = 0;							\
+	int j;								\
+	for (j = 0; j < P_TLANES; j++)					\
+		m[j] = a[0];						\
+	for (; i + P_TLANES <= n; i += P_TLANES)			\
+		for (j = 0; j < P_TLANES; j++)				\
+			m[j] = (a[i + j] OP m[j]) ? a[i + j] : m[j];	\
+	for (j = 1; j < P_TLANES; j++)					\
+		if (m[j] OP m[0])					\
+			m[0] = m[j];					\
+	for (; i < n; i++)						\
+		if (a[i] OP m[0])					\
+			m[0] = a[i];					\
+	*((T *)res) = m[0];						\
+}
+
+// Dot product:
+#define P_TDOT(NAME, ATTR, T, ACC, RES)					\
+ATTR static void NAME(const void *pa, const void *pb, size_t n, void *res) \
+{									\
+	const T *a = (const T *)pa;					\
+	const T *b = (const T *)pb;					\
+	ACC s[P_TLANES];						\
+	size_t i = 0;							\
+	int j;								\
+	for (j = 0; j < P_TLANES; j++)					\
+		s[j] = 0;						\
+	for (; i + P_TLANES <= n; i += P_TLANES)			\
+		for (j = 0; j < P_TLANES; j++)				\
+			s[j] += (ACC)a[i + j] * (ACC)b[i + j];		\
+	for (j = 1; j < P_TLANES; j++)					\
+		s[0] += s[j];						\
+	for (; i < n; i++)						\
+		s[0] += (ACC)a[i] * (ACC)b[i];				\
+	*((RES *)res) = (RES)s[0];					\
+}
+
+// Scale and add (integers use unsigned arithmetic, UT, so they
+// wrap around on overflow):
+#define P_TSCALE(NAME, ATTR, T, UT)					\
+ATTR static void NAME(void *p, size_t n, const void *factor)		\
+{									\
+	T *a = (T *)p;							\
+	const UT f = (UT)*((const T *)factor);				\
+	for (size_t i = 0; i < n; i++)					\
+		a[i] = (T)((UT)a[i] * f);				\
+}
+
+#define P_TADD(NAME, ATTR, T, UT)					\
+ATTR static void NAME(void *pa, const void *pb, size_t n)		\
+{									\
+	T *a = (T *)pa;							\
+	const T *b = (const T *)pb;					\
+	for (size_t i = 0; i < n; i++)					\
+		a[i] = (T)((UT)a[i] + (UT)b[i]);			\
+}
+
+// Count the items that compare (op) true with value. Every
+// operator is a combination of <, == and >, so a single loop
+// (without branches) handles all of them:
+static const uint8_t p_tcmp_masks[6] = {
+	1,	// - ZV_LT: <
+	3,	// - ZV_LE: < or ==
+	2,	// - ZV_EQ: ==
+	5,	// - ZV_NE: < or >
+	6,	// - ZV_GE: == or >
+	4	// - ZV_GT: >
+};
+
+#define P_TCOUNT(NAME, ATTR, T)						\
+ATTR static size_t NAME(const void *p, size_t n, uint32_t op,		\
+			const void *value)				\
+{									\
+	const T *a = (const T *)p;					\
+	const T v = *((const T *)value);				\
+	const int lt = p_tcmp_masks[op] & 1;				\
+	const int eq = (p_tcmp_masks[op] >> 1) & 1;			\
+	const int gt = (p_tcmp_masks[op] >> 2) & 1;			\
+	size_t c = 0;							\
+	for (size_t i = 0; i < n; i++)					\
+		c += (size_t)(((a[i] < v) & lt) | ((a[i] == v) & eq) |	\
+			      ((a[i] > v) & gt));			\
+	return c;							\
+}
+
+// Index of the first item equal to value (or n), items are
+// counted a block at a time (which is SIMD friendly, unlike
+// stopping at the first match) and only the block with the
+// first match is searched item by item:
+#define P_TFIND_BLOCK 256
+
+#define P_TFIND(NAME, ATTR, T)						\
+ATTR static size_t NAME(const void *p, size_t n, const void *value)	\
+{									\
+	const T *a = (const T *)p;					\
+	const T v = *((const T *)value);				\
+	size_t i = 0;							\
+	for (; i + P_TFIND_BLOCK <= n; i += P_TFIND_BLOCK) {		\
+		size_t c = 0;						\
+		for (size_t j = i; j < i + P_TFIND_BLOCK; j++)		\
+			c += (a[j] == v);				\
+		if (c)							\
+			break;						\
+	}								\
+	for (; i < n; i++)						\
+		if (a[i] == v)						\
+			return i;					\
+	return n;							\
+}
+
+// The compiler doesn't turn float min and max into SIMD
+// instructions (it can't assume there are no NaN), so on x86_64
+// they are written with intrinsics (LOAD, OP and STORE are the
+// load, min or max and store intrinsics for a VEC of LANES
+// floats, BASE is the portable version of the kernel):
+#define P_TMINMAX_F32_SIMD(NAME, ATTR, VEC, LANES, LOAD, OP, STORE, BASE, CMP) \
+ATTR static void NAME(const void *p, size_t n, void *res)		\
+{									\
+	const float *a = (const float *)p;				\
+	if (n < (2 * LANES)) {						\
+		BASE(p, n, res);					\
+		return;							\
+	}								\
+	VEC m0 = LOAD(a);						\
+	VEC m1 = LOAD(a + LANES);					\
+	size_t i = 2 * LANES;						\
+	for (; i + (2 * LANES) <= n; i += (2 * LANES)) {		\
+		m0 = OP(m0, LOAD(a + i));				\
+		m1 = OP(m1, LOAD(a + i + LANES));			\
+	}								\
+	float r[LANES];							\
+	STORE(r, OP(m0, m1));						\
+	float m;							\
+	BASE(r, LANES, &m);						\
+	for (; i < n; i++)						\
+		if (a[i] CMP m)						\
+			m = a[i];					\
+	*((float *)res) = m;						\
+}
+
+// All the typed kernels for one instruction set:
+#define P_TKERNELS(SFX, ATTR)						\
+P_TSUM(p_tsum_i32_##SFX, ATTR, int32_t, uint64_t, int64_t)		\
+P_TSUM(p_tsum_f32_##SFX, ATTR, float, double, double)			\
+P_TMINMAX(p_tmin_i32_##SFX, ATTR, int32_t, <)				\
+P_TMINMAX(p_tmin_i64_##SFX, ATTR, int64_t, <)				\
+P_TMINMAX(p_tmax_i32_##SFX, ATTR, int32_t, >)				\
+P_TMINMAX(p_tmax_i64_##SFX, ATTR, int64_t, >)				\
+P_TDOT(p_tdot_i32_##SFX, ATTR, int32_t, uint64_t, int64_t)		\
+P_TDOT(p_tdot_i64_##SFX, ATTR, int64_t, uint64_t, int64_t)		\
+P_TDOT(p_tdot_f32_##SFX, ATTR, float, double, double)			\
+P_TDOT(p_tdot_f64_##SFX, ATTR, double, double, double)			\
+P_TSCALE(p_tscale_i32_##SFX, ATTR, int32_t, uint32_t)			\
+P_TSCALE(p_tscale_i64_##SFX, ATTR, int64_t, uint64_t)			\
+P_TSCALE(p_tscale_f32_##SFX, ATTR, float, float)			\
+P_TSCALE(p_tscale_f64_##SFX, ATTR, double, double)			\
+P_TADD(p_tadd_i32_##SFX, ATTR, int32_t, uint32_t)			\
+P_TADD(p_tadd_i64_##SFX, ATTR, int64_t, uint64_t)			\
+P_TADD(p_tadd_f32_##SFX, ATTR, float, float)				\
+P_TADD(p_tadd_f64_##SFX, ATTR, double, double)				\
+P_TCOUNT(p_tcount_i32_##SFX, ATTR, int32_t)				\
+P_TCOUNT(p_tcount_i64_##SFX, ATTR, int64_t)				\
+P_TCOUNT(p_tcount_f32_##SFX, ATTR, float)				\
+P_TCOUNT(p_tcount_f64_##SFX, ATTR, double)				\
+P_TFIND(p_tfind_i32_##SFX, ATTR, int32_t)				\
+P_TFIND(p_tfind_i64_##SFX, ATTR, int64_t)				\
+P_TFIND(p_tfind_f32_##SFX, ATTR, float)					\
+P_TFIND(p_tfind_f64_##SFX, ATTR, double)
+
+// Wrappers for the reductions we already have:
+static void p_tsum_i64(const void *a, size_t n, void *res)
+{
+	*((int64_t *)res) = (*(p_kern.sum_i64))((const int64_t *)a, n);
+}
+
+static void p_tsum_f64(const void *a, size_t n, void *res)
+{
+	*((double *)res) = (*(p_kern.sum_f64))((const double *)a, n);
+}
+
+static void p_tmin_f64(const void *a, size_t n, void *res)
+{
+	*((double *)res) = (*(p_kern.min_f64))((const double *)a, n);
+}
+
+static void p_tmax_f64(const void *a, size_t n, void *res)
+{
+	*((double *)res) = (*(p_kern.max_f64))((const double *)a, n);
+}
+
+// The kernels table for one instruction set (indexed by
+// ZVECT_TYPES - 1):
+#define P_TTABLE(SFX) {								\
+	{ p_tsum_i32_##SFX, p_tmin_i32_##SFX, p_tmax_i32_##SFX,			\
+	  p_tdot_i32_##SFX, p_tscale_i32_##SFX, p_tadd_i32_##SFX,		\
+	  p_tcount_i32_##SFX, p_tfind_i32_##SFX },				\
+	{ p_tsum_i64, p_tmin_i64_##SFX, p_tmax_i64_##SFX,			\
+	  p_tdot_i64_##SFX, p_tscale_i64_##SFX, p_tadd_i64_##SFX,		\
+	  p_tcount_i64_##SFX, p_tfind_i64_##SFX },				\
+	{ p_tsum_f32_##SFX, p_tmin_f32_##SFX, p_tmax_f32_##SFX,			\
+	  p_tdot_f32_##SFX, p_tscale_f32_##SFX, p_tadd_f32_##SFX,		\
+	  p_tcount_f32_##SFX, p_tfind_f32_##SFX },				\
+	{ p_tsum_f64, p_tmin_f64, p_tmax_f64,					\
+	  p_tdot_f64_##SFX, p_tscale_f64_##SFX, p_tadd_f64_##SFX,		\
+	  p_tcount_f64_##SFX, p_tfind_f64_##SFX }				\
+}
+
+#define P_TTYPES 4
+
+P_TKERNELS(base, )
+P_TMINMAX(p_tmin_f32_base, , float, <)
+P_TMINMAX(p_tmax_f32_base, , float, >)
+static const struct p_typed_kernels p_tkern_base[P_TTYPES] = P_TTABLE(base);
+
+#if defined(ZVECT_SIMD_DISPATCH)
+P_TKERNELS(avx2, ZVECT_TARGET("avx2"))
+P_TMINMAX_F32_SIMD(p_tmin_f32_avx2, ZVECT_TARGET("avx2"), __m256, 8, _mm256_loadu_ps,
+		   _mm256_min_ps, _mm256_storeu_ps, p_tmin_f32_base, <)
+P_TMINMAX_F32_SIMD(p_tmax_f32_avx2, ZVECT_TARGET("avx2"), __m256, 8, _mm256_loadu_ps,
+		   _mm256_max_ps, _mm256_storeu_ps, p_tmax_f32_base, >)
+static const struct p_typed_kernels p_tkern_avx2[P_TTYPES] = P_TTABLE(avx2);
+
+P_TKERNELS(avx512, ZVECT_TARGET("avx512f,prefer-vector-width=512"))
+P_TMINMAX_F32_SIMD(p_tmin_f32_avx512, ZVECT_TARGET("avx512f"), __m512, 16, _mm512_loadu_ps,
+		   _mm512_min_ps, _mm512_storeu_ps, p_tmin_f32_base, <)
+P_TMINMAX_F32_SIMD(p_tmax_f32_avx512, ZVECT_TARGET("avx512f"), __m512, 16, _mm512_loadu_ps,
+		   _mm512_max_ps, _mm512_storeu_ps, p_tmax_f32_base, >)
+static const struct p_typed_kernels p_tkern_avx512[P_TTYPES] = P_TTABLE(avx512);
+#endif // ZVECT_SIMD_DISPATCH
+
+// Typed kernels in use:
+static const struct p_typed_kernels *p_tkern = p_tkern_base;
+
+static uint32_t p_cpu_detect(void)
+{
+	uint32_t features = 0;
+#if defined(ZVECT_SIMD_SSE2)
+	features |= ZV_CPU_SSE2;
+#endif
+#if defined(ZVECT_SIMD_DISPATCH)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		features |= ZV_CPU_AVX2;
+	if (__builtin_cpu_supports("avx512f"))
+		features |= ZV_CPU_AVX512;
+#endif
+	return features;
+}
+
+/*
+ * Select the best kernels using (at most) the given features
+ * and return the features actually in use.
+ */
+static uint32_t p_kernels_select(uint32_t features)
+{
+	struct p_kernels k = {
+		p_fill_ptrs_scalar, p_find_bytes_scalar, p_sum_f64_scalar,
+		p_sum_i64_scalar, p_min_f64_scalar, p_max_f64_scalar
+	};
+	const struct p_typed_kernels *tk = p_tkern_base;
+	uint32_t active = 0;
+
+	features &= p_cpu_detected;
+
+#if defined(ZVECT_SIMD_SSE2)
+	if (features & ZV_CPU_SSE2) {
+		k.fill_ptrs = p_fill_ptrs_sse2;
+		k.find_bytes = p_find_bytes_sse2;
+		k.sum_f64 = p_sum_f64_sse2;
+		k.sum_i64 = p_sum_i64_sse2;
+		k.min_f64 = p_min_f64_sse2;
+		k.max_f64 = p_max_f64_sse2;
+		active |= ZV_CPU_SSE2;
+	}
+#endif
+#if defined(ZVECT_SIMD_DISPATCH)
+	if (features & ZV_CPU_AVX2) {
+		k.fill_ptrs = p_fill_ptrs_avx2;
+		k.find_bytes = p_find_bytes_avx2;
+		k.sum_f64 = p_sum_f64_avx2;
+		k.sum_i64 = p_sum_i64_avx2;
+		k.min_f64 = p_min_f64_avx2;
+		k.max_f64 = p_max_f64_avx2;
+		tk = p_tkern_avx2;
+		active |= ZV_CPU_AVX2;
+	}
+	if (features & ZV_CPU_AVX512) {
+		k.fill_ptrs = p_fill_ptrs_avx512;
+		k.find_bytes = p_find_bytes_avx512;
+		k.sum_f64 = p_sum_f64_avx512;
+		k.sum_i64 = p_sum_i64_avx512;
+		k.min_f64 = p_min_f64_avx512;
+		k.max_f64 = p_max_f64_avx512;
+		tk = p_tkern_avx512;
+		active |= ZV_CPU_AVX512;
+	}
+#endif
+
+	p_kern = k;
+	p_tkern = tk;
+	p_cpu_active = active;
+
+	return active;
+}
+
+/*---------------------------------------------------------------------------*/
+
 /*---------------------------------------------------------------------------*/
 // Memory management:
 
@@ -707,71 +1629,530 @@ static zvect_retval get_mutex_unlock(ivector v,
 #endif // ZVECT_THREAD_SAFE
 /*---------------------------------------------------------------------------*/
 
-/*****************************************************************************
- **                          ZVector Primitives                             **
- *****************************************************************************/
-
 /*---------------------------------------------------------------------------*/
-// Library Initialisation:
+// Worker Pool:
 
-void p_init_zvect(void)
-{
-#if (OS_TYPE == 1)
-#	if ( !defined(macOS) )
-		//mallopt(M_MXFAST, 196*sizeof(size_t)/4);
-#	endif
-#endif  // OS_TYPE == 1
+/*
+ * ZVector owns a single pool of worker threads that is shared by all the
+ * parallel functions. Each worker has its own deque of range tasks: it
+ * pops tasks from the bottom of its own deque and, when that is empty,
+ * it steals from the top of the other workers' deques.
+ * The thread that submits a range doesn't sit idle waiting for the pool,
+ * it helps executing tasks until all the chunks of its range are done,
+ * this also means that a parallel function can be safely called from
+ * within another parallel function.
+ */
 
-	// We are done initialising ZVector so set the following
-	// to one, so this function will no longer be called:
-	p_init_state = 1;
-}
+// Function that processes items [start, end) of a range task:
+typedef void (*p_task_func)(void *arg, zvect_index start, zvect_index end);
 
-/*---------------------------------------------------------------------------*/
+#if (ZVECT_WORKER_POOL == 1)
 
-/*---------------------------------------------------------------------------*/
-// Vector's Utilities:
+struct p_task_group {
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+	zvect_index pending;		// - Number of tasks not completed yet
+};
 
-ZVECT_ALWAYSINLINE
-static inline zvect_retval p_vect_check(const_vector const x)
+struct p_task {
+	p_task_func func;		// - Function to execute
+	void *arg;			// - Function's argument
+	zvect_index start;		// - First item of the chunk
+	zvect_index end;		// - Item after the last of the chunk
+	struct p_task_group *group;	// - Group this task belongs to
+};
+
+struct p_deque {
+	pthread_mutex_t lock;
+	struct p_task *tasks;		// - Ring buffer of tasks
+	size_t cap;			// - Ring buffer capacity
+	size_t top;			// - Thieves steal from here
+	size_t count;			// - Number of tasks in the deque
+};
+
+static struct p_pool {
+	pthread_mutex_t lock;		// - Protects all the fields below
+	pthread_cond_t work;		// - Signalled when tasks are queued
+	pthread_t *threads;
+	struct p_deque *deques;		// - One deque per worker
+	size_t nworkers;		// - Number of deques
+	size_t nthreads;		// - Number of threads running
+	size_t queued;			// - Tasks waiting in the deques
+	size_t next;			// - Next deque to receive tasks
+	bool shutdown;
+	uint32_t state;			// - 0 = stopped, 1 = running
+	size_t cfg_threads;		// - Number of workers to start
+	bool cfg_set;			// - cfg_threads has been configured
+	int *cpus;			// - CPUs the workers are pinned to
+	size_t ncpus;			//   (NULL = no affinity)
+} p_pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+	     NULL, NULL, 0, 0, 0, 0, false, 0, 0, false, NULL, 0 };
+
+static zvect_retval p_deque_push(struct p_deque *d, const struct p_task *t)
 {
-	return (x == NULL) ? ZVERR_VECTUNDEF : 0;
+	mutex_lock(&(d->lock));
+	if (d->count == d->cap) {
+		size_t new_cap = d->cap ? d->cap << 1 : 16;
+		struct p_task *new_tasks = (struct p_task *)malloc(sizeof(struct p_task) * new_cap);
+		if (new_tasks == NULL) {
+			mutex_unlock(&(d->lock));
+			return ZVERR_OUTOFMEM;
+		}
+		for (size_t i = 0; i < d->count; i++)
+			new_tasks[i] = d->tasks[(d->top + i) % d->cap];
+		free(d->tasks);
+		d->tasks = new_tasks;
+		d->cap = new_cap;
+		d->top = 0;
+	}
+	d->tasks[(d->top + d->count) % d->cap] = *t;
+	d->count++;
+	mutex_unlock(&(d->lock));
+	return 0;
 }
 
-ZVECT_ALWAYSINLINE
-static inline zvect_index p_vect_capacity(const_vector const v)
+// The owner takes from the bottom (most recently pushed task):
+static bool p_deque_pop(struct p_deque *d, struct p_task *t)
 {
-	return ( v->cap_left + v->cap_right );
+	bool rval = false;
+	mutex_lock(&(d->lock));
+	if (d->count) {
+		d->count--;
+		*t = d->tasks[(d->top + d->count) % d->cap];
+		rval = true;
+	}
+	mutex_unlock(&(d->lock));
+	return rval;
 }
 
-ZVECT_ALWAYSINLINE
-static inline zvect_index p_vect_size(const_vector const v)
+// Thieves take from the top (oldest task):
+static bool p_deque_steal(struct p_deque *d, struct p_task *t)
 {
-	return ( v->end > v->begin ) ? ( v->end - v->begin ) : ( v->begin - v->end );
+	bool rval = false;
+	mutex_lock(&(d->lock));
+	if (d->count) {
+		*t = d->tasks[d->top];
+		d->top = (d->top + 1) % d->cap;
+		d->count--;
+		rval = true;
+	}
+	mutex_unlock(&(d->lock));
+	return rval;
 }
 
-static inline void p_item_safewipe(const_vector const v, void *const item)
+/*
+ * Get a task to execute, "self" is the worker's own deque,
+ * use a value >= nworkers when the caller is not a worker.
+ */
+static bool p_pool_take(size_t self, struct p_task *t)
 {
-	if (item != NULL) {
-		if (!(v->status & ZVS_CUST_WIPE_ON)) {
-			memset(item, 0, v->data_size);
-		} else {
-			(*(v->SfWpFunc))(item, v->data_size);
-		}
+	size_t n = p_pool.nworkers;
+	bool found = false;
+
+	if (self < n)
+		found = p_deque_pop(&(p_pool.deques[self]), t);
+	else
+		self = 0;
+
+	for (size_t i = 0; !found && i < n; i++)
+		found = p_deque_steal(&(p_pool.deques[(self + i) % n]), t);
+
+	if (found) {
+		mutex_lock(&(p_pool.lock));
+		p_pool.queued--;
+		mutex_unlock(&(p_pool.lock));
 	}
+
+	return found;
 }
 
-ZVECT_ALWAYSINLINE
-static inline zvect_retval p_usr_status(zvect_index flag_id)
+static void p_task_run(const struct p_task *t)
 {
-	// For now leave the switch 'cause I may add more cases later
-	switch (flag_id) {
-		case  1: return 0;
-		default: return 1;
-	}
+	struct p_task_group *group = t->group;
+
+	(*(t->func))(t->arg, t->start, t->end);
+
+	// Please note: the group lives on the submitter's stack, so
+	// after we release its lock we must not touch it anymore:
+	mutex_lock(&(group->lock));
+	if (--(group->pending) == 0)
+		pthread_cond_signal(&(group->done));
+	mutex_unlock(&(group->lock));
 }
 
-bool vect_check_status(const_vector const v, zvect_index flag_id)
+static void p_pool_set_affinity(size_t self)
+{
+#	if defined(__linux__)
+	mutex_lock(&(p_pool.lock));
+	int cpu = (p_pool.ncpus) ? p_pool.cpus[self % p_pool.ncpus] : -1;
+	mutex_unlock(&(p_pool.lock));
+
+	if (cpu >= 0 && cpu < CPU_SETSIZE) {
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(cpu, &cpu_set);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+	}
+#	else
+	UNUSED(self);
+#	endif
+}
+
+static void *p_pool_worker(void *arg)
+{
+	size_t self = (size_t)(uintptr_t)arg;
+	struct p_task t;
+
+	p_pool_set_affinity(self);
+
+	for (;;) {
+		if (p_pool_take(self, &t)) {
+			p_task_run(&t);
+			continue;
+		}
+
+		// Nothing to do, sleep until new tasks get queued:
+		mutex_lock(&(p_pool.lock));
+		while (!p_pool.queued && !p_pool.shutdown)
+			pthread_cond_wait(&(p_pool.work), &(p_pool.lock));
+		bool quit = (p_pool.shutdown && !p_pool.queued);
+		mutex_unlock(&(p_pool.lock));
+
+		if (quit)
+			break;
+	}
+
+	return NULL;
+}
+
+static size_t p_pool_default_threads(void)
+{
+	long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+	// The submitting thread helps too, so we need one
+	// worker less than the number of online CPUs:
+	if (ncpu <= 1)
+		return 0;
+	if (ncpu > ZVECT_POOL_MAX_THREADS)
+		ncpu = ZVECT_POOL_MAX_THREADS;
+	return (size_t)(ncpu - 1);
+}
+
+/*
+ * Configure the pool defaults, this is called by p_init_zvect
+ * and doesn't spawn any thread: workers are started at the
+ * first parallel operation.
+ */
+static void p_pool_init(void)
+{
+	mutex_lock(&(p_pool.lock));
+	if (!p_pool.cfg_set) {
+		p_pool.cfg_threads = p_pool_default_threads();
+		p_pool.cfg_set = true;
+	}
+	mutex_unlock(&(p_pool.lock));
+}
+
+/*
+ * Start the pool (if it's not running already) and return
+ * the number of available workers.
+ */
+static size_t p_pool_start(void)
+{
+	size_t nworkers;
+
+	mutex_lock(&(p_pool.lock));
+	if (p_pool.state == 0) {
+		if (!p_pool.cfg_set) {
+			p_pool.cfg_threads = p_pool_default_threads();
+			p_pool.cfg_set = true;
+		}
+		size_t n = p_pool.cfg_threads;
+		p_pool.shutdown = false;
+		p_pool.queued = 0;
+		p_pool.next = 0;
+		p_pool.nworkers = 0;
+		p_pool.nthreads = 0;
+		if (n) {
+			p_pool.threads = (pthread_t *)malloc(sizeof(pthread_t) * n);
+			p_pool.deques = (struct p_deque *)calloc(n, sizeof(struct p_deque));
+			if (p_pool.threads == NULL || p_pool.deques == NULL) {
+				free(p_pool.threads);
+				free(p_pool.deques);
+				p_pool.threads = NULL;
+				p_pool.deques = NULL;
+				n = 0;
+			}
+		}
+		for (size_t i = 0; i < n; i++)
+			pthread_mutex_init(&(p_pool.deques[i].lock), NULL);
+		p_pool.nworkers = n;
+		// If we fail to spawn some threads we simply run with
+		// the workers we got (the others' deques will be
+		// emptied by stealing):
+		for (size_t i = 0; i < n; i++) {
+			if (pthread_create(&(p_pool.threads[i]), NULL,
+					   p_pool_worker, (void *)(uintptr_t)i))
+				break;
+			p_pool.nthreads++;
+		}
+		p_pool.state = 1;
+	}
+	nworkers = p_pool.nworkers;
+	mutex_unlock(&(p_pool.lock));
+
+	return nworkers;
+}
+
+/*
+ * Stop all the workers and release the pool resources. The
+ * workers complete all the queued tasks before quitting.
+ */
+static void p_pool_stop(void)
+{
+	mutex_lock(&(p_pool.lock));
+	if (p_pool.state == 0) {
+		mutex_unlock(&(p_pool.lock));
+		return;
+	}
+	p_pool.shutdown = true;
+	pthread_cond_broadcast(&(p_pool.work));
+	mutex_unlock(&(p_pool.lock));
+
+	for (size_t i = 0; i < p_pool.nthreads; i++)
+		pthread_join(p_pool.threads[i], NULL);
+
+	mutex_lock(&(p_pool.lock));
+	for (size_t i = 0; i < p_pool.nworkers; i++) {
+		free(p_pool.deques[i].tasks);
+		pthread_mutex_destroy(&(p_pool.deques[i].lock));
+	}
+	free(p_pool.deques);
+	free(p_pool.threads);
+	p_pool.deques = NULL;
+	p_pool.threads = NULL;
+	p_pool.nworkers = 0;
+	p_pool.nthreads = 0;
+	p_pool.state = 0;
+	mutex_unlock(&(p_pool.lock));
+}
+
+/*
+ * Split [start, end) in chunks of "grain" items and process them on
+ * up to "nthreads" threads (the calling thread included). nthreads
+ * set to 0 means use all the pool workers, grain set to 0 means let
+ * ZVector pick a chunk size.
+ */
+static zvect_retval p_pool_run_range(zvect_index start, zvect_index end,
+				     zvect_index nthreads, zvect_index grain,
+				     p_task_func func, void *arg)
+{
+	if (end <= start)
+		return 0;
+
+	zvect_index items = end - start;
+	size_t nworkers = p_pool_start();
+
+	if ((nthreads == 0) || (nthreads > nworkers + 1))
+		nthreads = (zvect_index)(nworkers + 1);
+
+	if (grain == 0) {
+		grain = items / (nthreads * 4);
+		if (grain < ZVECT_POOL_MIN_GRAIN)
+			grain = ZVECT_POOL_MIN_GRAIN;
+	}
+
+	// Not worth (or not possible) going parallel:
+	if ((nthreads <= 1) || (items <= grain)) {
+		(*func)(arg, start, end);
+		return 0;
+	}
+
+	struct p_task_group group;
+	pthread_mutex_init(&(group.lock), NULL);
+	pthread_cond_init(&(group.done), NULL);
+	group.pending = 0;
+
+	// Pick the deques that will receive this range:
+	mutex_lock(&(p_pool.lock));
+	size_t base = p_pool.next;
+	p_pool.next = (p_pool.next + (nthreads - 1)) % nworkers;
+	mutex_unlock(&(p_pool.lock));
+
+	// Queue the chunks (the group lock prevents the workers
+	// from seeing pending reaching 0 while we are still
+	// queueing):
+	struct p_task t;
+	t.func = func;
+	t.arg = arg;
+	t.group = &group;
+	size_t queued = 0;
+	zvect_index s = start;
+	mutex_lock(&(group.lock));
+	while (s < end) {
+		t.start = s;
+		t.end = (end - s > grain) ? s + grain : end;
+		if (p_deque_push(&(p_pool.deques[(base + (queued % (nthreads - 1))) % nworkers]), &t))
+			break;
+		group.pending++;
+		queued++;
+		s = t.end;
+	}
+	mutex_unlock(&(group.lock));
+
+	mutex_lock(&(p_pool.lock));
+	p_pool.queued += queued;
+	pthread_cond_broadcast(&(p_pool.work));
+	mutex_unlock(&(p_pool.lock));
+
+	// If we ran out of memory while queueing, then
+	// process what's left on this thread:
+	if (s < end)
+		(*func)(arg, s, end);
+
+	// Help the pool until all our tasks have been taken:
+	for (;;) {
+		mutex_lock(&(group.lock));
+		zvect_index pending = group.pending;
+		mutex_unlock(&(group.lock));
+		if (!pending || !p_pool_take((size_t)-1, &t))
+			break;
+		p_task_run(&t);
+	}
+
+	// Wait for the chunks still running on the workers:
+	mutex_lock(&(group.lock));
+	while (group.pending)
+		pthread_cond_wait(&(group.done), &(group.lock));
+	mutex_unlock(&(group.lock));
+
+	pthread_cond_destroy(&(group.done));
+	pthread_mutex_destroy(&(group.lock));
+
+	return 0;
+}
+
+#else
+
+// No pool available on this platform, so just process
+// the whole range on the calling thread:
+static zvect_retval p_pool_run_range(zvect_index start, zvect_index end,
+				     zvect_index nthreads, zvect_index grain,
+				     p_task_func func, void *arg)
+{
+	UNUSED(nthreads);
+	UNUSED(grain);
+	if (end > start)
+		(*func)(arg, start, end);
+	return 0;
+}
+
+#endif // ZVECT_WORKER_POOL
+
+/*---------------------------------------------------------------------------*/
+
+/*****************************************************************************
+ **                          ZVector Primitives                             **
+ *****************************************************************************/
+
+/*---------------------------------------------------------------------------*/
+// Library Initialisation:
+
+void p_init_zvect(void)
+{
+#if (OS_TYPE == 1)
+#	if ( !defined(macOS) )
+		//mallopt(M_MXFAST, 196*sizeof(size_t)/4);
+#	endif
+#endif  // OS_TYPE == 1
+
+	// Select the best bulk kernels for this CPU:
+	p_cpu_detected = p_cpu_detect();
+	p_kernels_select(p_cpu_detected);
+
+#if (ZVECT_WORKER_POOL == 1)
+	// Configure the worker pool (threads will be
+	// spawned at the first parallel operation):
+	p_pool_init();
+#endif
+
+	// We are done initialising ZVector so set the following
+	// to one, so this function will no longer be called:
+	p_init_state = 1;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Vector's Utilities:
+
+static inline unsigned int p_popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_popcountll(x);
+#else
+	unsigned int n = 0;
+	for (; x; x &= x - 1)
+		n++;
+	return n;
+#endif
+}
+
+static inline unsigned int p_ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (unsigned int)__builtin_ctzll(x);
+#else
+	unsigned int n = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+ZVECT_ALWAYSINLINE
+static inline zvect_retval p_vect_check(const_vector const x)
+{
+	return (x == NULL) ? ZVERR_VECTUNDEF : 0;
+}
+
+ZVECT_ALWAYSINLINE
+static inline zvect_index p_vect_capacity(const_vector const v)
+{
+	return ( v->cap_left + v->cap_right );
+}
+
+ZVECT_ALWAYSINLINE
+static inline zvect_index p_vect_size(const_vector const v)
+{
+	return ( v->end > v->begin ) ? ( v->end - v->begin ) : ( v->begin - v->end );
+}
+
+static inline void p_item_safewipe(const_vector const v, void *const item)
+{
+	if (item != NULL) {
+		if (!(v->status & ZVS_CUST_WIPE_ON)) {
+			memset(item, 0, v->data_size);
+			P_WIPE_BARRIER(item);
+		} else {
+			(*(v->SfWpFunc))(item, v->data_size);
+		}
+	}
+}
+
+ZVECT_ALWAYSINLINE
+static inline zvect_retval p_usr_status(zvect_index flag_id)
+{
+	// For now leave the switch 'cause I may add more cases later
+	switch (flag_id) {
+		case  1: return 0;
+		default: return 1;
+	}
+}
+
+bool vect_check_status(const_vector const v, zvect_index flag_id)
 {
 	if (flag_id > 23)
 		return 0;
@@ -883,6 +2264,7 @@ static zvect_retval p_vect_set_capacity(ivector v,
 
 	// Apply changes
 	v->data = new_data;
+	v->generation++;
 
 	// done
 	return 0;
@@ -981,6 +2363,18 @@ static zvect_retval p_vect_decrease_capacity(ivector v,
 
 		new_capacity = max( (p_vect_size(v) >> 1), new_capacity);
 
+		// Items past the new end of the storage (begin may have
+		// been moved right by deletes at the front) are moved down
+		// first, or realloc would cut them off:
+		zvect_index limit = v->cap_left + new_capacity;
+		if (v->end > limit) {
+			zvect_index shift = v->end - limit;
+			p_vect_memmove(v->data + (v->begin - shift), v->data + v->begin,
+				       sizeof(void *) * (v->end - v->begin));
+			v->begin -= shift;
+			v->end = limit;
+		}
+
 		new_data = (void **)realloc(v->data, sizeof(void *) * (v->cap_left + new_capacity));
 		if (new_data == NULL)
 			return ZVERR_OUTOFMEM;
@@ -991,6 +2385,7 @@ static zvect_retval p_vect_decrease_capacity(ivector v,
 
 	// Apply changes
 	v->data = new_data;
+	v->generation++;
 
 	// done:
 	return 0;
@@ -1028,13 +2423,16 @@ static zvect_retval p_vect_shrink(ivector v)
 	// Note: ">> 1" is the same as "/ 2"
 	//       this is an optimisation for old
 	//       compilers.
-	nb = ( new_capacity >> 1 );
+	// The free slots are split between the two sides, so the
+	// items always fit in the new capacity:
+	nb = ( (new_capacity - p_vect_size(v)) >> 1 );
 	ne = ( nb + (v->end - v->begin) );
 	p_vect_memcpy(new_data + nb, v->data + v->begin, sizeof(void *) * (v->end - v->begin) );
 
 	// Apply changes:
 	free(v->data);
 	v->data = new_data;
+	v->generation++;
 	v->end = ne;
 	v->begin = nb;
 	v->cap_left = new_capacity >> 1;
@@ -1047,653 +2445,6082 @@ static zvect_retval p_vect_shrink(ivector v)
 /*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
-// Creation and destruction primitives:
+// Hash index primitives:
+#ifdef ZVECT_DMF_EXTENSIONS
+// The hash index is an open addressing (linear probing) hash
+// table which maps the hash of every item to its index in the
+// vector. Indexes are stored with a bias, so that adding or
+// removing items at the front of the vector (which shifts all
+// the indexes by the same amount) only needs to change the bias.
+// Changes the index can't follow incrementally just mark it as
+// dirty and it's rebuilt on the next search.
+#define P_HINDEX_MIN_SLOTS 16
+
+struct p_hslot {
+	uint32_t hash;			// - Item hash (0 means empty slot)
+	zvect_index pos;		// - Item index + bias
+};
 
-zvect_retval p_vect_clear(ivector v)
-{
-	// Clear the vector:
-	if (!vect_is_empty(v))
-		p_free_items(v, 0, (p_vect_size(v) - 1));
+struct p_hindex {
+	uint64_t (*hash_fn)(const void *item);
+	bool (*eq_fn)(const void *key, const void *item);
+	struct p_hslot *slots;		// - Hash table
+	zvect_index mask;		// - Number of slots - 1
+	zvect_index count;		// - Number of used slots
+	zvect_index bias;		// - Added to the indexes stored
+	bool dirty;			// - Needs to be rebuilt
+};
 
-	// Reset interested descriptors:
-	v->begin = v->end = 0;
+static inline uint32_t p_hindex_hash(const struct p_hindex *hx, const void *item) {
+	uint64_t h = (*(hx->hash_fn))(item);
+	uint32_t hv = (uint32_t)(h >> 32) ^ (uint32_t)h;
+	return hv ? hv : 1;
+}
 
-	// Shrink Vector's capacity:
-	// p_vect_shrink(v); // commented this out to make vect_clear behave more like the clear method in C++
+static void p_hindex_put_slot(struct p_hindex *hx, uint32_t hv, zvect_index pos) {
+	zvect_index i = hv & hx->mask;
+	while (hx->slots[i].hash != 0)
+		i = (i + 1) & hx->mask;
+	hx->slots[i].hash = hv;
+	hx->slots[i].pos = pos;
+	hx->count++;
+}
+
+// Resizes the hash table so it can contain at least "items" items
+// with a load factor lower than 50%:
+static zvect_retval p_hindex_resize(struct p_hindex *hx, zvect_index items) {
+	size_t nslots = P_HINDEX_MIN_SLOTS;
+	while (nslots < ((size_t)items * 2))
+		nslots *= 2;
+
+	struct p_hslot *old = hx->slots;
+	size_t old_nslots = (old != NULL) ? (size_t)hx->mask + 1 : 0;
+	struct p_hslot *slots = (struct p_hslot *)calloc(nslots, sizeof(struct p_hslot));
+	if (slots == NULL)
+		return ZVERR_OUTOFMEM;
+
+	hx->slots = slots;
+	hx->mask = (zvect_index)(nslots - 1);
+	hx->count = 0;
+	for (size_t i = 0; i < old_nslots; i++) {
+		if (old[i].hash != 0)
+			p_hindex_put_slot(hx, old[i].hash, old[i].pos);
+	}
+	free(old);
 
 	return 0;
 }
 
-static zvect_retval p_vect_destroy(vector v, uint32_t flags)
-{
-	// p_destroy is an exception to the rule of handling
-	// locking from the public methods. This because
-	// p_destroy has to destroy the vector mutex too and
-	// so it needs to control the lock as well!
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-	if (!lock_owner && (!locking_disabled) && !(v->flags & ZV_NOLOCKING))
-		return ZVERR_RACECOND;
-#endif
+static zvect_retval p_hindex_rebuild(const_vector v, struct p_hindex *hx) {
+	zvect_index vsize = p_vect_size(v);
 
-	// Clear the vector (if LSB of flags is set to 1):
-	if ((p_vect_size(v) > 0) && (flags & 1)) {
-		// Clean the vector:
-		p_vect_clear(v);
+	free(hx->slots);
+	hx->slots = NULL;
+	hx->bias = 0;
+	hx->dirty = true;
 
-		// Reset interested descriptors:
-		v->end = 0;
-	}
+	zvect_retval rval = p_hindex_resize(hx, vsize);
+	if (rval)
+		return rval;
 
-	// Destroy the vector:
-	v->init_capacity = v->cap_left = v->cap_right = 0;
+	for (zvect_index i = 0; i < vsize; i++)
+		p_hindex_put_slot(hx, p_hindex_hash(hx, v->data[v->begin + i]), i);
+	hx->dirty = false;
 
-	// Destroy it:
-	if (v->status & ZVS_CUST_WIPE_ON)
-		v->SfWpFunc = NULL;
+	return 0;
+}
 
-	if (v->data != NULL) {
-		free(v->data);
-		v->data = NULL;
+static void p_hindex_free(struct p_hindex *hx) {
+	if (hx == NULL)
+		return;
+	free(hx->slots);
+	free(hx);
+}
+
+static inline void p_hindex_invalidate(const_vector v) {
+	if (v->hindex != NULL)
+		v->hindex->dirty = true;
+}
+
+// Removes the slot of the item at index i (using backward shift
+// deletion, so no tombstones are needed):
+static void p_hindex_del_slot(struct p_hindex *hx, uint32_t hv, zvect_index i) {
+	zvect_index pos = i + hx->bias;
+	zvect_index s = hv & hx->mask;
+
+	while (hx->slots[s].hash != 0) {
+		if ((hx->slots[s].hash == hv) && (hx->slots[s].pos == pos))
+			break;
+		s = (s + 1) & hx->mask;
+	}
+	if (hx->slots[s].hash == 0) {
+		// Not found, the index is out of sync:
+		hx->dirty = true;
+		return;
 	}
 
-	// Clear vector status flags:
-	v->status = v->flags = v->begin = v->end = v->data_size = v->balance = v->bottom = 0;
+	zvect_index j = s;
+	while (1) {
+		j = (j + 1) & hx->mask;
+		if (hx->slots[j].hash == 0)
+			break;
+		zvect_index home = hx->slots[j].hash & hx->mask;
+		// Slot j can stay where it is if its home is
+		// (cyclically) within (s, j]:
+		if ((s <= j) ? ((s < home) && (home <= j)) : ((s < home) || (home <= j)))
+			continue;
+		hx->slots[s] = hx->slots[j];
+		s = j;
+	}
+	hx->slots[s].hash = 0;
+	hx->count--;
+}
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if ( lock_owner )
-		get_mutex_unlock(v, v->lock_type);
-	mutex_destroy(&(v->lock));
-	semaphore_destroy(&(v->semaphore));
-#endif
+// Adds "delta" to the index of every item at index "from" or after:
+static void p_hindex_shift(struct p_hindex *hx, zvect_index from, zvect_index delta) {
+	for (zvect_index s = 0; s <= hx->mask; s++) {
+		if ((hx->slots[s].hash != 0) && ((hx->slots[s].pos - hx->bias) >= from))
+			hx->slots[s].pos += delta;
+	}
+}
 
-	// All done and freed, so we can safely
-	// free the vector itself:
-	free(v);
+// Called after an item has been added at index i:
+static void p_hindex_insert(const_vector v, zvect_index i) {
+	struct p_hindex *hx = v->hindex;
+	if (hx->dirty || (v->flags & ZV_CIRCULAR)) {
+		hx->dirty = true;
+		return;
+	}
 
-	return 0;
+	zvect_index vsize = p_vect_size(v);
+	if ((hx->count + 1) * 2 > hx->mask + 1) {
+		if (p_hindex_resize(hx, hx->count + 1)) {
+			hx->dirty = true;
+			return;
+		}
+	}
+
+	if (i == 0)
+		hx->bias--;
+	else if (i < (vsize - 1))
+		p_hindex_shift(hx, i, 1);
+	p_hindex_put_slot(hx, p_hindex_hash(hx, v->data[v->begin + i]), i + hx->bias);
 }
 
-/*---------------------------------------------------------------------------*/
+// Called before "count" items are removed starting from index i:
+static void p_hindex_remove(const_vector v, zvect_index i, zvect_index count) {
+	struct p_hindex *hx = v->hindex;
+	if (hx->dirty || (v->flags & ZV_CIRCULAR)) {
+		hx->dirty = true;
+		return;
+	}
 
+	zvect_index vsize = p_vect_size(v);
+	if ((i + count) > vsize) {
+		hx->dirty = true;
+		return;
+	}
 
-/*---------------------------------------------------------------------------*/
-// Vector data storage primitives:
+	for (zvect_index j = i; j < i + count; j++)
+		p_hindex_del_slot(hx, p_hindex_hash(hx, v->data[v->begin + j]), j);
 
-// inline implementation for all put:
-static zvect_retval p_vect_put_at(ivector v, const void *value,
-                                const zvect_index i) {
-	// Check if the index passed is out of bounds:
-	zvect_index idx = i;
-	if (!(v->flags & ZV_CIRCULAR))
-	{
-		if (idx >= p_vect_size(v))
-			return ZVERR_IDXOUTOFBOUND;
-	} else {
-		if (idx >= p_vect_size(v))
-			idx = i % v->init_capacity;
-	}
+	if (i == 0)
+		hx->bias += count;
+	else if ((i + count) < vsize)
+		p_hindex_shift(hx, i + count, (zvect_index)(0 - count));
+}
 
-	// Add value at the specified index, considering
-	// if the vector has ZV_BYREF property enabled:
-	if ( v->flags & ZV_BYREF ) {
-		void *temp = v->data[v->begin + idx];
-		v->data[v->begin + idx] = (void *)value;
-		if ( v->flags & ZV_SEC_WIPE )
-			memset((void *)temp, 0, v->data_size);
-	} else {
-		p_vect_memcpy(v->data[v->begin + idx], value, v->data_size);
+// Called before (before = true) and after the item at index i is
+// replaced:
+static void p_hindex_replace(const_vector v, zvect_index i, bool before) {
+	struct p_hindex *hx = v->hindex;
+	if (hx->dirty || (v->flags & ZV_CIRCULAR)) {
+		hx->dirty = true;
+		return;
 	}
 
-	// done
-	return 0;
+	uint32_t hv = p_hindex_hash(hx, v->data[v->begin + i]);
+	if (before)
+		p_hindex_del_slot(hx, hv, i);
+	else
+		p_hindex_put_slot(hx, hv, i + hx->bias);
 }
 
-// inline implementation for all add(s):
-static inline zvect_retval p_vect_add_at(ivector v, const void *value,
-                                	 const zvect_index i) {
-	// Check if the item is NULL:
-	if (value == NULL)
-		return 0;
+static void p_hindex_clear(const_vector v) {
+	struct p_hindex *hx = v->hindex;
+	memset(hx->slots, 0, sizeof(struct p_hslot) * ((size_t)hx->mask + 1));
+	hx->count = 0;
+	hx->bias = 0;
+	hx->dirty = false;
+}
+#endif  // ZVECT_DMF_EXTENSIONS
 
-	zvect_index idx = i;
+/*---------------------------------------------------------------------------*/
 
-	// Get vector size:
-	zvect_index vsize = p_vect_size(v);
+/*---------------------------------------------------------------------------*/
+// Counted B+tree primitives:
 
-	// Allocate memory for the new item:
-	zvect_index base = v->begin;
+/*
+ * The items of a ZV_TREE vector can be stored in a counted B+tree:
+ * the item pointers are kept in leaves of P_TREE_LEAF_ITEMS pointers,
+ * linked in order, while every internal node stores, for each child,
+ * the number of items in its subtree. So an index is found in O(log n)
+ * and adding or deleting an item moves only the pointers of one leaf.
+ * Nodes that get too small are merged with a sibling (when they fit in
+ * one node), so nodes are at least about half full, except the ones
+ * filled by appending items at the end of the tree, which are kept
+ * full.
+ */
+#define P_TREE_LEAF_ITEMS 512
+#define P_TREE_FANOUT 64
 
-#if (ZVECT_FULL_REENTRANT == 1)
-	// If we are in FULL_REENTRANT MODE prepare for potential
-	// array copy:
-	void **new_data = NULL;
-	new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
-	if (new_data == NULL)
-		return ZVERR_OUTOFMEM;
-	// Algorithm to try to copy an array of pointers as fast as possible:
-	//if (idx > 0)
-	//	p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * idx);
-	//p_vect_memcpy(new_data + base + (idx + 1), v->data + base +  idx,
-	//	      sizeof(void *) * (vsize - idx));
-	if (vsize)
-		p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * vsize);
-#endif
+struct p_tree_leaf {
+	zvect_index count;		// - Number of items
+	struct p_tree_leaf *next;	// - Next leaf (in items order)
+	void *items[P_TREE_LEAF_ITEMS];	// - Item pointers
+};
 
-	// Allocate space at the beginning or end of the vector as required:
-	if (!idx) {
-		// Prepare left side of the vector:
-		if ( base )
-			base--;
-		if (!(v->flags & ZV_BYREF)) {
-#if (ZVECT_FULL_REENTRANT == 1)
-			new_data[base] = (void *)malloc(v->data_size);
-			if (new_data[base] == NULL) {
-				free(new_data);
-				new_data = NULL;
+struct p_tree_node {
+	uint32_t nchild;		// - Number of children
+	zvect_index counts[P_TREE_FANOUT];
+					// - Number of items of every child
+	void *child[P_TREE_FANOUT];	// - Children (nodes or leaves)
+};
+
+struct p_tree {
+	zvect_index size;		// - Number of items
+	uint32_t height;		// - Levels of nodes above the leaves
+	void *root;			// - Root node (or leaf if height is 0)
+};
+
+// New right sibling created by a split:
+struct p_tree_split {
+	void *node;			// - Sibling (or NULL if no split)
+	zvect_index count;		// - Number of items of the sibling
+};
+
+static inline struct p_tree_leaf *p_tree_leaf_new(void)
+{
+	struct p_tree_leaf *l = (struct p_tree_leaf *)malloc(sizeof(struct p_tree_leaf));
+	if (l != NULL) {
+		l->count = 0;
+		l->next = NULL;
+	}
+	return l;
+}
+
+static inline bool p_tree_full(void *n, uint32_t h)
+{
+	return h ? (((struct p_tree_node *)n)->nchild == P_TREE_FANOUT)
+		 : (((struct p_tree_leaf *)n)->count == P_TREE_LEAF_ITEMS);
+}
+
+// Frees the subtree n (of height h), but not the items:
+static void p_tree_free(void *n, uint32_t h)
+{
+	if (h) {
+		struct p_tree_node *nd = (struct p_tree_node *)n;
+		for (uint32_t k = 0; k < nd->nchild; k++)
+			p_tree_free(nd->child[k], h - 1);
+	}
+	free(n);
+}
+
+// Returns the leaf with item i and its index in the leaf:
+static struct p_tree_leaf *p_tree_locate(const struct p_tree *t, zvect_index i, zvect_index *pos)
+{
+	void *n = t->root;
+	for (uint32_t h = t->height; h; h--) {
+		struct p_tree_node *nd = (struct p_tree_node *)n;
+		uint32_t k = 0;
+		while ((k < nd->nchild - 1) && (i >= nd->counts[k]))
+			i -= nd->counts[k++];
+		n = nd->child[k];
+	}
+	*pos = i;
+	return (struct p_tree_leaf *)n;
+}
+
+// Inserts a child (and its count) at position k of a node:
+static inline void p_tree_node_insert(struct p_tree_node *nd, uint32_t k, void *child, zvect_index count)
+{
+	p_vect_memmove(&(nd->child[k + 1]), &(nd->child[k]), (nd->nchild - k) * sizeof(void *));
+	p_vect_memmove(&(nd->counts[k + 1]), &(nd->counts[k]), (nd->nchild - k) * sizeof(zvect_index));
+	nd->child[k] = child;
+	nd->counts[k] = count;
+	nd->nchild++;
+}
+
+// Adds an item at index i of the subtree n (of height h). If n has
+// to be split, the new right sibling is returned in split. A node on
+// the right edge of the tree (last) split by an item added at its end
+// moves only that item to its sibling, so appending keeps the nodes
+// full. Full nodes get their sibling allocated before going down the
+// tree, so a failed allocation never leaves the tree changed:
+static zvect_retval p_tree_insert(void *n, uint32_t h, bool last, zvect_index i, void *item,
+				  struct p_tree_split *split)
+{
+	split->node = NULL;
+
+	if (h == 0) {
+		struct p_tree_leaf *l = (struct p_tree_leaf *)n;
+		if (l->count == P_TREE_LEAF_ITEMS) {
+			struct p_tree_leaf *r = p_tree_leaf_new();
+			if (r == NULL)
 				return ZVERR_OUTOFMEM;
+			zvect_index half = (last && (i == l->count)) ? l->count : (l->count >> 1);
+			r->count = l->count - half;
+			p_vect_memcpy(r->items, &(l->items[half]), (size_t)r->count * sizeof(void *));
+			l->count = half;
+			r->next = l->next;
+			l->next = r;
+			split->node = r;
+			if (i >= half) {
+				l = r;
+				i -= half;
 			}
-#else
-			v->data[base] = malloc(v->data_size);
-			if (v->data[base] == NULL)
-				return ZVERR_OUTOFMEM;
-#endif
-		}
-	} else if (idx == vsize && !(v->flags & ZV_BYREF)) {
-		// Prepare right side of the vector:
-#if (ZVECT_FULL_REENTRANT == 1)
-		new_data[base + vsize] = (void *)malloc(v->data_size);
-		if (new_data[base + vsize] == NULL) {
-			free(new_data);
-			new_data = NULL;
-			return ZVERR_OUTOFMEM;
 		}
-#else
-		v->data[base + vsize] = malloc(v->data_size);
-		if (v->data[base + vsize] == NULL)
-			return ZVERR_OUTOFMEM;
-#endif
+		p_vect_memmove(&(l->items[i + 1]), &(l->items[i]), (size_t)(l->count - i) * sizeof(void *));
+		l->items[i] = item;
+		l->count++;
+		if (split->node != NULL)
+			split->count = ((struct p_tree_leaf *)split->node)->count;
+		return 0;
 	}
 
-	// "Shift" right the array of one position to make space for the new item:
-	int16_t array_changed = 0;
+	struct p_tree_node *nd = (struct p_tree_node *)n;
+	struct p_tree_node *r = NULL;
+	if (nd->nchild == P_TREE_FANOUT) {
+		r = (struct p_tree_node *)malloc(sizeof(struct p_tree_node));
+		if (r == NULL)
+			return ZVERR_OUTOFMEM;
+	}
 
-	if ((idx < vsize) && (idx != 0)) {
-		array_changed = 1;
-#if (ZVECT_FULL_REENTRANT == 1)
-		p_vect_memmove(new_data + base + (idx + 1), new_data + base + idx,
-			       sizeof(void *) * (vsize - idx));
-#else
-		p_vect_memmove(v->data + base + (idx + 1), v->data + base + idx,
-			       sizeof(void *) * (vsize - idx));
-#endif  // (ZVECT_FULL_REENTRANT == 1)
+	// Adding at the end of a child is preferred to adding at the
+	// beginning of the next one:
+	uint32_t k = 0;
+	while ((k < nd->nchild - 1) && (i > nd->counts[k]))
+		i -= nd->counts[k++];
+
+	struct p_tree_split cs;
+	zvect_retval rval = p_tree_insert(nd->child[k], h - 1, last && (k == nd->nchild - 1), i, item, &cs);
+	if (rval || (cs.node == NULL)) {
+		free(r);
+		if (!rval)
+			nd->counts[k]++;
+		return rval;
 	}
+	nd->counts[k] = nd->counts[k] + 1 - cs.count;
 
-	// Add new value in (at the index idx):
-#if (ZVECT_FULL_REENTRANT == 1)
-	if (array_changed && !(v->flags & ZV_BYREF)) {
-		new_data[base + idx] = (void *)malloc(v->data_size);
-		if (new_data[base + idx] == NULL) {
-			free(new_data);
-			new_data = NULL;
-			return ZVERR_OUTOFMEM;
-		}
+	if (r == NULL) {
+		p_tree_node_insert(nd, k + 1, cs.node, cs.count);
+		return 0;
 	}
-	if (v->flags & ZV_BYREF)
-		new_data[base + idx] = (void *)value;
+
+	// Split the node (and add the new child to the right half):
+	uint32_t half = (last && (k + 1 == nd->nchild)) ? nd->nchild : (P_TREE_FANOUT >> 1);
+	r->nchild = nd->nchild - half;
+	p_vect_memcpy(r->child, &(nd->child[half]), r->nchild * sizeof(void *));
+	p_vect_memcpy(r->counts, &(nd->counts[half]), r->nchild * sizeof(zvect_index));
+	nd->nchild = half;
+	if ((k + 1 <= half) && (half < P_TREE_FANOUT))
+		p_tree_node_insert(nd, k + 1, cs.node, cs.count);
 	else
-		p_vect_memcpy(new_data[base + idx], value, v->data_size);
-#else
-	if (array_changed && !(v->flags & ZV_BYREF)) {
-		// We moved chunks of memory, so we need to
-		// allocate new memory for the item at position i:
-		v->data[base + idx] = malloc(v->data_size);
-		if (v->data[base + idx] == NULL)
+		p_tree_node_insert(r, k + 1 - half, cs.node, cs.count);
+
+	split->node = r;
+	split->count = 0;
+	for (uint32_t c = 0; c < r->nchild; c++)
+		split->count += r->counts[c];
+	return 0;
+}
+
+// Adds an item at index i of the tree:
+static zvect_retval p_tree_add_at(struct p_tree *t, zvect_index i, void *item)
+{
+	// If the root is full it may be split, so its new parent is
+	// allocated first:
+	struct p_tree_node *root = NULL;
+	if (p_tree_full(t->root, t->height)) {
+		root = (struct p_tree_node *)malloc(sizeof(struct p_tree_node));
+		if (root == NULL)
 			return ZVERR_OUTOFMEM;
 	}
-	if (v->flags & ZV_BYREF)
-		v->data[base + idx] = (void *)value;
-	else
-		p_vect_memcpy(v->data[base + idx], value, v->data_size);
-#endif  // (ZVECT_FULL_REENTRANT == 1)
 
-	// Apply changes:
-#if (ZVECT_FULL_REENTRANT == 1)
-	//if (array_changed) {
-		free(v->data);
-		v->data = new_data;
-	//}
-#endif
-	// Increment vector size
-	if (!idx) {
-		if (v->begin == base)
-			v->end++;
-		else
-			v->begin = base;
-	} else {
-		v->end++;
+	struct p_tree_split split;
+	zvect_retval rval = p_tree_insert(t->root, t->height, true, i, item, &split);
+	if (rval || (split.node == NULL)) {
+		free(root);
+		if (!rval)
+			t->size++;
+		return rval;
 	}
 
-	// done
+	// The root has been split, so the tree grows by one level:
+	root->nchild = 2;
+	root->child[0] = t->root;
+	root->counts[0] = t->size + 1 - split.count;
+	root->child[1] = split.node;
+	root->counts[1] = split.count;
+	t->root = root;
+	t->height++;
+	t->size++;
+
 	return 0;
 }
 
-// This is the inline implementation for all the remove and pop
-static inline zvect_retval p_vect_remove_at(ivector v, const zvect_index i, void **item) {
-	zvect_index idx = i;
+// Merges child k + 1 of a node into child k (if they fit in one
+// node):
+static void p_tree_merge(struct p_tree_node *nd, uint32_t h, uint32_t k)
+{
+	if (h == 1) {
+		struct p_tree_leaf *l = (struct p_tree_leaf *)nd->child[k];
+		struct p_tree_leaf *r = (struct p_tree_leaf *)nd->child[k + 1];
+		if (l->count + r->count > P_TREE_LEAF_ITEMS)
+			return;
+		p_vect_memcpy(&(l->items[l->count]), r->items, (size_t)r->count * sizeof(void *));
+		l->count += r->count;
+		l->next = r->next;
+		free(r);
+	} else {
+		struct p_tree_node *l = (struct p_tree_node *)nd->child[k];
+		struct p_tree_node *r = (struct p_tree_node *)nd->child[k + 1];
+		if (l->nchild + r->nchild > P_TREE_FANOUT)
+			return;
+		p_vect_memcpy(&(l->child[l->nchild]), r->child, r->nchild * sizeof(void *));
+		p_vect_memcpy(&(l->counts[l->nchild]), r->counts, r->nchild * sizeof(zvect_index));
+		l->nchild += r->nchild;
+		free(r);
+	}
 
-	// Get the vector size:
-	zvect_index vsize = p_vect_size(v);
+	nd->counts[k] += nd->counts[k + 1];
+	p_vect_memmove(&(nd->child[k + 1]), &(nd->child[k + 2]), (nd->nchild - k - 2) * sizeof(void *));
+	p_vect_memmove(&(nd->counts[k + 1]), &(nd->counts[k + 2]), (nd->nchild - k - 2) * sizeof(zvect_index));
+	nd->nchild--;
+}
 
-	// Check if the index is out of bounds:
-	if (idx >= vsize) {
-		if (!(v->flags & ZV_CIRCULAR)) {
-			return ZVERR_IDXOUTOFBOUND;
-		} else {
-			idx = idx % vsize;
-		}
+// Deletes up to count items from index i of the subtree n (of height
+// h), all in the same leaf, and returns the number of items deleted
+// (the items themselves are not freed):
+static zvect_index p_tree_delete(void *n, uint32_t h, zvect_index i, zvect_index count)
+{
+	if (h == 0) {
+		struct p_tree_leaf *l = (struct p_tree_leaf *)n;
+		zvect_index d = ((l->count - i) < count) ? (l->count - i) : count;
+		p_vect_memmove(&(l->items[i]), &(l->items[i + d]), (size_t)(l->count - i - d) * sizeof(void *));
+		l->count -= d;
+		return d;
 	}
 
-	// Check if the vector got corrupted
-	if ((v->end != 0) && (v->begin > v->end))
-		return ZVERR_VECTCORRUPTED;
+	struct p_tree_node *nd = (struct p_tree_node *)n;
+	uint32_t k = 0;
+	while ((k < nd->nchild - 1) && (i >= nd->counts[k]))
+		i -= nd->counts[k++];
+
+	zvect_index d = p_tree_delete(nd->child[k], h - 1, i, count);
+	nd->counts[k] -= d;
+
+	// Merge the child with a sibling if it's less than a quarter
+	// full:
+	bool small = (h == 1) ? (((struct p_tree_leaf *)nd->child[k])->count < (P_TREE_LEAF_ITEMS >> 2))
+			      : (((struct p_tree_node *)nd->child[k])->nchild < (P_TREE_FANOUT >> 2));
+	if (small && (nd->nchild > 1)) {
+		if (k + 1 < nd->nchild)
+			p_tree_merge(nd, h, k);
+		else
+			p_tree_merge(nd, h, k - 1);
+	}
+	return d;
+}
 
-	zvect_index base = v->begin;
-	zvect_index top = v->end;
+// Deletes count items from index i of the tree (one leaf at a time):
+static void p_tree_delete_range(struct p_tree *t, zvect_index i, zvect_index count)
+{
+	while (count) {
+		zvect_index d = p_tree_delete(t->root, t->height, i, count);
+		count -= d;
+		t->size -= d;
+
+		// Drop the root while it has only one child:
+		while (t->height && (((struct p_tree_node *)t->root)->nchild == 1)) {
+			void *child = ((struct p_tree_node *)t->root)->child[0];
+			free(t->root);
+			t->root = child;
+			t->height--;
+		}
+	}
+}
 
-	// Start processing the vector:
-#if (ZVECT_FULL_REENTRANT == 1)
-	// Allocate memory for support Data Structure:
-	void **new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
-	if (new_data == NULL)
-		return ZVERR_OUTOFMEM;
-	if (vsize)
-		p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * vsize);
-#endif
+// Builds a tree with the n item pointers in items, filling its leaves
+// and nodes completely (or returns NULL if it can't be allocated):
+static struct p_tree *p_tree_build(void * const *items, zvect_index n)
+{
+	size_t nleaves = n ? (((size_t)n + P_TREE_LEAF_ITEMS - 1) / P_TREE_LEAF_ITEMS) : 1;
+	struct p_tree *t = (struct p_tree *)malloc(sizeof(struct p_tree));
+	void **level = (void **)malloc(nleaves * sizeof(void *));
+	zvect_index *counts = (zvect_index *)malloc(nleaves * sizeof(zvect_index));
+	if ((t == NULL) || (level == NULL) || (counts == NULL))
+		goto P_TREE_BUILD_FAILED;
+
+	// Leaves:
+	size_t len = 0;
+	struct p_tree_leaf *prev = NULL;
+	for (; len < nleaves; len++) {
+		struct p_tree_leaf *l = p_tree_leaf_new();
+		if (l == NULL)
+			goto P_TREE_BUILD_FREE_LEVEL;
+		zvect_index first = (zvect_index)(len * P_TREE_LEAF_ITEMS);
+		l->count = ((n - first) < P_TREE_LEAF_ITEMS) ? (n - first) : P_TREE_LEAF_ITEMS;
+		if (l->count)
+			p_vect_memcpy(l->items, items + first, (size_t)l->count * sizeof(void *));
+		if (prev != NULL)
+			prev->next = l;
+		prev = l;
+		level[len] = l;
+		counts[len] = l->count;
+	}
 
-	// Get the value we are about to remove:
-	// If the vector is set as ZV_BYREF, then just copy the pointer to the item
-	// If the vector is set as regular, then copy the item
-	if (v->flags & ZV_BYREF) {
-#if (ZVECT_FULL_REENTRANT == 1)
-		*item = new_data[base + idx];
-#else
-		*item = v->data[base + idx];
-#endif
-	} else {
-		*item = (void **)malloc(v->data_size);
-#if (ZVECT_FULL_REENTRANT == 1)
-		if ( new_data[base + idx] != NULL )
-#else
-		if ( v->data[base + idx] != NULL )
-#endif
-		{
-#if (ZVECT_FULL_REENTRANT == 1)
-			p_vect_memcpy(*item, new_data[base + idx], v->data_size);
-#else
-			p_vect_memcpy(*item, v->data[base + idx], v->data_size);
-#endif
-			// If the vector is set for secure wipe, and we copied the item
-			// then we need to wipe the old copy:
-			if (v->flags & ZV_SEC_WIPE)
-#if (ZVECT_FULL_REENTRANT == 1)
-				p_item_safewipe(v, new_data[base + idx]);
-#else
-				p_item_safewipe(v, v->data[base + idx]);
-#endif
+	// Nodes, one level at a time (every new node only reads
+	// children after its own slot, so the level is built in place):
+	uint32_t h = 0;
+	while (len > 1) {
+		size_t k = 0;
+		for (size_t c = 0; c < len; k++) {
+			struct p_tree_node *nd = (struct p_tree_node *)malloc(sizeof(struct p_tree_node));
+			if (nd == NULL) {
+				// Free the new nodes and the children left:
+				for (size_t j = 0; j < k; j++)
+					p_tree_free(level[j], h + 1);
+				for (; c < len; c++)
+					p_tree_free(level[c], h);
+				goto P_TREE_BUILD_FAILED;
+			}
+			zvect_index total = 0;
+			for (nd->nchild = 0; (nd->nchild < P_TREE_FANOUT) && (c < len); nd->nchild++, c++) {
+				nd->child[nd->nchild] = level[c];
+				nd->counts[nd->nchild] = counts[c];
+				total += counts[c];
+			}
+			level[k] = nd;
+			counts[k] = total;
 		}
+		len = k;
+		h++;
 	}
 
-	// "shift" left the array of one position:
-	uint16_t array_changed;
-	array_changed = 0;
-	if ( idx != 0 ) {
-		if ((idx < (vsize - 1)) && (vsize > 0)) {
-			array_changed = 1;
-#if (ZVECT_FULL_REENTRANT == 1)
+	t->size = n;
+	t->height = h;
+	t->root = level[0];
+	free(level);
+	free(counts);
+	return t;
+
+P_TREE_BUILD_FREE_LEVEL:
+	for (size_t j = 0; j < len; j++)
+		free(level[j]);
+P_TREE_BUILD_FAILED:
+	free(t);
+	free(level);
+	free(counts);
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Lazy deletes (tombstones) primitives:
+
+/*
+ * On a ZV_LAZY_DELETE vector vect_delete_at and vect_remove_at don't
+ * shift the items after the one removed, they just mark it as dead.
+ * Dead items are tracked with a bitmap (one bit per item, relative to
+ * v->begin) and a Fenwick tree of the live items in each bitmap word,
+ * so the getters can map a logical index to its physical position in
+ * O(log n). The vector is compacted, in a single pass, when the dead
+ * items reach ZVECT_LAZY_DELETE_RATIO percent of the vector, on
+ * vect_compact and by every function that is not tombstones aware
+ * (they call p_vect_settle_locked right after taking the vector lock),
+ * so these always see a contiguous vector.
+ */
+struct p_tombs {
+	uint64_t *bits;		// - Dead items bitmap.
+	uint32_t *tree;		// - Fenwick tree (1-based) of the
+				//   live items per bitmap word.
+	size_t nwords;		// - Number of bitmap words.
+	size_t top;		// - Highest power of 2 <= nwords.
+	zvect_index dead;	// - Number of dead items.
+};
+
+// Vectors smaller than this are cheaper to shift than to track:
+#define P_TOMBS_MIN_ITEMS 64
+
+static void p_tombs_free(ivector v) {
+	if (v->tombs == NULL)
+		return;
+	free(v->tombs->bits);
+	free(v->tombs->tree);
+	free(v->tombs);
+	v->tombs = NULL;
+}
+
+static zvect_retval p_tombs_create(ivector v) {
+	zvect_index vsize = p_vect_size(v);
+	struct p_tombs *t = (struct p_tombs *)malloc(sizeof(struct p_tombs));
+	if (t == NULL)
+		return ZVERR_OUTOFMEM;
+
+	t->nwords = ((size_t)vsize + 63) >> 6;
+	t->bits = (uint64_t *)calloc(t->nwords, sizeof(uint64_t));
+	t->tree = (uint32_t *)malloc(sizeof(uint32_t) * (t->nwords + 1));
+	if ((t->bits == NULL) || (t->tree == NULL)) {
+		free(t->bits);
+		free(t->tree);
+		free(t);
+		return ZVERR_OUTOFMEM;
+	}
+	t->dead = 0;
+
+	// The bits after the last item are marked dead, so every word
+	// counts only the items it really has:
+	if (vsize & 63)
+		t->bits[t->nwords - 1] = ~(uint64_t)0 << (vsize & 63);
+
+	// Build the Fenwick tree in O(nwords):
+	t->tree[0] = 0;
+	for (size_t k = 1; k <= t->nwords; k++)
+		t->tree[k] = 64 - p_popcount64(t->bits[k - 1]);
+	for (size_t k = 1; k <= t->nwords; k++) {
+		size_t parent = k + (k & (~k + 1));
+		if (parent <= t->nwords)
+			t->tree[parent] += t->tree[k];
+	}
+	for (t->top = 1; (t->top << 1) <= t->nwords; t->top <<= 1)
+		;
+
+	v->tombs = t;
+	return 0;
+}
+
+// Returns the physical index (relative to v->begin) of the live item
+// at logical index i (i must be lower than the live items count):
+static inline zvect_index p_tombs_select(const struct p_tombs *t, zvect_index i) {
+	size_t pos = 0;
+	for (size_t step = t->top; step != 0; step >>= 1) {
+		if (((pos + step) <= t->nwords) && (t->tree[pos + step] <= i)) {
+			pos += step;
+			i -= t->tree[pos];
+		}
+	}
+
+	// pos is now the word with the item, find its i-th live bit:
+	uint64_t live = ~t->bits[pos];
+	for (; i != 0; i--)
+		live &= live - 1;
+	return (zvect_index)((pos << 6) + p_ctz64(live));
+}
+
+static inline void p_tombs_mark(struct p_tombs *t, zvect_index p) {
+	t->bits[p >> 6] |= (uint64_t)1 << (p & 63);
+	t->dead++;
+	for (size_t k = ((size_t)p >> 6) + 1; k <= t->nwords; k += (k & (~k + 1)))
+		t->tree[k]--;
+}
+
+ZVECT_ALWAYSINLINE
+static inline zvect_index p_vect_live_size(const_vector const v) {
+	if (v->tree != NULL)
+		return v->tree->size;
+	return p_vect_size(v) - v->gap_len - ((v->tombs != NULL) ? v->tombs->dead : 0);
+}
+
+// Lazy deletes are used only once the vector is large enough:
+static inline bool p_vect_use_tombs(const_vector const v) {
+	return (v->flags & ZV_LAZY_DELETE) &&
+	       ((v->tombs != NULL) || (p_vect_size(v) >= P_TOMBS_MIN_ITEMS));
+}
+
+// Wipes (if required) and frees an item dropped by the bulk
+// removal functions:
+static inline void p_drop_item(ivector v, void *item) {
+	if (item == NULL)
+		return;
+	if (v->flags & ZV_SEC_WIPE)
+		p_item_safewipe(v, item);
+	if (!(v->flags & ZV_BYREF))
+		free(item);
+}
+
+// Completes a bulk removal that left "w" of the "vsize" items
+// at the beginning of the vector, adjusting its capacity (if
+// needed) only once:
+static void p_vect_compact_done(ivector v, zvect_index w, zvect_index vsize) {
+	// Clear leftover item pointers:
+	(*(p_kern.fill_ptrs))(v->data + v->begin + w, NULL, vsize - w);
+	v->end = v->begin + w;
+	if (v->begin == v->end) {
+		v->begin = 0;
+		v->end = 0;
+	}
+
+	// Check if we need to shrink the vector:
+	if ((4 * w) < p_vect_capacity(v))
+		p_vect_shrink(v);
+}
+
+// Moves all the live items to the beginning of the vector (in a single
+// pass) and drops the tombstones:
+static void p_tombs_compact(ivector v) {
+	struct p_tombs *t = v->tombs;
+	zvect_index vsize = p_vect_size(v);
+	void **a = v->data + v->begin;
+	zvect_index w = 0;
+
+	for (size_t k = 0; k < t->nwords; k++) {
+		uint64_t live = ~t->bits[k];
+		zvect_index base = (zvect_index)(k << 6);
+		// Leading runs of live items are already in place:
+		if ((w == base) && (live == ~(uint64_t)0)) {
+			w += 64;
+			continue;
+		}
+		for (; live != 0; live &= live - 1)
+			a[w++] = a[base + p_ctz64(live)];
+	}
+	p_tombs_free(v);
+	v->generation++;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	// Items moved in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	p_vect_compact_done(v, w, vsize);
+}
+
+// Marks the item at (logical) index i as dead. If item is not NULL the
+// item is returned in it (and the caller owns it), otherwise it's freed
+// according to the vector properties:
+static zvect_retval p_vect_lazy_remove_at(ivector v, const zvect_index i, void **item) {
+	zvect_retval rval = 0;
+
+	if ((v->tombs == NULL) && ((rval = p_tombs_create(v)) != 0))
+		return rval;
+
+	struct p_tombs *t = v->tombs;
+	zvect_index vsize = p_vect_size(v);
+	if (i >= (vsize - t->dead))
+		return (vsize == t->dead) ? ZVERR_VECTEMPTY : ZVERR_IDXOUTOFBOUND;
+
+	zvect_index p = p_tombs_select(t, i);
+	if (item != NULL)
+		*item = v->data[v->begin + p];
+	else
+		p_drop_item(v, v->data[v->begin + p]);
+	v->data[v->begin + p] = NULL;
+	p_tombs_mark(t, p);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// Compact the vector once it has too many dead items:
+	if (((uint64_t)t->dead * 100) >= ((uint64_t)ZVECT_LAZY_DELETE_RATIO * vsize))
+		p_tombs_compact(v);
+
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Gap buffer primitives:
+
+/*
+ * On a ZV_GAP_BUFFER vector the free slots on the right of the items
+ * are used as a gap, which is kept (inside [v->begin, v->end)) where
+ * the last item was added or deleted. Adding or deleting an item moves
+ * the gap there first, which moves only the items between the old and
+ * the new gap position, so edits close to each other cost O(1)
+ * amortised. The gap starts before the item at (logical) index
+ * v->gap_at and is v->gap_len slots long, its slots hold stale
+ * pointers. Like tombstones, the gap is closed (moving it at the end
+ * of the vector) by vect_compact and by every function that is not
+ * gap aware, so these always see a contiguous vector.
+ */
+
+// A gap smaller than this grows the vector capacity before opening:
+#define P_GAP_MIN_ITEMS 64
+
+// Returns a new item for value (a copy of it, unless the vector stores
+// items by reference), or NULL if it can't be allocated:
+static inline void *p_item_new(const_vector const v, const void *value) {
+	void *item = NULL;
+	if (v->flags & ZV_BYREF) {
+		item = (void *)value;
+	} else {
+		item = malloc(v->data_size);
+		if (item != NULL)
+			memcpy(item, value, v->data_size);
+	}
+	return item;
+}
+
+// Moves the gap before the item at (logical) index i (an empty gap
+// has no slots to move, so it's just placed there):
+static void p_gap_move(ivector v, const zvect_index i) {
+	void **a = v->data + v->begin;
+	if (v->gap_len != 0) {
+		if (i < v->gap_at)
+			p_vect_memmove(a + i + v->gap_len, a + i, sizeof(void *) * (v->gap_at - i));
+		else if (i > v->gap_at)
+			p_vect_memmove(a + v->gap_at, a + v->gap_at + v->gap_len, sizeof(void *) * (i - v->gap_at));
+	}
+	v->gap_at = i;
+}
+
+// Opens a gap at the end of the vector with all the free slots on its
+// right (doubling the right capacity first if they are too few):
+static zvect_retval p_gap_open(ivector v) {
+	zvect_retval rval = 0;
+	while ((p_vect_capacity(v) - v->end) < P_GAP_MIN_ITEMS)
+		if ((rval = p_vect_increase_capacity(v, 1)) != 0)
+			return rval;
+
+	v->gap_at = p_vect_size(v);
+	v->gap_len = p_vect_capacity(v) - v->end;
+	v->end = p_vect_capacity(v);
+	return 0;
+}
+
+// Closes the gap, so the vector items are contiguous again:
+static void p_gap_close(ivector v) {
+	zvect_index vsize = p_vect_size(v);
+	zvect_index w = vsize - v->gap_len;
+
+	p_gap_move(v, w);
+	v->gap_at = 0;
+	v->gap_len = 0;
+	v->generation++;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	p_vect_compact_done(v, w, vsize);
+}
+
+// Adds an item at (logical) index i, at the beginning of the gap:
+static zvect_retval p_gap_add_at(ivector v, const void *value, const zvect_index i) {
+	zvect_retval rval = 0;
+
+	if (value == NULL)
+		return 0;
+	if (i > (p_vect_size(v) - v->gap_len))
+		return ZVERR_IDXOUTOFBOUND;
+	if ((v->gap_len == 0) && ((rval = p_gap_open(v)) != 0))
+		return rval;
+
+	void *item = p_item_new(v, value);
+	if (item == NULL)
+		return ZVERR_OUTOFMEM;
+
+	p_gap_move(v, i);
+	v->data[v->begin + i] = item;
+	v->gap_at++;
+	v->gap_len--;
+
+	// A full gap is closed (there is nothing left to settle):
+	if (v->gap_len == 0)
+		v->gap_at = 0;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	return 0;
+}
+
+// Removes the item at (logical) index i, at the end of the gap. If item
+// is not NULL the item is returned in it (and the caller owns it),
+// otherwise it's freed according to the vector properties:
+static zvect_retval p_gap_remove_at(ivector v, const zvect_index i, void **item) {
+	zvect_index vsize = p_vect_size(v) - v->gap_len;
+	if (i >= vsize)
+		return (vsize == 0) ? ZVERR_VECTEMPTY : ZVERR_IDXOUTOFBOUND;
+
+	p_gap_move(v, i);
+	void **slot = v->data + v->begin + i + v->gap_len;
+	if (item != NULL)
+		*item = *slot;
+	else
+		p_drop_item(v, *slot);
+	*slot = NULL;
+	v->gap_len++;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// Close the gap (which shrinks the vector) once it's mostly
+	// empty:
+	if (((4 * (vsize - 1)) < p_vect_capacity(v)) && (p_vect_capacity(v) > v->init_capacity))
+		p_gap_close(v);
+
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Tree storage primitives:
+
+/*
+ * A ZV_TREE vector moves its items to a counted B+tree (see above) the
+ * first time a tree aware function adds or deletes an item once the
+ * vector has P_TREE_MIN_ITEMS items, and from then on its storage
+ * (v->data) stays empty. Like the gap, the tree is flattened back into
+ * the vector storage by vect_compact and by every function that is
+ * not tree aware, so these always see a contiguous vector.
+ */
+
+// Smaller vectors are cheaper to shift than to keep in a tree:
+#define P_TREE_MIN_ITEMS 8192
+
+// The tree aware functions use the tree once it's built, or when the
+// vector is large enough to build it:
+static inline bool p_vect_use_tree(const_vector const v) {
+	return (v->tree != NULL) ||
+	       ((v->flags & ZV_TREE) && (p_vect_size(v) >= P_TREE_MIN_ITEMS));
+}
+
+// Frees the tree of v (but not its items):
+static void p_vect_tree_free(ivector v) {
+	if (v->tree == NULL)
+		return;
+	p_tree_free(v->tree->root, v->tree->height);
+	free(v->tree);
+	v->tree = NULL;
+}
+
+// Moves the items of v to a new tree:
+static zvect_retval p_vect_tree_build(ivector v) {
+	zvect_index vsize = p_vect_size(v);
+	struct p_tree *t = p_tree_build(v->data + v->begin, vsize);
+	if (t == NULL)
+		return ZVERR_OUTOFMEM;
+	v->tree = t;
+	v->generation++;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// The vector storage is not used while the tree is:
+	p_vect_compact_done(v, 0, vsize);
+	return 0;
+}
+
+// Moves the items of the tree back to the (empty) vector storage and
+// drops the tree:
+static void p_vect_tree_flatten(ivector v) {
+	struct p_tree *t = v->tree;
+	if ((p_vect_capacity(v) < t->size) && (p_vect_set_capacity(v, 1, t->size) != 0))
+		p_throw_error(ZVERR_OUTOFMEM, NULL);
+
+	zvect_index pos;
+	void **a = v->data;
+	for (struct p_tree_leaf *l = p_tree_locate(t, 0, &pos); l != NULL; l = l->next) {
+		p_vect_memcpy(a, l->items, (size_t)l->count * sizeof(void *));
+		a += l->count;
+	}
+	v->begin = 0;
+	v->end = t->size;
+	p_vect_tree_free(v);
+	v->generation++;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+}
+
+// Drops all the items of the tree and the tree:
+static void p_vect_tree_clear(ivector v) {
+	zvect_index pos;
+	for (struct p_tree_leaf *l = p_tree_locate(v->tree, 0, &pos); l != NULL; l = l->next)
+		for (zvect_index j = 0; j < l->count; j++)
+			p_drop_item(v, l->items[j]);
+	p_vect_tree_free(v);
+}
+
+// Adds an item at (logical) index i, building the tree first if needed:
+static zvect_retval p_vect_tree_add_at(ivector v, const void *value, const zvect_index i) {
+	zvect_retval rval = 0;
+
+	if (value == NULL)
+		return 0;
+	if (i > p_vect_live_size(v))
+		return ZVERR_IDXOUTOFBOUND;
+	if ((v->tree == NULL) && ((rval = p_vect_tree_build(v)) != 0))
+		return rval;
+	if (v->tree->size == zvect_index_max)
+		return ZVERR_OUTOFMEM;
+
+	void *item = p_item_new(v, value);
+	if (item == NULL)
+		return ZVERR_OUTOFMEM;
+	if ((rval = p_tree_add_at(v->tree, i, item)) != 0) {
+		if (!(v->flags & ZV_BYREF))
+			free(item);
+		return rval;
+	}
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	return 0;
+}
+
+// Deletes the items from first to last (included), building the tree
+// first if needed. If item is not NULL (and first is last) the item is
+// returned in it (and the caller owns it), otherwise the items are
+// freed according to the vector properties:
+static zvect_retval p_vect_tree_remove_range(ivector v, const zvect_index first, const zvect_index last,
+					     void **item) {
+	zvect_retval rval = 0;
+	zvect_index vsize = p_vect_live_size(v);
+
+	if (vsize == 0)
+		return ZVERR_VECTEMPTY;
+	if ((first > last) || (last >= vsize))
+		return ZVERR_IDXOUTOFBOUND;
+	if ((v->tree == NULL) && ((rval = p_vect_tree_build(v)) != 0))
+		return rval;
+
+	// Take the items out of the leaves first:
+	zvect_index pos;
+	zvect_index left = last - first + 1;
+	for (struct p_tree_leaf *l = p_tree_locate(v->tree, first, &pos); left; l = l->next, pos = 0) {
+		zvect_index n = ((l->count - pos) < left) ? (l->count - pos) : left;
+		if (item != NULL)
+			*item = l->items[pos];
+		else
+			for (zvect_index j = 0; j < n; j++)
+				p_drop_item(v, l->items[pos + j]);
+		left -= n;
+	}
+	p_tree_delete_range(v->tree, first, last - first + 1);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	return 0;
+}
+
+// Replaces the item at (logical) index i of the tree:
+static zvect_retval p_vect_tree_put_at(ivector v, const void *value, const zvect_index i) {
+	if (i >= v->tree->size)
+		return ZVERR_IDXOUTOFBOUND;
+
+	zvect_index pos;
+	struct p_tree_leaf *l = p_tree_locate(v->tree, i, &pos);
+	if (v->flags & ZV_BYREF) {
+		void *temp = l->items[pos];
+		l->items[pos] = (void *)value;
+		if (v->flags & ZV_SEC_WIPE)
+			memset(temp, 0, v->data_size);
+	} else {
+		p_vect_memcpy(l->items[pos], value, v->data_size);
+	}
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	return 0;
+}
+
+// Searches key in the tree of v (if it has one) without flattening it,
+// with a binary search if sorted is true (the probes find their items
+// in O(log n), so it's O(log^2 n)) or walking the leaves in order
+// otherwise. Returns false if v has no tree (so the caller searches
+// the vector storage), or true with the result in *found:
+static bool p_vect_tree_search(ivector v, const void *key, int (*f1)(const void *, const void *),
+			       bool sorted, zvect_index *item_index, bool *found) {
+	bool has_tree = false;
+	zvect_index pos;
+	*found = false;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (v->tree == NULL)
+		goto TREE_SEARCH_DONE_PROCESSING;
+	has_tree = true;
+
+	if (sorted) {
+		// First item not smaller than key:
+		zvect_index lo = 0;
+		zvect_index hi = v->tree->size;
+		while (lo < hi) {
+			zvect_index mid = lo + ((hi - lo) >> 1);
+			if ((*f1)(key, p_tree_locate(v->tree, mid, &pos)->items[pos]) > 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if ((lo < v->tree->size) && ((*f1)(key, p_tree_locate(v->tree, lo, &pos)->items[pos]) == 0)) {
+			*item_index = lo;
+			*found = true;
+		}
+	} else {
+		zvect_index base = 0;
+		for (struct p_tree_leaf *l = p_tree_locate(v->tree, 0, &pos); (l != NULL) && !*found; l = l->next) {
+			for (zvect_index j = 0; j < l->count; j++) {
+				if ((*f1)(key, l->items[j]) != 0) {
+					*item_index = base + j;
+					*found = true;
+					break;
+				}
+			}
+			base += l->count;
+		}
+	}
+
+TREE_SEARCH_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+	return has_tree;
+}
+
+// Calls f for the items of the tree from x to y (included), walking
+// the leaves in order:
+static void p_vect_tree_apply(ivector v, void (*f)(void *), const zvect_index x, const zvect_index y) {
+	zvect_index pos;
+	zvect_index left = y - x + 1;
+	for (struct p_tree_leaf *l = p_tree_locate(v->tree, x, &pos); left; l = l->next, pos = 0) {
+		zvect_index n = ((l->count - pos) < left) ? (l->count - pos) : left;
+		for (zvect_index j = 0; j < n; j++)
+			(*f)(l->items[pos + j]);
+		left -= n;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Storage settling primitives:
+
+// Settles the lazy deletes, the gap or the tree of v (if any). The
+// functions that are not aware of them call it right after taking the
+// vector lock, so no other thread can change them while they work on
+// the vector:
+static inline void p_vect_settle_locked(ivector v) {
+	if (v->tombs != NULL)
+		p_tombs_compact(v);
+	else if (v->gap_len != 0)
+		p_gap_close(v);
+	else if (v->tree != NULL)
+		p_vect_tree_flatten(v);
+}
+
+// Settles a vector that the caller reads without holding its lock (so
+// it takes the lock just to settle it). Settling doesn't change the
+// items seen by the caller, so it takes const vectors too:
+static void p_vect_settle(const_vector const x) {
+	if (!(x->flags & (ZV_LAZY_DELETE | ZV_GAP_BUFFER | ZV_TREE)))
+		return;
+
+	ivector v = (vector)x;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	p_vect_settle_locked(v);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Creation and destruction primitives:
+
+zvect_retval p_vect_clear(ivector v)
+{
+	// The gap slots hold stale pointers, so close it first:
+	if (v->gap_len != 0)
+		p_gap_close(v);
+
+	// The items of a tree are dropped from its leaves:
+	if (v->tree != NULL)
+		p_vect_tree_clear(v);
+
+	// Clear the vector:
+	if (!vect_is_empty(v))
+		p_free_items(v, 0, (p_vect_size(v) - 1));
+
+	// Reset interested descriptors:
+	v->begin = v->end = 0;
+	p_tombs_free(v);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_clear(v);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// Shrink Vector's capacity:
+	// p_vect_shrink(v); // commented this out to make vect_clear behave more like the clear method in C++
+
+	return 0;
+}
+
+static zvect_retval p_vect_destroy(vector v, uint32_t flags)
+{
+	// p_destroy is an exception to the rule of handling
+	// locking from the public methods. This because
+	// p_destroy has to destroy the vector mutex too and
+	// so it needs to control the lock as well!
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	if (!lock_owner && (!locking_disabled) && !(v->flags & ZV_NOLOCKING))
+		return ZVERR_RACECOND;
+#endif
+
+	// Clear the vector (if LSB of flags is set to 1):
+	if (((p_vect_size(v) > 0) || (v->tree != NULL)) && (flags & 1)) {
+		// Clean the vector:
+		p_vect_clear(v);
+
+		// Reset interested descriptors:
+		v->end = 0;
+	}
+
+	// Destroy the vector:
+	v->init_capacity = v->cap_left = v->cap_right = 0;
+
+	// Destroy it:
+	if (v->status & ZVS_CUST_WIPE_ON)
+		v->SfWpFunc = NULL;
+
+	if (v->data != NULL) {
+		free(v->data);
+		v->data = NULL;
+	}
+
+	// Clear vector status flags:
+	v->status = v->flags = v->begin = v->end = v->data_size = 0;
+	p_tombs_free(v);
+	p_vect_tree_free(v);
+#ifdef ZVECT_DMF_EXTENSIONS
+	v->ord_hint.balance = v->ord_hint.bottom = 0;
+	p_hindex_free(v->hindex);
+	v->hindex = NULL;
+#endif // ZVECT_DMF_EXTENSIONS
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if ( lock_owner )
+		get_mutex_unlock(v, v->lock_type);
+	mutex_destroy(&(v->lock));
+	semaphore_destroy(&(v->semaphore));
+#endif
+
+	// All done and freed, so we can safely
+	// free the vector itself:
+	free(v);
+
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------------*/
+// Vector data storage primitives:
+
+// inline implementation for all put:
+static zvect_retval p_vect_put_at(ivector v, const void *value,
+                                const zvect_index i) {
+	// Check if the index passed is out of bounds:
+	zvect_index idx = i;
+	if (!(v->flags & ZV_CIRCULAR))
+	{
+		if (idx >= p_vect_size(v))
+			return ZVERR_IDXOUTOFBOUND;
+	} else {
+		if (idx >= p_vect_size(v))
+			idx = i % v->init_capacity;
+	}
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_replace(v, idx, true);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// Add value at the specified index, considering
+	// if the vector has ZV_BYREF property enabled:
+	if ( v->flags & ZV_BYREF ) {
+		void *temp = v->data[v->begin + idx];
+		v->data[v->begin + idx] = (void *)value;
+		if ( v->flags & ZV_SEC_WIPE )
+			memset((void *)temp, 0, v->data_size);
+	} else {
+		p_vect_memcpy(v->data[v->begin + idx], value, v->data_size);
+	}
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_replace(v, idx, false);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// done
+	return 0;
+}
+
+// inline implementation for all add(s):
+static inline zvect_retval p_vect_add_at(ivector v, const void *value,
+                                	 const zvect_index i) {
+	// Check if the item is NULL:
+	if (value == NULL)
+		return 0;
+
+	zvect_index idx = i;
+
+	// Get vector size:
+	zvect_index vsize = p_vect_size(v);
+
+	// Allocate memory for the new item:
+	zvect_index base = v->begin;
+
+#if (ZVECT_FULL_REENTRANT == 1)
+	// If we are in FULL_REENTRANT MODE prepare for potential
+	// array copy:
+	void **new_data = NULL;
+	new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
+	if (new_data == NULL)
+		return ZVERR_OUTOFMEM;
+	// Algorithm to try to copy an array of pointers as fast as possible:
+	//if (idx > 0)
+	//	p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * idx);
+	//p_vect_memcpy(new_data + base + (idx + 1), v->data + base +  idx,
+	//	      sizeof(void *) * (vsize - idx));
+	if (vsize)
+		p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * vsize);
+#endif
+
+	// Allocate space at the beginning or end of the vector as required:
+	if (!idx) {
+		// Prepare left side of the vector:
+		if ( base )
+			base--;
+		if (!(v->flags & ZV_BYREF)) {
+#if (ZVECT_FULL_REENTRANT == 1)
+			new_data[base] = (void *)malloc(v->data_size);
+			if (new_data[base] == NULL) {
+				free(new_data);
+				new_data = NULL;
+				return ZVERR_OUTOFMEM;
+			}
+#else
+			v->data[base] = malloc(v->data_size);
+			if (v->data[base] == NULL)
+				return ZVERR_OUTOFMEM;
+#endif
+		}
+	} else if (idx == vsize && !(v->flags & ZV_BYREF)) {
+		// Prepare right side of the vector:
+#if (ZVECT_FULL_REENTRANT == 1)
+		new_data[base + vsize] = (void *)malloc(v->data_size);
+		if (new_data[base + vsize] == NULL) {
+			free(new_data);
+			new_data = NULL;
+			return ZVERR_OUTOFMEM;
+		}
+#else
+		v->data[base + vsize] = malloc(v->data_size);
+		if (v->data[base + vsize] == NULL)
+			return ZVERR_OUTOFMEM;
+#endif
+	}
+
+	// "Shift" right the array of one position to make space for the new item:
+	int16_t array_changed = 0;
+
+	if ((idx < vsize) && (idx != 0)) {
+		array_changed = 1;
+#if (ZVECT_FULL_REENTRANT == 1)
+		p_vect_memmove(new_data + base + (idx + 1), new_data + base + idx,
+			       sizeof(void *) * (vsize - idx));
+#else
+		p_vect_memmove(v->data + base + (idx + 1), v->data + base + idx,
+			       sizeof(void *) * (vsize - idx));
+#endif  // (ZVECT_FULL_REENTRANT == 1)
+	}
+
+	// Add new value in (at the index idx):
+#if (ZVECT_FULL_REENTRANT == 1)
+	if (array_changed && !(v->flags & ZV_BYREF)) {
+		new_data[base + idx] = (void *)malloc(v->data_size);
+		if (new_data[base + idx] == NULL) {
+			free(new_data);
+			new_data = NULL;
+			return ZVERR_OUTOFMEM;
+		}
+	}
+	if (v->flags & ZV_BYREF)
+		new_data[base + idx] = (void *)value;
+	else
+		p_vect_memcpy(new_data[base + idx], value, v->data_size);
+#else
+	if (array_changed && !(v->flags & ZV_BYREF)) {
+		// We moved chunks of memory, so we need to
+		// allocate new memory for the item at position i:
+		v->data[base + idx] = malloc(v->data_size);
+		if (v->data[base + idx] == NULL)
+			return ZVERR_OUTOFMEM;
+	}
+	if (v->flags & ZV_BYREF)
+		v->data[base + idx] = (void *)value;
+	else
+		p_vect_memcpy(v->data[base + idx], value, v->data_size);
+#endif  // (ZVECT_FULL_REENTRANT == 1)
+
+	// Apply changes:
+#if (ZVECT_FULL_REENTRANT == 1)
+	//if (array_changed) {
+		free(v->data);
+		v->data = new_data;
+		v->generation++;
+	//}
+#endif
+	// Increment vector size
+	if (!idx) {
+		if (v->begin == base)
+			v->end++;
+		else
+			v->begin = base;
+	} else {
+		v->end++;
+	}
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_insert(v, idx);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// done
+	return 0;
+}
+
+// This is the inline implementation for all the remove and pop
+static inline zvect_retval p_vect_remove_at(ivector v, const zvect_index i, void **item) {
+	zvect_index idx = i;
+
+	// Get the vector size:
+	zvect_index vsize = p_vect_size(v);
+
+	// Check if the index is out of bounds:
+	if (idx >= vsize) {
+		if (!(v->flags & ZV_CIRCULAR)) {
+			return ZVERR_IDXOUTOFBOUND;
+		} else {
+			idx = idx % vsize;
+		}
+	}
+
+	// Check if the vector got corrupted
+	if ((v->end != 0) && (v->begin > v->end))
+		return ZVERR_VECTCORRUPTED;
+
+	zvect_index base = v->begin;
+	zvect_index top = v->end;
+
+	// Start processing the vector:
+#if (ZVECT_FULL_REENTRANT == 1)
+	// Allocate memory for support Data Structure:
+	void **new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
+	if (new_data == NULL)
+		return ZVERR_OUTOFMEM;
+	if (vsize)
+		p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * vsize);
+#endif
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_remove(v, idx, 1);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	// Get the value we are about to remove:
+	// If the vector is set as ZV_BYREF, then just copy the pointer to the item
+	// If the vector is set as regular, then copy the item
+	if (v->flags & ZV_BYREF) {
+#if (ZVECT_FULL_REENTRANT == 1)
+		*item = new_data[base + idx];
+#else
+		*item = v->data[base + idx];
+#endif
+	} else {
+		*item = (void **)malloc(v->data_size);
+#if (ZVECT_FULL_REENTRANT == 1)
+		if ( new_data[base + idx] != NULL )
+#else
+		if ( v->data[base + idx] != NULL )
+#endif
+		{
+#if (ZVECT_FULL_REENTRANT == 1)
+			p_vect_memcpy(*item, new_data[base + idx], v->data_size);
+#else
+			p_vect_memcpy(*item, v->data[base + idx], v->data_size);
+#endif
+			// If the vector is set for secure wipe, and we copied the item
+			// then we need to wipe the old copy:
+			if (v->flags & ZV_SEC_WIPE)
+#if (ZVECT_FULL_REENTRANT == 1)
+				p_item_safewipe(v, new_data[base + idx]);
+#else
+				p_item_safewipe(v, v->data[base + idx]);
+#endif
+		}
+	}
+
+	// "shift" left the array of one position:
+	uint16_t array_changed;
+	array_changed = 0;
+	if ( idx != 0 ) {
+		if ((idx < (vsize - 1)) && (vsize > 0)) {
+			array_changed = 1;
+#if (ZVECT_FULL_REENTRANT == 1)
 			if (!(v->flags & ZV_BYREF)) {
 				free(new_data[base + idx]);
 				new_data[base + idx]=NULL;
 			}
-			/*
-			// old code, was faster than new logic, but too keen to problems
-			// I may try to reuse it in a better way in the future.
-			p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * idx);
-			p_vect_memcpy(new_data + base + idx, v->data + base + (idx + 1),
-				sizeof(void *) * (vsize - idx));
-			*/
+			/*
+			// old code, was faster than new logic, but too keen to problems
+			// I may try to reuse it in a better way in the future.
+			p_vect_memcpy(new_data + base, v->data + base, sizeof(void *) * idx);
+			p_vect_memcpy(new_data + base + idx, v->data + base + (idx + 1),
+				sizeof(void *) * (vsize - idx));
+			*/
+#else
+		if (!(v->flags & ZV_BYREF)) {
+			free(v->data[base + idx]);
+			v->data[base + idx]=NULL;
+		}
+#endif
+
+			// move data
+#if (ZVECT_FULL_REENTRANT == 1)
+			p_vect_memmove(new_data + (base + idx), new_data + (base + (idx + 1)),
+					sizeof(void *) * ((vsize - idx) - 1));
+			// Clear leftover item pointers:
+			new_data[(base + vsize) - 1] = NULL;
+#else
+			p_vect_memmove(v->data + (base + idx), v->data +
+				       (base + (idx + 1)),
+				       sizeof(void *) * ((vsize - idx) - 1));
+
+			// Clear leftover item pointers:
+			v->data[(base + vsize) - 1] = NULL;
+#endif
+		}
+	} else {
+		if ( base < top ) {
+			array_changed = 1;
+#if (ZVECT_FULL_REENTRANT == 1)
+			if (new_data[base] != NULL) {
+				if (!(v->flags & ZV_BYREF)) {
+					free(new_data[base]);
+				}
+				new_data[base]=NULL;
+			}
+#else
+			if (v->data[base] != NULL) {
+				if (!(v->flags & ZV_BYREF)) {
+					free(v->data[base]);
+				}
+				v->data[base]=NULL;
+			}
+#endif
+		}
+	}
+
+	// Reduce vector size:
+#if (ZVECT_FULL_REENTRANT == 0)
+	if (!(v->flags & ZV_BYREF) && !array_changed)
+		p_free_items(v, vsize - 1, 0);
+#else
+	if (!(v->flags & ZV_BYREF) && !array_changed)
+		for (register zvect_index j = (vsize - 1); j >= vsize; j--) {
+			if (new_data[base + j] != NULL) {
+				if (v->flags & ZV_SEC_WIPE)
+					p_item_safewipe(v, new_data[base + j]);
+				if (!(v->flags & ZV_BYREF)) {
+					free(new_data[base + j]);
+					new_data[base + j]=NULL;
+				}
+			}
+			if (j == (vsize - 1))
+				break;	// this is required if we are using
+					// uint and the first element is element
+					// 0, because on GCC an uint will fail
+					// then check in the for loop if j >= first
+					// in this particular case!
+		}
+
+	// Apply changes
+	//if (array_changed) {
+	free(v->data);
+	v->data = new_data;
+	v->generation++;
+	//}
+#endif
+	if (!(v->flags & ZV_CIRCULAR)) {
+		if ( idx != 0 ) {
+			if (v->end > v->begin) {
+				v->end--;
+			} else {
+				v->end = v->begin;
+			}
+		} else {
+			if (v->begin < v->end) {
+				v->begin++;
+			} else {
+				v->begin = v->end;
+			}
+		}
+		// Check if we need to shrink vector's capacity:
+		if ((4 * vsize) < p_vect_capacity(v) )
+			p_vect_decrease_capacity(v, idx);
+	}
+
+	// All done, return control:
+	return 0;
+}
+
+// This is the inline implementation for all the "delete" methods
+static inline zvect_retval p_vect_delete_at(ivector v,
+					    const zvect_index start,
+					    const zvect_index offset,
+					    uint32_t flags)
+{
+
+	zvect_index vsize = p_vect_size(v);
+
+	// If the vector is empty just return
+	if (vsize == 0)
+		return ZVERR_VECTEMPTY;
+
+	// Check if the index is out of bounds:
+	if ((start + offset) > vsize)
+		return ZVERR_IDXOUTOFBOUND;
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	if (v->hindex != NULL)
+		p_hindex_remove(v, start, offset + 1);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	uint16_t array_changed = 0;
+
+	// "shift" left the data of one position:
+	zvect_index tot_items = start + offset;
+#ifdef DEBUG
+	/*
+	log_msg(ZVLP_INFO, "p_vect_delete_at: start     %*u\n", 14, start);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: offset    %*u\n", 14, offset);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: tot_items %*u\n", 14, tot_items);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: v->begin  %*u\n", 14, v->begin);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: v->end    %*u\n", 14, v->end);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: vsize     %*u\n", 14, vsize);
+	log_msg(ZVLP_INFO, "p_vect_delete_at: data      %*p\n", 14, v->data);
+	*/
+#endif
+	// Deleting from the front just moves begin (see below), so
+	// the array needs to be changed only for the other cases:
+	if ( (vsize > 1) && (start != 0) && (start < (vsize - 1)) && (v->data != NULL) ) {
+		array_changed = 1;
+#ifdef DEBUG
+		/* for (zvect_index ptrID = start; ptrID < start + offset; ptrID++)
+		{
+				log_msg(ZVLP_INFO, "p_vect_delete_at: data ptr  %*p\n", 14, v->data + (v->begin + ptrID));
+		}*/
+#endif
+		// Safe-erase items?
+		if ( flags & 1 )
+			p_free_items(v, start, offset);
+
+		// Move remaining items pointers up:
+		p_vect_memmove(v->data + (v->begin + start), v->data + (v->begin + tot_items + 1),
+			sizeof(void *) * (((vsize - start) - offset) - 1));
+
+		// Clear leftover item pointers:
+		if ( !(flags & 1) )
+			(*(p_kern.fill_ptrs))(v->data + ((v->begin + vsize) - (offset + 1)), NULL, offset + 1);
+	}
+
+	// Reduce vector size:
+	if (!(v->flags & ZV_BYREF) && (flags & 1) && !array_changed)
+			p_free_items(v, (start == 0) ? 0 : ((vsize - 1) - offset), offset);
+
+	// Check if we need to increment begin or decrement end
+	// depending on the direction of the "delete" (left or right)
+	if ( (start != 0) || array_changed ) {
+		if ((v->end - (offset + 1)) > v->begin) {
+			v->end -= (offset + 1);
+		} else {
+			v->end = v->begin;
+		}
+	} else {
+		if ((v->begin + (offset + 1)) < v->end) {
+			v->begin += (offset + 1);
+		} else {
+			v->begin = v->end;
+		}
+	}
+
+	if (v->begin == v->end)
+	{
+		v->begin = 0;
+		v->end = 0;
+	}
+
+	// Check if we need to shrink the vector:
+	if ((4 * vsize) < p_vect_capacity(v))
+		p_vect_decrease_capacity(v, start);
+
+	// All done, return control:
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+
+
+
+/*****************************************************************************
+ **                            ZVector API                                  **
+ *****************************************************************************/
+
+/*---------------------------------------------------------------------------*/
+// Vector Size and Capacity management functions:
+
+/*
+ * Public method to request ZVector to
+ * shrink a vector.
+ */
+void vect_shrink(ivector v)
+{
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	zvect_retval rval = p_vect_shrink(v);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Vector Structural Information report:
+
+bool vect_is_empty(const_vector const v)
+{
+	return !p_vect_check(v) ? (p_vect_live_size(v) == 0) : (bool)ZVERR_VECTUNDEF;
+}
+
+zvect_index vect_size(const_vector const v)
+{
+	return !p_vect_check(v) ? p_vect_live_size(v) : 0;
+}
+
+zvect_index vect_max_size(const_vector const v)
+{
+	return (!p_vect_check(v) ? zvect_index_max : 0);
+}
+
+void *vect_begin(const_vector const v)
+{
+	if (p_vect_check(v))
+		return NULL;
+	p_vect_settle(v);
+	return v->data[v->begin];
+}
+
+void *vect_end(const_vector const v)
+{
+	if (p_vect_check(v))
+		return NULL;
+	p_vect_settle(v);
+	return v->data[v->end];
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Vector Creation and Destruction:
+
+vector vect_create(const zvect_index init_capacity, const size_t item_size,
+                   const uint32_t properties) {
+	// If ZVector has not been initialised yet, then initialise it
+	// when creating the first vector:
+	if (p_init_state == 0)
+		p_init_zvect();
+
+	// Create the vector first:
+	vector v = (vector)malloc(sizeof(struct p_vector));
+	if (v == NULL)
+		p_throw_error(ZVERR_OUTOFMEM, NULL);
+
+	// Initialize the vector:
+	v->end = 0;
+	if (item_size == 0)
+		v->data_size = ZVECT_DEFAULT_DATA_SIZE;
+	else
+		v->data_size = item_size;
+
+	zvect_index capacity = init_capacity;
+	if (init_capacity == 0)
+	{
+		v->cap_left = ZVECT_INITIAL_CAPACITY / 2;
+		v->cap_right= ZVECT_INITIAL_CAPACITY / 2;
+	} else {
+		if (init_capacity <= 4)
+			capacity = 4;
+
+		v->cap_left = capacity / 2;
+		v->cap_right= capacity / 2;
+	}
+	v->begin = v->end = 0;
+
+	v->init_capacity = v->cap_left + v->cap_right;
+	v->flags = properties;
+	v->SfWpFunc = NULL;
+	v->status = 0;
+	if (v->flags & ZV_CIRCULAR)
+	{
+		// If the vector is circular then
+		// we need to pre-allocate all the elements
+		// the vector will not grow:
+		v->end = v->cap_right - 1;
+		v->begin = v->cap_left - 1;
+		// Circular vectors overwrite their items in place, so
+		// they never use lazy deletes or a gap:
+		v->flags &= ~(uint32_t)(ZV_LAZY_DELETE | ZV_GAP_BUFFER | ZV_TREE);
+	}
+	// A tree vector has no gap and a gap buffer vector has no
+	// tombstones:
+	if (v->flags & ZV_TREE)
+		v->flags &= ~(uint32_t)ZV_GAP_BUFFER;
+	if (v->flags & (ZV_GAP_BUFFER | ZV_TREE))
+		v->flags &= ~(uint32_t)ZV_LAZY_DELETE;
+	v->tombs = NULL;
+	v->tree = NULL;
+	v->gap_at = v->gap_len = 0;
+	v->generation = 0;
+#ifdef ZVECT_DMF_EXTENSIONS
+	v->ord_hint.balance = v->ord_hint.bottom = 0;
+	v->hindex = NULL;
+#endif // ZVECT_DMF_EXTENSIONS
+
+	v->data = NULL;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	v->lock_type = 0;
+	mutex_init(&(v->lock));
+	mutex_cond_init(&(v->cond));
+	semaphore_init(&(v->semaphore), 0);
+#endif
+
+	// Allocate memory for the vector storage area
+	v->data = (void **)calloc(p_vect_capacity(v), sizeof(void *));
+	if (v->data == NULL)
+		p_throw_error(ZVERR_OUTOFMEM, NULL);
+
+	// Return the vector to the user:
+	return v;
+}
+
+void *vect_destroy(vector v) {
+	// Call p_vect_destroy with flags set to 1
+	// to destroy data according to the vector
+	// properties:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_DESTROY_JOB_DONE;
+
+	rval = p_vect_destroy(v, 1);
+
+VECT_DESTROY_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Vector Thread Safe user functions:
+
+#if (ZVECT_THREAD_SAFE == 1)
+void vect_lock_enable(void) {
+	locking_disabled = false;
+}
+
+void vect_lock_disable(void) {
+	locking_disabled = true;
+}
+
+static inline zvect_retval p_vect_lock(ivector v) {
+	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 3);
+}
+
+zvect_retval vect_lock(ivector v) {
+	return p_vect_lock(v);
+}
+
+static inline zvect_retval p_vect_unlock(ivector v) {
+	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_unlock(v, 3);
+}
+
+zvect_retval vect_unlock(ivector v) {
+	return p_vect_unlock(v);
+}
+
+static inline zvect_retval p_vect_trylock(ivector v) {
+	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : check_mutex_trylock(v, 3);
+}
+
+zvect_retval vect_trylock(ivector v) {
+	return p_vect_trylock(v);
+}
+
+zvect_retptr vect_sem_wait(ivector v) {
+#if !defined(macOS)
+	return (zvect_retptr)sem_wait(&(v->semaphore));
+#else
+	return (zvect_retptr)dispatch_semaphore_wait(v->semaphore, DISPATCH_TIME_FOREVER);
+#endif
+}
+
+zvect_retptr vect_sem_post(ivector v) {
+#	if !defined(macOS)
+	return (zvect_retptr)sem_post(&(v->semaphore));
+#	else
+	return (zvect_retptr)dispatch_semaphore_signal(v->semaphore);
+#	endif
+}
+
+/*
+TODO: Implement this function:
+
+static inline zvect_retval p_vect_wait_for_signal(const vector v) {
+    	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 1 : wait_for_signal(v, 3);
+}
+
+and also:
+
+inline zvect_retval vect_wait_for_signal(const vector v) {
+    	return p_vect_wait_for_signal(v);
+}
+*/
+
+static inline zvect_retval p_vect_lock_after_signal(ivector v) {
+    	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 1 : lock_after_signal(v, 3);
+}
+
+zvect_retval vect_lock_after_signal(ivector v) {
+	return p_vect_lock_after_signal(v);
+}
+
+zvect_retval vect_send_signal(ivector v) {
+	return send_signal(v, 3);
+}
+
+zvect_retval vect_broadcast_signal(ivector v) {
+	return broadcast_signal(v, 3);
+}
+
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Worker Pool user functions:
+
+#if (ZVECT_THREAD_SAFE == 1)
+
+zvect_retval vect_pool_set_threads(zvect_index nthreads) {
+#	if (ZVECT_WORKER_POOL == 1)
+	if (nthreads > ZVECT_POOL_MAX_THREADS)
+		nthreads = ZVECT_POOL_MAX_THREADS;
+
+	// Stop the running workers, the new configuration
+	// will be used when the pool is restarted:
+	p_pool_stop();
+
+	mutex_lock(&(p_pool.lock));
+	p_pool.cfg_threads = nthreads;
+	p_pool.cfg_set = true;
+	mutex_unlock(&(p_pool.lock));
+
+	return 0;
+#	else
+	return (nthreads) ? ZVERR_OPNOTALLOWED : 0;
+#	endif
+}
+
+zvect_index vect_pool_get_threads(void) {
+#	if (ZVECT_WORKER_POOL == 1)
+	mutex_lock(&(p_pool.lock));
+	if (!p_pool.cfg_set) {
+		p_pool.cfg_threads = p_pool_default_threads();
+		p_pool.cfg_set = true;
+	}
+	zvect_index nthreads = (zvect_index)p_pool.cfg_threads;
+	mutex_unlock(&(p_pool.lock));
+
+	return nthreads;
+#	else
+	return 0;
+#	endif
+}
+
+zvect_retval vect_pool_set_affinity(const int *cpus, zvect_index ncpus) {
+#	if (ZVECT_WORKER_POOL == 1) && defined(__linux__)
+	int *new_cpus = NULL;
+	if (cpus != NULL && ncpus > 0) {
+		for (zvect_index i = 0; i < ncpus; i++)
+			if (cpus[i] < 0 || cpus[i] >= CPU_SETSIZE)
+				return ZVERR_IDXOUTOFBOUND;
+		new_cpus = (int *)malloc(sizeof(int) * ncpus);
+		if (new_cpus == NULL)
+			return ZVERR_OUTOFMEM;
+		memcpy(new_cpus, cpus, sizeof(int) * ncpus);
+	} else {
+		ncpus = 0;
+	}
+
+	// Affinity is applied by the workers when they
+	// start, so restart the pool (lazily):
+	p_pool_stop();
+
+	mutex_lock(&(p_pool.lock));
+	free(p_pool.cpus);
+	p_pool.cpus = new_cpus;
+	p_pool.ncpus = ncpus;
+	mutex_unlock(&(p_pool.lock));
+
+	return 0;
+#	else
+	UNUSED(cpus);
+	return (ncpus) ? ZVERR_OPNOTALLOWED : 0;
+#	endif
+}
+
+struct p_submit_job {
+	struct p_vector *v;
+	void (*f)(vector, zvect_index, zvect_index, void *);
+	void *ctx;
+};
+
+static void p_submit_chunk(void *arg, zvect_index start, zvect_index end) {
+	const struct p_submit_job *job = (struct p_submit_job *)arg;
+	(*(job->f))(job->v, start, end, job->ctx);
+}
+
+zvect_retval vect_pool_submit_range(ivector v, zvect_index start,
+				    zvect_index end,
+				    void (*f)(vector, zvect_index, zvect_index, void *),
+				    void *ctx, zvect_index nthreads,
+				    zvect_index grain) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_POOL_SUBMIT_JOB_DONE;
+
+	if (f == NULL) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_POOL_SUBMIT_JOB_DONE;
+	}
+
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	p_vect_settle_locked(v);
+
+	if (start > end || end > p_vect_size(v)) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_POOL_SUBMIT_DONE_PROCESSING;
+	}
+
+	struct p_submit_job job = { v, f, ctx };
+	rval = p_pool_run_range(start, end, nthreads, grain, p_submit_chunk, &job);
+
+VECT_POOL_SUBMIT_DONE_PROCESSING:
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+
+VECT_POOL_SUBMIT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+	return rval;
+}
+
+void vect_pool_shutdown(void) {
+#	if (ZVECT_WORKER_POOL == 1)
+	p_pool_stop();
+#	endif
+}
+
+#endif  // ZVECT_THREAD_SAFE
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// CPU features user functions:
+
+uint32_t vect_get_cpu_features(void) {
+	if (p_init_state == 0)
+		p_init_zvect();
+
+	return p_cpu_detected;
+}
+
+uint32_t vect_set_cpu_features(uint32_t features) {
+	if (p_init_state == 0)
+		p_init_zvect();
+
+	return p_kernels_select(features);
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Typed numeric vectors:
+
+// Values are stored contiguously, 64 bytes aligned (so they
+// can be read one cache line at a time by the SIMD kernels):
+#define P_TYPED_ALIGN 64
+
+struct p_typed_vector {
+	uint32_t type;			// - One of the ZVECT_TYPES
+	size_t value_size;		// - Size of one value
+	zvect_index size;		// - Number of values
+	zvect_index capacity;		// - Number of values we have room for
+	char *data;			// - Values (aligned)
+	void *data_mem;			// - Memory allocated for data
+};
+
+static inline zvect_retval p_typed_check(const struct p_typed_vector *tv)
+{
+	return (tv == NULL) ? ZVERR_VECTUNDEF : 0;
+}
+
+static inline const struct p_typed_kernels *p_typed_kernels(const struct p_typed_vector *tv)
+{
+	return &(p_tkern[tv->type - 1]);
+}
+
+// Grows the capacity to at least "capacity" values:
+static zvect_retval p_typed_reserve(struct p_typed_vector *tv, zvect_index capacity)
+{
+	if (capacity <= tv->capacity)
+		return 0;
+
+	zvect_index new_capacity = tv->capacity ? tv->capacity : ZVECT_INITIAL_CAPACITY;
+	while (new_capacity < capacity)
+		new_capacity = (new_capacity > (zvect_index_max >> 1)) ? capacity : (new_capacity << 1);
+
+	void *mem = malloc(((size_t)new_capacity * tv->value_size) + (P_TYPED_ALIGN - 1));
+	if (mem == NULL)
+		return ZVERR_OUTOFMEM;
+	char *data = (char *)(((uintptr_t)mem + (P_TYPED_ALIGN - 1)) & ~((uintptr_t)(P_TYPED_ALIGN - 1)));
+
+	if (tv->size)
+		p_vect_memcpy(data, tv->data, (size_t)tv->size * tv->value_size);
+	free(tv->data_mem);
+	tv->data_mem = mem;
+	tv->data = data;
+	tv->capacity = new_capacity;
+
+	return 0;
+}
+
+typed_vector vect_create_typed(uint32_t type, zvect_index capacity)
+{
+	// Initialise ZVector, if this has not been done yet
+	// (the kernels are selected at initialisation time):
+	if (p_init_state == 0)
+		p_init_zvect();
+
+	zvect_retval rval = 0;
+	struct p_typed_vector *tv = NULL;
+
+	if ((type < ZV_T_I32) || (type > ZV_T_F64)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_CREATE_TYPED_JOB_DONE;
+	}
+
+	tv = (struct p_typed_vector *)calloc(1, sizeof(struct p_typed_vector));
+	if (tv == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_TYPED_JOB_DONE;
+	}
+	tv->type = type;
+	tv->value_size = ((type == ZV_T_I32) || (type == ZV_T_F32)) ? 4 : 8;
+
+	rval = p_typed_reserve(tv, capacity ? capacity : ZVECT_INITIAL_CAPACITY);
+	if (rval) {
+		free(tv);
+		tv = NULL;
+	}
+
+VECT_CREATE_TYPED_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+
+	return tv;
+}
+
+void vect_typed_destroy(typed_vector tv)
+{
+	if (tv == NULL)
+		return;
+	free(tv->data_mem);
+	free(tv);
+}
+
+uint32_t vect_typed_type(typed_vector const tv)
+{
+	return (tv == NULL) ? 0 : tv->type;
+}
+
+zvect_index vect_typed_size(typed_vector const tv)
+{
+	return (tv == NULL) ? 0 : tv->size;
+}
+
+void *vect_typed_data(typed_vector const tv)
+{
+	return (tv == NULL) ? NULL : tv->data;
+}
+
+zvect_retval vect_typed_push(typed_vector const tv, const void *value)
+{
+	return vect_typed_append(tv, value, 1);
+}
+
+zvect_retval vect_typed_append(typed_vector const tv, const void *values, zvect_index count)
+{
+	zvect_retval rval = p_typed_check(tv);
+	if (rval)
+		goto VECT_TYPED_APPEND_JOB_DONE;
+
+	if ((values == NULL) || (count == 0))
+		goto VECT_TYPED_APPEND_JOB_DONE;
+
+	if (count > (zvect_index_max - tv->size)) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_TYPED_APPEND_JOB_DONE;
+	}
+
+	rval = p_typed_reserve(tv, tv->size + count);
+	if (rval)
+		goto VECT_TYPED_APPEND_JOB_DONE;
+
+	p_vect_memcpy(tv->data + ((size_t)tv->size * tv->value_size), values,
+		      (size_t)count * tv->value_size);
+	tv->size += count;
+
+VECT_TYPED_APPEND_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+void *vect_typed_get_at(typed_vector const tv, zvect_index i)
+{
+	if ((tv == NULL) || (i >= tv->size))
+		return NULL;
+	return tv->data + ((size_t)i * tv->value_size);
+}
+
+void vect_typed_clear(typed_vector const tv)
+{
+	if (tv != NULL)
+		tv->size = 0;
+}
+
+zvect_retval vect_typed_sum(typed_vector const tv, void *result)
+{
+	zvect_retval rval = p_typed_check(tv);
+	if (rval || (result == NULL))
+		goto VECT_TYPED_SUM_JOB_DONE;
+
+	(*(p_typed_kernels(tv)->sum))(tv->data, tv->size, result);
+
+VECT_TYPED_SUM_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+// Min (max = false) or max (max = true) value:
+static zvect_retval p_typed_minmax(typed_vector const tv, void *result, bool max)
+{
+	zvect_retval rval = p_typed_check(tv);
+	if (rval || (result == NULL))
+		goto TYPED_MINMAX_JOB_DONE;
+
+	if (tv->size == 0) {
+		rval = ZVERR_VECTEMPTY;
+		goto TYPED_MINMAX_JOB_DONE;
+	}
+
+	const struct p_typed_kernels *k = p_typed_kernels(tv);
+	if (max)
+		(*(k->max))(tv->data, tv->size, result);
+	else
+		(*(k->min))(tv->data, tv->size, result);
+
+TYPED_MINMAX_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_typed_min(typed_vector const tv, void *result)
+{
+	return p_typed_minmax(tv, result, false);
+}
+
+zvect_retval vect_typed_max(typed_vector const tv, void *result)
+{
+	return p_typed_minmax(tv, result, true);
+}
+
+// The arg functions find the min (or max) value first and then
+// its first occurrence, both passes are SIMD friendly (while
+// tracking the index along with the value is not):
+static zvect_index p_typed_arg(typed_vector const tv, bool max)
+{
+	uint64_t value;		// - Large enough for all the types
+
+	if ((tv == NULL) || (tv->size == 0))
+		return zvect_index_max;
+
+	const struct p_typed_kernels *k = p_typed_kernels(tv);
+	if (max)
+		(*(k->max))(tv->data, tv->size, &value);
+	else
+		(*(k->min))(tv->data, tv->size, &value);
+
+	// A NaN minimum (or maximum) is not equal to any item, so
+	// find_eq can't find it:
+	size_t i = (*(k->find_eq))(tv->data, tv->size, &value);
+	return (i < tv->size) ? (zvect_index)i : zvect_index_max;
+}
+
+zvect_index vect_typed_argmin(typed_vector const tv)
+{
+	return p_typed_arg(tv, false);
+}
+
+zvect_index vect_typed_argmax(typed_vector const tv)
+{
+	return p_typed_arg(tv, true);
+}
+
+// Checks two typed vectors can be used together:
+static inline zvect_retval p_typed_check2(const struct p_typed_vector *tv1,
+					  const struct p_typed_vector *tv2)
+{
+	if ((tv1 == NULL) || (tv2 == NULL))
+		return ZVERR_VECTUNDEF;
+	if (tv1->type != tv2->type)
+		return ZVERR_VECTDATASIZE;
+	if (tv1->size != tv2->size)
+		return ZVERR_OPNOTALLOWED;
+	return 0;
+}
+
+zvect_retval vect_typed_dot(typed_vector const tv1, typed_vector const tv2, void *result)
+{
+	zvect_retval rval = p_typed_check2(tv1, tv2);
+	if (rval || (result == NULL))
+		goto VECT_TYPED_DOT_JOB_DONE;
+
+	(*(p_typed_kernels(tv1)->dot))(tv1->data, tv2->data, tv1->size, result);
+
+VECT_TYPED_DOT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_typed_scale(typed_vector const tv, const void *factor)
+{
+	zvect_retval rval = p_typed_check(tv);
+	if (rval || (factor == NULL))
+		goto VECT_TYPED_SCALE_JOB_DONE;
+
+	(*(p_typed_kernels(tv)->scale))(tv->data, tv->size, factor);
+
+VECT_TYPED_SCALE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_typed_add(typed_vector const tv1, typed_vector const tv2)
+{
+	zvect_retval rval = p_typed_check2(tv1, tv2);
+	if (rval)
+		goto VECT_TYPED_ADD_JOB_DONE;
+
+	(*(p_typed_kernels(tv1)->add))(tv1->data, tv2->data, tv1->size);
+
+VECT_TYPED_ADD_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_index vect_typed_count_if(typed_vector const tv, uint32_t op, const void *value)
+{
+	if ((tv == NULL) || (value == NULL) || (op > ZV_GT))
+		return 0;
+
+	return (zvect_index)(*(p_typed_kernels(tv)->count_if))(tv->data, tv->size, op, value);
+}
+
+
+/*---------------------------------------------------------------------------*/
+// Columnar vectors:
+
+// Every field of the records is stored in its own column, all
+// the columns share one allocation and every column starts on
+// a new cache line (so a scan of one field reads only that
+// column):
+#define P_COLUMN_ALIGN 64
+
+struct p_column {
+	size_t offset;			// - Offset of the field in a record
+	size_t size;			// - Size of the field
+	char *data;			// - Column values (aligned)
+};
+
+struct p_columnar_vector {
+	uint32_t flags;			// - Vector's properties (ZV_NOLOCKING)
+	size_t record_size;		// - Size of one record
+	uint32_t nfields;		// - Number of fields (and columns)
+	zvect_index size;		// - Number of records
+	zvect_index capacity;		// - Number of records we have room for
+	struct p_column *columns;	// - One column per field
+	void *data_mem;			// - Memory allocated for the columns
+#if (ZVECT_THREAD_SAFE == 1)
+	pthread_mutex_t lock;		// - Columnar vector's mutex
+#endif
+};
+
+#if (ZVECT_THREAD_SAFE == 1)
+static inline zvect_retval p_columnar_lock(struct p_columnar_vector *cv)
+{
+	if (locking_disabled || (cv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_lock(&(cv->lock));
+	return 1;
+}
+
+static inline void p_columnar_unlock(struct p_columnar_vector *cv, zvect_retval lock_owner)
+{
+	if (lock_owner)
+		mutex_unlock(&(cv->lock));
+}
+#	define P_COLUMNAR_LOCK(cv) zvect_retval lock_owner = p_columnar_lock(cv)
+#	define P_COLUMNAR_UNLOCK(cv) p_columnar_unlock(cv, lock_owner)
+#else
+#	define P_COLUMNAR_LOCK(cv)
+#	define P_COLUMNAR_UNLOCK(cv)
+#endif
+
+// Copies one field value, common field sizes are copied with a
+// constant size memcpy (which the compiler turns into a single
+// load and store):
+static inline void p_field_copy(void *dst, const void *src, size_t size)
+{
+	switch (size) {
+	case 1:
+		memcpy(dst, src, 1);
+		break;
+	case 2:
+		memcpy(dst, src, 2);
+		break;
+	case 4:
+		memcpy(dst, src, 4);
+		break;
+	case 8:
+		memcpy(dst, src, 8);
+		break;
+	default:
+		memcpy(dst, src, size);
+		break;
+	}
+}
+
+// Bytes needed to store "capacity" values of a column:
+static inline size_t p_column_bytes(const struct p_column *c, zvect_index capacity)
+{
+	return (((size_t)capacity * c->size) + (P_COLUMN_ALIGN - 1)) & ~((size_t)(P_COLUMN_ALIGN - 1));
+}
+
+// Grows the capacity to at least "capacity" records:
+static zvect_retval p_columnar_reserve(struct p_columnar_vector *cv, zvect_index capacity)
+{
+	if (capacity <= cv->capacity)
+		return 0;
+
+	zvect_index new_capacity = cv->capacity ? cv->capacity : ZVECT_INITIAL_CAPACITY;
+	while (new_capacity < capacity)
+		new_capacity = (new_capacity > (zvect_index_max >> 1)) ? capacity : (new_capacity << 1);
+
+	size_t total = 0;
+	for (uint32_t f = 0; f < cv->nfields; f++)
+		total += p_column_bytes(&(cv->columns[f]), new_capacity);
+
+	void *mem = malloc(total + (P_COLUMN_ALIGN - 1));
+	if (mem == NULL)
+		return ZVERR_OUTOFMEM;
+	char *data = (char *)(((uintptr_t)mem + (P_COLUMN_ALIGN - 1)) & ~((uintptr_t)(P_COLUMN_ALIGN - 1)));
+
+	for (uint32_t f = 0; f < cv->nfields; f++) {
+		struct p_column *c = &(cv->columns[f]);
+		if (cv->size)
+			p_vect_memcpy(data, c->data, (size_t)cv->size * c->size);
+		c->data = data;
+		data += p_column_bytes(c, new_capacity);
+	}
+	free(cv->data_mem);
+	cv->data_mem = mem;
+	cv->capacity = new_capacity;
+
+	return 0;
+}
+
+// Scatters the fields of a record to row i of the columns:
+static inline void p_columnar_scatter(struct p_columnar_vector *cv, zvect_index i, const void *record)
+{
+	for (uint32_t f = 0; f < cv->nfields; f++) {
+		struct p_column *c = &(cv->columns[f]);
+		p_field_copy(c->data + ((size_t)i * c->size), (const char *)record + c->offset, c->size);
+	}
+}
+
+columnar_vector vect_create_columnar(size_t record_size, const zvect_field *fields,
+				     uint32_t nfields, zvect_index capacity,
+				     const uint32_t properties)
+{
+	// Initialise ZVector, if this has not been done yet
+	// (vect_columnar_count_if uses the typed kernels):
+	if (p_init_state == 0)
+		p_init_zvect();
+
+	zvect_retval rval = 0;
+	struct p_columnar_vector *cv = NULL;
+
+	if ((fields == NULL) || (nfields == 0)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_CREATE_COLUMNAR_JOB_DONE;
+	}
+	for (uint32_t f = 0; f < nfields; f++) {
+		if ((fields[f].size == 0) || (fields[f].offset > record_size) ||
+		    (fields[f].size > (record_size - fields[f].offset))) {
+			rval = ZVERR_OPNOTALLOWED;
+			goto VECT_CREATE_COLUMNAR_JOB_DONE;
+		}
+	}
+
+	cv = (struct p_columnar_vector *)calloc(1, sizeof(struct p_columnar_vector));
+	if (cv == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_COLUMNAR_JOB_DONE;
+	}
+	cv->columns = (struct p_column *)calloc(nfields, sizeof(struct p_column));
+	if (cv->columns == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_COLUMNAR_JOB_DONE;
+	}
+	cv->flags = properties;
+	cv->record_size = record_size;
+	cv->nfields = nfields;
+	for (uint32_t f = 0; f < nfields; f++) {
+		cv->columns[f].offset = fields[f].offset;
+		cv->columns[f].size = fields[f].size;
+	}
+
+	rval = p_columnar_reserve(cv, capacity ? capacity : ZVECT_INITIAL_CAPACITY);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (!rval)
+		mutex_init(&(cv->lock));
+#endif
+
+VECT_CREATE_COLUMNAR_JOB_DONE:
+	if (rval && (cv != NULL)) {
+		free(cv->columns);
+		free(cv);
+		cv = NULL;
+	}
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+
+	return cv;
+}
+
+void vect_columnar_destroy(columnar_vector cv)
+{
+	if (cv == NULL)
+		return;
+#if (ZVECT_THREAD_SAFE == 1)
+	mutex_destroy(&(cv->lock));
+#endif
+	free(cv->data_mem);
+	free(cv->columns);
+	free(cv);
+}
+
+#if (ZVECT_THREAD_SAFE == 1)
+zvect_retval vect_columnar_lock(columnar_vector const cv)
+{
+	return p_columnar_lock(cv);
+}
+
+zvect_retval vect_columnar_unlock(columnar_vector const cv)
+{
+	if (locking_disabled || (cv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_unlock(&(cv->lock));
+	return 1;
+}
+#endif
+
+zvect_index vect_columnar_size(columnar_vector const cv)
+{
+	return (cv == NULL) ? 0 : cv->size;
+}
+
+void *vect_columnar_column(columnar_vector const cv, uint32_t field)
+{
+	if ((cv == NULL) || (field >= cv->nfields))
+		return NULL;
+	return cv->columns[field].data;
+}
+
+zvect_retval vect_columnar_add(columnar_vector const cv, const void *record)
+{
+	zvect_retval rval = (cv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval || (record == NULL))
+		goto VECT_COLUMNAR_ADD_JOB_DONE;
+
+	P_COLUMNAR_LOCK(cv);
+
+	if (cv->size == zvect_index_max) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_COLUMNAR_ADD_DONE_PROCESSING;
+	}
+
+	rval = p_columnar_reserve(cv, cv->size + 1);
+	if (rval)
+		goto VECT_COLUMNAR_ADD_DONE_PROCESSING;
+
+	p_columnar_scatter(cv, cv->size, record);
+	cv->size++;
+
+VECT_COLUMNAR_ADD_DONE_PROCESSING:
+	P_COLUMNAR_UNLOCK(cv);
+
+VECT_COLUMNAR_ADD_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_columnar_put_at(columnar_vector const cv, zvect_index i, const void *record)
+{
+	zvect_retval rval = (cv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval || (record == NULL))
+		goto VECT_COLUMNAR_PUT_AT_JOB_DONE;
+
+	P_COLUMNAR_LOCK(cv);
+
+	if (i >= cv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_COLUMNAR_PUT_AT_DONE_PROCESSING;
+	}
+
+	p_columnar_scatter(cv, i, record);
+
+VECT_COLUMNAR_PUT_AT_DONE_PROCESSING:
+	P_COLUMNAR_UNLOCK(cv);
+
+VECT_COLUMNAR_PUT_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_columnar_get_at(columnar_vector const cv, zvect_index i, void *record)
+{
+	zvect_retval rval = (cv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval || (record == NULL))
+		goto VECT_COLUMNAR_GET_AT_JOB_DONE;
+
+	P_COLUMNAR_LOCK(cv);
+
+	if (i >= cv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_COLUMNAR_GET_AT_DONE_PROCESSING;
+	}
+
+	// Gather the fields of the record:
+	for (uint32_t f = 0; f < cv->nfields; f++) {
+		const struct p_column *c = &(cv->columns[f]);
+		p_field_copy((char *)record + c->offset, c->data + ((size_t)i * c->size), c->size);
+	}
+
+VECT_COLUMNAR_GET_AT_DONE_PROCESSING:
+	P_COLUMNAR_UNLOCK(cv);
+
+VECT_COLUMNAR_GET_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_columnar_remove_at(columnar_vector const cv, zvect_index i)
+{
+	zvect_retval rval = (cv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_COLUMNAR_REMOVE_AT_JOB_DONE;
+
+	P_COLUMNAR_LOCK(cv);
+
+	if (i >= cv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_COLUMNAR_REMOVE_AT_DONE_PROCESSING;
+	}
+
+	for (uint32_t f = 0; f < cv->nfields; f++) {
+		struct p_column *c = &(cv->columns[f]);
+		p_vect_memmove(c->data + ((size_t)i * c->size), c->data + ((size_t)(i + 1) * c->size),
+			       (size_t)(cv->size - i - 1) * c->size);
+	}
+	cv->size--;
+
+VECT_COLUMNAR_REMOVE_AT_DONE_PROCESSING:
+	P_COLUMNAR_UNLOCK(cv);
+
+VECT_COLUMNAR_REMOVE_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+void vect_columnar_clear(columnar_vector const cv)
+{
+	if (cv == NULL)
+		return;
+
+	P_COLUMNAR_LOCK(cv);
+	cv->size = 0;
+	P_COLUMNAR_UNLOCK(cv);
+}
+
+zvect_index vect_columnar_count_if(columnar_vector const cv, uint32_t field, uint32_t type,
+				   uint32_t op, const void *value)
+{
+	if ((cv == NULL) || (value == NULL) || (field >= cv->nfields) ||
+	    (type < ZV_T_I32) || (type > ZV_T_F64) || (op > ZV_GT))
+		return 0;
+
+	// The column must hold values of the requested type:
+	const struct p_column *c = &(cv->columns[field]);
+	if (c->size != (((type == ZV_T_I32) || (type == ZV_T_F32)) ? 4 : 8))
+		return 0;
+
+	// The column is a plain array, so the typed vectors kernels
+	// can be used on it:
+	P_COLUMNAR_LOCK(cv);
+	zvect_index count = (zvect_index)(*(p_tkern[type - 1].count_if))(c->data, cv->size, op, value);
+	P_COLUMNAR_UNLOCK(cv);
+
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+// Bit vectors:
+
+// Bits are packed in 64 bit words, bits past the size are always
+// zero (so popcount and the bitwise operations can work on whole
+// words). rank and select use a directory with the number of
+// set bits before every block of P_BITS_BLOCK words, which is
+// rebuilt (only when needed) after the bits have changed:
+#define P_BITS_BLOCK 8
+
+struct p_bit_vector {
+	uint32_t flags;			// - Vector's properties (ZV_NOLOCKING)
+	zvect_index size;		// - Number of bits
+	size_t capacity;		// - Number of words allocated
+	uint64_t *words;		// - The bits
+	zvect_index *ranks;		// - Rank directory (or NULL)
+	bool ranks_valid;		// - The rank directory is up to date
+#if (ZVECT_THREAD_SAFE == 1)
+	pthread_mutex_t lock;		// - Bit vector's mutex
+#endif
+};
+
+#if (ZVECT_THREAD_SAFE == 1)
+static inline zvect_retval p_bits_lock(struct p_bit_vector *bv)
+{
+	if (locking_disabled || (bv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_lock(&(bv->lock));
+	return 1;
+}
+
+static inline void p_bits_unlock(struct p_bit_vector *bv, zvect_retval lock_owner)
+{
+	if (lock_owner)
+		mutex_unlock(&(bv->lock));
+}
+#	define P_BITS_LOCK(bv) zvect_retval lock_owner = p_bits_lock(bv)
+#	define P_BITS_UNLOCK(bv) p_bits_unlock(bv, lock_owner)
+#else
+#	define P_BITS_LOCK(bv)
+#	define P_BITS_UNLOCK(bv)
+#endif
+
+// Number of words used by "bits" bits:
+static inline size_t p_bits_words(zvect_index bits)
+{
+	return ((size_t)bits + 63) >> 6;
+}
+
+// Grows the storage to at least "bits" bits (new words are zero):
+static zvect_retval p_bits_reserve(struct p_bit_vector *bv, zvect_index bits)
+{
+	size_t needed = p_bits_words(bits);
+	if (needed <= bv->capacity)
+		return 0;
+
+	size_t new_capacity = bv->capacity ? bv->capacity : 1;
+	while (new_capacity < needed)
+		new_capacity <<= 1;
+
+	uint64_t *words = (uint64_t *)realloc(bv->words, new_capacity * sizeof(uint64_t));
+	if (words == NULL)
+		return ZVERR_OUTOFMEM;
+	memset(words + bv->capacity, 0, (new_capacity - bv->capacity) * sizeof(uint64_t));
+	bv->words = words;
+	bv->capacity = new_capacity;
+
+	return 0;
+}
+
+// Rebuilds the rank directory (if the bits have changed):
+static zvect_retval p_bits_ranks(struct p_bit_vector *bv)
+{
+	if (bv->ranks_valid)
+		return 0;
+
+	size_t nwords = p_bits_words(bv->size);
+	size_t nblocks = (nwords + P_BITS_BLOCK - 1) / P_BITS_BLOCK;
+	zvect_index *ranks = (zvect_index *)realloc(bv->ranks, (nblocks + 1) * sizeof(zvect_index));
+	if (ranks == NULL)
+		return ZVERR_OUTOFMEM;
+
+	zvect_index count = 0;
+	for (size_t b = 0; b < nblocks; b++) {
+		ranks[b] = count;
+		size_t end = ((b + 1) * P_BITS_BLOCK < nwords) ? (b + 1) * P_BITS_BLOCK : nwords;
+		for (size_t w = b * P_BITS_BLOCK; w < end; w++)
+			count += p_popcount64(bv->words[w]);
+	}
+	ranks[nblocks] = count;
+	bv->ranks = ranks;
+	bv->ranks_valid = true;
+
+	return 0;
+}
+
+bit_vector vect_create_bits(const zvect_index init_capacity, const uint32_t properties)
+{
+	zvect_retval rval = 0;
+	struct p_bit_vector *bv = (struct p_bit_vector *)calloc(1, sizeof(struct p_bit_vector));
+	if (bv == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_BITS_JOB_DONE;
+	}
+	bv->flags = properties;
+
+	rval = p_bits_reserve(bv, init_capacity ? init_capacity : 64);
+	if (rval) {
+		free(bv);
+		bv = NULL;
+		goto VECT_CREATE_BITS_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	mutex_init(&(bv->lock));
+#endif
+
+VECT_CREATE_BITS_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+
+	return bv;
+}
+
+void vect_bits_destroy(bit_vector bv)
+{
+	if (bv == NULL)
+		return;
+#if (ZVECT_THREAD_SAFE == 1)
+	mutex_destroy(&(bv->lock));
+#endif
+	free(bv->words);
+	free(bv->ranks);
+	free(bv);
+}
+
+#if (ZVECT_THREAD_SAFE == 1)
+zvect_retval vect_bits_lock(bit_vector const bv)
+{
+	return p_bits_lock(bv);
+}
+
+zvect_retval vect_bits_unlock(bit_vector const bv)
+{
+	if (locking_disabled || (bv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_unlock(&(bv->lock));
+	return 1;
+}
+#endif
+
+zvect_index vect_bits_size(bit_vector const bv)
+{
+	return (bv == NULL) ? 0 : bv->size;
+}
+
+void vect_bits_clear(bit_vector const bv)
+{
+	if (bv == NULL)
+		return;
+
+	P_BITS_LOCK(bv);
+	memset(bv->words, 0, p_bits_words(bv->size) * sizeof(uint64_t));
+	bv->size = 0;
+	bv->ranks_valid = false;
+	P_BITS_UNLOCK(bv);
+}
+
+zvect_retval vect_bits_push(bit_vector const bv, const bool bit)
+{
+	zvect_retval rval = (bv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_BITS_PUSH_JOB_DONE;
+
+	P_BITS_LOCK(bv);
+
+	if (bv->size == zvect_index_max) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_BITS_PUSH_DONE_PROCESSING;
+	}
+
+	rval = p_bits_reserve(bv, bv->size + 1);
+	if (rval)
+		goto VECT_BITS_PUSH_DONE_PROCESSING;
+
+	bv->words[bv->size >> 6] |= ((uint64_t)bit) << (bv->size & 63);
+	bv->size++;
+	bv->ranks_valid = false;
+
+VECT_BITS_PUSH_DONE_PROCESSING:
+	P_BITS_UNLOCK(bv);
+
+VECT_BITS_PUSH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+bool vect_bits_pop(bit_vector const bv)
+{
+	bool bit = false;
+	if (bv == NULL)
+		return false;
+
+	P_BITS_LOCK(bv);
+	if (bv->size) {
+		bv->size--;
+		uint64_t mask = ((uint64_t)1) << (bv->size & 63);
+		bit = (bv->words[bv->size >> 6] & mask) != 0;
+		bv->words[bv->size >> 6] &= ~mask;
+		bv->ranks_valid = false;
+	}
+	P_BITS_UNLOCK(bv);
+
+	return bit;
+}
+
+bool vect_bits_get(bit_vector const bv, const zvect_index i)
+{
+	if ((bv == NULL) || (i >= bv->size))
+		return false;
+	return (bv->words[i >> 6] >> (i & 63)) & 1;
+}
+
+zvect_retval vect_bits_set(bit_vector const bv, const zvect_index i, const bool bit)
+{
+	zvect_retval rval = (bv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_BITS_SET_JOB_DONE;
+
+	P_BITS_LOCK(bv);
+
+	if (i >= bv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_BITS_SET_DONE_PROCESSING;
+	}
+
+	uint64_t mask = ((uint64_t)1) << (i & 63);
+	bv->words[i >> 6] = bit ? (bv->words[i >> 6] | mask) : (bv->words[i >> 6] & ~mask);
+	bv->ranks_valid = false;
+
+VECT_BITS_SET_DONE_PROCESSING:
+	P_BITS_UNLOCK(bv);
+
+VECT_BITS_SET_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_index vect_bits_popcount(bit_vector const bv)
+{
+	zvect_index count = 0;
+	if (bv == NULL)
+		return 0;
+
+	P_BITS_LOCK(bv);
+	size_t nwords = p_bits_words(bv->size);
+	for (size_t w = 0; w < nwords; w++)
+		count += p_popcount64(bv->words[w]);
+	P_BITS_UNLOCK(bv);
+
+	return count;
+}
+
+// First bit equal to "bit" at index >= from (or zvect_index_max):
+static zvect_index p_bits_find(struct p_bit_vector *bv, zvect_index from, bool bit)
+{
+	zvect_index found = zvect_index_max;
+	if ((bv == NULL) || (from >= bv->size))
+		return found;
+
+	P_BITS_LOCK(bv);
+	size_t nwords = p_bits_words(bv->size);
+	const uint64_t flip = bit ? 0 : ~((uint64_t)0);
+	size_t w = from >> 6;
+	uint64_t word = (bv->words[w] ^ flip) & (~((uint64_t)0) << (from & 63));
+	for (;;) {
+		if (word) {
+			zvect_index i = (zvect_index)((w << 6) + p_ctz64(word));
+			if (i < bv->size)
+				found = i;
+			break;
+		}
+		if (++w >= nwords)
+			break;
+		word = bv->words[w] ^ flip;
+	}
+	P_BITS_UNLOCK(bv);
+
+	return found;
+}
+
+zvect_index vect_bits_find_first_set(bit_vector const bv, const zvect_index from)
+{
+	return p_bits_find(bv, from, true);
+}
+
+zvect_index vect_bits_find_first_clear(bit_vector const bv, const zvect_index from)
+{
+	return p_bits_find(bv, from, false);
+}
+
+// Bitwise operations (dst = dst op src):
+enum {
+	P_BITS_AND = 0,
+	P_BITS_OR,
+	P_BITS_XOR,
+	P_BITS_ANDNOT
+};
+
+static zvect_retval p_bits_op(struct p_bit_vector *dst, struct p_bit_vector *src, int op)
+{
+	zvect_retval rval = ((dst == NULL) || (src == NULL)) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto BITS_OP_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = p_bits_lock(dst);
+	zvect_retval lock_owner2 = (src != dst) ? p_bits_lock(src) : 0;
+#endif
+
+	if (dst->size != src->size) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto BITS_OP_DONE_PROCESSING;
+	}
+
+	// Simple loops over whole words, which the compiler turns
+	// into SIMD code:
+	uint64_t *d = dst->words;
+	const uint64_t *s = src->words;
+	size_t nwords = p_bits_words(dst->size);
+	switch (op) {
+	case P_BITS_AND:
+		for (size_t w = 0; w < nwords; w++)
+			d[w] &= s[w];
+		break;
+	case P_BITS_OR:
+		for (size_t w = 0; w < nwords; w++)
+			d[w] |= s[w];
+		break;
+	case P_BITS_XOR:
+		for (size_t w = 0; w < nwords; w++)
+			d[w] ^= s[w];
+		break;
+	default:
+		for (size_t w = 0; w < nwords; w++)
+			d[w] &= ~s[w];
+		break;
+	}
+	dst->ranks_valid = false;
+
+BITS_OP_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	p_bits_unlock(src, lock_owner2);
+	p_bits_unlock(dst, lock_owner);
+#endif
+
+BITS_OP_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_bits_and(bit_vector const dst, bit_vector const src)
+{
+	return p_bits_op(dst, src, P_BITS_AND);
+}
+
+zvect_retval vect_bits_or(bit_vector const dst, bit_vector const src)
+{
+	return p_bits_op(dst, src, P_BITS_OR);
+}
+
+zvect_retval vect_bits_xor(bit_vector const dst, bit_vector const src)
+{
+	return p_bits_op(dst, src, P_BITS_XOR);
+}
+
+zvect_retval vect_bits_andnot(bit_vector const dst, bit_vector const src)
+{
+	return p_bits_op(dst, src, P_BITS_ANDNOT);
+}
+
+zvect_index vect_bits_rank(bit_vector const bv, zvect_index i)
+{
+	zvect_index count = 0;
+	if (bv == NULL)
+		return 0;
+
+	P_BITS_LOCK(bv);
+	if (i > bv->size)
+		i = bv->size;
+	if (p_bits_ranks(bv) == 0) {
+		size_t w = i >> 6;
+		count = bv->ranks[w / P_BITS_BLOCK];
+		for (size_t k = (w / P_BITS_BLOCK) * P_BITS_BLOCK; k < w; k++)
+			count += p_popcount64(bv->words[k]);
+		if (i & 63)
+			count += p_popcount64(bv->words[w] & ((((uint64_t)1) << (i & 63)) - 1));
+	}
+	P_BITS_UNLOCK(bv);
+
+	return count;
+}
+
+zvect_index vect_bits_select(bit_vector const bv, zvect_index k)
+{
+	zvect_index found = zvect_index_max;
+	if (bv == NULL)
+		return found;
+
+	P_BITS_LOCK(bv);
+	if (p_bits_ranks(bv))
+		goto VECT_BITS_SELECT_DONE_PROCESSING;
+
+	size_t nwords = p_bits_words(bv->size);
+	size_t nblocks = (nwords + P_BITS_BLOCK - 1) / P_BITS_BLOCK;
+	if (k >= bv->ranks[nblocks])
+		goto VECT_BITS_SELECT_DONE_PROCESSING;
+
+	// Last block with less than k + 1 set bits before it:
+	size_t lo = 0, hi = nblocks - 1;
+	while (lo < hi) {
+		size_t mid = (lo + hi + 1) >> 1;
+		if (bv->ranks[mid] <= k)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	k -= bv->ranks[lo];
+
+	// Then the word and the bit in the word:
+	for (size_t w = lo * P_BITS_BLOCK; w < nwords; w++) {
+		uint64_t word = bv->words[w];
+		unsigned int c = p_popcount64(word);
+		if (k < c) {
+			while (k--)
+				word &= word - 1;
+			found = (zvect_index)((w << 6) + p_ctz64(word));
+			break;
+		}
+		k -= c;
+	}
+
+VECT_BITS_SELECT_DONE_PROCESSING:
+	P_BITS_UNLOCK(bv);
+
+	return found;
+}
+
+/*---------------------------------------------------------------------------*/
+// Variable length items vectors:
+
+// Items are stored one after the other in a single byte arena
+// and found through an array of slots (8 bytes per item). The
+// bytes of removed (or replaced) items are left in the arena as
+// garbage, until it's large enough to be worth compacting:
+#define P_VARLEN_MIN_GARBAGE 4096
+
+struct p_varlen_slot {
+	zvect_index offset;		// - Item offset in the arena
+	zvect_index len;		// - Item length (in bytes)
+};
+
+struct p_varlen_vector {
+	uint32_t flags;			// - Vector's properties (ZV_NOLOCKING)
+	zvect_index size;		// - Number of items
+	zvect_index capacity;		// - Number of slots allocated
+	struct p_varlen_slot *slots;	// - One slot per item
+	char *arena;			// - Items bytes
+	size_t arena_used;		// - Bytes used in the arena
+	size_t arena_capacity;		// - Bytes allocated for the arena
+	size_t garbage;			// - Bytes of removed items in the arena
+#if (ZVECT_THREAD_SAFE == 1)
+	pthread_mutex_t lock;		// - Varlen vector's mutex
+#endif
+};
+
+#if (ZVECT_THREAD_SAFE == 1)
+static inline zvect_retval p_varlen_lock(struct p_varlen_vector *vv)
+{
+	if (locking_disabled || (vv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_lock(&(vv->lock));
+	return 1;
+}
+
+static inline void p_varlen_unlock(struct p_varlen_vector *vv, zvect_retval lock_owner)
+{
+	if (lock_owner)
+		mutex_unlock(&(vv->lock));
+}
+#	define P_VARLEN_LOCK(vv) zvect_retval lock_owner = p_varlen_lock(vv)
+#	define P_VARLEN_UNLOCK(vv) p_varlen_unlock(vv, lock_owner)
+#else
+#	define P_VARLEN_LOCK(vv)
+#	define P_VARLEN_UNLOCK(vv)
+#endif
+
+// Grows the slots to at least "capacity" items and the arena to
+// at least "bytes" bytes:
+static zvect_retval p_varlen_reserve(struct p_varlen_vector *vv, zvect_index capacity, size_t bytes)
+{
+	if (capacity > vv->capacity) {
+		zvect_index new_capacity = vv->capacity ? vv->capacity : ZVECT_INITIAL_CAPACITY;
+		while (new_capacity < capacity)
+			new_capacity = (new_capacity > (zvect_index_max >> 1)) ? capacity : (new_capacity << 1);
+		struct p_varlen_slot *slots = (struct p_varlen_slot *)realloc(vv->slots,
+							(size_t)new_capacity * sizeof(struct p_varlen_slot));
+		if (slots == NULL)
+			return ZVERR_OUTOFMEM;
+		vv->slots = slots;
+		vv->capacity = new_capacity;
+	}
+
+	if (bytes > vv->arena_capacity) {
+		// Offsets are zvect_index, so that's also the arena limit:
+		if (bytes > (size_t)zvect_index_max)
+			return ZVERR_OUTOFMEM;
+		size_t new_capacity = vv->arena_capacity ? vv->arena_capacity : 256;
+		while (new_capacity < bytes)
+			new_capacity <<= 1;
+		if (new_capacity > (size_t)zvect_index_max)
+			new_capacity = (size_t)zvect_index_max;
+		char *arena = (char *)realloc(vv->arena, new_capacity);
+		if (arena == NULL)
+			return ZVERR_OUTOFMEM;
+		vv->arena = arena;
+		vv->arena_capacity = new_capacity;
+	}
+
+	return 0;
+}
+
+// Copies the live items to a new arena, in items order (so scans
+// read the arena sequentially again):
+static zvect_retval p_varlen_compact(struct p_varlen_vector *vv)
+{
+	if (vv->garbage == 0)
+		return 0;
+
+	size_t live = vv->arena_used - vv->garbage;
+	char *arena = (char *)malloc(live ? live : 1);
+	if (arena == NULL)
+		return ZVERR_OUTOFMEM;
+
+	zvect_index offset = 0;
+	for (zvect_index i = 0; i < vv->size; i++) {
+		struct p_varlen_slot *s = &(vv->slots[i]);
+		p_vect_memcpy(arena + offset, vv->arena + s->offset, s->len);
+		s->offset = offset;
+		offset += s->len;
+	}
+	free(vv->arena);
+	vv->arena = arena;
+	vv->arena_capacity = live ? live : 1;
+	vv->arena_used = live;
+	vv->garbage = 0;
+
+	return 0;
+}
+
+// Compacts the arena when at least half of it is garbage:
+static inline void p_varlen_auto_compact(struct p_varlen_vector *vv)
+{
+	if ((vv->garbage >= P_VARLEN_MIN_GARBAGE) && (vv->garbage >= (vv->arena_used >> 1)))
+		p_varlen_compact(vv);
+}
+
+varlen_vector vect_create_varlen(zvect_index capacity, size_t arena_capacity,
+				 const uint32_t properties)
+{
+	zvect_retval rval = 0;
+	struct p_varlen_vector *vv = (struct p_varlen_vector *)calloc(1, sizeof(struct p_varlen_vector));
+	if (vv == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_VARLEN_JOB_DONE;
+	}
+	vv->flags = properties;
+
+	rval = p_varlen_reserve(vv, capacity ? capacity : ZVECT_INITIAL_CAPACITY,
+				arena_capacity ? arena_capacity : 256);
+	if (rval) {
+		free(vv->slots);
+		free(vv);
+		vv = NULL;
+		goto VECT_CREATE_VARLEN_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	mutex_init(&(vv->lock));
+#endif
+
+VECT_CREATE_VARLEN_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+
+	return vv;
+}
+
+void vect_varlen_destroy(varlen_vector vv)
+{
+	if (vv == NULL)
+		return;
+#if (ZVECT_THREAD_SAFE == 1)
+	mutex_destroy(&(vv->lock));
+#endif
+	free(vv->slots);
+	free(vv->arena);
+	free(vv);
+}
+
+#if (ZVECT_THREAD_SAFE == 1)
+zvect_retval vect_varlen_lock(varlen_vector const vv)
+{
+	return p_varlen_lock(vv);
+}
+
+zvect_retval vect_varlen_unlock(varlen_vector const vv)
+{
+	if (locking_disabled || (vv->flags & ZV_NOLOCKING))
+		return 0;
+	mutex_unlock(&(vv->lock));
+	return 1;
+}
+#endif
+
+zvect_index vect_varlen_size(varlen_vector const vv)
+{
+	return (vv == NULL) ? 0 : vv->size;
+}
+
+size_t vect_varlen_garbage(varlen_vector const vv)
+{
+	return (vv == NULL) ? 0 : vv->garbage;
+}
+
+zvect_retval vect_add_bytes_n(varlen_vector const vv, const void * const *items,
+			      const zvect_index *lens, zvect_index count)
+{
+	zvect_retval rval = (vv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval || (count == 0))
+		goto VECT_ADD_BYTES_N_JOB_DONE;
+
+	P_VARLEN_LOCK(vv);
+
+	if ((items == NULL) || (lens == NULL) || (count > (zvect_index_max - vv->size))) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_ADD_BYTES_N_DONE_PROCESSING;
+	}
+
+	// Grow the slots and the arena only once:
+	size_t bytes = vv->arena_used;
+	for (zvect_index i = 0; i < count; i++)
+		bytes += lens[i];
+	rval = p_varlen_reserve(vv, vv->size + count, bytes);
+	if (rval)
+		goto VECT_ADD_BYTES_N_DONE_PROCESSING;
+
+	for (zvect_index i = 0; i < count; i++) {
+		struct p_varlen_slot *s = &(vv->slots[vv->size + i]);
+		s->offset = (zvect_index)vv->arena_used;
+		s->len = lens[i];
+		if (lens[i])
+			p_vect_memcpy(vv->arena + vv->arena_used, items[i], lens[i]);
+		vv->arena_used += lens[i];
+	}
+	vv->size += count;
+
+VECT_ADD_BYTES_N_DONE_PROCESSING:
+	P_VARLEN_UNLOCK(vv);
+
+VECT_ADD_BYTES_N_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_add_bytes(varlen_vector const vv, const void *item, zvect_index len)
+{
+	return vect_add_bytes_n(vv, &item, &len, 1);
+}
+
+const void *vect_get_bytes(varlen_vector const vv, zvect_index i, zvect_index *len)
+{
+	const void *item = NULL;
+	if (vv == NULL)
+		return NULL;
+
+	P_VARLEN_LOCK(vv);
+	if (i < vv->size) {
+		if (len != NULL)
+			*len = vv->slots[i].len;
+		item = vv->arena + vv->slots[i].offset;
+	}
+	P_VARLEN_UNLOCK(vv);
+
+	return item;
+}
+
+zvect_retval vect_put_bytes(varlen_vector const vv, zvect_index i, const void *item, zvect_index len)
+{
+	zvect_retval rval = (vv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_PUT_BYTES_JOB_DONE;
+
+	P_VARLEN_LOCK(vv);
+
+	if (i >= vv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_PUT_BYTES_DONE_PROCESSING;
+	}
+
+	// Items that fit in the old one's bytes are stored in place,
+	// larger ones are added at the end of the arena:
+	struct p_varlen_slot *s = &(vv->slots[i]);
+	if (len > s->len) {
+		rval = p_varlen_reserve(vv, vv->size, vv->arena_used + len);
+		if (rval)
+			goto VECT_PUT_BYTES_DONE_PROCESSING;
+		s = &(vv->slots[i]);
+		vv->garbage += s->len;
+		s->offset = (zvect_index)vv->arena_used;
+		vv->arena_used += len;
+	} else {
+		vv->garbage += s->len - len;
+	}
+	if (len)
+		p_vect_memcpy(vv->arena + s->offset, item, len);
+	s->len = len;
+
+	p_varlen_auto_compact(vv);
+
+VECT_PUT_BYTES_DONE_PROCESSING:
+	P_VARLEN_UNLOCK(vv);
+
+VECT_PUT_BYTES_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_varlen_remove_at(varlen_vector const vv, zvect_index i)
+{
+	zvect_retval rval = (vv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_VARLEN_REMOVE_AT_JOB_DONE;
+
+	P_VARLEN_LOCK(vv);
+
+	if (i >= vv->size) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_VARLEN_REMOVE_AT_DONE_PROCESSING;
+	}
+
+	vv->garbage += vv->slots[i].len;
+	p_vect_memmove(&(vv->slots[i]), &(vv->slots[i + 1]),
+		       (size_t)(vv->size - i - 1) * sizeof(struct p_varlen_slot));
+	vv->size--;
+
+	if (vv->size == 0) {
+		vv->arena_used = vv->garbage = 0;
+	} else {
+		p_varlen_auto_compact(vv);
+	}
+
+VECT_VARLEN_REMOVE_AT_DONE_PROCESSING:
+	P_VARLEN_UNLOCK(vv);
+
+VECT_VARLEN_REMOVE_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+zvect_retval vect_varlen_compact(varlen_vector const vv)
+{
+	zvect_retval rval = (vv == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_VARLEN_COMPACT_JOB_DONE;
+
+	P_VARLEN_LOCK(vv);
+	rval = p_varlen_compact(vv);
+	P_VARLEN_UNLOCK(vv);
+
+VECT_VARLEN_COMPACT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+void vect_varlen_clear(varlen_vector const vv)
+{
+	if (vv == NULL)
+		return;
+
+	P_VARLEN_LOCK(vv);
+	vv->size = vv->arena_used = vv->garbage = 0;
+	P_VARLEN_UNLOCK(vv);
+}
+
+/*---------------------------------------------------------------------------*/
+// Slot maps:
+
+// The items are stored densely in a vector (removing an item
+// moves the last one in its place), while the slots array maps
+// the stable handles to the items indexes. Handles are made of
+// the slot index (low 32 bits) and the slot generation (high 32
+// bits), which is odd while the slot is in use and is increased
+// every time the slot is used or freed (so handles of removed
+// items never match again and 0 is never a valid handle). Free
+// slots are chained in a free list:
+#define P_SLOT_NONE zvect_index_max
+
+struct p_slot {
+	uint32_t generation;		// - Odd when the slot is in use
+	zvect_index index;		// - Item index (or next free slot)
+};
+
+struct p_slot_map {
+	vector items;			// - Items (dense)
+	zvect_index *item_slot;		// - Slot of every item
+	struct p_slot *slots;		// - Slots
+	zvect_index nslots;		// - Number of slots used
+	zvect_index capacity;		// - Number of slots allocated
+	zvect_index free_head;		// - First free slot (or P_SLOT_NONE)
+};
+
+static inline zvect_handle p_slot_handle(const struct p_slot_map *sm, zvect_index s)
+{
+	return (((zvect_handle)sm->slots[s].generation) << 32) | (zvect_handle)s;
+}
+
+// Returns the slot of a live handle (or P_SLOT_NONE):
+static inline zvect_index p_slot_find(const struct p_slot_map *sm, zvect_handle h)
+{
+	zvect_index s = (zvect_index)(h & 0xFFFFFFFF);
+	if ((s >= sm->nslots) || (sm->slots[s].generation != (uint32_t)(h >> 32)) ||
+	    !(sm->slots[s].generation & 1))
+		return P_SLOT_NONE;
+	return s;
+}
+
+// Grows the slots (and the items to slots map) to "capacity":
+static zvect_retval p_slot_reserve(struct p_slot_map *sm, zvect_index capacity)
+{
+	if (capacity <= sm->capacity)
+		return 0;
+
+	zvect_index new_capacity = sm->capacity ? sm->capacity : ZVECT_INITIAL_CAPACITY;
+	while (new_capacity < capacity)
+		new_capacity = (new_capacity > (zvect_index_max >> 1)) ? capacity : (new_capacity << 1);
+
+	struct p_slot *slots = (struct p_slot *)realloc(sm->slots, (size_t)new_capacity * sizeof(struct p_slot));
+	if (slots == NULL)
+		return ZVERR_OUTOFMEM;
+	sm->slots = slots;
+	zvect_index *item_slot = (zvect_index *)realloc(sm->item_slot, (size_t)new_capacity * sizeof(zvect_index));
+	if (item_slot == NULL)
+		return ZVERR_OUTOFMEM;
+	sm->item_slot = item_slot;
+	sm->capacity = new_capacity;
+
+	return 0;
+}
+
+slot_map vect_create_slot_map(const zvect_index init_capacity, const size_t item_size,
+			      const uint32_t properties)
+{
+	zvect_retval rval = 0;
+	struct p_slot_map *sm = NULL;
+
+	// Items are moved around on removals, so circular vectors
+	// can't be used:
+	if (properties & ZV_CIRCULAR) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_CREATE_SLOT_MAP_JOB_DONE;
+	}
+
+	sm = (struct p_slot_map *)calloc(1, sizeof(struct p_slot_map));
+	if (sm == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_SLOT_MAP_JOB_DONE;
+	}
+	sm->free_head = P_SLOT_NONE;
+
+	sm->items = vect_create(init_capacity, item_size, properties);
+	if (sm->items == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_CREATE_SLOT_MAP_JOB_DONE;
+	}
+
+	rval = p_slot_reserve(sm, init_capacity ? init_capacity : ZVECT_INITIAL_CAPACITY);
+
+VECT_CREATE_SLOT_MAP_JOB_DONE:
+	if (rval && (sm != NULL)) {
+		if (sm->items != NULL)
+			vect_destroy(sm->items);
+		free(sm->slots);
+		free(sm->item_slot);
+		free(sm);
+		sm = NULL;
+	}
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+
+	return sm;
+}
+
+void vect_slot_map_destroy(slot_map sm)
+{
+	if (sm == NULL)
+		return;
+	vect_destroy(sm->items);
+	free(sm->slots);
+	free(sm->item_slot);
+	free(sm);
+}
+
+zvect_handle vect_slot_map_insert(slot_map const sm, const void *item)
+{
+	zvect_handle h = 0;
+	zvect_retval rval = (sm == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval || (item == NULL))
+		goto VECT_SLOT_MAP_INSERT_JOB_DONE;
+
+	ivector v = sm->items;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+
+	// Get a slot (from the free list, if possible):
+	zvect_index s = sm->free_head;
+	if (s == P_SLOT_NONE) {
+		if (sm->nslots == P_SLOT_NONE) {
+			rval = ZVERR_OUTOFMEM;
+			goto VECT_SLOT_MAP_INSERT_DONE_PROCESSING;
+		}
+		rval = p_slot_reserve(sm, sm->nslots + 1);
+		if (rval)
+			goto VECT_SLOT_MAP_INSERT_DONE_PROCESSING;
+		s = sm->nslots;
+		sm->slots[s].generation = 0;
+	}
+
+	// Add the item at the end of the items:
+	zvect_index i = p_vect_size(v);
+	if ( (v->end >= v->cap_right) && ((rval = p_vect_increase_capacity(v, 1)) != 0) )
+		goto VECT_SLOT_MAP_INSERT_DONE_PROCESSING;
+	rval = p_vect_add_at(v, item, i);
+	if (rval)
+		goto VECT_SLOT_MAP_INSERT_DONE_PROCESSING;
+
+	if (s == sm->free_head)
+		sm->free_head = sm->slots[s].index;
+	else
+		sm->nslots++;
+	sm->slots[s].generation++;
+	sm->slots[s].index = i;
+	sm->item_slot[i] = s;
+	h = p_slot_handle(sm, s);
+
+VECT_SLOT_MAP_INSERT_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
+#endif
+
+VECT_SLOT_MAP_INSERT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return h;
+}
+
+zvect_retval vect_slot_map_remove(slot_map const sm, const zvect_handle h)
+{
+	zvect_retval rval = (sm == NULL) ? ZVERR_VECTUNDEF : 0;
+	if (rval)
+		goto VECT_SLOT_MAP_REMOVE_JOB_DONE;
+
+	ivector v = sm->items;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+
+	zvect_index s = p_slot_find(sm, h);
+	if (s == P_SLOT_NONE) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_SLOT_MAP_REMOVE_DONE_PROCESSING;
+	}
+
+	// Move the last item in the place of the removed one (only
+	// the two pointers are swapped, nothing else is moved):
+	zvect_index i = sm->slots[s].index;
+	zvect_index last = p_vect_size(v) - 1;
+	if (i != last) {
+		void *item = v->data[v->begin + i];
+		v->data[v->begin + i] = v->data[v->begin + last];
+		v->data[v->begin + last] = item;
+		sm->item_slot[i] = sm->item_slot[last];
+		sm->slots[sm->item_slot[i]].index = i;
+#ifdef ZVECT_DMF_EXTENSIONS
+		p_hindex_invalidate(v);
+#endif
+	}
+	rval = p_vect_delete_at(v, last, 0, 1);
+
+	// Free the slot:
+	sm->slots[s].generation++;
+	sm->slots[s].index = sm->free_head;
+	sm->free_head = s;
+
+VECT_SLOT_MAP_REMOVE_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
+#endif
+
+VECT_SLOT_MAP_REMOVE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#endif
+	return rval;
+}
+
+void *vect_slot_map_get(slot_map const sm, const zvect_handle h)
+{
+	if (sm == NULL)
+		return NULL;
+
+	void *item = NULL;
+	ivector v = sm->items;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+
+	zvect_index s = p_slot_find(sm, h);
+	if (s != P_SLOT_NONE)
+		item = v->data[v->begin + sm->slots[s].index];
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
+#endif
+	return item;
+}
+
+bool vect_slot_map_contains(slot_map const sm, const zvect_handle h)
+{
+	return vect_slot_map_get(sm, h) != NULL;
+}
+
+zvect_index vect_slot_map_size(slot_map const sm)
+{
+	return (sm == NULL) ? 0 : p_vect_size(sm->items);
+}
+
+vector vect_slot_map_items(slot_map const sm)
+{
+	return (sm == NULL) ? NULL : sm->items;
+}
+
+zvect_handle vect_slot_map_handle_at(slot_map const sm, const zvect_index i)
+{
+	if ((sm == NULL) || (i >= p_vect_size(sm->items)))
+		return 0;
+	return p_slot_handle(sm, sm->item_slot[i]);
+}
+
+void vect_slot_map_clear(slot_map const sm)
+{
+	if (sm == NULL)
+		return;
+
+	ivector v = sm->items;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+
+	// Free all the slots in use (so all the handles become
+	// invalid):
+	zvect_index n = p_vect_size(v);
+	for (zvect_index i = 0; i < n; i++) {
+		zvect_index s = sm->item_slot[i];
+		sm->slots[s].generation++;
+		sm->slots[s].index = sm->free_head;
+		sm->free_head = s;
+	}
+	p_vect_clear(v);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+// Vector Data Storage functions:
+
+void vect_clear(ivector v) {
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_CLEAR_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	rval = p_vect_clear(v);
+
+//DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_CLEAR_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_set_wipefunct(ivector v, void (*f1)(const void *, size_t)) {
+	// Set custom Safe Wipe function:
+	v->SfWpFunc = f1;
+	v->status |= ZVS_CUST_WIPE_ON;
+}
+
+// Add an item at the END (top) of the vector
+void vect_push(ivector v, const void *value) {
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_PUSH_JOB_DONE;
+
+	// If the vector is circular then use vect_put_at
+	// instead:
+	if (v->flags & ZV_CIRCULAR) {
+		rval = p_vect_put_at(v, value, p_vect_size(v));
+		goto VECT_PUSH_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v)) {
+		rval = p_vect_tree_add_at(v, value, p_vect_live_size(v));
+		goto VECT_PUSH_DONE_PROCESSING;
+	}
+	if (v->flags & ZV_GAP_BUFFER) {
+		rval = p_gap_add_at(v, value, p_vect_live_size(v));
+		goto VECT_PUSH_DONE_PROCESSING;
+	}
+	p_vect_settle_locked(v);
+
+	// The very first time we do a push, if the vector is
+	// declared very small, we may need to expand its
+	// capacity on the left. This because the very first
+	// push will use index 0 and the rule in ZVector is
+	// when we use index 0 we may need to expand on the
+	// left. So let's check if we do for this vector:
+	vsize = p_vect_size(v);
+
+	// Check if we need to expand on thr right side:
+	if ( (v->end >= v->cap_right) && ((rval = p_vect_increase_capacity(v, 1)) != 0) )
+		goto VECT_PUSH_DONE_PROCESSING;
+
+	rval = p_vect_add_at(v, value, vsize);
+
+VECT_PUSH_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_PUSH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Add an item at the END of the vector
+void vect_add(ivector v, const void *value) {
+	vect_push(v, value);
+}
+
+// Add an item at position "i" of the vector
+void vect_add_at(ivector v, const void *value, const zvect_index i) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ADD_AT_JOB_DONE;
+
+	// If the vector is circular then use vect_put_at
+	// instead:
+	if (v->flags & ZV_CIRCULAR) {
+		rval = p_vect_put_at(v, value, i);
+		goto VECT_ADD_AT_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v)) {
+		rval = p_vect_tree_add_at(v, value, i);
+		goto VECT_ADD_AT_DONE_PROCESSING;
+	}
+	if (v->flags & ZV_GAP_BUFFER) {
+		rval = p_gap_add_at(v, value, i);
+		goto VECT_ADD_AT_DONE_PROCESSING;
+	}
+	p_vect_settle_locked(v);
+
+	// Check if the provided index is out of bounds:
+	if (i > p_vect_size(v))
+	{
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_ADD_AT_DONE_PROCESSING;
+	}
+
+	if (!i) {
+		// Check if we need to expand on the left side:
+		if ( (v->begin == 0 || v->cap_left <= 1) && ( (rval = p_vect_increase_capacity(v, 0)) != 0 ) )
+				goto VECT_ADD_AT_DONE_PROCESSING;
+	} else {
+		// Check if we need to expand on thr right side:
+		if ( (v->end >= v->cap_right ) && ( (rval = p_vect_increase_capacity(v, 1)) != 0 ) )
+				goto VECT_ADD_AT_DONE_PROCESSING;
+	}
+	rval = p_vect_add_at(v, value, i);
+
+VECT_ADD_AT_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_ADD_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Add an item at the FRONT of the vector
+void vect_add_front(ivector v, const void *value) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ADD_FRONT_JOB_DONE;
+
+	// If the vector is circular then use vect_put_at
+	// instead:
+	if (v->flags & ZV_CIRCULAR) {
+		rval = p_vect_put_at(v, value, 0);
+		goto VECT_ADD_FRONT_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v)) {
+		rval = p_vect_tree_add_at(v, value, 0);
+		goto VECT_ADD_FRONT_DONE_PROCESSING;
+	}
+	if (v->flags & ZV_GAP_BUFFER) {
+		rval = p_gap_add_at(v, value, 0);
+		goto VECT_ADD_FRONT_DONE_PROCESSING;
+	}
+	p_vect_settle_locked(v);
+
+	// Check if we need to expand on the left side:
+	if ( (v->begin == 0 || v->cap_left <= 1 ) && ( (rval = p_vect_increase_capacity(v, 0)) != 0 ) )
+		goto VECT_ADD_FRONT_DONE_PROCESSING;
+
+	rval = p_vect_add_at(v, value, 0);
+
+VECT_ADD_FRONT_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_ADD_FRONT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// inline implementation for all get(s):
+static inline void *p_vect_get_at(const_vector const v, const zvect_index i) {
+	// Check if passed index is out of bounds:
+	if (i >= p_vect_live_size(v))
+		p_throw_error(ZVERR_IDXOUTOFBOUND, NULL);
+
+	// Find the item in the tree (if any):
+	if (v->tree != NULL) {
+		zvect_index pos;
+		return p_tree_locate(v->tree, i, &pos)->items[pos];
+	}
+
+	// Skip the lazily deleted items (if any):
+	if (v->tombs != NULL)
+		return v->data[v->begin + p_tombs_select(v->tombs, i)];
+
+	// Skip the gap (if the item is after it):
+	if ((v->gap_len != 0) && (i >= v->gap_at))
+		return v->data[v->begin + i + v->gap_len];
+
+	// Return found element:
+	return v->data[v->begin + i];
+}
+
+void *vect_get(const_vector const v) {
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (!rval)
+		return p_vect_get_at(v, p_vect_live_size(v) - 1);
+	else
+		p_throw_error(rval, NULL);
+
+	return NULL;
+}
+
+void *vect_get_at(const_vector const v, const zvect_index i) {
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (!rval)
+		return p_vect_get_at(v, i);
+	else
+		p_throw_error(rval, NULL);
+
+	return NULL;
+}
+
+void *vect_get_front(const_vector const v) {
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (!rval)
+		return p_vect_get_at(v, 0);
+	else
+		p_throw_error(rval, NULL);
+
+	return NULL;
+}
+
+void vect_put(ivector v, const void *value) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_PUT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	rval = p_vect_put_at(v, value, p_vect_size(v) - 1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_PUT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_put_at(ivector v, const void *value, const zvect_index i) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_PUT_AT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (v->tree != NULL) {
+		rval = p_vect_tree_put_at(v, value, i);
+	} else {
+		p_vect_settle_locked(v);
+		rval = p_vect_put_at(v, value, i);
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_PUT_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_put_front(ivector v, const void *value) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_PUT_FRONT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+		rval = p_vect_put_at(v, value, 0);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_PUT_FRONT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void *vect_pop(ivector v) {
+	void *item = NULL;
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_POP_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	vsize = p_vect_size(v);
+	if (vsize != 0)
+		rval = p_vect_remove_at(v, vsize - 1, &item);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_POP_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return item;
+}
+
+void *vect_remove(ivector v) {
+	void *item = NULL;
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_REM_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	vsize = p_vect_size(v);
+	if (vsize != 0)
+		rval = p_vect_remove_at(v, vsize - 1, &item);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_REM_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return item;
+}
+
+void *vect_remove_at(ivector v, const zvect_index i) {
+	void *item = NULL;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_REM_AT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v))
+		rval = p_vect_tree_remove_range(v, i, i, &item);
+	else if (v->flags & ZV_GAP_BUFFER)
+		rval = p_gap_remove_at(v, i, &item);
+	else if (p_vect_use_tombs(v))
+		rval = p_vect_lazy_remove_at(v, i, &item);
+	else if (p_vect_size(v) != 0)
+		rval = p_vect_remove_at(v, i, &item);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_REM_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return item;
+}
+
+void *vect_remove_front(ivector v) {
+	void *item = NULL;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_REM_FRONT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	if (p_vect_size(v) != 0)
+		rval = p_vect_remove_at(v, 0, &item);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_REM_FRONT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return item;
+}
+
+// Delete an item at the END of the vector
+void vect_delete(ivector v) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_DEL_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	rval = p_vect_delete_at(v, p_vect_size(v) - 1, 0, 1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_DEL_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Delete an item at position "i" on the vector
+void vect_delete_at(ivector v, const zvect_index i) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_DEL_AT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v))
+		rval = p_vect_tree_remove_range(v, i, i, NULL);
+	else if (v->flags & ZV_GAP_BUFFER)
+		rval = p_gap_remove_at(v, i, NULL);
+	else if (p_vect_use_tombs(v))
+		rval = p_vect_lazy_remove_at(v, i, NULL);
+	else
+		rval = p_vect_delete_at(v, i, 0, 1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_DEL_AT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Delete a range of items from "first_element" to "last_element" on the vector v
+void vect_delete_range(ivector v, const zvect_index first_element,
+                       const zvect_index last_element) {
+	zvect_index end = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_DEL_RANGE_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	if (p_vect_use_tree(v)) {
+		rval = p_vect_tree_remove_range(v, first_element, last_element, NULL);
+	} else {
+		p_vect_settle_locked(v);
+		end = (last_element - first_element);
+		rval = p_vect_delete_at(v, first_element, end, 1);
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_DEL_RANGE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Delete an item at the BEGINNING of a vector v
+void vect_delete_front(ivector v) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_DEL_FRONT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	rval = p_vect_delete_at(v, 0, 0, 1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_DEL_FRONT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Compacts (now) a ZV_LAZY_DELETE vector, removing its tombstones,
+// closes the gap of a ZV_GAP_BUFFER vector or flattens the tree of a
+// ZV_TREE vector:
+void vect_compact(ivector v) {
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_COMPACT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+
+	p_vect_settle_locked(v);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_COMPACT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+// Vector Data Manipulation functions
+#ifdef ZVECT_DMF_EXTENSIONS
+
+// Number of item pointers the in place swaps and rotations buffer
+// on the stack:
+#define P_SWAP_BUF_ITEMS 128
+
+// Swaps the n item pointers in a with the ones in b (the two blocks
+// must not overlap), in chunks that fit a small buffer on the stack:
+static void p_swap_ptrs(void **a, void **b, zvect_index n) {
+	void *buf[P_SWAP_BUF_ITEMS];
+	while (n > 0) {
+		zvect_index c = (n < P_SWAP_BUF_ITEMS) ? n : P_SWAP_BUF_ITEMS;
+		p_vect_memcpy(buf, a, sizeof(void *) * c);
+		p_vect_memcpy(a, b, sizeof(void *) * c);
+		p_vect_memcpy(b, buf, sizeof(void *) * c);
+		a += c;
+		b += c;
+		n -= c;
+	}
+}
+
+// Rotates left of k positions the n item pointers in a, in place
+// and without allocating memory. Short shifts (on either side) take
+// a single move through the stack buffer, the others use the Gries
+// Mills block swaps, so every pointer is moved only a few times:
+static void p_rotate_ptrs(void **a, zvect_index n, zvect_index k) {
+	void *buf[P_SWAP_BUF_ITEMS];
+	while ((k != 0) && (k != n)) {
+		zvect_index r = n - k;
+		if (k <= P_SWAP_BUF_ITEMS) {
+			p_vect_memcpy(buf, a, sizeof(void *) * k);
+			p_vect_memmove(a, a + k, sizeof(void *) * r);
+			p_vect_memcpy(a + r, buf, sizeof(void *) * k);
+			return;
+		}
+		if (r <= P_SWAP_BUF_ITEMS) {
+			p_vect_memcpy(buf, a + k, sizeof(void *) * r);
+			p_vect_memmove(a + r, a, sizeof(void *) * k);
+			p_vect_memcpy(a, buf, sizeof(void *) * r);
+			return;
+		}
+		if (k <= r) {
+			// [A B1 B2] (|B1| = |A|) -> [B1 A B2], B1 is done:
+			p_swap_ptrs(a, a + k, k);
+			a += k;
+			n -= k;
+		} else {
+			// [A1 A2 B] (|A2| = |B|) -> [A1 B A2], A2 is done:
+			p_swap_ptrs(a + (k - r), a + k, r);
+			n -= r;
+			k -= r;
+		}
+	}
+}
+
+void vect_swap(ivector v, const zvect_index i1, const zvect_index i2) {
+	// Check parameters:
+	if (i1 == i2)
+		return;
+
+	// Prepare variables:
+	zvect_index vsize = 0;
+	void *temp = NULL;
+
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_SWP_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	// Items are moved around, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	// Check parameters:
+	vsize = p_vect_size(v);
+	if (i1 > vsize || i2 > vsize) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_SWP_DONE_PROCESSING;
+	}
+
+	// Let's swap items:
+	temp = v->data[v->begin + i2];
+	v->data[v->begin + i2] = v->data[v->begin + i1];
+	v->data[v->begin + i1] = temp;
+
+VECT_SWP_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_SWP_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_swap_range(ivector v, const zvect_index s1, const zvect_index e1,
+                     const zvect_index s2) {
+	// Check parameters:
+	if (s1 == s2)
+		return;
+
+	zvect_index vsize = 0;
+	zvect_index end = e1;
+	if (e1 != 0)
+		end = e1 - s1;
+
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_SWP_RANGE_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	// Items are moved around, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	vsize = p_vect_size(v);
+	if ((s1 + end) >= vsize || (s2 + end) >= vsize || s2 <= (s1 + end)) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_SWP_RANGE_DONE_PROCESSING;
+	}
+
+	// Let's swap items:
+	p_swap_ptrs(v->data + v->begin + s1, v->data + v->begin + s2, end + 1);
+
+VECT_SWP_RANGE_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_SWP_RANGE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_rotate_left(ivector v, zvect_index i) {
+
+	// check if the vector exists:
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ROT_LEFT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	// Items are moved around, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	// Rotate left the vector of "i" positions (in place):
+	vsize = p_vect_size(v);
+	if (vsize != 0)
+		p_rotate_ptrs(v->data + v->begin, vsize, i % vsize);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_ROT_LEFT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_rotate_right(ivector v, zvect_index i) {
+	// check if the vector exists:
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ROT_RIGHT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	// Items are moved around, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	// Rotating right of "i" positions is rotating left of the
+	// remaining ones:
+	vsize = p_vect_size(v);
+	if (vsize != 0)
+		p_rotate_ptrs(v->data + v->begin, vsize, vsize - (i % vsize));
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_ROT_RIGHT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Removes (remove = true) or keeps (remove = false) all the items
+// for which pred returns true, compacting the vector in a single
+// pass (so every item left is moved at most once):
+static zvect_index p_vect_remove_if(ivector v, bool (*pred)(const void *, void *),
+				    void *ctx, bool remove) {
+	zvect_index vsize = p_vect_size(v);
+	void **a = v->data + v->begin;
+	zvect_index r = 0;
+
+	// Skip the leading items that stay where they are:
+	while ((r < vsize) && ((*pred)(a[r], ctx) != remove))
+		r++;
+	if (r == vsize)
+		return 0;
+
+	// Items are removed in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	// The predicate is called once per item, so the first item
+	// to remove is dropped here and not tested again:
+	p_drop_item(v, a[r]);
+	zvect_index w = r;
+	for (r++; r < vsize; r++) {
+		if ((*pred)(a[r], ctx) != remove)
+			a[w++] = a[r];
+		else
+			p_drop_item(v, a[r]);
+	}
+	p_vect_compact_done(v, w, vsize);
+
+	return vsize - w;
+}
+
+zvect_index vect_remove_if(ivector v, bool (*pred)(const void *, void *), void *ctx) {
+	zvect_index removed = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_REMOVE_IF_JOB_DONE;
+
+	if ((pred == NULL) || (v->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_REMOVE_IF_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	removed = p_vect_remove_if(v, pred, ctx, true);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_REMOVE_IF_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return removed;
+}
+
+zvect_index vect_retain_if(ivector v, bool (*pred)(const void *, void *), void *ctx) {
+	zvect_index removed = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_RETAIN_IF_JOB_DONE;
+
+	if ((pred == NULL) || (v->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_RETAIN_IF_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	removed = p_vect_remove_if(v, pred, ctx, false);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_RETAIN_IF_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return removed;
+}
+
+// Removes the items equal (by f1) to the item before them:
+static zvect_index p_vect_unique(ivector v, int (*f1)(const void *, const void *)) {
+	zvect_index vsize = p_vect_size(v);
+	void **a = v->data + v->begin;
+	zvect_index r = 1;
+
+	// Skip the leading items that stay where they are:
+	while ((r < vsize) && ((*f1)(a[r - 1], a[r]) != 0))
+		r++;
+	if (r >= vsize)
+		return 0;
+
+	// Items are removed in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	zvect_index w = r;
+	for (; r < vsize; r++) {
+		if ((*f1)(a[w - 1], a[r]) != 0)
+			a[w++] = a[r];
+		else
+			p_drop_item(v, a[r]);
+	}
+	p_vect_compact_done(v, w, vsize);
+
+	return vsize - w;
+}
+
+// Removes the items equal (by eq_fn) to any item before them,
+// using a temporary hash set (a hash index of the items kept):
+static zvect_retval p_vect_unique_hash(ivector v, uint64_t (*hash_fn)(const void *),
+				       bool (*eq_fn)(const void *, const void *),
+				       zvect_index *removed) {
+	zvect_index vsize = p_vect_size(v);
+	void **a = v->data + v->begin;
+	struct p_hindex hx = { hash_fn, eq_fn, NULL, 0, 0, 0, false };
+
+	*removed = 0;
+	if (vsize < 2)
+		return 0;
+
+	zvect_retval rval = p_hindex_resize(&hx, vsize);
+	if (rval)
+		return rval;
+
+	zvect_index w = 0;
+	for (zvect_index r = 0; r < vsize; r++) {
+		void *item = a[r];
+		uint32_t hv = p_hindex_hash(&hx, item);
+		zvect_index s = hv & hx.mask;
+		bool found = false;
+		while (hx.slots[s].hash != 0) {
+			if ((hx.slots[s].hash == hv) &&
+			    (*eq_fn)(item, a[hx.slots[s].pos])) {
+				found = true;
+				break;
+			}
+			s = (s + 1) & hx.mask;
+		}
+		if (found) {
+			p_drop_item(v, item);
+		} else {
+			hx.slots[s].hash = hv;
+			hx.slots[s].pos = w;
+			a[w++] = item;
+		}
+	}
+	free(hx.slots);
+
+	if (w < vsize) {
+		// Items are removed in bulk, so the hash index must be rebuilt:
+		p_hindex_invalidate(v);
+		p_vect_compact_done(v, w, vsize);
+	}
+	*removed = vsize - w;
+
+	return 0;
+}
+
+zvect_index vect_unique(ivector v, int (*f1)(const void *, const void *)) {
+	zvect_index removed = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_UNIQUE_JOB_DONE;
+
+	if ((f1 == NULL) || (v->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_UNIQUE_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	removed = p_vect_unique(v, f1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_UNIQUE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return removed;
+}
+
+zvect_index vect_unique_hash(ivector v, uint64_t (*hash_fn)(const void *item),
+			     bool (*eq_fn)(const void *a, const void *b)) {
+	zvect_index removed = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_UNIQUE_HASH_JOB_DONE;
+
+	if ((hash_fn == NULL) || (eq_fn == NULL) || (v->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_UNIQUE_HASH_JOB_DONE;
+	}
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	rval = p_vect_unique_hash(v, hash_fn, eq_fn, &removed);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_UNIQUE_HASH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+
+	return removed;
+}
+
+#if !defined(ZVECT_COOPERATIVE)
+#ifdef TRADITIONAL_QSORT
+static inline zvect_index
+p_partition(vector v, zvect_index low, zvect_index high,
+           int (*compare_func)(const void *, const void *)) {
+	if (high >= p_vect_size(v))
+		high = p_vect_size(v) - 1;
+
+	void *pivot = v->data[v->begin + high];
+	zvect_index i = (low - 1);
+
+	for (register zvect_index j = low; j <= (high - 1); j++) {
+		// v->data[j] <= pivot
+		if ((*compare_func)(v->data[v->begin + j], pivot) <= 0)
+			vect_swap(v, ++i, j);
+	}
+
+	vect_swap(v, i + 1, high);
+	return (i + 1);
+}
+
+static void p_vect_qsort(vector v, zvect_index low, zvect_index high,
+                        int (*compare_func)(const void *, const void *)) {
+	if (low < high) {
+		zvect_index pi = p_partition(v, low, high, compare_func);
+		p_vect_qsort(v, low, pi - 1, compare_func);
+		p_vect_qsort(v, pi + 1, high, compare_func);
+	}
+}
+#endif // TRADITIONAL_QSORT
+
+#if !defined(TRADITIONAL_QSORT)
+// This is my much faster implementation of a quicksort algorithm
+// it fundamentally uses the 3 ways partitioning adapted and improved
+// to deal with arrays of pointers together with having a custom
+// compare function.
+// The pivot is the median of the first, middle and last items (so
+// ordered or almost ordered runs don't degrade to O(n^2)), items
+// pointers are swapped directly and only the smaller partition is
+// sorted recursively, so the stack depth is O(log n). Partition
+// indexes are signed, as they can go one position before l.
+static inline void p_qsort_swap(void **a, int64_t x, int64_t y) {
+	void *t = a[x];
+	a[x] = a[y];
+	a[y] = t;
+}
+
+static void p_vect_qsort(ivector v, zvect_index l, zvect_index r,
+                        int (*compare_func)(const void *, const void *)) {
+	void **a = v->data + v->begin;
+
+	while (l < r) {
+		// Move the median of three in a[r]:
+		zvect_index m = l + ((r - l) / 2);
+		if ((*compare_func)(a[m], a[l]) < 0)
+			p_qsort_swap(a, m, l);
+		if ((*compare_func)(a[r], a[l]) < 0)
+			p_qsort_swap(a, r, l);
+		if ((*compare_func)(a[m], a[r]) < 0)
+			p_qsort_swap(a, m, r);
+
+		int64_t i = (int64_t)l - 1;
+		int64_t j = r;
+		int64_t p = (int64_t)l - 1;
+		int64_t q = r;
+		int64_t k;
+		void const *ref_val = a[r];
+
+		for (;;) {
+			while ((*compare_func)(a[++i], ref_val) < 0)
+				;
+			while ((*compare_func)(ref_val, a[--j]) < 0)
+				if (j == l)
+					break;
+			if (i >= j)
+				break;
+			p_qsort_swap(a, i, j);
+			if ((*compare_func)(a[i], ref_val) == 0) {
+				p++;
+				p_qsort_swap(a, p, i);
+			}
+			if ((*compare_func)(ref_val, a[j]) == 0) {
+				q--;
+				p_qsort_swap(a, q, j);
+			}
+		}
+		p_qsort_swap(a, i, r);
+
+		// Move the items equal to the pivot in the middle:
+		j = i - 1;
+		i = i + 1;
+		for (k = l; k <= p; k++, j--)
+			p_qsort_swap(a, k, j);
+		for (k = (int64_t)r - 1; k >= q; k--, i++)
+			p_qsort_swap(a, k, i);
+
+		// Now a[l..j] < pivot and a[i..r] > pivot:
+		if ((j - (int64_t)l) < ((int64_t)r - i)) {
+			if (j > (int64_t)l)
+				p_vect_qsort(v, l, (zvect_index)j, compare_func);
+			if (i >= (int64_t)r)
+				break;
+			l = (zvect_index)i;
+		} else {
+			if (i < (int64_t)r)
+				p_vect_qsort(v, (zvect_index)i, r, compare_func);
+			if (j <= (int64_t)l)
+				break;
+			r = (zvect_index)j;
+		}
+	}
+}
+#endif // ! TRADITIONAL_QSORT
+#endif // ! ZVECT_COOPERATIVE
+
+#if defined(ZVECT_COOPERATIVE)
+// Cooperative quicksort algorithm:
+void initQSortState(cmt_state const state, int initialCapacity) {
+    state->stack = malloc(initialCapacity * sizeof(struct p_cmt_state_range));
+    state->stackSize = 0;
+    state->isInitialized = 1;
+}
+
+void freeQSortState(cmt_state const state) {
+    free(state->stack);
+    state->stackSize = 0;
+    state->stack = NULL;
+}
+
+void pushQSortRange(struct p_cmt_state_range range, cmt_state const state) {
+    if (state->stackSize >= state->stackCapacity) {
+        // Resize the stack if needed
+        state->stackCapacity *= 2;
+        state->stack = realloc(state->stack, state->stackCapacity * sizeof(struct p_cmt_state_range));
+    }
+    state->stack[state->stackSize] = range;
+    state->stackSize++;
+}
+
+struct p_cmt_state_range popQSortRange(cmt_state const state) {
+    if (state->stackSize == 0) {
+        // Handle error for empty stack or return a default value
+        struct p_cmt_state_range empty = {0, 0};
+        return empty;
+    }
+    state->stackSize--;
+    return state->stack[state->stackSize];
+}
+
+int p_qsort_is_empty(cmt_state const state) {
+    return state->stackSize == 0;
+}
+
+zvect_index partition(ivector v,
+		      zvect_index low, zvect_index high,
+		      int (*compare_func)(const void *, const void *))
+{
+    const void * const pivot = vect_get_at(v, high); // Pivot element
+    zvect_index i = (low - 1); // Index of smaller element
+
+    for (zvect_index j = low; j <= high - 1; j++) {
+        // If current element is smaller than or equal to pivot
+        if (compare_func(vect_get_at(v, j), pivot) <= 0) {
+            i++; // Increment index of smaller element
+            vect_swap(v, i, j); // Swap elements at i and j
+        }
+    }
+    vect_swap(v, i + 1, high); // Swap the pivot element with the element at i + 1
+    return (i + 1);
+}
+
+
+// Cooperative and iterative quicksort algorithm:
+void p_vect_cqsort(ivector v, cmt_state state,
+	    	   int(*compare_func)(const void *, const void *),
+	    	   zvect_index iterationLimit)
+{
+    zvect_index iterations = 0;
+    if (!state->isInitialized) {
+	initQSortState(state, p_vect_size(v) / iterationLimit );
+    }
+
+    while (!p_qsort_is_empty(state) && iterations < iterationLimit) {
+        cmt_state_range range = popQSortRange(state);
+
+        if (range.low < range.high) {
+            zvect_index pivot = partition(v, range.low, range.high, compare_func);
+
+            pushQSortRange((struct p_cmt_state_range){range.low, pivot - 1}, state);
+            pushQSortRange((struct p_cmt_state_range){pivot + 1, range.high}, state);
+
+            iterations++;
+        }
+    }
+
+    // If the function exits here, the state is automatically saved
+    // and can be used to resume in the next call.
+}
+#endif
+
+// Public quicksort function:
+// This function is a wrapper for the actual quicksort function
+// Depending on which macro is defined, it will call the:
+// traditional quicksort
+// or
+// the 3 ways partitioning quicksort
+// or
+// the cooperative quicksort
+void vect_qsort(ivector v,
+		int (*compare_func)(const void *, const void *)
+#if defined(ZVECT_COOPERATIVE)
+		, struct p_cmt_state* const state
+		, zvect_index iterationLimit
+#endif
+		)
+{
+	// Check parameters:
+	if ( compare_func == NULL )
+		return;
+
+	zvect_index vsize = 0;
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_QSORT_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	// Items are moved around, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	vsize = p_vect_size(v);
+	if (vsize <= 1)
+		goto VECT_QSORT_DONE_PROCESSING;
+
+	// Process the vector:
+#ifndef ZVECT_COOPERATIVE
+	p_vect_qsort(v, 0, vsize - 1, compare_func);
 #else
-		if (!(v->flags & ZV_BYREF)) {
-			free(v->data[base + idx]);
-			v->data[base + idx]=NULL;
-		}
+	if (iterationLimit == 0)
+	    iterationLimit = vect_size(v);
+	if (iterationLimit > vect_size(v))
+	    iterationLimit = vect_size(v);
+	if (!state->isInitialized) {
+	    initQSortState(state, vsize / iterationLimit );
+	}
+	struct p_cmt_state_range range = {0, vsize - 1};
+	pushQSortRange(range, state);
+	p_vect_cqsort(v, state, compare_func, iterationLimit);
+	freeQSortState(state);
 #endif
 
-			// move data
-#if (ZVECT_FULL_REENTRANT == 1)
-			p_vect_memmove(new_data + (base + idx), new_data + (base + (idx + 1)),
-					sizeof(void *) * (vsize - idx));
-			// Clear leftover item pointers:
-			memset(new_data[(v->begin + vsize) - 1], 0, 1);
+VECT_QSORT_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_QSORT_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
 #else
-			p_vect_memmove(v->data + (base + idx), v->data +
-				       (base + (idx + 1)),
-				       sizeof(void *) * (vsize - idx));
+	SET_ERROR(v, rval);
+#endif
+}
 
-			// Clear leftover item pointers:
-			memset(v->data[(v->begin + vsize) - 1], 0, 1);
+#ifdef TRADITIONAL_BINARY_SEARCH
+static bool p_standard_binary_search(vector v, const void *key,
+                                    zvect_index *item_index,
+                                    int (*f1)(const void *, const void *));
+#else
+static bool p_adaptive_binary_search(const_vector v, const void *key,
+                                    zvect_index *item_index,
+                                    int (*f1)(const void *, const void *),
+                                    bsearch_cursor *cursor);
 #endif
-		}
-	} else {
-		if ( base < top ) {
-			array_changed = 1;
-#if (ZVECT_FULL_REENTRANT == 1)
-			if (new_data[base] != NULL) {
-				if (!(v->flags & ZV_BYREF)) {
-					free(new_data[base]);
-				}
-				new_data[base]=NULL;
-			}
+
+/*
+ * Although if the vect_add_* doesn't belong to this group of
+ * functions, the vect_add_ordered is an exception because it
+ * requires vect_bserach and vect_qsort to be available.
+ */
+void vect_add_ordered(ivector v, const void *value,
+                      int (*f1)(const void *, const void *)) {
+	// Check parameters:
+	if (value == NULL)
+		return;
+
+	zvect_index item_index = 0;
+	zvect_index vsize = 0;
+
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ADD_ORD_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+	p_vect_settle_locked(v);
+
+	// Few tricks to make it faster:
+	vsize = p_vect_size(v);
+	if (vsize == 0) {
+		// If the vector is empty clearly we can just
+		// use vect_add and add the value normally!
+		vect_add(v, value);
+		goto VECT_ADD_ORD_DONE_PROCESSING;
+	}
+
+	if ((*f1)(value, v->data[v->begin + (vsize - 1)]) > 0) {
+		// If the compare function returns that
+		// the value passed should go after the
+		// last value in the vector, just do so!
+		vect_add(v, value);
+		goto VECT_ADD_ORD_DONE_PROCESSING;
+	}
+
+	// Ok previous checks didn't help us, so we need
+	// to get "heavy weapons" out and find where in
+	// the vector we should add "value":
+
+	// Here is another trick:
+	// I improved adaptive binary search to ALWAYS
+	// return an index (even when it doesn't find a
+	// searched item), this works for both: regular
+	// searches which will also use the bool to
+	// know if we actually found the item in that
+	// item_index or not and the vect_add_ordered
+	// which will use item_index (which will be the
+	// place where value should have been) to insert
+	// value as an ordered item :)
+#ifdef TRADITIONAL_BINARY_SEARCH
+	p_standard_binary_search(v, value, &item_index, f1);
 #else
-			if (v->data[base] != NULL) {
-				if (!(v->flags & ZV_BYREF)) {
-					free(v->data[base]);
-				}
-				v->data[base]=NULL;
-			}
+	p_adaptive_binary_search(v, value, &item_index, f1, &(v->ord_hint));
+#endif
+
+	vect_add_at(v, value, item_index);
+
+VECT_ADD_ORD_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
 #endif
+
+VECT_ADD_ORD_JOB_DONE:
+	if(rval)
+		p_throw_error(rval, NULL);
+}
+
+// Stable merge sort of an array of items pointers (tmp must have
+// room for n pointers):
+static void p_ptrs_merge_sort(void **a, void **tmp, zvect_index n,
+			      int (*f1)(const void *, const void *)) {
+	for (zvect_index width = 1; width < n; width *= 2) {
+		for (zvect_index lo = 0; lo < n - width; lo += 2 * width) {
+			zvect_index mid = lo + width;
+			zvect_index hi = (n - mid > width) ? mid + width : n;
+			// Already in order:
+			if ((*f1)(a[mid - 1], a[mid]) <= 0)
+				continue;
+			zvect_index i = lo;
+			zvect_index j = mid;
+			zvect_index k = lo;
+			while ((i < mid) && (j < hi))
+				tmp[k++] = ((*f1)(a[j], a[i]) < 0) ? a[j++] : a[i++];
+			while (i < mid)
+				tmp[k++] = a[i++];
+			while (j < hi)
+				tmp[k++] = a[j++];
+			p_vect_memcpy(a + lo, tmp + lo, sizeof(void *) * (hi - lo));
 		}
+		if (width > (n / 2))
+			break;
 	}
+}
 
-	// Reduce vector size:
-#if (ZVECT_FULL_REENTRANT == 0)
-	if (!(v->flags & ZV_BYREF) && !array_changed)
-		p_free_items(v, vsize - 1, 0);
-#else
-	if (!(v->flags & ZV_BYREF) && !array_changed)
-		for (register zvect_index j = (vsize - 1); j >= vsize; j--) {
-			if (new_data[base + j] != NULL) {
-				if (v->flags & ZV_SEC_WIPE)
-					p_item_safewipe(v, new_data[base + j]);
-				if (!(v->flags & ZV_BYREF)) {
-					free(new_data[base + j]);
-					new_data[base + j]=NULL;
-				}
+void vect_add_ordered_n(ivector v, const void *values, zvect_index count,
+			int (*f1)(const void *, const void *)) {
+	void **src = NULL;
+	zvect_index i;
+
+	// Check parameters:
+	if ((values == NULL) || (count == 0))
+		return;
+
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_ADD_ORD_N_JOB_DONE;
+
+	if ((f1 == NULL) || (v->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_ADD_ORD_N_JOB_DONE;
+	}
+
+	// Prepare the new items (copies, or the values themselves
+	// for ZV_BYREF vectors) and sort them:
+	src = (void **)malloc(sizeof(void *) * 2 * (size_t)count);
+	if (src == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_ADD_ORD_N_JOB_DONE;
+	}
+	for (i = 0; i < count; i++) {
+		const void *value = (const char *)values + ((size_t)i * v->data_size);
+		if (v->flags & ZV_BYREF) {
+			src[i] = (void *)value;
+		} else {
+			src[i] = malloc(v->data_size);
+			if (src[i] == NULL) {
+				while (i-- > 0)
+					free(src[i]);
+				rval = ZVERR_OUTOFMEM;
+				goto VECT_ADD_ORD_N_JOB_DONE;
 			}
-			if (j == (vsize - 1))
-				break;	// this is required if we are using
-					// uint and the first element is element
-					// 0, because on GCC an uint will fail
-					// then check in the for loop if j >= first
-					// in this particular case!
+			p_vect_memcpy(src[i], value, v->data_size);
+		}
+	}
+	p_ptrs_merge_sort(src, src + count, count, f1);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+#endif
+	p_vect_settle_locked(v);
+
+	// Reserve space for the new items:
+	zvect_index vsize = p_vect_size(v);
+	if ((v->end + count) > p_vect_capacity(v)) {
+		rval = p_vect_set_capacity(v, 1, (v->end + count) - v->cap_left);
+		if (rval) {
+			if (!(v->flags & ZV_BYREF))
+				for (i = 0; i < count; i++)
+					free(src[i]);
+			goto VECT_ADD_ORD_N_DONE_PROCESSING;
 		}
+	}
+
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v);
+
+	// Merge backward, from the end of the vector, so every item
+	// is moved only once (new items go after the existing items
+	// that are equal to them):
+	void **a = v->data + v->begin;
+	zvect_index j = count;
+	zvect_index w = vsize + count;
+	i = vsize;
+	while (j > 0) {
+		if ((i > 0) && ((*f1)(a[i - 1], src[j - 1]) > 0))
+			a[--w] = a[--i];
+		else
+			a[--w] = src[--j];
+	}
+	v->end += count;
+
+VECT_ADD_ORD_N_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 2);
+#endif
+
+VECT_ADD_ORD_N_JOB_DONE:
+	free(src);
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	if (v != NULL)
+		SET_ERROR(v, rval);
+#endif
+}
+
+// Sorted sets operations:
+// The result is appended to dst after reserving, once, the space
+// for the largest possible result. When one vector is much larger
+// than the other, runs of items are skipped galloping (exponential
+// search) instead of comparing them one by one.
+#define P_SET_UNION 0
+#define P_SET_INTERSECT 1
+#define P_SET_DIFFERENCE 2
+// Size ratio from which galloping is used:
+#define P_SET_GALLOP_RATIO 8
+
+// Returns the index of the first item of v, from index i (and
+// before vsize), which is not lower than key:
+static zvect_index p_set_advance(const_vector v, zvect_index i, zvect_index vsize,
+				 const void *key, int (*f1)(const void *, const void *),
+				 bool gallop) {
+	if (!gallop) {
+		while ((i < vsize) && ((*f1)(v->data[v->begin + i], key) < 0))
+			i++;
+		return i;
+	}
+
+	zvect_index step = 1;
+	zvect_index lo = i;
+	while ((step < vsize - lo) && ((*f1)(v->data[v->begin + lo + step], key) < 0)) {
+		lo += step;
+		step *= 2;
+	}
+	zvect_index hi = (step < vsize - lo) ? lo + step : vsize;
+
+	// v[lo] < key (when lo > i), v[hi] >= key, so search in (lo, hi]:
+	lo = (lo == i) ? i : lo + 1;
+	while (lo < hi) {
+		zvect_index mid = lo + ((hi - lo) / 2);
+		if ((*f1)(v->data[v->begin + mid], key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+// Appends items [from, to) of src to dst (capacity has already
+// been reserved):
+static zvect_retval p_set_emit(ivector dst, const_vector src,
+			       zvect_index from, zvect_index to) {
+	if (dst->flags & ZV_BYREF) {
+		p_vect_memcpy(dst->data + dst->end, src->data + (src->begin + from),
+			      sizeof(void *) * (to - from));
+		dst->end += (to - from);
+		return 0;
+	}
 
-	// Apply changes
-	//if (array_changed) {
-	free(v->data);
-	v->data = new_data;
-	//}
-#endif
-	if (!(v->flags & ZV_CIRCULAR)) {
-		if ( idx != 0 ) {
-			if (v->end > v->begin) {
-				v->end--;
-			} else {
-				v->end = v->begin;
-			}
+	for (zvect_index i = from; i < to; i++) {
+		void *item = malloc(dst->data_size);
+		if (item == NULL)
+			return ZVERR_OUTOFMEM;
+		p_vect_memcpy(item, src->data[src->begin + i], dst->data_size);
+		dst->data[dst->end++] = item;
+	}
+	return 0;
+}
+
+static zvect_retval p_vect_set_op(ivector dst, const_vector v1, const_vector v2,
+				  int (*f1)(const void *, const void *), int op) {
+	zvect_index n1 = p_vect_size(v1);
+	zvect_index n2 = p_vect_size(v2);
+	zvect_retval rval = 0;
+
+	// Reserve space for the largest result possible:
+	zvect_index max_out = (op == P_SET_UNION) ? n1 + n2 :
+			      (op == P_SET_INTERSECT) ? ((n1 < n2) ? n1 : n2) : n1;
+	if ((dst->end + max_out) > p_vect_capacity(dst)) {
+		rval = p_vect_set_capacity(dst, 1, (dst->end + max_out) - dst->cap_left);
+		if (rval)
+			return rval;
+	}
+
+	bool gallop = (n1 > (zvect_index)(P_SET_GALLOP_RATIO * (size_t)n2)) ||
+		      (n2 > (zvect_index)(P_SET_GALLOP_RATIO * (size_t)n1));
+	zvect_index i = 0;
+	zvect_index j = 0;
+
+	while ((i < n1) && (j < n2) && !rval) {
+		int c = (*f1)(v1->data[v1->begin + i], v2->data[v2->begin + j]);
+		if (c < 0) {
+			// Run of v1 items lower than v2[j]:
+			zvect_index k = p_set_advance(v1, i + 1, n1, v2->data[v2->begin + j], f1, gallop);
+			if (op != P_SET_INTERSECT)
+				rval = p_set_emit(dst, v1, i, k);
+			i = k;
+		} else if (c > 0) {
+			// Run of v2 items lower than v1[i]:
+			zvect_index k = p_set_advance(v2, j + 1, n2, v1->data[v1->begin + i], f1, gallop);
+			if (op == P_SET_UNION)
+				rval = p_set_emit(dst, v2, j, k);
+			j = k;
 		} else {
-			if (v->begin < v->end) {
-				v->begin++;
-			} else {
-				v->begin = v->end;
-			}
+			if (op != P_SET_DIFFERENCE)
+				rval = p_set_emit(dst, v1, i, i + 1);
+			i++;
+			j++;
 		}
-		// Check if we need to shrink vector's capacity:
-		if ((4 * vsize) < p_vect_capacity(v) )
-			p_vect_decrease_capacity(v, idx);
 	}
 
-	// All done, return control:
-	return 0;
+	if (!rval && (op != P_SET_INTERSECT) && (i < n1))
+		rval = p_set_emit(dst, v1, i, n1);
+	if (!rval && (op == P_SET_UNION) && (j < n2))
+		rval = p_set_emit(dst, v2, j, n2);
+
+	return rval;
 }
 
-// This is the inline implementation for all the "delete" methods
-static inline zvect_retval p_vect_delete_at(ivector v,
-					    const zvect_index start,
-					    const zvect_index offset,
-					    uint32_t flags)
-{
+static zvect_retval p_vect_set_public(ivector dst, const_vector v1, const_vector v2,
+				      int (*f1)(const void *, const void *), int op) {
+	// check if the vectors exist:
+	zvect_retval rval = p_vect_check(dst) | p_vect_check(v1) | p_vect_check(v2);
+	if (rval)
+		goto VECT_SET_JOB_DONE;
 
-	zvect_index vsize = p_vect_size(v);
+	// Check parameters:
+	if ((f1 == NULL) || (dst == v1) || (dst == v2) || (dst->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_SET_JOB_DONE;
+	}
 
-	// If the vector is empty just return
-	if (vsize == 0)
-		return ZVERR_VECTEMPTY;
+	// We can only use vectors with the same data_size!
+	if ((dst->data_size != v1->data_size) || (dst->data_size != v2->data_size)) {
+		rval = ZVERR_VECTDATASIZE;
+		goto VECT_SET_JOB_DONE;
+	}
+	p_vect_settle(v1);
+	p_vect_settle(v2);
 
-	// Check if the index is out of bounds:
-	if ((start + offset) > vsize)
-		return ZVERR_IDXOUTOFBOUND;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (dst->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(dst, 2);
+#endif
+	p_vect_settle_locked(dst);
 
-	uint16_t array_changed = 0;
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(dst);
 
-	// "shift" left the data of one position:
-	zvect_index tot_items = start + offset;
-#ifdef DEBUG
-	/*
-	log_msg(ZVLP_INFO, "p_vect_delete_at: start     %*u\n", 14, start);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: offset    %*u\n", 14, offset);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: tot_items %*u\n", 14, tot_items);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: v->begin  %*u\n", 14, v->begin);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: v->end    %*u\n", 14, v->end);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: vsize     %*u\n", 14, vsize);
-	log_msg(ZVLP_INFO, "p_vect_delete_at: data      %*p\n", 14, v->data);
-	*/
+	rval = p_vect_set_op(dst, v1, v2, f1, op);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(dst, 2);
 #endif
-	if ( (vsize > 1) && (start < (vsize - 1)) && (v->data != NULL) ) {
-		array_changed = 1;
-#ifdef DEBUG
-		/* for (zvect_index ptrID = start; ptrID < start + offset; ptrID++)
-		{
-				log_msg(ZVLP_INFO, "p_vect_delete_at: data ptr  %*p\n", 14, v->data + (v->begin + ptrID));
-		}*/
+
+VECT_SET_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	if (dst != NULL)
+		SET_ERROR(dst, rval);
 #endif
-		// Safe-erase items?
-		if ( flags & 1 )
-			p_free_items(v, start, offset);
 
-		// Move remaining items pointers up:
-		if ( tot_items )
-			p_vect_memmove(v->data + (v->begin + start), v->data + (v->begin + tot_items + 1),
-				sizeof(void *) * ((vsize - start) - offset));
+	return rval;
+}
 
-		// Clear leftover item pointers:
-		if ( offset && !(flags & 1))
-			memset(v->data + ((v->begin + vsize) - (offset + 1)), 0, offset);
+zvect_retval vect_set_union(ivector dst, const_vector v1, const_vector v2,
+			    int (*f1)(const void *, const void *)) {
+	return p_vect_set_public(dst, v1, v2, f1, P_SET_UNION);
+}
+
+zvect_retval vect_set_intersect(ivector dst, const_vector v1, const_vector v2,
+				int (*f1)(const void *, const void *)) {
+	return p_vect_set_public(dst, v1, v2, f1, P_SET_INTERSECT);
+}
+
+zvect_retval vect_set_difference(ivector dst, const_vector v1, const_vector v2,
+				 int (*f1)(const void *, const void *)) {
+	return p_vect_set_public(dst, v1, v2, f1, P_SET_DIFFERENCE);
+}
+
+// K-way merge:
+// A binary min-heap holds the next item of every vector still
+// being merged. Ties are broken by the vector position in the
+// array, so the merge is stable.
+struct p_merge_head {
+	const_vector v;			// - Vector being merged
+	zvect_index pos;		// - Next item to merge
+	zvect_index size;		// - Vector size
+	zvect_index id;			// - Vector position in the array
+};
+
+static inline bool p_merge_less(const struct p_merge_head *a, const struct p_merge_head *b,
+				int (*f1)(const void *, const void *)) {
+	int c = (*f1)(a->v->data[a->v->begin + a->pos], b->v->data[b->v->begin + b->pos]);
+	return (c < 0) || ((c == 0) && (a->id < b->id));
+}
+
+static void p_merge_sift_down(struct p_merge_head *heap, zvect_index n, zvect_index i,
+			      int (*f1)(const void *, const void *)) {
+	struct p_merge_head h = heap[i];
+	while (1) {
+		zvect_index c = 2 * i + 1;
+		if (c >= n)
+			break;
+		if ((c + 1 < n) && p_merge_less(&heap[c + 1], &heap[c], f1))
+			c++;
+		if (!p_merge_less(&heap[c], &h, f1))
+			break;
+		heap[i] = heap[c];
+		i = c;
 	}
+	heap[i] = h;
+}
 
-	// Reduce vector size:
-	if (!(v->flags & ZV_BYREF) && (flags & 1) && !array_changed)
-			p_free_items(v, ((vsize - 1) - offset), offset);
+zvect_retval vect_merge_sorted(ivector dst, vector const vectors[], zvect_index k,
+			       int (*f1)(const void *, const void *)) {
+	struct p_merge_head *heap = NULL;
+	zvect_index i;
 
-	// Check if we need to increment begin or decrement end
-	// depending on the direction of the "delete" (left or right)
-	if ( (start != 0) || array_changed ) {
-		if ((v->end - (offset + 1)) > v->begin) {
-			v->end -= (offset + 1);
-		} else {
-			v->end = v->begin;
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(dst);
+	if (rval)
+		goto VECT_MERGE_SORTED_JOB_DONE;
+
+	// Check parameters:
+	if ((f1 == NULL) || ((vectors == NULL) && (k > 0)) || (dst->flags & ZV_CIRCULAR)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_MERGE_SORTED_JOB_DONE;
+	}
+
+	size_t total = 0;
+	for (i = 0; i < k; i++) {
+		if ((rval = p_vect_check(vectors[i])) != 0)
+			goto VECT_MERGE_SORTED_JOB_DONE;
+		p_vect_settle(vectors[i]);
+		if (vectors[i] == dst) {
+			rval = ZVERR_OPNOTALLOWED;
+			goto VECT_MERGE_SORTED_JOB_DONE;
 		}
-	} else {
-		if ((v->begin + (offset + 1)) < v->end) {
-			v->begin += (offset + 1);
-		} else {
-			v->begin = v->end;
+		// We can only merge vectors with the same data_size!
+		if (vectors[i]->data_size != dst->data_size) {
+			rval = ZVERR_VECTDATASIZE;
+			goto VECT_MERGE_SORTED_JOB_DONE;
 		}
+		total += p_vect_size(vectors[i]);
 	}
-
-	if (v->begin == v->end)
-	{
-		v->begin = 0;
-		v->end = 0;
+	if ((dst->end + total) > zvect_index_max) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_MERGE_SORTED_JOB_DONE;
 	}
 
-	// Check if we need to shrink the vector:
-	if ((4 * vsize) < p_vect_capacity(v))
-		p_vect_decrease_capacity(v, start);
+	if (k > 0) {
+		heap = (struct p_merge_head *)malloc(sizeof(struct p_merge_head) * k);
+		if (heap == NULL) {
+			rval = ZVERR_OUTOFMEM;
+			goto VECT_MERGE_SORTED_JOB_DONE;
+		}
+	}
 
-	// All done, return control:
-	return 0;
-}
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (dst->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(dst, 2);
+#endif
+	p_vect_settle_locked(dst);
 
-/*---------------------------------------------------------------------------*/
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(dst);
 
+	// Reserve space for all the items:
+	if ((dst->end + total) > p_vect_capacity(dst)) {
+		rval = p_vect_set_capacity(dst, 1, (zvect_index)((dst->end + total) - dst->cap_left));
+		if (rval)
+			goto VECT_MERGE_SORTED_DONE_PROCESSING;
+	}
 
+	// Build the heap with the first item of every vector:
+	zvect_index n = 0;
+	for (i = 0; i < k; i++) {
+		zvect_index vsize = p_vect_size(vectors[i]);
+		if (vsize == 0)
+			continue;
+		heap[n].v = vectors[i];
+		heap[n].pos = 0;
+		heap[n].size = vsize;
+		heap[n].id = i;
+		n++;
+	}
+	for (i = n / 2; i-- > 0; )
+		p_merge_sift_down(heap, n, i, f1);
 
+	while ((n > 0) && !rval) {
+		struct p_merge_head *top = &heap[0];
 
-/*****************************************************************************
- **                            ZVector API                                  **
- *****************************************************************************/
+		// Only one vector left, copy the rest of it in one go:
+		if (n == 1) {
+			rval = p_set_emit(dst, top->v, top->pos, top->size);
+			break;
+		}
 
-/*---------------------------------------------------------------------------*/
-// Vector Size and Capacity management functions:
+		rval = p_set_emit(dst, top->v, top->pos, top->pos + 1);
+		if (++(top->pos) == top->size)
+			heap[0] = heap[--n];
+		p_merge_sift_down(heap, n, 0, f1);
+	}
 
-/*
- * Public method to request ZVector to
- * shrink a vector.
- */
-void vect_shrink(ivector v)
-{
+VECT_MERGE_SORTED_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = get_mutex_lock(v, 1);
+	if (lock_owner)
+		get_mutex_unlock(dst, 2);
 #endif
 
-	zvect_retval rval = p_vect_shrink(v);
+	free(heap);
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+VECT_MERGE_SORTED_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
-	SET_ERROR(v, rval);
+	if (dst != NULL)
+		SET_ERROR(dst, rval);
 #endif
+
+	return rval;
 }
 
-/*---------------------------------------------------------------------------*/
 
-/*---------------------------------------------------------------------------*/
-// Vector Structural Information report:
+// Searching Algorithms:
+
+#ifdef TRADITIONAL_BINARY_SEARCH
+static bool p_standard_binary_search(vector v, const void *key,
+                                    zvect_index *item_index,
+                                    int (*f1)(const void *, const void *)) {
+	zvect_index bot, top;
+
+	bot = 0;
+	top = p_vect_size(v) - 1;
+
+	while (bot < top) {
+        zvect_index mid // mid-point
+		mid = top - (top - bot) / 2;
+
+		// key < array[mid]
+		if ((*f1)(key, v->data[v->begin + mid]) < 0) {
+			top = mid - 1;
+		} else {
+			bot = mid;
+		}
+	}
+
+	// key == array[top]
+	if ((*f1)(key, v->data[v->begin + top]) == 0) {
+		*item_index = top;
+		return true;
+	}
+
+	*item_index = top;
+	return false;
+}
+#endif // TRADITIONAL_BINARY_SEARCH
+
+#ifndef TRADITIONAL_BINARY_SEARCH
+// This is my re-implementation of Igor van den Hoven's Adaptive
+// Binary Search algorithm. It has few improvements over the
+// original design, most notably the use of custom compare
+// function that makes it suitable also to search through strings
+// and other types of vectors.
+// The search hints (where the previous search ended and how far
+// it was from the one before) are kept in "cursor", which is
+// owned by the caller, so searching never writes to the vector.
+static bool p_adaptive_binary_search(const_vector v, const void *key,
+                                    zvect_index *item_index,
+                                    int (*f1)(const void *, const void *),
+                                    bsearch_cursor *cursor) {
+	zvect_index bot;
+	zvect_index top;
+	zvect_index mid;
+
+	if ((cursor->balance >= 32) || (p_vect_size(v) <= 64) ||
+	    (cursor->bottom >= p_vect_size(v))) {
+		bot = 0;
+		top = p_vect_size(v);
+		goto P_ADP_BSEARCH_MONOBOUND;
+	}
+	bot = cursor->bottom;
+	top = 32;
+
+	// the following evaluation correspond to: key >= array[bot]
+	if ((*f1)(key, v->data[v->begin + bot]) >= 0) {
+		while (1) {
+			if ((bot + top) >= p_vect_size(v)) {
+				top = p_vect_size(v) - bot;
+				break;
+			}
+			bot += top;
+
+			// the meaning of the line below is: key < array[bot]
+			if ((*f1)(key, v->data[v->begin + bot]) < 0) {
+				bot -= top;
+				break;
+			}
+			top *= 2;
+		}
+	} else {
+		while (1) {
+			if (bot < top) {
+				top = bot;
+				bot = 0;
+				break;
+			}
+			bot -= top;
+
+			// the meaning of the line below is: key >= array[bot]
+			if ((*f1)(key, v->data[v->begin + bot]) >= 0)
+				break;
+			top *= 2;
+		}
+	}
+
+P_ADP_BSEARCH_MONOBOUND:
+	while (top > 3) {
+		mid = top / 2;
+		// the meaning of the following statement is: key >= array[bot + mid]
+		if ((*f1)(key, v->data[v->begin + (bot + mid)]) >= 0)
+			bot += mid;
+		top -= mid;
+	}
 
-bool vect_is_empty(const_vector const v)
-{
-	return !p_vect_check(v) ? (p_vect_size(v) == 0) : (bool)ZVERR_VECTUNDEF;
-}
+	cursor->balance = cursor->bottom > bot ? cursor->bottom - bot : bot - cursor->bottom;
+	cursor->bottom = bot;
 
-zvect_index vect_size(const_vector const v)
-{
-	return !p_vect_check(v) ? p_vect_size(v) : 0;
-}
+	while (top) {
+		// the meaning of the following statement is: key == array[bot + --top]
+		int test = (*f1)(key, v->data[v->begin + (bot + (--top))]);
+		if (test == 0) {
+			*item_index = bot + top;
+			return true;
+		} else if (test > 0) {
+			*item_index = bot + (top + 1);
+			return false;
+		}
+	}
 
-zvect_index vect_max_size(const_vector const v)
-{
-	return (!p_vect_check(v) ? zvect_index_max : 0);
+	*item_index = bot + top;
+	return false;
 }
+#endif // ADAPTIVE TRADITIONAL_BINARY_SEARCH
 
-void *vect_begin(const_vector const v)
-{
-	return !p_vect_check(v) ? v->data[v->begin] : NULL;
-}
+static bool p_vect_bsearch(const_vector v, const void *key,
+			   int (*f1)(const void *, const void *),
+			   bsearch_cursor *cursor, zvect_index *item_index) {
+	zvect_index vsize = p_vect_size(v);
 
-void *vect_end(const_vector const v)
-{
-	return !p_vect_check(v) ? v->data[v->end] : NULL;
-}
+	// First case (vector is empty, so we can't search):
+	if (vsize == 0)
+		return false;
 
-/*---------------------------------------------------------------------------*/
+	// Second case (vector has only 1 item, so we can't search):
+	if (vsize == 1)
+		return ((*f1)(key, v->data[v->begin]) == 0);
 
-/*---------------------------------------------------------------------------*/
-// Vector Creation and Destruction:
+#ifdef TRADITIONAL_BINARY_SEARCH
+	UNUSED(cursor);
+	if (p_standard_binary_search(v, key, item_index, f1))
+		return true;
+#else
+	if (p_adaptive_binary_search(v, key, item_index, f1, cursor))
+		return true;
+#endif // TRADITIONAL_BINARY_SEARCH
 
-vector vect_create(const zvect_index init_capacity, const size_t item_size,
-                   const uint32_t properties) {
-	// If ZVector has not been initialised yet, then initialise it
-	// when creating the first vector:
-	if (p_init_state == 0)
-		p_init_zvect();
+	*item_index = 0;
+	return false;
+}
 
-	// Create the vector first:
-	vector v = (vector)malloc(sizeof(struct p_vector));
-	if (v == NULL)
-		p_throw_error(ZVERR_OUTOFMEM, NULL);
+bool vect_bsearch(ivector v, const void *key,
+                  int (*f1)(const void *, const void *),
+                  zvect_index *item_index) {
+	*item_index = 0;
 
-	// Initialize the vector:
-	v->end = 0;
-	if (item_size == 0)
-		v->data_size = ZVECT_DEFAULT_DATA_SIZE;
-	else
-		v->data_size = item_size;
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL))
+		return false;
 
-	zvect_index capacity = init_capacity;
-	if (init_capacity == 0)
-	{
-		v->cap_left = ZVECT_INITIAL_CAPACITY / 2;
-		v->cap_right= ZVECT_INITIAL_CAPACITY / 2;
-	} else {
-		if (init_capacity <= 4)
-			capacity = 4;
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_BSEARCH_JOB_DONE;
 
-		v->cap_left = capacity / 2;
-		v->cap_right= capacity / 2;
-	}
-	v->begin = v->end = 0;
+	// Search the tree (if any) without flattening it:
+	bool found = false;
+	if (p_vect_tree_search(v, key, f1, true, item_index, &found))
+		return found;
+	p_vect_settle(v);
 
-	v->init_capacity = v->cap_left + v->cap_right;
-	v->flags = properties;
-	v->SfWpFunc = NULL;
-	v->status = 0;
-	if (v->flags & ZV_CIRCULAR)
-	{
-		// If the vector is circular then
-		// we need to pre-allocate all the elements
-		// the vector will not grow:
-		v->end = v->cap_right - 1;
-		v->begin = v->cap_left - 1;
-	}
-#ifdef ZVECT_DMF_EXTENSIONS
-	v->balance = v->bottom = 0;
-#endif // ZVECT_DMF_EXTENSIONS
+	// No hints available, so start with a full search:
+	bsearch_cursor cursor = { 0, 32 };
 
-	v->data = NULL;
+	return p_vect_bsearch(v, key, f1, &cursor, item_index);
 
-#if (ZVECT_THREAD_SAFE == 1)
-	v->lock_type = 0;
-	mutex_init(&(v->lock));
-	mutex_cond_init(&(v->cond));
-	semaphore_init(&(v->semaphore), 0);
+VECT_BSEARCH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
 #endif
 
-	// Allocate memory for the vector storage area
-	v->data = (void **)calloc(p_vect_capacity(v), sizeof(void *));
-	if (v->data == NULL)
-		p_throw_error(ZVERR_OUTOFMEM, NULL);
-
-	// Return the vector to the user:
-	return v;
+	return false;
 }
 
-void *vect_destroy(vector v) {
-	// Call p_vect_destroy with flags set to 1
-	// to destroy data according to the vector
-	// properties:
+bool vect_bsearch_hint(ivector v, const void *key,
+		       int (*f1)(const void *, const void *),
+		       bsearch_cursor *cursor, zvect_index *item_index) {
+	*item_index = 0;
+
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL) || (cursor == NULL))
+		return false;
+
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_DESTROY_JOB_DONE;
+		goto VECT_BSEARCH_HINT_JOB_DONE;
+	p_vect_settle(v);
 
-	rval = p_vect_destroy(v, 1);
+	return p_vect_bsearch(v, key, f1, cursor, item_index);
 
-VECT_DESTROY_JOB_DONE:
+VECT_BSEARCH_HINT_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -1701,227 +8528,400 @@ VECT_DESTROY_JOB_DONE:
 	SET_ERROR(v, rval);
 #endif
 
-	return NULL;
+	return false;
 }
 
-/*---------------------------------------------------------------------------*/
+// Batch Binary Search:
+// Sorted probe keys are searched by galloping forward from
+// where the previous key was found, unsorted probe keys are
+// searched a group at a time, interleaving the steps of the
+// searches so the cache misses of one search are hidden by
+// the work done on the others.
+#if (ZVECT_COMPTYPE == 1)
+#define P_PREFETCH(x) __builtin_prefetch(x)
+#else
+#define P_PREFETCH(x)
+#endif
+
+// Number of searches interleaved:
+#define P_BSEARCH_LANES 16
+// Number of keys after which the search method is re-evaluated:
+#define P_BSEARCH_BLOCK 256
+
+// Returns the first index in [first, first + count) whose item is
+// not lower than key, or first + count if there is no such item:
+static inline zvect_index p_lower_bound(const_vector v, const void *key,
+				       int (*f1)(const void *, const void *),
+				       zvect_index first, zvect_index count) {
+	if (count == 0)
+		return first;
+
+	void * const *items = v->data + v->begin;
+	zvect_index base = first;
+	while (count > 1) {
+		zvect_index half = count / 2;
+		if ((*f1)(key, items[base + half]) > 0)
+			base += half;
+		count -= half;
+	}
+	return base + ((*f1)(key, items[base]) > 0);
+}
 
-/*---------------------------------------------------------------------------*/
-// Vector Thread Safe user functions:
+// Galloping search starting from the lower bound of the previous
+// key (prev). Returns the lower bound of key and sets *backward
+// when key is lower than the previous one:
+static zvect_index p_gallop_lower_bound(const_vector v, const void *key,
+				       int (*f1)(const void *, const void *),
+				       zvect_index prev, bool *backward) {
+	void * const *items = v->data + v->begin;
+	zvect_index vsize = p_vect_size(v);
 
-#if (ZVECT_THREAD_SAFE == 1)
-void vect_lock_enable(void) {
-	locking_disabled = false;
-}
+	*backward = false;
+	if ((prev < vsize) && ((*f1)(key, items[prev]) <= 0)) {
+		// key <= array[prev], check if it's still the same slot:
+		if ((prev == 0) || ((*f1)(key, items[prev - 1]) > 0))
+			return prev;
+		*backward = true;
+		return p_lower_bound(v, key, f1, 0, prev - 1);
+	}
+	if (prev >= vsize) {
+		if ((*f1)(key, items[vsize - 1]) > 0)
+			return vsize;
+		*backward = true;
+		return p_lower_bound(v, key, f1, 0, vsize - 1);
+	}
 
-void vect_lock_disable(void) {
-	locking_disabled = true;
+	// key > array[prev], gallop forward:
+	zvect_index lo = prev;
+	zvect_index step = 1;
+	while ((step < vsize - lo) && ((*f1)(key, items[lo + step]) > 0)) {
+		lo += step;
+		step *= 2;
+	}
+	zvect_index hi = (step < vsize - lo) ? lo + step : vsize;
+	return p_lower_bound(v, key, f1, lo + 1, hi - (lo + 1));
 }
 
-static inline zvect_retval p_vect_lock(ivector v) {
-	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 3);
-}
+// Interleaved search of up to P_BSEARCH_LANES keys at once, all the
+// searches walk the same number of levels, so at every level the
+// pointers array slot and then the item of each search can be
+// prefetched before comparing them:
+static void p_interleaved_lower_bound(const_vector v, const void * const *keys,
+				      zvect_index nkeys,
+				      int (*f1)(const void *, const void *),
+				      zvect_index *out_idx) {
+	void * const *items = v->data + v->begin;
+	zvect_index base[P_BSEARCH_LANES];
+	zvect_index count = p_vect_size(v);
+	zvect_index j;
 
-zvect_retval vect_lock(ivector v) {
-	return p_vect_lock(v);
-}
+	for (j = 0; j < nkeys; j++)
+		base[j] = 0;
 
-static inline zvect_retval p_vect_unlock(ivector v) {
-	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_unlock(v, 3);
-}
+	while (count > 1) {
+		zvect_index half = count / 2;
+		for (j = 0; j < nkeys; j++)
+			P_PREFETCH(items[base[j] + half]);
+		for (j = 0; j < nkeys; j++) {
+			if ((*f1)(keys[j], items[base[j] + half]) > 0)
+				base[j] += half;
+		}
+		count -= half;
+		if (count > 1) {
+			for (j = 0; j < nkeys; j++)
+				P_PREFETCH(&items[base[j] + (count / 2)]);
+		}
+	}
 
-zvect_retval vect_unlock(ivector v) {
-	return p_vect_unlock(v);
+	for (j = 0; j < nkeys; j++)
+		out_idx[j] = base[j] + ((*f1)(keys[j], items[base[j]]) > 0);
 }
 
-static inline zvect_retval p_vect_trylock(ivector v) {
-	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : check_mutex_trylock(v, 3);
-}
+zvect_index vect_bsearch_batch(ivector v, const void * const *keys, zvect_index nkeys,
+			       int (*f1)(const void *, const void *),
+			       zvect_index *out_idx) {
+	zvect_index found = 0;
 
-zvect_retval vect_trylock(ivector v) {
-	return p_vect_trylock(v);
-}
+	// Check parameters:
+	if ((keys == NULL) || (f1 == NULL) || (out_idx == NULL) || (nkeys == 0))
+		return 0;
 
-zvect_retptr vect_sem_wait(ivector v) {
-#if !defined(macOS)
-	return (zvect_retptr)sem_wait(&(v->semaphore));
-#else
-	return (zvect_retptr)dispatch_semaphore_wait(v->semaphore, DISPATCH_TIME_FOREVER);
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_BSEARCH_BATCH_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
-}
+	p_vect_settle_locked(v);
 
-zvect_retptr vect_sem_post(ivector v) {
-#	if !defined(macOS)
-	return (zvect_retptr)sem_post(&(v->semaphore));
-#	else
-	return (zvect_retptr)dispatch_semaphore_signal(v->semaphore);
-#	endif
-}
+	zvect_index vsize = p_vect_size(v);
+	void * const *items = v->data + v->begin;
+	zvect_index prev = 0;
+	bool gallop = true;
+	zvect_index i = 0;
+
+	while ((i < nkeys) && (vsize > 0)) {
+		zvect_index block_end = (nkeys - i > P_BSEARCH_BLOCK) ? i + P_BSEARCH_BLOCK : nkeys;
+		zvect_index descents = 0;
+		zvect_index block_start = i;
+
+		if (gallop) {
+			for (; i < block_end; i++) {
+				bool backward;
+				prev = p_gallop_lower_bound(v, keys[i], f1, prev, &backward);
+				out_idx[i] = prev;
+				descents += backward;
+			}
+		} else {
+			for (; i < block_end; i += P_BSEARCH_LANES) {
+				zvect_index n = (block_end - i > P_BSEARCH_LANES) ? P_BSEARCH_LANES : block_end - i;
+				p_interleaved_lower_bound(v, keys + i, n, f1, out_idx + i);
+			}
+			for (zvect_index j = block_start + 1; j < block_end; j++)
+				descents += (out_idx[j] < out_idx[j - 1]);
+			prev = out_idx[block_end - 1];
+		}
 
-/*
-TODO: Implement this function:
+		// Keys that go backward more than a few times are not
+		// sorted, so galloping would be slower than searching
+		// from scratch:
+		gallop = (descents <= (block_end - block_start) / 16);
+	}
 
-static inline zvect_retval p_vect_wait_for_signal(const vector v) {
-    	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 1 : wait_for_signal(v, 3);
-}
+	// Turn lower bounds into results:
+	for (i = 0; i < nkeys; i++) {
+		if ((vsize > 0) && (out_idx[i] < vsize) && ((*f1)(keys[i], items[out_idx[i]]) == 0)) {
+			found++;
+		} else {
+			out_idx[i] = zvect_index_max;
+		}
+	}
 
-and also:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
 
-inline zvect_retval vect_wait_for_signal(const vector v) {
-    	return p_vect_wait_for_signal(v);
-}
-*/
+VECT_BSEARCH_BATCH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
 
-static inline zvect_retval p_vect_lock_after_signal(ivector v) {
-    	return (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 1 : lock_after_signal(v, 3);
+	return found;
 }
 
-zvect_retval vect_lock_after_signal(ivector v) {
-	return p_vect_lock_after_signal(v);
-}
+// Static search index (Eytzinger layout):
+// keys[1..n] holds the extracted keys in the order of a breadth
+// first visit of the (implicit) binary search tree, so the nodes
+// searched first share the same few cache lines, and pos[k] is
+// the index in the vector of the item keys[k] came from.
+// keys[] is 64 bytes aligned, so the 8 descendants of node k 3
+// levels below it (8k .. 8k + 7) are in a single cache line.
+#define P_INDEX_ALIGN 64
+
+struct p_search_index {
+	uint64_t *keys;			// - Keys in Eytzinger order (1 based)
+	zvect_index *pos;		// - Items indexes (1 based)
+	zvect_index size;		// - Number of keys
+	void *keys_mem;			// - Memory allocated for keys
+};
 
-zvect_retval vect_send_signal(ivector v) {
-	return send_signal(v, 3);
+// Fills the index with an in-order visit of the implicit tree,
+// which reads the vector items sequentially. Returns the next
+// vector item to read:
+static zvect_index p_index_fill(struct p_search_index *si, const_vector v,
+				uint64_t (*key_extractor)(const void *item),
+				zvect_index i, zvect_index k) {
+	if (k <= si->size) {
+		i = p_index_fill(si, v, key_extractor, i, 2 * k);
+		si->keys[k] = (*key_extractor)(v->data[v->begin + i]);
+		si->pos[k] = i++;
+		i = p_index_fill(si, v, key_extractor, i, 2 * k + 1);
+	}
+	return i;
 }
 
-zvect_retval vect_broadcast_signal(ivector v) {
-	return broadcast_signal(v, 3);
+void vect_index_destroy(search_index si) {
+	if (si == NULL)
+		return;
+	free(si->keys_mem);
+	free(si->pos);
+	free(si);
 }
 
-#endif
-
-/*---------------------------------------------------------------------------*/
+search_index vect_index_build(ivector v,
+			      uint64_t (*key_extractor)(const void *item)) {
+	struct p_search_index *si = NULL;
 
-/*---------------------------------------------------------------------------*/
-// Vector Data Storage functions:
+	// Check parameters:
+	if (key_extractor == NULL)
+		return NULL;
 
-void vect_clear(ivector v) {
 	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_CLEAR_JOB_DONE;
+		goto VECT_INDEX_BUILD_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
+
+	zvect_index vsize = p_vect_size(v);
+	zvect_index i;
+
+	// The vector must be ordered by key:
+	for (i = 1; i < vsize; i++) {
+		if ((*key_extractor)(v->data[v->begin + i - 1]) >
+		    (*key_extractor)(v->data[v->begin + i])) {
+			rval = ZVERR_OPNOTALLOWED;
+			goto VECT_INDEX_BUILD_DONE_PROCESSING;
+		}
+	}
+
+	si = (struct p_search_index *)calloc(1, sizeof(struct p_search_index));
+	if (si == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_INDEX_BUILD_DONE_PROCESSING;
+	}
+	si->size = vsize;
+	si->keys_mem = malloc(sizeof(uint64_t) * ((size_t)vsize + 1) + P_INDEX_ALIGN);
+	si->pos = (zvect_index *)malloc(sizeof(zvect_index) * ((size_t)vsize + 1));
+	if ((si->keys_mem == NULL) || (si->pos == NULL)) {
+		vect_index_destroy(si);
+		si = NULL;
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_INDEX_BUILD_DONE_PROCESSING;
+	}
+	si->keys = (uint64_t *)(((uintptr_t)si->keys_mem + (P_INDEX_ALIGN - 1)) &
+				~(uintptr_t)(P_INDEX_ALIGN - 1));
 
-	rval = p_vect_clear(v);
+	p_index_fill(si, v, key_extractor, 0, 1);
 
-//DONE_PROCESSING:
+VECT_INDEX_BUILD_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_CLEAR_JOB_DONE:
+VECT_INDEX_BUILD_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
 	SET_ERROR(v, rval);
 #endif
+
+	return si;
 }
 
-void vect_set_wipefunct(ivector v, void (*f1)(const void *, size_t)) {
-	// Set custom Safe Wipe function:
-	v->SfWpFunc = f1;
-	v->status |= ZVS_CUST_WIPE_ON;
+bool vect_index_find(search_index si, uint64_t key, zvect_index *item_index) {
+	*item_index = 0;
+
+	if ((si == NULL) || (si->size == 0))
+		return false;
+
+	const uint64_t *keys = si->keys;
+	zvect_index n = si->size;
+	zvect_index k = 1;
+
+	// Branchless descent, prefetching the cache line 3 levels
+	// below the current node:
+	while (k <= n) {
+		P_PREFETCH(keys + 8 * (size_t)k);
+		k = 2 * k + (keys[k] < key);
+	}
+
+	// Go back to the last node where we turned left, that's
+	// the first key not lower than "key":
+	k >>= p_ctz32(~k) + 1;
+
+	if ((k == 0) || (keys[k] != key))
+		return false;
+
+	*item_index = si->pos[k];
+	return true;
 }
 
-// Add an item at the END (top) of the vector
-void vect_push(ivector v, const void *value) {
-	zvect_index vsize = 0;
+// Hash index:
+zvect_retval vect_hindex_create(ivector v, uint64_t (*hash_fn)(const void *item),
+				bool (*eq_fn)(const void *key, const void *item)) {
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_PUSH_JOB_DONE;
+		goto VECT_HINDEX_CREATE_JOB_DONE;
 
-	// If the vector is circular then use vect_put_at
-	// instead:
-	if (v->flags & ZV_CIRCULAR) {
-		rval = p_vect_put_at(v, value, p_vect_size(v));
-		goto VECT_PUSH_JOB_DONE;
+	// Check parameters:
+	if ((hash_fn == NULL) || (eq_fn == NULL)) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_HINDEX_CREATE_JOB_DONE;
 	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	// The very first time we do a push, if the vector is
-	// declared very small, we may need to expand its
-	// capacity on the left. This because the very first
-	// push will use index 0 and the rule in ZVector is
-	// when we use index 0 we may need to expand on the
-	// left. So let's check if we do for this vector:
-	vsize = p_vect_size(v);
-
-	// Check if we need to expand on thr right side:
-	if ( (v->end >= v->cap_right) && ((rval = p_vect_increase_capacity(v, 1)) != 0) )
-		goto VECT_PUSH_DONE_PROCESSING;
+	struct p_hindex *hx = v->hindex;
+	if (hx == NULL) {
+		hx = (struct p_hindex *)calloc(1, sizeof(struct p_hindex));
+		if (hx == NULL) {
+			rval = ZVERR_OUTOFMEM;
+			goto VECT_HINDEX_CREATE_DONE_PROCESSING;
+		}
+	}
+	hx->hash_fn = hash_fn;
+	hx->eq_fn = eq_fn;
 
-	rval = p_vect_add_at(v, value, vsize);
+	rval = p_hindex_rebuild(v, hx);
+	if (rval) {
+		p_hindex_free(hx);
+		hx = NULL;
+	}
+	v->hindex = hx;
 
-VECT_PUSH_DONE_PROCESSING:
+VECT_HINDEX_CREATE_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_PUSH_JOB_DONE:
+VECT_HINDEX_CREATE_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
 	SET_ERROR(v, rval);
 #endif
-}
 
-// Add an item at the END of the vector
-void vect_add(ivector v, const void *value) {
-	vect_push(v, value);
+	return rval;
 }
 
-// Add an item at position "i" of the vector
-void vect_add_at(ivector v, const void *value, const zvect_index i) {
+void vect_hindex_destroy(ivector v) {
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_ADD_AT_JOB_DONE;
-
-	// If the vector is circular then use vect_put_at
-	// instead:
-	if (v->flags & ZV_CIRCULAR) {
-		rval = p_vect_put_at(v, value, i);
-		goto VECT_ADD_AT_JOB_DONE;
-	}
+		goto VECT_HINDEX_DESTROY_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	// Check if the provided index is out of bounds:
-	if (i > p_vect_size(v))
-	{
-		rval = ZVERR_IDXOUTOFBOUND;
-		goto VECT_ADD_AT_DONE_PROCESSING;
-	}
-
-	if (!i) {
-		// Check if we need to expand on the left side:
-		if ( (v->begin == 0 || v->cap_left <= 1) && ( (rval = p_vect_increase_capacity(v, 0)) != 0 ) )
-				goto VECT_ADD_AT_DONE_PROCESSING;
-	} else {
-		// Check if we need to expand on thr right side:
-		if ( (v->end >= v->cap_right ) && ( (rval = p_vect_increase_capacity(v, 1)) != 0 ) )
-				goto VECT_ADD_AT_DONE_PROCESSING;
-	}
-	rval = p_vect_add_at(v, value, i);
+	p_hindex_free(v->hindex);
+	v->hindex = NULL;
 
-VECT_ADD_AT_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_ADD_AT_JOB_DONE:
+VECT_HINDEX_DESTROY_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -1930,214 +8930,353 @@ VECT_ADD_AT_JOB_DONE:
 #endif
 }
 
-// Add an item at the FRONT of the vector
-void vect_add_front(ivector v, const void *value) {
+bool vect_hindex_find(ivector v, const void *key, zvect_index *item_index) {
+	bool found = false;
+	*item_index = 0;
+
+	// Check parameters:
+	if (key == NULL)
+		return false;
+
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_ADD_FRONT_JOB_DONE;
+		goto VECT_HINDEX_FIND_JOB_DONE;
 
-	// If the vector is circular then use vect_put_at
-	// instead:
-	if (v->flags & ZV_CIRCULAR) {
-		rval = p_vect_put_at(v, value, 0);
-		goto VECT_ADD_FRONT_JOB_DONE;
+	if (v->hindex == NULL) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_HINDEX_FIND_JOB_DONE;
 	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	// Check if we need to expand on the left side:
-	if ( (v->begin == 0 || v->cap_left <= 1 ) && ( (rval = p_vect_increase_capacity(v, 0)) != 0 ) )
-		goto VECT_ADD_FRONT_DONE_PROCESSING;
+	struct p_hindex *hx = v->hindex;
+	if (hx->dirty) {
+		rval = p_hindex_rebuild(v, hx);
+		if (rval)
+			goto VECT_HINDEX_FIND_DONE_PROCESSING;
+	}
 
-	rval = p_vect_add_at(v, value, 0);
+	// Walk the whole probe sequence, so that the lowest index
+	// is returned when more items match the key:
+	uint32_t hv = p_hindex_hash(hx, key);
+	zvect_index vsize = p_vect_size(v);
+	for (zvect_index s = hv & hx->mask; hx->slots[s].hash != 0; s = (s + 1) & hx->mask) {
+		if (hx->slots[s].hash != hv)
+			continue;
+		zvect_index idx = hx->slots[s].pos - hx->bias;
+		if ((idx < vsize) && (!found || (idx < *item_index)) &&
+		    (*(hx->eq_fn))(key, v->data[v->begin + idx])) {
+			*item_index = idx;
+			found = true;
+		}
+	}
 
-VECT_ADD_FRONT_DONE_PROCESSING:
+VECT_HINDEX_FIND_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_ADD_FRONT_JOB_DONE:
+VECT_HINDEX_FIND_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
 	SET_ERROR(v, rval);
 #endif
+
+	return found;
 }
 
-// inline implementation for all get(s):
-static inline void *p_vect_get_at(const_vector const v, const zvect_index i) {
-	// Check if passed index is out of bounds:
-	if (i >= p_vect_size(v))
-		p_throw_error(ZVERR_IDXOUTOFBOUND, NULL);
+// Traditional Linear Search Algorithm,
+// useful with non-sorted vectors:
+#if !defined(ZVECT_COOPERATIVE)
+bool vect_lsearch(ivector v, const void *key,
+                  int (*f1)(const void *, const void *),
+                  zvect_index *item_index) {
+	*item_index = 0;
 
-	// Return found element:
-	return v->data[v->begin + i];
-}
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL) || (p_vect_live_size(v) == 0))
+		return false;
+
+	zvect_index vsize = 0;
 
-void *vect_get(const_vector const v) {
 	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
-	if (!rval)
-		return p_vect_get_at(v, p_vect_size(v) - 1);
-	else
-		p_throw_error(rval, NULL);
+	if (rval)
+		goto VECT_LSEARCH_JOB_DONE;
 
-	return NULL;
-}
+	// Search the tree (if any) without flattening it:
+	bool found = false;
+	if (p_vect_tree_search(v, key, f1, false, item_index, &found))
+		return found;
+	p_vect_settle(v);
 
-void *vect_get_at(const_vector const v, const zvect_index i) {
-	// check if the vector exists:
-	zvect_retval rval = p_vect_check(v);
-	if (!rval)
-		return p_vect_get_at(v, i);
-	else
-		p_throw_error(rval, NULL);
+	// TODO: Add mutex locking
+	vsize = p_vect_size(v);
 
-	return NULL;
-}
+	// First case (vector is empty, so we can't search):
+	if (vsize == 0)
+		goto VECT_LSEARCH_JOB_DONE;
 
-void *vect_get_front(const_vector const v) {
-	// check if the vector exists:
-	zvect_retval rval = p_vect_check(v);
-	if (!rval)
-		return p_vect_get_at(v, 0);
-	else
+	// Second case (vector has only 1 item, so we can't search):
+	if (vsize == 1) {
+		if ((*f1)(key, v->data[v->begin]) != 0) {
+			*item_index = 0;
+			return true;
+		} else {
+			goto VECT_LSEARCH_JOB_DONE;
+		}
+	}
+
+	// Check if we can do unrolled search:
+	if ( (vsize & 3) == 0 ) {
+		// Nice, we can do some unrolled search
+		// to speed up the process:
+		for (register zvect_index x=0; x<vsize; x+=4) {
+			if ((*f1)(key, v->data[v->begin + x]) != 0) {
+				*item_index = x;
+				return true;
+			}
+			if ((*f1)(key, v->data[v->begin + (x+1)]) != 0) {
+				*item_index = x + 1;
+				return true;
+			}
+			if ((*f1)(key, v->data[v->begin + (x+2)]) != 0) {
+				*item_index = x + 2;
+				return true;
+			}
+			if ((*f1)(key, v->data[v->begin + (x+3)]) != 0) {
+				*item_index = x + 3;
+				return true;
+			}
+		}
+	} else {
+		// We can't do unrolled search, so let's
+		// do a normal linear search:
+		for (register zvect_index x=0; x<vsize; x++) {
+			if ((*f1)(key, v->data[v->begin + x]) != 0) {
+				*item_index = x;
+				return true;
+			}
+		}
+	}
+
+VECT_LSEARCH_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
 		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
 
-	return NULL;
+	*item_index = 0;
+	return false;
 }
+#endif // TRADITIONAL_LINEAR_SEARCH
 
-void vect_put(ivector v, const void *value) {
+#if defined(ZVECT_COOPERATIVE)
+// Cooperative and iterative linear search algorithm:
+bool vect_lsearch(ivector v, const void *key,
+		  int (*f1)(const void *, const void *),
+		  zvect_index *item_index,
+		  cmt_state const state,
+		  zvect_index maxIterations)
+{
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL) || (p_vect_live_size(v) == 0))
+		return false;
+
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_PUT_JOB_DONE;
+		goto VECT_LSEARCH_JOB_DONE;
+	p_vect_settle(v);
+
+	// TODO: Add mutex locking
+	zvect_index vsize = p_vect_size(v);
+
+	// Special case (vector has only 1 item, so we can't search):
+	if (vsize == 1) {
+		if ((*f1)(key, v->data[v->begin]) != 0) {
+			*item_index = 0;
+			return true;
+		} else {
+			goto VECT_LSEARCH_JOB_DONE;
+		}
+	}
+
+	// Check if the state is initialized:
+	if (!state->isInitialized) {
+		*item_index = 0;
+		state->currentIndex = 0;
+		state->isInitialized = true;
+	}
+
+	// Initialize internal parameters:
+	zvect_index iterations = 0;
+	zvect_index x = state->currentIndex;
+	if (maxIterations == 0)
+		maxIterations = vsize;
+	if (maxIterations > vsize)
+		maxIterations = vsize;
+	if (maxIterations > (vsize - x))
+		maxIterations = vsize - x;
+
+	// Search in the vector:
+	while (x < vsize && iterations < maxIterations) {
+		if (f1(key, v->data[v->begin + x]) != 0) {
+			*item_index = x;
+			return true;
+		}
+		x++;
+		iterations++;
 
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
+		// Check if we can do loop unrolling
+		// within the cooperative search:
+		if ((maxIterations - iterations) > 3)
+		{
+			// Nice, we can do some unrolled search
+			if (f1(key, v->data[v->begin + x]) != 0) {
+        			*item_index = x;
+        			return true;
+    			}
+    			if (f1(key, v->data[v->begin + x + 1]) != 0) {
+        			*item_index = x + 1;
+        			return true;
+    			}
+    			if (f1(key, v->data[v->begin + x + 2]) != 0) {
+        			*item_index = x + 2;
+        			return true;
+    			}
+    			if (f1(key, v->data[v->begin + x + 3]) != 0) {
+        			*item_index = x + 3;
+        			return true;
+    			}
+    			x += 3; // Skip ahead for unrolled iterations
+    			iterations += 3; // Update iteration count
+        	}
+	}
 
-	rval = p_vect_put_at(v, value, p_vect_size(v) - 1);
+	state->currentIndex = x;
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+	// Check if the search is complete
+	if (x >= vsize) {
+		*item_index = 0;
+		return false;
+	}
 
-VECT_PUT_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
-#endif
+VECT_LSEARCH_JOB_DONE:
+	return false; // Indicate more iterations are needed
 }
 
-void vect_put_at(ivector v, const void *value, const zvect_index i) {
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_PUT_AT_JOB_DONE;
-
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
+#endif // COOPERATIVE_LINEAR_SEARCH
 
-	rval = p_vect_put_at(v, value, i);
+// Parallel Linear Search:
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
+struct p_lsearch_job {
+	struct p_vector *v;
+	const void *key;
+	int (*f1)(const void *, const void *);
+#if (ZVECT_WORKER_POOL == 1)
+	pthread_mutex_t lock;
 #endif
+	zvect_index found;		// - Lowest matching index found so far
+};
 
-VECT_PUT_AT_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
+// Read the lowest index found so far (chunks beyond
+// it can stop early):
+static inline zvect_index p_lsearch_found(struct p_lsearch_job *job)
+{
+#if (ZVECT_WORKER_POOL == 1)
+	mutex_lock(&(job->lock));
+	zvect_index found = job->found;
+	mutex_unlock(&(job->lock));
+	return found;
 #else
-	SET_ERROR(v, rval);
+	return job->found;
 #endif
 }
 
-void vect_put_front(ivector v, const void *value) {
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_PUT_FRONT_JOB_DONE;
-
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
-
-		rval = p_vect_put_at(v, value, 0);
+static void p_lsearch_chunk(void *arg, zvect_index start, zvect_index end)
+{
+	struct p_lsearch_job *job = (struct p_lsearch_job *)arg;
+	void ** const data = job->v->data + job->v->begin;
+
+	for (register zvect_index i = start; i < end; i++) {
+		// Every now and then check if another thread has
+		// already found a match before this chunk:
+		if (((i - start) & 1023) == 0 && p_lsearch_found(job) <= i)
+			return;
+		if ((*(job->f1))(job->key, data[i]) != 0) {
+#if (ZVECT_WORKER_POOL == 1)
+			mutex_lock(&(job->lock));
+#endif
+			if (i < job->found)
+				job->found = i;
+#if (ZVECT_WORKER_POOL == 1)
+			mutex_unlock(&(job->lock));
+#endif
+			return;
+		}
+	}
+}
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+bool vect_lsearch_parallel(ivector v, const void *key,
+			   int (*f1)(const void *, const void *),
+			   zvect_index *item_index,
+			   zvect_index nthreads, zvect_index grain)
+{
+	bool found = false;
+	*item_index = 0;
 
-VECT_PUT_FRONT_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
-#endif
-}
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL))
+		return false;
 
-void *vect_pop(ivector v) {
-	void *item = NULL;
-	zvect_index vsize = 0;
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_POP_JOB_DONE;
+		goto VECT_LSEARCH_PAR_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	vsize = p_vect_size(v);
-	if (vsize != 0)
-		rval = p_vect_remove_at(v, vsize - 1, &item);
-
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+	zvect_index vsize = p_vect_size(v);
 
-VECT_POP_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
+	struct p_lsearch_job job;
+	job.v = v;
+	job.key = key;
+	job.f1 = f1;
+	job.found = vsize;
+#if (ZVECT_WORKER_POOL == 1)
+	pthread_mutex_init(&(job.lock), NULL);
 #endif
 
-	return item;
-}
-
-void *vect_remove(ivector v) {
-	void *item = NULL;
-	zvect_index vsize = 0;
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_REM_JOB_DONE;
+	rval = p_pool_run_range(0, vsize, nthreads, grain, p_lsearch_chunk, &job);
 
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#if (ZVECT_WORKER_POOL == 1)
+	pthread_mutex_destroy(&(job.lock));
 #endif
 
-	vsize = p_vect_size(v);
-	if (vsize != 0)
-		rval = p_vect_remove_at(v, vsize - 1, &item);
+	if (job.found < vsize) {
+		*item_index = job.found;
+		found = true;
+	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_REM_JOB_DONE:
+VECT_LSEARCH_PAR_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -2145,57 +9284,57 @@ VECT_REM_JOB_DONE:
 	SET_ERROR(v, rval);
 #endif
 
-	return item;
+	return found;
 }
 
-void *vect_remove_at(ivector v, const zvect_index i) {
-	void *item = NULL;
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_REM_AT_JOB_DONE;
-
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
-
-	if (p_vect_size(v) != 0)
-		rval = p_vect_remove_at(v, i, &item);
+// Fixed-width key search:
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+static inline zvect_index p_find_bytes(void * const *data, zvect_index n,
+				       const void *key, size_t offset,
+				       size_t key_len)
+{
+	return (*(p_kern.find_bytes))(data, n, key, offset, key_len);
+}
 
-VECT_REM_AT_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
-#endif
+bool vect_find_bytes(ivector v, const void *key, size_t key_offset,
+		     size_t key_len, zvect_index *item_index)
+{
+	bool found = false;
+	*item_index = 0;
 
-	return item;
-}
+	// Check parameters:
+	if ((key == NULL) || (key_len == 0))
+		return false;
 
-void *vect_remove_front(ivector v) {
-	void *item = NULL;
+	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_REM_FRONT_JOB_DONE;
+		goto VECT_FIND_BYTES_JOB_DONE;
+
+	// The key field must be within the item:
+	if (key_offset > v->data_size || key_len > v->data_size - key_offset) {
+		rval = ZVERR_VECTDATASIZE;
+		goto VECT_FIND_BYTES_JOB_DONE;
+	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	if (p_vect_size(v) != 0)
-		rval = p_vect_remove_at(v, 0, &item);
+	zvect_index vsize = p_vect_size(v);
+	zvect_index idx = p_find_bytes(v->data + v->begin, vsize, key, key_offset, key_len);
+	if (idx < vsize) {
+		*item_index = idx;
+		found = true;
+	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_REM_FRONT_JOB_DONE:
+VECT_FIND_BYTES_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -2203,355 +9342,343 @@ VECT_REM_FRONT_JOB_DONE:
 	SET_ERROR(v, rval);
 #endif
 
-	return item;
+	return found;
 }
 
-// Delete an item at the END of the vector
-void vect_delete(ivector v) {
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_DEL_JOB_DONE;
-
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
+/*---------------------------------------------------------------------------*/
+// Vector views:
 
-	rval = p_vect_delete_at(v, p_vect_size(v) - 1, 0, 1);
+/*
+ * A view aliases a range of the slots of its vector (it never copies
+ * the items), so it sees the same items as long as the vector storage
+ * is not reallocated or reorganised (which increments the vector
+ * generation) and it has no lazy deletes or gap. Items added or deleted
+ * in the vector before the end of the view shift the items the view
+ * sees, like it happens to the iterators of the C++ standard containers.
+ */
+struct p_view {
+	vector v;			// - Vector the view aliases.
+	zvect_index base;		// - Slot of the first item of the view
+					//   (so items stay put when v->begin
+					//   moves).
+	zvect_index len;		// - Number of items in the view.
+	uint32_t generation;		// - Vector's generation when the view
+					//   was made.
+};
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+// Returns 0 if the view exists:
+static inline zvect_retval p_view_defined(const struct p_view *vw) {
+	return ((vw == NULL) || (vw->v == NULL)) ? ZVERR_VECTUNDEF : 0;
+}
 
-VECT_DEL_JOB_DONE:
-#if (ZVECT_HANDLE_ERRORS == 1)
-	if (rval)
-		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
-#endif
+// Returns 0 if the view can still be used. The functions that lock
+// the vector call it only after taking the lock, so another thread
+// can't make the view stale while they use it:
+static inline zvect_retval p_view_check(const struct p_view *vw) {
+	if (p_view_defined(vw))
+		return ZVERR_VECTUNDEF;
+	if ((vw->generation != vw->v->generation) || (vw->v->tombs != NULL) || (vw->v->gap_len != 0) ||
+	    (vw->base < vw->v->begin) || ((size_t)vw->base + vw->len > vw->v->end))
+		return ZVERR_VIEWSTALE;
+	return 0;
 }
 
-// Delete an item at position "i" on the vector
-void vect_delete_at(ivector v, const zvect_index i) {
+vect_view vect_view_make(ivector v, zvect_index start, zvect_index len) {
+	struct p_view *vw = NULL;
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_DEL_AT_JOB_DONE;
+		goto VECT_VIEW_MAKE_JOB_DONE;
+
+	// Circular vectors wrap their items around the storage:
+	if (v->flags & ZV_CIRCULAR) {
+		rval = ZVERR_OPNOTALLOWED;
+		goto VECT_VIEW_MAKE_JOB_DONE;
+	}
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
+
+	if ((size_t)start + len > p_vect_size(v)) {
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_VIEW_MAKE_DONE_PROCESSING;
+	}
 
-	rval = p_vect_delete_at(v, i, 0, 1);
+	vw = (struct p_view *)malloc(sizeof(struct p_view));
+	if (vw == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_VIEW_MAKE_DONE_PROCESSING;
+	}
+	vw->v = v;
+	vw->base = v->begin + start;
+	vw->len = len;
+	vw->generation = v->generation;
 
+VECT_VIEW_MAKE_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_DEL_AT_JOB_DONE:
+VECT_VIEW_MAKE_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
-	SET_ERROR(v, rval);
+	if (v != NULL)
+		SET_ERROR(v, rval);
 #endif
+
+	return vw;
 }
 
-// Delete a range of items from "first_element" to "last_element" on the vector v
-void vect_delete_range(ivector v, const zvect_index first_element,
-                       const zvect_index last_element) {
-	zvect_index end = 0;
-	zvect_retval rval = p_vect_check(v);
-	if (rval)
-		goto VECT_DEL_RANGE_JOB_DONE;
+void vect_view_destroy(vect_view vw) {
+	free(vw);
+}
 
-#if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
-#endif
+zvect_index vect_view_size(vect_view const vw) {
+	return (vw == NULL) ? 0 : vw->len;
+}
 
-	end = (last_element - first_element);
-	rval = p_vect_delete_at(v, first_element, end, 1);
+bool vect_view_is_valid(vect_view const vw) {
+	return (p_view_check(vw) == 0);
+}
 
-#if (ZVECT_THREAD_SAFE == 1)
-	if (lock_owner)
-		get_mutex_unlock(v, 1);
-#endif
+void *vect_view_get_at(vect_view const vw, const zvect_index i) {
+	void *item = NULL;
+	zvect_retval rval = p_view_check(vw);
+	if (!rval && (i >= vw->len))
+		rval = ZVERR_IDXOUTOFBOUND;
+	if (!rval)
+		item = vw->v->data[vw->base + i];
 
-VECT_DEL_RANGE_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
 #endif
+
+	return item;
 }
 
-// Delete an item at the BEGINNING of a vector v
-void vect_delete_front(ivector v) {
-	zvect_retval rval = p_vect_check(v);
+zvect_retval vect_view_apply(vect_view const vw, void (*f)(void *, void *), void *ctx) {
+	zvect_retval rval = (f == NULL) ? ZVERR_OPNOTALLOWED : p_view_defined(vw);
 	if (rval)
-		goto VECT_DEL_FRONT_JOB_DONE;
+		goto VECT_VIEW_APPLY_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	zvect_retval lock_owner = (locking_disabled || (vw->v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(vw->v, 1);
 #endif
 
-	rval = p_vect_delete_at(v, 0, 0, 1);
+	if ((rval = p_view_check(vw)) != 0)
+		goto VECT_VIEW_APPLY_DONE_PROCESSING;
+
+	void **a = vw->v->data + vw->base;
+	for (zvect_index i = 0; i < vw->len; i++)
+		(*f)(a[i], ctx);
 
+VECT_VIEW_APPLY_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
-		get_mutex_unlock(v, 1);
+		get_mutex_unlock(vw->v, 1);
 #endif
 
-VECT_DEL_FRONT_JOB_DONE:
+VECT_VIEW_APPLY_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
 #endif
-}
 
-/*---------------------------------------------------------------------------*/
+	return rval;
+}
 
-/*---------------------------------------------------------------------------*/
-// Vector Data Manipulation functions
-#ifdef ZVECT_DMF_EXTENSIONS
+bool vect_view_lsearch(vect_view const vw, const void *key,
+		       int (*f1)(const void *, const void *),
+		       zvect_index *item_index) {
+	bool found = false;
+	*item_index = 0;
 
-void vect_swap(ivector v, const zvect_index i1, const zvect_index i2) {
 	// Check parameters:
-	if (i1 == i2)
-		return;
-
-	// Prepare variables:
-	zvect_index vsize = 0;
-	void *temp = NULL;
+	if ((key == NULL) || (f1 == NULL))
+		return false;
 
-	// check if the vector exists:
-	zvect_retval rval = p_vect_check(v);
+	zvect_retval rval = p_view_defined(vw);
 	if (rval)
-		goto VECT_SWP_JOB_DONE;
+		goto VECT_VIEW_LSEARCH_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	zvect_retval lock_owner = (locking_disabled || (vw->v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(vw->v, 1);
 #endif
 
-	// Check parameters:
-	vsize = p_vect_size(v);
-	if (i1 > vsize || i2 > vsize) {
-		rval = ZVERR_IDXOUTOFBOUND;
-		goto VECT_SWP_DONE_PROCESSING;
-	}
+	if ((rval = p_view_check(vw)) != 0)
+		goto VECT_VIEW_LSEARCH_DONE_PROCESSING;
 
-	// Let's swap items:
-	temp = v->data[v->begin + i2];
-	v->data[v->begin + i2] = v->data[v->begin + i1];
-	v->data[v->begin + i1] = temp;
+	void **a = vw->v->data + vw->base;
+	for (zvect_index i = 0; i < vw->len; i++) {
+		if ((*f1)(key, a[i]) == 0) {
+			*item_index = i;
+			found = true;
+			break;
+		}
+	}
 
-VECT_SWP_DONE_PROCESSING:
+VECT_VIEW_LSEARCH_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
-		get_mutex_unlock(v, 1);
+		get_mutex_unlock(vw->v, 1);
 #endif
 
-VECT_SWP_JOB_DONE:
+VECT_VIEW_LSEARCH_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
 #endif
+
+	return found;
 }
 
-void vect_swap_range(ivector v, const zvect_index s1, const zvect_index e1,
-                     const zvect_index s2) {
-	// Check parameters:
-	if (s1 == s2)
-		return;
+bool vect_view_bsearch(vect_view const vw, const void *key,
+		       int (*f1)(const void *, const void *),
+		       zvect_index *item_index) {
+	bool found = false;
+	*item_index = 0;
 
-	zvect_index vsize = 0;
-	zvect_index end = e1;
-	if (e1 != 0)
-		end = e1 - s1;
+	// Check parameters:
+	if ((key == NULL) || (f1 == NULL))
+		return false;
 
-	// check if the vector exists:
-	zvect_retval rval = p_vect_check(v);
+	zvect_retval rval = p_view_defined(vw);
 	if (rval)
-		goto VECT_SWP_RANGE_JOB_DONE;
+		goto VECT_VIEW_BSEARCH_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	zvect_retval lock_owner = (locking_disabled || (vw->v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(vw->v, 1);
 #endif
 
-	vsize = p_vect_size(v);
-	if ((s1 + end) > vsize || (s2 + end) > vsize || s2 < (s1 + end)) {
-		rval = ZVERR_IDXOUTOFBOUND;
-		goto VECT_SWP_RANGE_DONE_PROCESSING;
-	}
-
-	// Let's swap items:
-	register zvect_index i = 0;
-	register zvect_index j = s1;
-	// Let's check if we can unroll the loop:
-	if ((s1 + end) > 4) {
-		// Nice we can unroll the loop!
-		for (j = s1; j <= (s1 + end)-4; j += 4) {
-			i = j - s1;
-#if (COMPILER == COMPILER_GCC)
-			__builtin_prefetch(v->data[v->begin + j + 4]);
-			#pragma GCC unroll 4
-			for (register zvect_index k = 0; k < 4; k++) {
-				void *temp = v->data[v->begin + j + k];
-				v->data[v->begin + j + k] = v->data[v->begin + (s2 + i + k)];
-				v->data[v->begin + (s2 + i + k)] = temp;
-			}
-#else
-			void *temp = v->data[v->begin + j];
-			v->data[v->begin + j] = v->data[v->begin + (s2 + i)];
-			v->data[v->begin + (s2 + i)] = temp;
-
-			temp = v->data[v->begin + j + 1];
-			v->data[v->begin + j + 1] = v->data[v->begin + (s2 + i + 1)];
-			v->data[v->begin + (s2 + i + 1)] = temp;
+	if ((rval = p_view_check(vw)) != 0)
+		goto VECT_VIEW_BSEARCH_DONE_PROCESSING;
 
-			temp = v->data[v->begin + j + 2];
-			v->data[v->begin + j + 2] = v->data[v->begin + (s2 + i + 2)];
-			v->data[v->begin + (s2 + i + 2)] = temp;
-
-			temp = v->data[v->begin + j + 3];
-			v->data[v->begin + j + 3] = v->data[v->begin + (s2 + i + 3)];
-			v->data[v->begin + (s2 + i + 3)] = temp;
-#endif
-		}
-	}
-	// let's process the rest of the items:
-	for (register zvect_index j2 = j; j2 <= (s1 + end); j2++) {
-		i = j2 - s1;
-		void *temp = v->data[v->begin + j2];
-		v->data[v->begin + j2] = v->data[v->begin + (s2 + i)];
-		v->data[v->begin + (s2 + i)] = temp;
+	// Find the first item that is not lower than key:
+	void **a = vw->v->data + vw->base;
+	zvect_index bot = 0;
+	zvect_index top = vw->len;
+	while (bot < top) {
+		zvect_index mid = bot + ((top - bot) >> 1);
+		if ((*f1)(key, a[mid]) > 0)
+			bot = mid + 1;
+		else
+			top = mid;
 	}
+	*item_index = bot;
+	found = (bot < vw->len) && ((*f1)(key, a[bot]) == 0);
 
-VECT_SWP_RANGE_DONE_PROCESSING:
+VECT_VIEW_BSEARCH_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
-		get_mutex_unlock(v, 1);
+		get_mutex_unlock(vw->v, 1);
 #endif
 
-VECT_SWP_RANGE_JOB_DONE:
+VECT_VIEW_BSEARCH_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
 #endif
-}
 
-void vect_rotate_left(ivector v, zvect_index i) {
+	return found;
+}
 
-	// check if the vector exists:
-	zvect_index vsize = 0;
-	zvect_retval rval = p_vect_check(v);
+zvect_retval vect_view_qsort(vect_view const vw, int (*compare_func)(const void *, const void *)) {
+	zvect_retval rval = (compare_func == NULL) ? ZVERR_OPNOTALLOWED : p_view_defined(vw);
 	if (rval)
-		goto VECT_ROT_LEFT_JOB_DONE;
+		goto VECT_VIEW_QSORT_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+	zvect_retval lock_owner = (locking_disabled || (vw->v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(vw->v, 1);
 #endif
 
-	// Check parameters:
-	vsize = p_vect_size(v);
-	if (i == 0 || i == vsize)
-		goto VECT_ROT_LEFT_DONE_PROCESSING;
-
-	if (i > vsize)
-		i = i % vsize;
-
-	// Process the vector
-	if (i == 1) {
-		// Rotate left the vector of 1 position:
-		void *temp = v->data[0];
-		p_vect_memmove(v->data, v->data + 1, sizeof(void *) * (vsize - 1));
-		v->data[vsize - 1] = temp;
-	} else {
-		void **new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
-		if (new_data == NULL) {
-			rval = ZVERR_OUTOFMEM;
-			goto VECT_ROT_LEFT_DONE_PROCESSING;
-		}
-		// Rotate left the vector of "i" positions:
-		p_vect_memcpy(new_data + v->begin, v->data + v->begin, sizeof(void *) * i);
-		p_vect_memmove(v->data + v->begin, v->data + v->begin + i, sizeof(void *) * (vsize - i));
-		p_vect_memcpy(v->data + v->begin + (vsize - i), new_data + v->begin, sizeof(void *) * i);
+	if ((rval = p_view_check(vw)) != 0)
+		goto VECT_VIEW_QSORT_DONE_PROCESSING;
 
-		free(new_data);
-		new_data=NULL;
+	if (vw->len > 1) {
+		// Items are moved around, so the hash index must be rebuilt:
+		p_hindex_invalidate(vw->v);
+		zvect_index l = vw->base - vw->v->begin;
+		p_vect_qsort(vw->v, l, l + (vw->len - 1), compare_func);
 	}
 
-VECT_ROT_LEFT_DONE_PROCESSING:
+VECT_VIEW_QSORT_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
-		get_mutex_unlock(v, 1);
+		get_mutex_unlock(vw->v, 1);
 #endif
 
-VECT_ROT_LEFT_JOB_DONE:
+VECT_VIEW_QSORT_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
-#else
-	SET_ERROR(v, rval);
 #endif
+
+	return rval;
 }
 
-void vect_rotate_right(ivector v, zvect_index i) {
-	// check if the vector exists:
-	zvect_index vsize = 0;
+#endif // ZVECT_DMF_EXTENSIONS
+
+#ifdef ZVECT_SFMD_EXTENSIONS
+// Single Function Call Multiple Data operations extensions:
+
+#if !defined(ZVECT_COOPERATIVE)
+void vect_apply(ivector v, void (*f)(void *)) {
+	// Check Parameters:
+	if (f == NULL)
+		return;
+
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_ROT_RIGHT_JOB_DONE;
+		goto VECT_APPLY_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
 
-	// Check parameters:
-	vsize = p_vect_size(v);
-	if (i == 0 || i == vsize)
-		goto VECT_ROT_RIGHT_DONE_PROCESSING;
-
-	if (i > vsize)
-		i = i % vsize;
-
-	// Process the vector
-	if (i == 1) {
-		// Rotate right the vector of 1 position:
-		void *temp = v->data[v->begin + p_vect_size(v) - 1];
-		p_vect_memmove(v->data + v->begin + 1, v->data + v->begin, sizeof(void *) * (vsize - 1));
-		v->data[v->begin] = temp;
-	} else {
-		void **new_data = (void **)malloc(sizeof(void *) * p_vect_capacity(v));
-		if (new_data == NULL) {
-			rval = ZVERR_OUTOFMEM;
-			goto VECT_ROT_RIGHT_DONE_PROCESSING;
-		}
-
-		// Rotate right the vector of "i" positions:
-		p_vect_memcpy(new_data + v->begin, v->data + v->begin + (p_vect_size(v) - i), sizeof(void *) * i);
-		p_vect_memmove(v->data + v->begin + i, v->data + v->begin, sizeof(void *) * (vsize - i));
-		p_vect_memcpy(v->data + v->begin, new_data + v->begin, sizeof(void *) * i);
+	// Process the tree (if any):
+	if (v->tree != NULL) {
+		if (v->tree->size)
+			p_vect_tree_apply(v, f, 0, v->tree->size - 1);
+		goto VECT_APPLY_DONE_PROCESSING;
+	}
+	p_vect_settle_locked(v);
 
-		free(new_data);
-		new_data=NULL;
+	// Process the vector:
+	// Check if we can do loop unrolling
+	zvect_index vsize = p_vect_size(v);
+	register zvect_index i = 0;
+	if (vsize > 4) {
+		// Nice, we can do some unrolled apply:
+		for (i = 0; i <= (vsize - 4); i+=4)
+		{
+#if (COMPILER == COMPILER_GCC)
+			#pragma GCC unroll 4
+			for (zvect_index x=i; x < i + 4; x++)
+				(*f)(v->data[v->begin + x]);
+#else
+			(*f)(v->data[v->begin + i]);
+			(*f)(v->data[v->begin + (i+1)]);
+			(*f)(v->data[v->begin + (i+2)]);
+			(*f)(v->data[v->begin + (i+3)]);
+#endif
+		}
 	}
+	// Cleanup loop for remaining elements if any
+	for (; i < vsize; i++)
+		(*f)(v->data[v->begin + i]);
 
-VECT_ROT_RIGHT_DONE_PROCESSING:
+VECT_APPLY_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_ROT_RIGHT_JOB_DONE:
+VECT_APPLY_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -2559,239 +9686,211 @@ VECT_ROT_RIGHT_JOB_DONE:
 	SET_ERROR(v, rval);
 #endif
 }
+#endif
 
-#if !defined(ZVECT_COOPERATIVE)
-#ifdef TRADITIONAL_QSORT
-static inline zvect_index
-p_partition(vector v, zvect_index low, zvect_index high,
-           int (*compare_func)(const void *, const void *)) {
-	if (high >= p_vect_size(v))
-		high = p_vect_size(v) - 1;
+#if defined(ZVECT_COOPERATIVE)
+void vect_apply(ivector v,
+		void (*f)(void *),
+		cmt_state const state,
+		zvect_index maxIterations)
+{
+	// Check Parameters:
+	if (f == NULL)
+		return;
 
-	void *pivot = v->data[v->begin + high];
-	zvect_index i = (low - 1);
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_APPLY_JOB_DONE;
+	p_vect_settle(v);
 
-	for (register zvect_index j = low; j <= (high - 1); j++) {
-		// v->data[j] <= pivot
-		if ((*compare_func)(v->data[v->begin + j], pivot) <= 0)
-			vect_swap(v, ++i, j);
+	zvect_index vsize = p_vect_size(v);
+	zvect_index iterations = 0;
+	if (!state->isInitialized) {
+		state->currentIndex = 0;
+		state->isInitialized = true;
 	}
 
-	vect_swap(v, i + 1, high);
-	return (i + 1);
-}
-
-static void p_vect_qsort(vector v, zvect_index low, zvect_index high,
-                        int (*compare_func)(const void *, const void *)) {
-	if (low < high) {
-		zvect_index pi = p_partition(v, low, high, compare_func);
-		p_vect_qsort(v, low, pi - 1, compare_func);
-		p_vect_qsort(v, pi + 1, high, compare_func);
+	if ((vsize & 3) == 0) {
+		// Unrolled loop
+		while (state->currentIndex < vsize &&
+			iterations < maxIterations) {
+        		(*f)(v->data[v->begin + state->currentIndex]);
+        		(*f)(v->data[v->begin + state->currentIndex + 1]);
+        		(*f)(v->data[v->begin + state->currentIndex + 2]);
+        		(*f)(v->data[v->begin + state->currentIndex + 3]);
+        		state->currentIndex += 4;
+        		iterations += 4;
+		}
+	} else {
+		// Standard loop
+		while (state->currentIndex < vsize &&
+		       iterations < maxIterations) {
+        		(*f)(v->data[v->begin + state->currentIndex]);
+        		state->currentIndex++;
+        		iterations++;
+        	}
 	}
+
+VECT_APPLY_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
 }
-#endif // TRADITIONAL_QSORT
 
-#if !defined(TRADITIONAL_QSORT)
-// This is my much faster implementation of a quicksort algorithm
-// it fundamentally uses the 3 ways partitioning adapted and improved
-// to deal with arrays of pointers together with having a custom
-// compare function:
-static void p_vect_qsort(ivector v, zvect_index l, zvect_index r,
-                        int (*compare_func)(const void *, const void *)) {
-	if (r <= l)
-	    return;
 
-	zvect_index i;
-	zvect_index p;
-	zvect_index j;
-	zvect_index q;
-	void const *ref_val = NULL;
+#endif // COOPERATIVE_APPLY
 
-	// l = left (also low)
-	if (l > 0)
-		i = l - 1;
-	else
-		i = l;
-	// r = right (also high)
-	j = r;
-	p = i;
-	q = r;
-	ref_val = v->data[v->begin + r];
+void vect_apply_range(ivector v, void (*f)(void *), const zvect_index x,
+		      const zvect_index y)
+{
+	// Check parameters:
+	if ( f == NULL )
+		return;
 
-	for (;;) {
-		while ((*compare_func)(v->data[v->begin + i], ref_val) < 0)
-			i++;
-		while ((*compare_func)(ref_val, v->data[(--j) + v->begin]) < 0)
-			if (j == l)
-				break;
-		if (i >= j)
-			break;
-		vect_swap(v, i, j);
-		if ((*compare_func)(v->data[v->begin + i], ref_val) == 0) {
-			p++;
-			vect_swap(v, p, i);
-		}
-		if ((*compare_func)(ref_val, v->data[v->begin + j]) == 0) {
-			q--;
-			vect_swap(v, q, j);
-		}
-	}
-	vect_swap(v, i, r);
-	j = i - 1;
-	i = i + 1;
-    	register zvect_index k;
-	for (k = l; k < p; k++, j--)
-		vect_swap(v, k, j);
-	for (k = r - 1; k > q; k--, i++)
-		vect_swap(v, k, i);
-	p_vect_qsort(v, l, j, compare_func);
-	p_vect_qsort(v, i, r, compare_func);
-}
-#endif // ! TRADITIONAL_QSORT
-#endif // ! ZVECT_COOPERATIVE
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_APPLY_RNG_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	if (v->tree == NULL)
+		p_vect_settle_locked(v);
+
+	if (x >= p_vect_live_size(v) || y >= p_vect_live_size(v))
+	{
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_APPLY_RNG_DONE_PROCESSING;
+	}
+
+	zvect_index start;
+	zvect_index end;
+	if (x > y) {
+		start = y;
+		end = x;
+	} else {
+		start = x;
+		end = y;
+	}
 
-#if defined(ZVECT_COOPERATIVE)
-// Cooperative quicksort algorithm:
-void initQSortState(cmt_state const state, int initialCapacity) {
-    state->stack = malloc(initialCapacity * sizeof(struct p_cmt_state_range));
-    state->stackSize = 0;
-    state->isInitialized = 1;
-}
+	// Process the tree (if any) or the vector:
+	if (v->tree != NULL) {
+		p_vect_tree_apply(v, f, start, end);
+	} else {
+		for (register zvect_index i = start; i <= end; i++)
+			(*f)(v->data[v->begin + i]);
+	}
 
-void freeQSortState(cmt_state const state) {
-    free(state->stack);
-    state->stackSize = 0;
-    state->stack = NULL;
-}
+VECT_APPLY_RNG_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
 
-void pushQSortRange(struct p_cmt_state_range range, cmt_state const state) {
-    if (state->stackSize >= state->stackCapacity) {
-        // Resize the stack if needed
-        state->stackCapacity *= 2;
-        state->stack = realloc(state->stack, state->stackCapacity * sizeof(struct p_cmt_state_range));
-    }
-    state->stack[state->stackSize] = range;
-    state->stackSize++;
+VECT_APPLY_RNG_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
 }
 
-struct p_cmt_state_range popQSortRange(cmt_state const state) {
-    if (state->stackSize == 0) {
-        // Handle error for empty stack or return a default value
-        struct p_cmt_state_range empty = {0, 0};
-        return empty;
-    }
-    state->stackSize--;
-    return state->stack[state->stackSize];
-}
+// Parallel apply:
 
-int p_qsort_is_empty(cmt_state const state) {
-    return state->stackSize == 0;
-}
+struct p_apply_job {
+	struct p_vector *v;
+	void (*f)(void *, void *);
+	void *ctx;
+};
 
-zvect_index partition(ivector v,
-		      zvect_index low, zvect_index high,
-		      int (*compare_func)(const void *, const void *))
+static void p_apply_chunk(void *arg, zvect_index start, zvect_index end)
 {
-    const void * const pivot = vect_get_at(v, high); // Pivot element
-    zvect_index i = (low - 1); // Index of smaller element
+	const struct p_apply_job *job = (const struct p_apply_job *)arg;
+	void ** const data = job->v->data + job->v->begin;
 
-    for (zvect_index j = low; j <= high - 1; j++) {
-        // If current element is smaller than or equal to pivot
-        if (compare_func(vect_get_at(v, j), pivot) <= 0) {
-            i++; // Increment index of smaller element
-            vect_swap(v, i, j); // Swap elements at i and j
-        }
-    }
-    vect_swap(v, i + 1, high); // Swap the pivot element with the element at i + 1
-    return (i + 1);
+	for (register zvect_index i = start; i < end; i++)
+		(*(job->f))(data[i], job->ctx);
 }
 
-
-// Cooperative and iterative quicksort algorithm:
-void p_vect_cqsort(ivector v, cmt_state state,
-	    	   int(*compare_func)(const void *, const void *),
-	    	   zvect_index iterationLimit)
+void vect_apply_range_parallel(ivector v, void (*f)(void *, void *), void *ctx,
+			       const zvect_index x, const zvect_index y,
+			       zvect_index nthreads, zvect_index grain)
 {
-    zvect_index iterations = 0;
-    if (!state->isInitialized) {
-	initQSortState(state, p_vect_size(v) / iterationLimit );
-    }
+	// Check parameters:
+	if ( f == NULL )
+		return;
 
-    while (!p_qsort_is_empty(state) && iterations < iterationLimit) {
-        cmt_state_range range = popQSortRange(state);
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_APPLY_RNG_PAR_JOB_DONE;
 
-        if (range.low < range.high) {
-            zvect_index pivot = partition(v, range.low, range.high, compare_func);
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
-            pushQSortRange((struct p_cmt_state_range){range.low, pivot - 1}, state);
-            pushQSortRange((struct p_cmt_state_range){pivot + 1, range.high}, state);
+	if (x >= p_vect_size(v) || y >= p_vect_size(v))
+	{
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_APPLY_RNG_PAR_DONE_PROCESSING;
+	}
 
-            iterations++;
-        }
-    }
+	struct p_apply_job job = { v, f, ctx };
 
-    // If the function exits here, the state is automatically saved
-    // and can be used to resume in the next call.
-}
+	// Process the vector (please note: the range is inclusive):
+	if (x > y)
+		rval = p_pool_run_range(y, x + 1, nthreads, grain, p_apply_chunk, &job);
+	else
+		rval = p_pool_run_range(x, y + 1, nthreads, grain, p_apply_chunk, &job);
+
+VECT_APPLY_RNG_PAR_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
 #endif
 
-// Public quicksort function:
-// This function is a wrapper for the actual quicksort function
-// Depending on which macro is defined, it will call the:
-// traditional quicksort
-// or
-// the 3 ways partitioning quicksort
-// or
-// the cooperative quicksort
-void vect_qsort(ivector v,
-		int (*compare_func)(const void *, const void *)
-#if defined(ZVECT_COOPERATIVE)
-		, struct p_cmt_state* const state
-		, zvect_index iterationLimit
+VECT_APPLY_RNG_PAR_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
 #endif
-		)
+}
+
+void vect_apply_parallel(ivector v, void (*f)(void *, void *), void *ctx,
+			 zvect_index nthreads, zvect_index grain)
 {
 	// Check parameters:
-	if ( compare_func == NULL )
+	if ( f == NULL )
 		return;
 
-	zvect_index vsize = 0;
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_QSORT_JOB_DONE;
+		goto VECT_APPLY_PAR_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	vsize = p_vect_size(v);
-	if (vsize <= 1)
-		goto VECT_QSORT_DONE_PROCESSING;
+	struct p_apply_job job = { v, f, ctx };
 
 	// Process the vector:
-#ifndef ZVECT_COOPERATIVE
-	p_vect_qsort(v, 0, vsize - 1, compare_func);
-#else
-	if (iterationLimit == 0)
-	    iterationLimit = vect_size(v);
-	if (iterationLimit > vect_size(v))
-	    iterationLimit = vect_size(v);
-	if (!state->isInitialized) {
-	    initQSortState(state, vsize / iterationLimit );
-	}
-	struct p_cmt_state_range range = {0, vsize - 1};
-	pushQSortRange(range, state);
-	p_vect_cqsort(v, state, compare_func, iterationLimit);
-	freeQSortState(state);
-#endif
+	rval = p_pool_run_range(0, p_vect_size(v), nthreads, grain, p_apply_chunk, &job);
 
-VECT_QSORT_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_QSORT_JOB_DONE:
+VECT_APPLY_PAR_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -2800,498 +9899,397 @@ VECT_QSORT_JOB_DONE:
 #endif
 }
 
-#ifdef TRADITIONAL_BINARY_SEARCH
-static bool p_standard_binary_search(vector v, const void *key,
-                                    zvect_index *item_index,
-                                    int (*f1)(const void *, const void *));
-#else
-static bool p_adaptive_binary_search(ivector v, const void *key,
-                                    zvect_index *item_index,
-                                    int (*f1)(const void *, const void *));
-#endif
+// Apply with user context:
 
-/*
- * Although if the vect_add_* doesn't belong to this group of
- * functions, the vect_add_ordered is an exception because it
- * requires vect_bserach and vect_qsort to be available.
- */
-void vect_add_ordered(ivector v, const void *value,
-                      int (*f1)(const void *, const void *)) {
+void vect_apply_ctx(ivector v, void (*f)(void *, void *), void *ctx)
+{
 	// Check parameters:
-	if (value == NULL)
+	if ( f == NULL )
 		return;
 
-	zvect_index item_index = 0;
-	zvect_index vsize = 0;
-
-	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_ADD_ORD_JOB_DONE;
+		goto VECT_APPLY_CTX_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
-	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 2);
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	// Few tricks to make it faster:
-	vsize = p_vect_size(v);
-	if (vsize == 0) {
-		// If the vector is empty clearly we can just
-		// use vect_add and add the value normally!
-		vect_add(v, value);
-		goto VECT_ADD_ORD_DONE_PROCESSING;
-	}
-
-	if ((*f1)(value, v->data[v->begin + (vsize - 1)]) > 0) {
-		// If the compare function returns that
-		// the value passed should go after the
-		// last value in the vector, just do so!
-		vect_add(v, value);
-		goto VECT_ADD_ORD_DONE_PROCESSING;
-	}
-
-	// Ok previous checks didn't help us, so we need
-	// to get "heavy weapons" out and find where in
-	// the vector we should add "value":
-
-	// Here is another trick:
-	// I improved adaptive binary search to ALWAYS
-	// return an index (even when it doesn't find a
-	// searched item), this works for both: regular
-	// searches which will also use the bool to
-	// know if we actually found the item in that
-	// item_index or not and the vect_add_ordered
-	// which will use item_index (which will be the
-	// place where value should have been) to insert
-	// value as an ordered item :)
-#ifdef TRADITIONAL_BINARY_SEARCH
-	p_standard_binary_search(v, value, &item_index, f1);
-#else
-	p_adaptive_binary_search(v, value, &item_index, f1);
-#endif
+	struct p_apply_job job = { v, f, ctx };
 
-	vect_add_at(v, value, item_index);
+	// Process the vector:
+	p_apply_chunk(&job, 0, p_vect_size(v));
 
-VECT_ADD_ORD_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
-		get_mutex_unlock(v, 2);
+		get_mutex_unlock(v, 1);
 #endif
 
-VECT_ADD_ORD_JOB_DONE:
-	if(rval)
+VECT_APPLY_CTX_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
 		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
 }
 
+void vect_apply_range_ctx(ivector v, void (*f)(void *, void *), void *ctx,
+			  const zvect_index x, const zvect_index y)
+{
+	// Check parameters:
+	if ( f == NULL )
+		return;
 
-// Searching Algorithms:
-
-#ifdef TRADITIONAL_BINARY_SEARCH
-static bool p_standard_binary_search(vector v, const void *key,
-                                    zvect_index *item_index,
-                                    int (*f1)(const void *, const void *)) {
-	zvect_index bot, top;
-
-	bot = 0;
-	top = p_vect_size(v) - 1;
-
-	while (bot < top) {
-        zvect_index mid // mid-point
-		mid = top - (top - bot) / 2;
-
-		// key < array[mid]
-		if ((*f1)(key, v->data[v->begin + mid]) < 0) {
-			top = mid - 1;
-		} else {
-			bot = mid;
-		}
-	}
-
-	// key == array[top]
-	if ((*f1)(key, v->data[v->begin + top]) == 0) {
-		*item_index = top;
-		return true;
-	}
-
-	*item_index = top;
-	return false;
-}
-#endif // TRADITIONAL_BINARY_SEARCH
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_APPLY_RNG_CTX_JOB_DONE;
 
-#ifndef TRADITIONAL_BINARY_SEARCH
-// This is my re-implementation of Igor van den Hoven's Adaptive
-// Binary Search algorithm. It has few improvements over the
-// original design, most notably the use of custom compare
-// function that makes it suitable also to search through strings
-// and other types of vectors.
-static bool p_adaptive_binary_search(ivector v, const void *key,
-                                    zvect_index *item_index,
-                                    int (*f1)(const void *, const void *)) {
-	zvect_index bot;
-	zvect_index top;
-	zvect_index mid;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
-	if ((v->balance >= 32) || (p_vect_size(v) <= 64)) {
-		bot = 0;
-		top = p_vect_size(v);
-		goto P_ADP_BSEARCH_MONOBOUND;
+	if (x >= p_vect_size(v) || y >= p_vect_size(v))
+	{
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_APPLY_RNG_CTX_DONE_PROCESSING;
 	}
-	bot = v->bottom;
-	top = 32;
 
-	// the following evaluation correspond to: key >= array[bot]
-	if ((*f1)(key, v->data[v->begin + bot]) >= 0) {
-		while (1) {
-			if ((bot + top) >= p_vect_size(v)) {
-				top = p_vect_size(v) - bot;
-				break;
-			}
-			bot += top;
+	struct p_apply_job job = { v, f, ctx };
 
-			// the meaning of the line below is: key < array[bot]
-			if ((*f1)(key, v->data[v->begin + bot]) < 0) {
-				bot -= top;
-				break;
-			}
-			top *= 2;
-		}
-	} else {
-		while (1) {
-			if (bot < top) {
-				top = bot;
-				bot = 0;
-				break;
-			}
-			bot -= top;
+	// Process the vector (please note: the range is inclusive):
+	if (x > y)
+		p_apply_chunk(&job, y, x + 1);
+	else
+		p_apply_chunk(&job, x, y + 1);
 
-			// the meaning of the line below is: key >= array[bot]
-			if ((*f1)(key, v->data[v->begin + bot]) >= 0)
-				break;
-			top *= 2;
-		}
-	}
+VECT_APPLY_RNG_CTX_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
 
-P_ADP_BSEARCH_MONOBOUND:
-	while (top > 3) {
-		mid = top / 2;
-		// the meaning of the following statement is: key >= array[bot + mid]
-		if ((*f1)(key, v->data[v->begin + (bot + mid)]) >= 0)
-			bot += mid;
-		top -= mid;
-	}
+VECT_APPLY_RNG_CTX_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
 
-	v->balance = v->bottom > bot ? v->bottom - bot : bot - v->bottom;
-	v->bottom = bot;
+// Batch apply:
 
-	while (top) {
-		// the meaning of the following statement is: key == array[bot + --top]
-		int test = (*f1)(key, v->data[v->begin + (bot + (--top))]);
-		if (test == 0) {
-			*item_index = bot + top;
-			return true;
-		} else if (test > 0) {
-			*item_index = bot + (top + 1);
-			return false;
-		}
-	}
+struct p_batch_job {
+	struct p_vector *v;
+	void (*f)(void **, size_t, void *);
+	void *ctx;
+};
 
-	*item_index = bot + top;
-	return false;
-}
-#endif // ADAPTIVE TRADITIONAL_BINARY_SEARCH
+static void p_batch_chunk(void *arg, zvect_index start, zvect_index end)
+{
+	const struct p_batch_job *job = (const struct p_batch_job *)arg;
 
-bool vect_bsearch(ivector v, const void *key,
-                  int (*f1)(const void *, const void *),
-                  zvect_index *item_index) {
-	*item_index = 0;
+	if (end > start)
+		(*(job->f))(job->v->data + job->v->begin + start,
+			    (size_t)(end - start), job->ctx);
+}
 
+void vect_apply_batch(ivector v, void (*f)(void **, size_t, void *), void *ctx)
+{
 	// Check parameters:
-	if ((key == NULL) || (f1 == NULL) || (p_vect_size(v) == 0))
-		return false;
-
-	zvect_index vsize = 0;
+	if ( f == NULL )
+		return;
 
-	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_BSEARCH_JOB_DONE;
+		goto VECT_APPLY_BATCH_JOB_DONE;
 
-	// TODO: Add mutex locking
-
-	vsize = p_vect_size(v);
-	// First case (vector is empty, so we can't search):
-	if (vsize == 0)
-		goto VECT_BSEARCH_JOB_DONE;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
-	// Second case (vector has only 1 item, so we can't search):
-	if (vsize == 1) {
-		if ((*f1)(key, v->data[v->begin]) != 0) {
-			*item_index = 0;
-			return true;
-		} else {
-			goto VECT_BSEARCH_JOB_DONE;
-		}
-	}
+	struct p_batch_job job = { v, f, ctx };
 
-#ifdef TRADITIONAL_BINARY_SEARCH
-	if (p_standard_binary_search(v, key, item_index, f1)) {
-		return true;
-	} else {
-		*item_index = 0;
-		return false;
-	}
-#endif // TRADITIONAL_BINARY_SEARCH
-#ifndef TRADITIONAL_BINARY_SEARCH
-	if (p_adaptive_binary_search(v, key, item_index, f1)) {
-		return true;
-	} else {
-		*item_index = 0;
-		return false;
-	}
-#endif // ADAPTIVE TRADITIONAL_BINARY_SEARCH
+	// Items are stored contiguously, so the whole
+	// vector can be passed as a single batch:
+	p_batch_chunk(&job, 0, p_vect_size(v));
 
-// VECT_BSEARCH_DONE_PROCESSING:
-	// TODO: Add mutex unlock
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
 
-VECT_BSEARCH_JOB_DONE:
+VECT_APPLY_BATCH_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
 	SET_ERROR(v, rval);
 #endif
-
-	return false;
 }
 
-// Traditional Linear Search Algorithm,
-// useful with non-sorted vectors:
-#if !defined(ZVECT_COOPERATIVE)
-bool vect_lsearch(ivector v, const void *key,
-                  int (*f1)(const void *, const void *),
-                  zvect_index *item_index) {
-	*item_index = 0;
-
+void vect_apply_range_batch(ivector v, void (*f)(void **, size_t, void *),
+			    void *ctx, const zvect_index x, const zvect_index y)
+{
 	// Check parameters:
-	if ((key == NULL) || (f1 == NULL) || (p_vect_size(v) == 0))
-		return false;
-
-	zvect_index vsize = 0;
+	if ( f == NULL )
+		return;
 
 	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_LSEARCH_JOB_DONE;
-
-	// TODO: Add mutex locking
-	vsize = p_vect_size(v);
+		goto VECT_APPLY_RNG_BATCH_JOB_DONE;
 
-	// First case (vector is empty, so we can't search):
-	if (vsize == 0)
-		goto VECT_LSEARCH_JOB_DONE;
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
-	// Second case (vector has only 1 item, so we can't search):
-	if (vsize == 1) {
-		if ((*f1)(key, v->data[v->begin]) != 0) {
-			*item_index = 0;
-			return true;
-		} else {
-			goto VECT_LSEARCH_JOB_DONE;
-		}
+	if (x >= p_vect_size(v) || y >= p_vect_size(v))
+	{
+		rval = ZVERR_IDXOUTOFBOUND;
+		goto VECT_APPLY_RNG_BATCH_DONE_PROCESSING;
 	}
 
-	// Check if we can do unrolled search:
-	if ( (vsize & 3) == 0 ) {
-		// Nice, we can do some unrolled search
-		// to speed up the process:
-		for (register zvect_index x=0; x<vsize; x+=4) {
-			if ((*f1)(key, v->data[v->begin + x]) != 0) {
-				*item_index = x;
-				return true;
-			}
-			if ((*f1)(key, v->data[v->begin + (x+1)]) != 0) {
-				*item_index = x + 1;
-				return true;
-			}
-			if ((*f1)(key, v->data[v->begin + (x+2)]) != 0) {
-				*item_index = x + 2;
-				return true;
-			}
-			if ((*f1)(key, v->data[v->begin + (x+3)]) != 0) {
-				*item_index = x + 3;
-				return true;
-			}
-		}
-	} else {
-		// We can't do unrolled search, so let's
-		// do a normal linear search:
-		for (register zvect_index x=0; x<vsize; x++) {
-			if ((*f1)(key, v->data[v->begin + x]) != 0) {
-				*item_index = x;
-				return true;
-			}
-		}
-	}
+	struct p_batch_job job = { v, f, ctx };
 
-VECT_LSEARCH_JOB_DONE:
+	// Process the vector (please note: the range is inclusive):
+	if (x > y)
+		p_batch_chunk(&job, y, x + 1);
+	else
+		p_batch_chunk(&job, x, y + 1);
+
+VECT_APPLY_RNG_BATCH_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_APPLY_RNG_BATCH_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
 #else
 	SET_ERROR(v, rval);
 #endif
-
-	*item_index = 0;
-	return false;
 }
-#endif // TRADITIONAL_LINEAR_SEARCH
 
-#if defined(ZVECT_COOPERATIVE)
-// Cooperative and iterative linear search algorithm:
-bool vect_lsearch(ivector v, const void *key,
-		  int (*f1)(const void *, const void *),
-		  zvect_index *item_index,
-		  cmt_state const state,
-		  zvect_index maxIterations)
+void vect_apply_batch_parallel(ivector v, void (*f)(void **, size_t, void *),
+			       void *ctx, zvect_index nthreads, zvect_index grain)
 {
 	// Check parameters:
-	if ((key == NULL) || (f1 == NULL) || (p_vect_size(v) == 0))
-		return false;
+	if ( f == NULL )
+		return;
 
-	// check if the vector exists:
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_LSEARCH_JOB_DONE;
+		goto VECT_APPLY_BATCH_PAR_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
+
+	struct p_batch_job job = { v, f, ctx };
+
+	// Process the vector (each chunk is a batch):
+	rval = p_pool_run_range(0, p_vect_size(v), nthreads, grain, p_batch_chunk, &job);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_APPLY_BATCH_PAR_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+// Reduce and scan:
+// The parallel versions split the vector in chunks of "grain"
+// items, fold every chunk in its own partial accumulator (the
+// partial accumulators are cache line aligned, so the threads
+// don't share cache lines) and then combine the partials in
+// order, so combine needs to be associative but not commutative.
+#define P_REDUCE_MAX_CHUNKS 256
+
+struct p_reduce_job {
+	struct p_vector *v;
+	void (*fold)(void *, const void *, void *);
+	void *ctx;
+	char *partials;			// - One accumulator per chunk
+	void *partials_mem;		// - Memory allocated for partials
+	size_t stride;			// - Distance between two partials
+	size_t acc_size;
+	char *out;			// - Scan output (NULL for reduce)
+	zvect_index grain;
+};
 
-	// TODO: Add mutex locking
-	zvect_index vsize = p_vect_size(v);
+static inline size_t p_reduce_stride(size_t acc_size) {
+	return (acc_size + 63) & ~((size_t)63);
+}
 
-	// Special case (vector has only 1 item, so we can't search):
-	if (vsize == 1) {
-		if ((*f1)(key, v->data[v->begin]) != 0) {
-			*item_index = 0;
-			return true;
-		} else {
-			goto VECT_LSEARCH_JOB_DONE;
-		}
+static inline zvect_index p_reduce_grain(zvect_index items, zvect_index grain) {
+	if (grain == 0) {
+		grain = items / P_REDUCE_MAX_CHUNKS;
+		if (grain < ZVECT_POOL_MIN_GRAIN)
+			grain = ZVECT_POOL_MIN_GRAIN;
 	}
+	return grain;
+}
 
-	// Check if the state is initialized:
-	if (!state->isInitialized) {
-		*item_index = 0;
-		state->currentIndex = 0;
-		state->isInitialized = true;
+// Folds the items [start, end) into the partial accumulator of
+// their chunk (a range can span multiple chunks when the pool
+// processes it on a single thread):
+static void p_reduce_chunk(void *arg, zvect_index start, zvect_index end)
+{
+	const struct p_reduce_job *job = (const struct p_reduce_job *)arg;
+	void ** const data = job->v->data + job->v->begin;
+
+	while (start < end) {
+		zvect_index c = start / job->grain;
+		zvect_index ce = (c + 1) * job->grain;
+		if ((ce > end) || (ce < start))
+			ce = end;
+		void *acc = job->partials + (c * job->stride);
+		for (register zvect_index i = start; i < ce; i++)
+			(*(job->fold))(acc, data[i], job->ctx);
+		start = ce;
 	}
+}
 
-	// Initialize internal parameters:
-	zvect_index iterations = 0;
-	zvect_index x = state->currentIndex;
-	if (maxIterations == 0)
-		maxIterations = vsize;
-	if (maxIterations > vsize)
-		maxIterations = vsize;
-	if (maxIterations > (vsize - x))
-		maxIterations = vsize - x;
-
-	// Search in the vector:
-	while (x < vsize && iterations < maxIterations) {
-		if (f1(key, v->data[v->begin + x]) != 0) {
-			*item_index = x;
-			return true;
+// Scans the items [start, end), every chunk starts from the
+// accumulator in its partial (the combination of all the items
+// before the chunk):
+static void p_scan_chunk(void *arg, zvect_index start, zvect_index end)
+{
+	const struct p_reduce_job *job = (const struct p_reduce_job *)arg;
+	void ** const data = job->v->data + job->v->begin;
+
+	while (start < end) {
+		zvect_index c = start / job->grain;
+		zvect_index ce = (c + 1) * job->grain;
+		if ((ce > end) || (ce < start))
+			ce = end;
+		const char *prev = job->partials + (c * job->stride);
+		for (register zvect_index i = start; i < ce; i++) {
+			char *acc = job->out + ((size_t)i * job->acc_size);
+			p_vect_memcpy(acc, prev, job->acc_size);
+			(*(job->fold))(acc, data[i], job->ctx);
+			prev = acc;
 		}
-		x++;
-		iterations++;
-
-		// Check if we can do loop unrolling
-		// within the cooperative search:
-		if ((maxIterations - iterations) > 3)
-		{
-			// Nice, we can do some unrolled search
-			if (f1(key, v->data[v->begin + x]) != 0) {
-        			*item_index = x;
-        			return true;
-    			}
-    			if (f1(key, v->data[v->begin + x + 1]) != 0) {
-        			*item_index = x + 1;
-        			return true;
-    			}
-    			if (f1(key, v->data[v->begin + x + 2]) != 0) {
-        			*item_index = x + 2;
-        			return true;
-    			}
-    			if (f1(key, v->data[v->begin + x + 3]) != 0) {
-        			*item_index = x + 3;
-        			return true;
-    			}
-    			x += 3; // Skip ahead for unrolled iterations
-    			iterations += 3; // Update iteration count
-        	}
+		start = ce;
 	}
+}
 
-	state->currentIndex = x;
+// Allocates and initialises (to identity) the partial accumulators:
+static zvect_retval p_reduce_setup(struct p_reduce_job *job, zvect_index items,
+				   const void *identity, zvect_index grain)
+{
+	job->grain = p_reduce_grain(items, grain);
+	job->stride = p_reduce_stride(job->acc_size);
 
-	// Check if the search is complete
-	if (x >= vsize) {
-		*item_index = 0;
-		return false;
-	}
+	zvect_index nchunks = (items / job->grain) + 1;
+	job->partials_mem = malloc((job->stride * nchunks) + 63);
+	if (job->partials_mem == NULL)
+		return ZVERR_OUTOFMEM;
+	job->partials = (char *)(((uintptr_t)job->partials_mem + 63) & ~((uintptr_t)63));
+	for (zvect_index c = 0; c < nchunks; c++)
+		p_vect_memcpy(job->partials + (c * job->stride), identity, job->acc_size);
 
-VECT_LSEARCH_JOB_DONE:
-	return false; // Indicate more iterations are needed
+	return 0;
 }
 
-#endif // COOPERATIVE_LINEAR_SEARCH
+void vect_reduce(ivector v, void *acc,
+		 void (*fold)(void *acc, const void *item, void *ctx), void *ctx)
+{
+	// Check parameters:
+	if ( acc == NULL || fold == NULL )
+		return;
 
-#endif // ZVECT_DMF_EXTENSIONS
+	zvect_retval rval = p_vect_check(v);
+	if (rval)
+		goto VECT_REDUCE_JOB_DONE;
 
-#ifdef ZVECT_SFMD_EXTENSIONS
-// Single Function Call Multiple Data operations extensions:
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
-#if !defined(ZVECT_COOPERATIVE)
-void vect_apply(ivector v, void (*f)(void *)) {
-	// Check Parameters:
-	if (f == NULL)
+	void ** const data = v->data + v->begin;
+	zvect_index vsize = p_vect_size(v);
+	for (register zvect_index i = 0; i < vsize; i++)
+		(*fold)(acc, data[i], ctx);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
+
+VECT_REDUCE_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v, rval);
+#endif
+}
+
+void vect_reduce_parallel(ivector v, void *acc, size_t acc_size, const void *identity,
+			  void (*fold)(void *acc, const void *item, void *ctx),
+			  void (*combine)(void *acc, const void *partial, void *ctx),
+			  void *ctx, zvect_index nthreads, zvect_index grain)
+{
+	// Check parameters:
+	if ( acc == NULL || identity == NULL || acc_size == 0 ||
+	     fold == NULL || combine == NULL )
 		return;
 
+	struct p_reduce_job job = { v, fold, ctx, NULL, NULL, 0, acc_size, NULL, 0 };
+
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_APPLY_JOB_DONE;
+		goto VECT_REDUCE_PAR_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	// Process the vector:
-	// Check if we can do loop unrolling
 	zvect_index vsize = p_vect_size(v);
-	register zvect_index i = 0;
-	if (vsize > 4) {
-		// Nice, we can do some unrolled apply:
-		for (i = 0; i <= (vsize - 4); i+=4)
-		{
-#if (COMPILER == COMPILER_GCC)
-			#pragma GCC unroll 4
-			for (zvect_index x=i; x < i + 4; x++)
-				(*f)(v->data[v->begin + x]);
-#else
-			(*f)(v->data[v->begin + i]);
-			(*f)(v->data[v->begin + (i+1)]);
-			(*f)(v->data[v->begin + (i+2)]);
-			(*f)(v->data[v->begin + (i+3)]);
-#endif
-		}
-	}
-	// Cleanup loop for remaining elements if any
-	for (; i < vsize; i++)
-		(*f)(v->data[v->begin + i]);
+	if (vsize == 0)
+		goto VECT_REDUCE_PAR_DONE_PROCESSING;
+
+	rval = p_reduce_setup(&job, vsize, identity, grain);
+	if (rval)
+		goto VECT_REDUCE_PAR_DONE_PROCESSING;
+
+	// Fold the chunks in parallel:
+	rval = p_pool_run_range(0, vsize, nthreads, job.grain, p_reduce_chunk, &job);
+	if (rval)
+		goto VECT_REDUCE_PAR_DONE_PROCESSING;
+
+	// Combine the partials, in order:
+	for (zvect_index c = 0; c <= ((vsize - 1) / job.grain); c++)
+		(*combine)(acc, job.partials + (c * job.stride), ctx);
 
-//VECT_APPLY_DONE_PROCESSING:
+VECT_REDUCE_PAR_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_APPLY_JOB_DONE:
+VECT_REDUCE_PAR_JOB_DONE:
+	free(job.partials_mem);
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -3299,51 +10297,39 @@ VECT_APPLY_JOB_DONE:
 	SET_ERROR(v, rval);
 #endif
 }
-#endif
 
-#if defined(ZVECT_COOPERATIVE)
-void vect_apply(ivector v,
-		void (*f)(void *),
-		cmt_state const state,
-		zvect_index maxIterations)
+void vect_scan(ivector v, void *out, size_t acc_size, const void *init,
+	       void (*fold)(void *acc, const void *item, void *ctx), void *ctx)
 {
-	// Check Parameters:
-	if (f == NULL)
+	// Check parameters:
+	if ( out == NULL || init == NULL || acc_size == 0 || fold == NULL )
 		return;
 
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_APPLY_JOB_DONE;
+		goto VECT_SCAN_JOB_DONE;
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
+#endif
+	p_vect_settle_locked(v);
 
+	void ** const data = v->data + v->begin;
 	zvect_index vsize = p_vect_size(v);
-	zvect_index iterations = 0;
-	if (!state->isInitialized) {
-		state->currentIndex = 0;
-		state->isInitialized = true;
+	const char *prev = (const char *)init;
+	for (register zvect_index i = 0; i < vsize; i++) {
+		char *acc = (char *)out + ((size_t)i * acc_size);
+		p_vect_memcpy(acc, prev, acc_size);
+		(*fold)(acc, data[i], ctx);
+		prev = acc;
 	}
 
-	if ((vsize & 3) == 0) {
-		// Unrolled loop
-		while (state->currentIndex < vsize &&
-			iterations < maxIterations) {
-        		(*f)(v->data[v->begin + state->currentIndex]);
-        		(*f)(v->data[v->begin + state->currentIndex + 1]);
-        		(*f)(v->data[v->begin + state->currentIndex + 2]);
-        		(*f)(v->data[v->begin + state->currentIndex + 3]);
-        		state->currentIndex += 4;
-        		iterations += 4;
-		}
-	} else {
-		// Standard loop
-		while (state->currentIndex < vsize &&
-		       iterations < maxIterations) {
-        		(*f)(v->data[v->begin + state->currentIndex]);
-        		state->currentIndex++;
-        		iterations++;
-        	}
-	}
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v, 1);
+#endif
 
-VECT_APPLY_JOB_DONE:
+VECT_SCAN_JOB_DONE:
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -3352,52 +10338,73 @@ VECT_APPLY_JOB_DONE:
 #endif
 }
 
-
-#endif // COOPERATIVE_APPLY
-
-void vect_apply_range(ivector v, void (*f)(void *), const zvect_index x,
-		      const zvect_index y)
+void vect_scan_parallel(ivector v, void *out, size_t acc_size,
+			const void *init, const void *identity,
+			void (*fold)(void *acc, const void *item, void *ctx),
+			void (*combine)(void *acc, const void *partial, void *ctx),
+			void *ctx, zvect_index nthreads, zvect_index grain)
 {
 	// Check parameters:
-	if ( f == NULL )
+	if ( out == NULL || init == NULL || identity == NULL || acc_size == 0 ||
+	     fold == NULL || combine == NULL )
 		return;
 
-	// check if the vector exists:
+	struct p_reduce_job job = { v, fold, ctx, NULL, NULL, 0, acc_size, NULL, 0 };
+
 	zvect_retval rval = p_vect_check(v);
 	if (rval)
-		goto VECT_APPLY_RNG_JOB_DONE;
+		goto VECT_SCAN_PAR_JOB_DONE;
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v, 1);
 #endif
+	p_vect_settle_locked(v);
 
-	if (x > p_vect_size(v) || y > p_vect_size(v))
-	{
-		rval = ZVERR_IDXOUTOFBOUND;
-		goto VECT_APPLY_RNG_DONE_PROCESSING;
+	zvect_index vsize = p_vect_size(v);
+	if (vsize == 0)
+		goto VECT_SCAN_PAR_DONE_PROCESSING;
+
+	rval = p_reduce_setup(&job, vsize, identity, grain);
+	if (rval)
+		goto VECT_SCAN_PAR_DONE_PROCESSING;
+
+	// First pass: reduce every chunk (the last chunk is not
+	// needed, nothing comes after it):
+	zvect_index last = (vsize - 1) / job.grain;
+	if (last > 0) {
+		rval = p_pool_run_range(0, last * job.grain, nthreads, job.grain, p_reduce_chunk, &job);
+		if (rval)
+			goto VECT_SCAN_PAR_DONE_PROCESSING;
 	}
 
-	zvect_index start;
-	zvect_index end;
-	if (x > y) {
-		start = x;
-		end = y;
-	} else {
-		start = y;
-		end = x;
+	// Turn the partials into the accumulator at the start of
+	// every chunk (init combined with all the chunks before):
+	char *tmp = (char *)malloc(acc_size * 2);
+	if (tmp == NULL) {
+		rval = ZVERR_OUTOFMEM;
+		goto VECT_SCAN_PAR_DONE_PROCESSING;
 	}
+	p_vect_memcpy(tmp, init, acc_size);
+	for (zvect_index c = 0; c <= last; c++) {
+		char *partial = job.partials + (c * job.stride);
+		p_vect_memcpy(tmp + acc_size, partial, acc_size);
+		p_vect_memcpy(partial, tmp, acc_size);
+		(*combine)(tmp, tmp + acc_size, ctx);
+	}
+	free(tmp);
 
-	// Process the vector:
-	for (register zvect_index i = start; i <= end; i++)
-		(*f)(v->data[v->begin + i]);
+	// Second pass: scan every chunk from its own start:
+	job.out = (char *)out;
+	rval = p_pool_run_range(0, vsize, nthreads, job.grain, p_scan_chunk, &job);
 
-VECT_APPLY_RNG_DONE_PROCESSING:
+VECT_SCAN_PAR_DONE_PROCESSING:
 #if (ZVECT_THREAD_SAFE == 1)
 	if (lock_owner)
 		get_mutex_unlock(v, 1);
 #endif
 
-VECT_APPLY_RNG_JOB_DONE:
+VECT_SCAN_PAR_JOB_DONE:
+	free(job.partials_mem);
 #if (ZVECT_HANDLE_ERRORS == 1)
 	if (rval)
 		p_throw_error(rval, NULL);
@@ -3417,10 +10424,12 @@ void vect_apply_if(ivector v1, const_vector const v2, void (*f1)(void *),
 	zvect_retval rval = p_vect_check(v1) | p_vect_check(v2);
 	if (rval)
 		goto VECT_APPLY_IF_JOB_DONE;
+	p_vect_settle(v2);
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v1->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v1, 1);
 #endif
+	p_vect_settle_locked(v1);
 
 	// Check parameters:
 	if (p_vect_size(v1) > p_vect_size(v2)) {
@@ -3491,10 +10500,12 @@ void vect_apply_if(ivector v1, const_vector const v2, void (*f1)(void *),
 	zvect_retval rval = p_vect_check(v1) | p_vect_check(v2);
 	if (rval)
 		goto VECT_APPLY_IF_JOB_DONE;
+	p_vect_settle(v2);
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v1->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v1, 1);
 #endif
+	p_vect_settle_locked(v1);
 
 	zvect_index vsize = p_vect_size(v1);
 	zvect_index iterations = 0;
@@ -3556,16 +10567,70 @@ VECT_APPLY_IF_JOB_DONE:
 
 #endif // COOPERATIVE_APPLY_IF
 
+void vect_apply_if_ctx(ivector v1, const_vector const v2,
+		       void (*f1)(void *, void *),
+		       bool (*f2)(void *, void *, void *), void *ctx) {
+	// Check parameters:
+	if (f1 == NULL || f2 == NULL)
+		return;
+
+	// check if the vector exists:
+	zvect_retval rval = p_vect_check(v1) | p_vect_check(v2);
+	if (rval)
+		goto VECT_APPLY_IF_CTX_JOB_DONE;
+	p_vect_settle(v2);
+
+#if (ZVECT_THREAD_SAFE == 1)
+	zvect_retval lock_owner = (locking_disabled || (v1->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v1, 1);
+#endif
+	p_vect_settle_locked(v1);
+
+	// Check parameters:
+	if (p_vect_size(v1) > p_vect_size(v2)) {
+		rval = ZVERR_VECTTOOSMALL;
+		goto VECT_APPLY_IF_CTX_DONE_PROCESSING;
+	}
+
+	// Process vectors:
+	zvect_index vsize = p_vect_size(v1);
+	void ** const data1 = v1->data + v1->begin;
+	void ** const data2 = v2->data + v2->begin;
+	for (register zvect_index i = 0; i < vsize; i++)
+		if ((*f2)(data1[i], data2[i], ctx))
+			(*f1)(data1[i], ctx);
+
+VECT_APPLY_IF_CTX_DONE_PROCESSING:
+#if (ZVECT_THREAD_SAFE == 1)
+	if (lock_owner)
+		get_mutex_unlock(v1, 1);
+#endif
+
+VECT_APPLY_IF_CTX_JOB_DONE:
+#if (ZVECT_HANDLE_ERRORS == 1)
+	if (rval)
+		p_throw_error(rval, NULL);
+#else
+	SET_ERROR(v1, rval);
+#endif
+}
+
 void vect_copy(ivector v1, ivector v2, const zvect_index s2,
                const zvect_index e2) {
 	// check if the vectors v1 and v2 exist:
 	zvect_retval rval = p_vect_check(v1) | p_vect_check(v2);
 	if (rval)
 		goto VECT_COPY_JOB_DONE;
+	p_vect_settle(v2);
 
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v1->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v1, 2);
 #endif
+	p_vect_settle_locked(v1);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v1);
+#endif  // ZVECT_DMF_EXTENSIONS
 
 	// We can only copy vectors with the same data_size!
 	if (v1->data_size != v2->data_size) {
@@ -3626,9 +10691,16 @@ void vect_insert(ivector v1, ivector v2, const zvect_index s2,
 	zvect_retval rval = p_vect_check(v1) | p_vect_check(v2);
 	if (rval)
 		goto VECT_INSERT_JOB_DONE;
+	p_vect_settle(v2);
 #if (ZVECT_THREAD_SAFE == 1)
 	zvect_retval lock_owner = (locking_disabled || (v1->flags & ZV_NOLOCKING)) ? 0 : get_mutex_lock(v1, 2);
 #endif
+	p_vect_settle_locked(v1);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v1);
+#endif  // ZVECT_DMF_EXTENSIONS
 
 	// We can only copy vectors with the same data_size!
 	if (v1->data_size != v2->data_size) {
@@ -3772,6 +10844,10 @@ static inline zvect_retval p_vect_move(ivector v1, ivector v2, const zvect_index
 		goto P_VECT_MOVE_DONE_PROCESSING;
 	}
 
+#ifdef ZVECT_DMF_EXTENSIONS
+	p_hindex_invalidate(v1);
+#endif  // ZVECT_DMF_EXTENSIONS
+
 	// Update v1 size:
 	v1->end += ee2;
 
@@ -3815,6 +10891,8 @@ void vect_move(ivector v1, vector v2, const zvect_index s2,
 	log_msg(ZVLP_INFO, "vect_move: lock_owner2 for vector v2: %*u\n",10,lock_owner2);
 #	endif // ZVECT_THREAD_SAFE
 #endif
+	p_vect_settle_locked(v1);
+	p_vect_settle_locked(v2);
 
 	// We can only copy vectors with the same data_size!
 	if (v1->data_size != v2->data_size) {
@@ -3873,6 +10951,8 @@ zvect_retval vect_move_if(ivector v1, vector v2, const zvect_index s2,
 	log_msg(ZVLP_INFO, "vect_move_if: lock_owner2 for vector v2: %*u\n",10,lock_owner2);
 #	endif // ZVECT_THREAD_SAFE
 #endif
+	p_vect_settle_locked(v1);
+	p_vect_settle_locked(v2);
 
 	// We can only move vectors with the same data_size!
 	if (v1->data_size != v2->data_size) {
@@ -3943,6 +11023,8 @@ zvect_retval vect_move_on_signal(ivector v1, vector v2, const zvect_index s2,
 	log_msg(ZVLP_MEDIUM, "vect_move_on_signal: --- begin ---\n");
 #endif
 	// Proceed with move items:
+	p_vect_settle_locked(v1);
+	p_vect_settle_locked(v2);
 	rval = p_vect_move(v1, v2, s2, e2);
 
 #ifdef DEBUG
@@ -4003,6 +11085,11 @@ void *vect_merge(ivector v1, vector v2) {
 
 #endif
 
+#ifdef ZVECT_DMF_EXTENSIONS
+	// Items are added in bulk, so the hash index must be rebuilt:
+	p_hindex_invalidate(v1);
+#endif  // ZVECT_DMF_EXTENSIONS
+
 #ifdef DEBUG
 	log_msg(ZVLP_INFO, "vect_merge: --- begin ---\n");
 #	if (ZVECT_THREAD_SAFE == 1)
@@ -4010,6 +11097,8 @@ void *vect_merge(ivector v1, vector v2) {
 	log_msg(ZVLP_INFO, "vect_merge: lock_owner2 for vector v2: %*u\n",10,lock_owner2);
 #	endif // ZVECT_THREAD_SAFE
 #endif // DEBUG
+	p_vect_settle_locked(v1);
+	p_vect_settle_locked(v2);
 
 	// We can only copy vectors with the same data_size!
 	if (v1->data_size != v2->data_size) {
@@ -34,6 +34,48 @@ extern "C" {
 typedef struct p_vector * vector;
 typedef struct p_vector const * const_vector;
 
+// Caller-owned cursor used by vect_bsearch_hint to store the
+// Adaptive Binary Search hints between searches. Initialise
+// it to zero before the first search:
+// bsearch_cursor c = { 0, 0 };
+typedef struct p_bsearch_cursor {
+	zvect_index bottom;		// - Where the last search ended
+	zvect_index balance;		// - Distance between the last two searches
+} bsearch_cursor;
+
+// Static search index built over an ordered vector by
+// vect_index_build (see vect_index_find):
+typedef struct p_search_index * search_index;
+
+// Numeric vector storing its values contiguously (see
+// vect_create_typed):
+typedef struct p_typed_vector * typed_vector;
+
+// Vector of records storing every field in its own column (see
+// vect_create_columnar), the fields are described by their
+// offset and size in the record:
+typedef struct p_columnar_vector * columnar_vector;
+typedef struct p_zvect_field {
+	size_t offset;			// - Offset of the field (use offsetof)
+	size_t size;			// - Size of the field
+} zvect_field;
+
+// Vector of bits packed in 64 bit words (see vect_create_bits):
+typedef struct p_bit_vector * bit_vector;
+
+// Vector of variable length items (strings or blobs) stored in a
+// single byte arena (see vect_create_varlen):
+typedef struct p_varlen_vector * varlen_vector;
+
+// Container giving its items stable handles (see
+// vect_create_slot_map):
+typedef struct p_slot_map * slot_map;
+typedef uint64_t zvect_handle;
+
+// Zero-copy view over a range of a vector's items (see
+// vect_view_make):
+typedef struct p_view * vect_view;
+
 #if defined(ZVECT_COOPERATIVE)
 // Cooperative Scheduler support
 typedef struct p_cmt_state * cmt_state;
@@ -64,6 +106,44 @@ enum ZVECT_PROPERTIES {
 	ZV_BYREF      = 1 << 1, // Sets the vector to store items by reference instead of copying them as per default.
 	ZV_CIRCULAR   = 1 << 2, // Sets the vector to be a circular vector (so it will not grow in capacity automatically). Elements will be overwritten as in typical circular buffers!
 	ZV_NOLOCKING  = 1 << 3, // This Property means the vector will not use mutexes, be careful using it!
+	ZV_LAZY_DELETE = 1 << 4, // vect_delete_at and vect_remove_at mark items as dead instead of shifting the vector (see vect_compact). Ignored by circular vectors.
+	ZV_GAP_BUFFER = 1 << 5, // Items are added and deleted at a gap of free slots kept at the last edit position, so clustered edits don't shift the vector (see vect_compact). Ignored by circular vectors, overrides ZV_LAZY_DELETE.
+	ZV_TREE       = 1 << 6, // Large vectors store their items in a counted B+tree, so adding and deleting items at any index is O(log n) (see vect_compact). Ignored by circular vectors, overrides ZV_GAP_BUFFER and ZV_LAZY_DELETE.
+};
+
+/*
+ * CPU Features Flags identify the instruction set extensions
+ * ZVector can use for its bulk kernels (see vect_get_cpu_features
+ * and vect_set_cpu_features).
+ */
+enum ZVECT_CPU_FEATURES {
+	ZV_CPU_NONE   = 0,      // Portable scalar kernels only.
+	ZV_CPU_SSE2   = 1 << 0, // x86_64 SSE2 kernels.
+	ZV_CPU_AVX2   = 1 << 1, // x86_64 AVX2 kernels.
+	ZV_CPU_AVX512 = 1 << 2, // x86_64 AVX-512 (AVX-512F) kernels.
+	ZV_CPU_ALL    = ZV_CPU_SSE2 | ZV_CPU_AVX2 | ZV_CPU_AVX512,
+};
+
+/*
+ * Typed vectors value types (see vect_create_typed).
+ */
+enum ZVECT_TYPES {
+	ZV_T_I32      = 1,      // int32_t values.
+	ZV_T_I64      = 2,      // int64_t values.
+	ZV_T_F32      = 3,      // float values.
+	ZV_T_F64      = 4,      // double values.
+};
+
+/*
+ * Compare operators used by vect_typed_count_if.
+ */
+enum ZVECT_CMP {
+	ZV_LT         = 0,      // Item < value
+	ZV_LE         = 1,      // Item <= value
+	ZV_EQ         = 2,      // Item == value
+	ZV_NE         = 3,      // Item != value
+	ZV_GE         = 4,      // Item >= value
+	ZV_GT         = 5,      // Item > value
 };
 
 enum ZVECT_ERR {
@@ -75,7 +155,8 @@ enum ZVECT_ERR {
 	ZVERR_VECTTOOSMALL  = -6,
 	ZVERR_VECTDATASIZE  = -7,
 	ZVERR_VECTEMPTY     = -8,
-	ZVERR_OPNOTALLOWED  = -9
+	ZVERR_OPNOTALLOWED  = -9,
+	ZVERR_VIEWSTALE     = -10
 };
 
 extern unsigned int LOG_PRIORITY;
@@ -247,8 +328,103 @@ zvect_retptr vect_sem_wait(const vector v);
 
 zvect_retptr vect_sem_post(const vector v);
 
+// Worker Pool functions:
+
+/*
+ * vect_pool_set_threads allows you to configure how many
+ * worker threads ZVector will use for its parallel
+ * functions (the calling thread always helps, so 0 means
+ * parallel functions will run entirely on the calling
+ * thread). The default is the number of online CPUs - 1.
+ * If the pool is running it will be stopped and then
+ * restarted with the new configuration at the next
+ * parallel operation. Do NOT call this function while a
+ * parallel operation is in progress.
+ *
+ * Example of use: To use 3 worker threads
+ * vect_pool_set_threads(3);
+ */
+zvect_retval vect_pool_set_threads(zvect_index nthreads);
+
+/*
+ * vect_pool_get_threads returns the number of worker
+ * threads the pool is configured to use.
+ */
+zvect_index vect_pool_get_threads(void);
+
+/*
+ * vect_pool_set_affinity allows you to pin the worker
+ * threads to the given list of CPUs (worker i will run on
+ * cpus[i % ncpus]). Passing NULL (or ncpus = 0) removes
+ * the affinity. This is currently supported on Linux only,
+ * on other platforms it returns ZVERR_OPNOTALLOWED.
+ *
+ * Example of use: To pin the workers to CPUs 2 and 3
+ * int cpus[] = { 2, 3 };
+ * vect_pool_set_affinity(cpus, 2);
+ */
+zvect_retval vect_pool_set_affinity(const int *cpus, zvect_index ncpus);
+
+/*
+ * vect_pool_submit_range splits the range [start, end) of
+ * the vector v in chunks of "grain" items and calls
+ * f(v, chunk_start, chunk_end, ctx) for each chunk on the
+ * worker pool. The function returns when all the chunks
+ * have been processed. The vector is locked for the whole
+ * operation, so f must not call ZVector functions that
+ * lock v. nthreads set to 0 means use all the pool
+ * threads, grain set to 0 means let ZVector pick a chunk
+ * size.
+ *
+ * Example of use: To process the whole vector v with
+ * my_func:
+ * vect_pool_submit_range(v, 0, vect_size(v), my_func, NULL, 0, 0);
+ */
+zvect_retval vect_pool_submit_range(vector v, zvect_index start,
+				    zvect_index end,
+				    void (*f)(vector, zvect_index, zvect_index, void *),
+				    void *ctx, zvect_index nthreads,
+				    zvect_index grain);
+
+/*
+ * vect_pool_shutdown stops all the worker threads and
+ * releases the pool resources. The pool will be restarted
+ * automatically at the next parallel operation. Do NOT
+ * call this function while a parallel operation is in
+ * progress.
+ */
+void vect_pool_shutdown(void);
+
 #endif  // ( ZVECT_THREAD_SAFE == 1 )
 
+// CPU features functions:
+
+/*
+ * vect_get_cpu_features returns the CPU features (see
+ * enum ZVECT_CPU_FEATURES) detected at runtime on the CPU
+ * ZVector is running on.
+ */
+uint32_t vect_get_cpu_features(void);
+
+/*
+ * ZVector selects the best bulk kernels (pointer-array
+ * fill, byte-key search and numeric reductions) for the CPU
+ * at initialisation time, pointer moves and secure wipes use
+ * the C library memmove and memset.
+ * vect_set_cpu_features allows you to restrict the kernels
+ * to the given set of features (only the ones supported by
+ * the CPU will be used), it returns the features actually in
+ * use. This is mostly useful for benchmarking and testing.
+ * Do NOT call this function while other threads are using
+ * ZVector.
+ *
+ * Example of use: To use only the portable scalar kernels
+ * vect_set_cpu_features(ZV_CPU_NONE);
+ * and to restore the defaults:
+ * vect_set_cpu_features(ZV_CPU_ALL);
+ */
+uint32_t vect_set_cpu_features(uint32_t features);
+
 /////////////////////////////////////////////////////
 // Vector Data Storage functions:
 
@@ -423,6 +599,417 @@ void vect_delete_range(vector const v, const zvect_index first_element, const zv
  */
 void vect_delete_front(vector const v);
 
+/*
+ * On vectors created with ZV_LAZY_DELETE, vect_delete_at and
+ * vect_remove_at don't shift the items that follow the one
+ * removed, they just mark it as dead (a tombstone), which makes
+ * bursts of scattered deletes on large vectors much cheaper.
+ * vect_size, vect_is_empty and vect_get(_at/_front) skip the
+ * dead items (in O(log n)), while all the other functions
+ * compact the vector first. The vector is also compacted when
+ * its dead items reach ZVECT_LAZY_DELETE_RATIO percent (see
+ * zvector_config.h), or explicitly with vect_compact.
+ *
+ * For example:
+ * vector v = vect_create(0, sizeof(int), ZV_LAZY_DELETE);
+ * ...
+ * for (i = 0; i < n; i++)
+ *     vect_delete_at(v, victims[i]);
+ * vect_compact(v);
+ *
+ * On vectors created with ZV_GAP_BUFFER, the free slots of the
+ * vector are kept as a gap at the position of the last item
+ * added or deleted (a gap buffer). vect_add(_at/_front),
+ * vect_push, vect_delete_at and vect_remove_at move the gap to
+ * their index first, which moves only the items between the
+ * two positions, so edits clustered around a moving cursor
+ * (like in a text editor) cost O(1) amortised instead of
+ * shifting all the items that follow. vect_size, vect_is_empty
+ * and vect_get(_at/_front) skip the gap, while all the other
+ * functions close it first (vect_compact closes it too).
+ *
+ * For example:
+ * vector v = vect_create(0, sizeof(char), ZV_GAP_BUFFER);
+ * vect_add_at(v, &c, cursor++);
+ * ...
+ * vect_delete_at(v, --cursor);
+ *
+ * On vectors created with ZV_TREE, once the vector is large
+ * enough (a few thousand items) the item pointers are moved to
+ * blocks of 4KB organised in a counted B+tree, so finding,
+ * adding and deleting the item at any index cost O(log n)
+ * instead of moving all the following items (which for
+ * hundreds of millions of items means moving hundreds of MB
+ * of pointers on every operation). vect_add(_at/_front),
+ * vect_push, vect_delete_at, vect_delete_range, vect_remove_at
+ * and vect_put_at work on the tree, vect_size, vect_is_empty,
+ * vect_get(_at/_front), vect_apply, vect_apply_range,
+ * vect_lsearch and vect_bsearch (O(log^2 n) on the tree) read
+ * it, while all the other functions move the items back to a
+ * contiguous vector first (vect_compact does it too), and the
+ * next add or delete moves them to a new tree. Both moves cost
+ * O(n), so workloads that mix edits with calls that are not
+ * tree aware (sorts, hash index lookups, views, bulk copies)
+ * pay O(n) per call instead of O(log n).
+ *
+ * For example:
+ * vector v = vect_create(0, sizeof(struct record), ZV_TREE);
+ * ...
+ * vect_add_at(v, &rec, 1000000);
+ * vect_delete_range(v, 5000, 5999);
+ */
+void vect_compact(vector const v);
+
+/////////////////////////////////////////////////////
+// Typed numeric vectors:
+
+/*
+ * vect_create_typed creates a vector of numbers (of one of the
+ * ZVECT_TYPES) which stores its values contiguously, instead
+ * of allocating every item on its own, so it uses much less
+ * memory and can be processed with SIMD kernels (see below).
+ * Typed vectors have their own functions (vect_typed_*) and
+ * don't use locks, so they must be protected by the caller
+ * when shared between threads.
+ *
+ * For example:
+ * typed_vector tv = vect_create_typed(ZV_T_F64, 1024);
+ * double x = 1.5;
+ * vect_typed_push(tv, &x);
+ * ...
+ * vect_typed_destroy(tv);
+ */
+typed_vector vect_create_typed(uint32_t type, zvect_index capacity);
+void vect_typed_destroy(typed_vector tv);
+
+// Typed vectors information and storage:
+uint32_t vect_typed_type(typed_vector const tv);
+zvect_index vect_typed_size(typed_vector const tv);
+
+/*
+ * vect_typed_data returns the array of values of a typed vector
+ * (which is valid until the next value is added).
+ */
+void *vect_typed_data(typed_vector const tv);
+
+/*
+ * vect_typed_push adds the value pointed by "value" at the end
+ * of the vector, while vect_typed_append adds "count" values
+ * from the array "values" (growing the vector only once).
+ */
+zvect_retval vect_typed_push(typed_vector const tv, const void *value);
+zvect_retval vect_typed_append(typed_vector const tv, const void *values, zvect_index count);
+
+/*
+ * vect_typed_get_at returns a pointer to the value at index i
+ * (or NULL if i is out of bounds).
+ */
+void *vect_typed_get_at(typed_vector const tv, zvect_index i);
+void vect_typed_clear(typed_vector const tv);
+
+/*
+ * Aggregates:
+ * vect_typed_sum and vect_typed_dot (the dot product of two
+ * vectors of the same type and size) store their result in an
+ * int64_t for ZV_T_I32 and ZV_T_I64 vectors (integer overflows
+ * wrap around), and in a double for ZV_T_F32 and ZV_T_F64
+ * vectors. vect_typed_min and vect_typed_max store their result
+ * in a value of the vector type (and return ZVERR_VECTEMPTY for
+ * empty vectors), while vect_typed_argmin and vect_typed_argmax
+ * return the index of the first minimum (or maximum) value, or
+ * zvect_index_max for empty vectors.
+ * Please note: NaNs in ZV_T_F32 and ZV_T_F64 vectors are compared
+ * like the SIMD min/max instructions do, so when a vector contains
+ * NaNs the minimum (or maximum) is not specified and can be a NaN.
+ * In that case vect_typed_argmin and vect_typed_argmax return
+ * zvect_index_max, they never return an index out of the vector.
+ *
+ * For example:
+ * double total, top;
+ * vect_typed_sum(tv, &total);
+ * vect_typed_max(tv, &top);
+ */
+zvect_retval vect_typed_sum(typed_vector const tv, void *result);
+zvect_retval vect_typed_min(typed_vector const tv, void *result);
+zvect_retval vect_typed_max(typed_vector const tv, void *result);
+zvect_index vect_typed_argmin(typed_vector const tv);
+zvect_index vect_typed_argmax(typed_vector const tv);
+zvect_retval vect_typed_dot(typed_vector const tv1, typed_vector const tv2, void *result);
+
+/*
+ * vect_typed_scale multiplies all the values by *factor (of the
+ * vector type), while vect_typed_add adds to every value of tv1
+ * the value at the same index of tv2 (of the same type and size).
+ */
+zvect_retval vect_typed_scale(typed_vector const tv, const void *factor);
+zvect_retval vect_typed_add(typed_vector const tv1, typed_vector const tv2);
+
+/*
+ * vect_typed_count_if returns the number of values for which
+ * "item op *value" is true (op is one of the ZVECT_CMP).
+ *
+ * For example to count the values greater than 100.0:
+ * double limit = 100.0;
+ * zvect_index n = vect_typed_count_if(tv, ZV_GT, &limit);
+ */
+zvect_index vect_typed_count_if(typed_vector const tv, uint32_t op, const void *value);
+
+// Columnar vectors:
+
+/*
+ * vect_create_columnar creates a vector of records of
+ * record_size bytes which stores each one of the nfields fields
+ * in its own contiguous column (structure of arrays), so a scan
+ * of one field reads only that field and not the whole records.
+ * Records are added and read whole (vect_columnar_add scatters
+ * their fields to the columns and vect_columnar_get_at gathers
+ * them back), bytes of the records not covered by any field
+ * are not stored. Like vect_create it takes the vector
+ * properties (only ZV_NOLOCKING is used by columnar vectors),
+ * and columnar vectors are locked in the same way vectors are.
+ *
+ * For example:
+ * zvect_field fields[] = {
+ *	{ offsetof(QueueItem, priority), sizeof(int) },
+ *	{ offsetof(QueueItem, data), sizeof(((QueueItem *)0)->data) }
+ * };
+ * columnar_vector cv = vect_create_columnar(sizeof(QueueItem), fields, 2, 0, ZV_NONE);
+ * vect_columnar_add(cv, &item);
+ * vect_columnar_get_at(cv, 0, &item);
+ * ...
+ * vect_columnar_destroy(cv);
+ */
+columnar_vector vect_create_columnar(size_t record_size, const zvect_field *fields,
+				     uint32_t nfields, zvect_index capacity,
+				     const uint32_t properties);
+void vect_columnar_destroy(columnar_vector cv);
+#if ( ZVECT_THREAD_SAFE == 1 )
+zvect_retval vect_columnar_lock(columnar_vector const cv);
+zvect_retval vect_columnar_unlock(columnar_vector const cv);
+#endif
+zvect_index vect_columnar_size(columnar_vector const cv);
+
+/*
+ * vect_columnar_column returns the column of a field (an array
+ * of vect_columnar_size values, valid until the next record is
+ * added), which can be scanned directly (holding the
+ * vect_columnar_lock if other threads change the vector).
+ */
+void *vect_columnar_column(columnar_vector const cv, uint32_t field);
+
+// Records storage:
+zvect_retval vect_columnar_add(columnar_vector const cv, const void *record);
+zvect_retval vect_columnar_put_at(columnar_vector const cv, zvect_index i, const void *record);
+zvect_retval vect_columnar_get_at(columnar_vector const cv, zvect_index i, void *record);
+zvect_retval vect_columnar_remove_at(columnar_vector const cv, zvect_index i);
+void vect_columnar_clear(columnar_vector const cv);
+
+/*
+ * vect_columnar_count_if works like vect_typed_count_if on the
+ * column of a field holding numbers of one of the ZVECT_TYPES
+ * (it returns 0 if the field size doesn't match the type).
+ *
+ * For example to count the items with a priority above 10:
+ * int limit = 10;
+ * zvect_index n = vect_columnar_count_if(cv, 0, ZV_T_I32, ZV_GT, &limit);
+ */
+zvect_index vect_columnar_count_if(columnar_vector const cv, uint32_t field, uint32_t type,
+				   uint32_t op, const void *value);
+
+// Bit vectors:
+
+/*
+ * vect_create_bits creates a vector of bits (booleans) packed
+ * in 64 bit words, which uses 1 bit per item instead of a
+ * pointer and an allocated item. Like vect_create it takes an
+ * initial capacity (in bits, 0 for the default) and the vector
+ * properties (only ZV_NOLOCKING is used by bit vectors), and
+ * bit vectors are locked in the same way vectors are.
+ *
+ * For example:
+ * bit_vector bv = vect_create_bits(0, ZV_NONE);
+ * vect_bits_push(bv, true);
+ * ...
+ * vect_bits_destroy(bv);
+ */
+bit_vector vect_create_bits(const zvect_index init_capacity, const uint32_t properties);
+void vect_bits_destroy(bit_vector bv);
+#if ( ZVECT_THREAD_SAFE == 1 )
+zvect_retval vect_bits_lock(bit_vector const bv);
+zvect_retval vect_bits_unlock(bit_vector const bv);
+#endif
+zvect_index vect_bits_size(bit_vector const bv);
+void vect_bits_clear(bit_vector const bv);
+
+/*
+ * vect_bits_push adds a bit at the end of the vector and
+ * vect_bits_pop removes it (returning false if the vector is
+ * empty). vect_bits_get returns the bit at index i (false if i
+ * is out of bounds) and vect_bits_set changes it.
+ */
+zvect_retval vect_bits_push(bit_vector const bv, const bool bit);
+bool vect_bits_pop(bit_vector const bv);
+bool vect_bits_get(bit_vector const bv, const zvect_index i);
+zvect_retval vect_bits_set(bit_vector const bv, const zvect_index i, const bool bit);
+
+/*
+ * vect_bits_popcount returns the number of set bits, while
+ * vect_bits_find_first_set (and vect_bits_find_first_clear)
+ * return the index of the first set (or clear) bit at index
+ * "from" or after it, or zvect_index_max if there isn't any.
+ *
+ * For example to visit all the set bits:
+ * for (zvect_index i = vect_bits_find_first_set(bv, 0);
+ *      i != zvect_index_max;
+ *      i = vect_bits_find_first_set(bv, i + 1))
+ *	...
+ */
+zvect_index vect_bits_popcount(bit_vector const bv);
+zvect_index vect_bits_find_first_set(bit_vector const bv, const zvect_index from);
+zvect_index vect_bits_find_first_clear(bit_vector const bv, const zvect_index from);
+
+/*
+ * Bitwise operations between two bit vectors of the same size
+ * (the result is stored in dst): vect_bits_andnot clears in dst
+ * the bits that are set in src.
+ */
+zvect_retval vect_bits_and(bit_vector const dst, bit_vector const src);
+zvect_retval vect_bits_or(bit_vector const dst, bit_vector const src);
+zvect_retval vect_bits_xor(bit_vector const dst, bit_vector const src);
+zvect_retval vect_bits_andnot(bit_vector const dst, bit_vector const src);
+
+/*
+ * vect_bits_rank returns the number of set bits before index i,
+ * and vect_bits_select returns the index of the set bit with
+ * rank k (so the first set bit is vect_bits_select(bv, 0)), or
+ * zvect_index_max if there are k or less set bits. Both of them
+ * use a small directory of counts, rebuilt at the first call
+ * after the bits have been changed.
+ */
+zvect_index vect_bits_rank(bit_vector const bv, zvect_index i);
+zvect_index vect_bits_select(bit_vector const bv, zvect_index k);
+
+// Variable length items vectors:
+
+/*
+ * vect_create_varlen creates a vector of variable length items
+ * (strings, blobs), which are copied one after the other in a
+ * single growable byte arena, so every item costs its length
+ * plus 8 bytes and scans read the arena sequentially. capacity
+ * is the initial number of items and arena_capacity the initial
+ * arena size in bytes (0 for the defaults). Like vect_create it
+ * also takes the vector properties (only ZV_NOLOCKING is used by
+ * varlen vectors), and varlen vectors are locked in the same way
+ * vectors are.
+ *
+ * For example:
+ * varlen_vector vv = vect_create_varlen(0, 0, ZV_NONE);
+ * vect_add_bytes(vv, "hello", 6);	// - Including the '\0'
+ * ...
+ * vect_varlen_destroy(vv);
+ */
+varlen_vector vect_create_varlen(zvect_index capacity, size_t arena_capacity,
+				 const uint32_t properties);
+void vect_varlen_destroy(varlen_vector vv);
+#if ( ZVECT_THREAD_SAFE == 1 )
+zvect_retval vect_varlen_lock(varlen_vector const vv);
+zvect_retval vect_varlen_unlock(varlen_vector const vv);
+#endif
+zvect_index vect_varlen_size(varlen_vector const vv);
+
+/*
+ * vect_add_bytes adds a copy of the "len" bytes at "item" at the
+ * end of the vector, while vect_add_bytes_n adds "count" items
+ * (items[i] of lens[i] bytes) growing the vector only once.
+ */
+zvect_retval vect_add_bytes(varlen_vector const vv, const void *item, zvect_index len);
+zvect_retval vect_add_bytes_n(varlen_vector const vv, const void * const *items,
+			      const zvect_index *lens, zvect_index count);
+
+/*
+ * vect_get_bytes returns a pointer to the bytes of item i (or
+ * NULL if i is out of bounds) and stores its length in *len (if
+ * len is not NULL). The pointer is valid until the vector is
+ * changed (hold the vect_varlen_lock while using it if other
+ * threads change the vector).
+ *
+ * For example:
+ * zvect_index len;
+ * const char *s = vect_get_bytes(vv, 0, &len);
+ */
+const void *vect_get_bytes(varlen_vector const vv, zvect_index i, zvect_index *len);
+
+/*
+ * vect_put_bytes replaces item i (item must not point inside the
+ * vector arena) and vect_varlen_remove_at removes it. The bytes
+ * of the old item are left in the arena, and the arena is
+ * compacted automatically when at least half of it is unused
+ * (vect_varlen_garbage returns the number of unused bytes and
+ * vect_varlen_compact compacts the arena immediately).
+ */
+zvect_retval vect_put_bytes(varlen_vector const vv, zvect_index i, const void *item, zvect_index len);
+zvect_retval vect_varlen_remove_at(varlen_vector const vv, zvect_index i);
+size_t vect_varlen_garbage(varlen_vector const vv);
+zvect_retval vect_varlen_compact(varlen_vector const vv);
+void vect_varlen_clear(varlen_vector const vv);
+
+// Slot maps:
+
+/*
+ * vect_create_slot_map creates a slot map, a container that
+ * returns a stable handle for every item inserted, which stays
+ * valid (while indexes in a vector change on every insertion and
+ * removal) until the item is removed. Handles are 64 bit values
+ * made of a slot index and a generation counter, so the handle
+ * of a removed item never finds the item that later reuses its
+ * slot, and 0 is never a valid handle. Insertions and removals
+ * are O(1) and don't move items (the last item is moved in the
+ * place of the removed one), and the items are kept densely in
+ * a vector (see vect_slot_map_items). Parameters are the same
+ * of vect_create (ZV_CIRCULAR is not allowed), and slot maps are
+ * locked like the vector of their items.
+ *
+ * For example:
+ * slot_map sm = vect_create_slot_map(0, sizeof(struct entity), ZV_NONE);
+ * zvect_handle h = vect_slot_map_insert(sm, &e);
+ * struct entity *p = (struct entity *)vect_slot_map_get(sm, h);
+ * vect_slot_map_remove(sm, h);
+ * ...
+ * vect_slot_map_destroy(sm);
+ */
+slot_map vect_create_slot_map(const zvect_index init_capacity, const size_t item_size,
+			      const uint32_t properties);
+void vect_slot_map_destroy(slot_map sm);
+
+/*
+ * vect_slot_map_insert adds an item and returns its handle (or 0
+ * in case of error), vect_slot_map_remove removes the item of a
+ * handle (or returns ZVERR_IDXOUTOFBOUND if the handle is not
+ * valid) and vect_slot_map_get returns the item of a handle (or
+ * NULL if the handle is not valid).
+ */
+zvect_handle vect_slot_map_insert(slot_map const sm, const void *item);
+zvect_retval vect_slot_map_remove(slot_map const sm, const zvect_handle h);
+void *vect_slot_map_get(slot_map const sm, const zvect_handle h);
+bool vect_slot_map_contains(slot_map const sm, const zvect_handle h);
+zvect_index vect_slot_map_size(slot_map const sm);
+void vect_slot_map_clear(slot_map const sm);
+
+/*
+ * vect_slot_map_items returns the vector with all the items (in
+ * no particular order), which can be read and iterated (or used
+ * with vect_apply and the other functions that don't change the
+ * vector), and vect_slot_map_handle_at returns the handle of its
+ * item at index i. The vector must not be changed directly.
+ *
+ * For example:
+ * vector items = vect_slot_map_items(sm);
+ * for (zvect_index i = 0; i < vect_size(items); i++)
+ *	update((struct entity *)vect_get_at(items, i));
+ */
+vector vect_slot_map_items(slot_map const sm);
+zvect_handle vect_slot_map_handle_at(slot_map const sm, const zvect_index i);
+
 ////////////
 // Vector Data manipulation functions:
 ////////////
@@ -447,7 +1034,8 @@ void vect_swap(vector const v, const zvect_index s, const zvect_index e);
  * a range of items in the same vector.
  * You just pass the vector, the index of the first item
  * to swap, the index of the last item to swap and the
- * index of the first item to swap with.
+ * index of the first item to swap with (the two ranges
+ * must not overlap). Items are swapped in place.
  *
  * For example to swap items from 10 to 20 with items
  * from 30 to 40 on vector v, use:
@@ -460,6 +1048,8 @@ void vect_swap_range(vector const v, const zvect_index s1, const zvect_index e1,
  * a vector of "i" positions to the left (or from the
  * "front" to the "end").
  *
+ * Rotations are done in place (they don't allocate memory).
+ *
  * For example to rotate a vector called v of 5 positions
  * to the left, use:
  * vect_rotate_left(v, 5);
@@ -477,6 +1067,59 @@ void vect_rotate_left(vector const v, const zvect_index i);
  */
 void vect_rotate_right(vector const v, const zvect_index i);
 
+/*
+ * vect_remove_if removes all the items for which the
+ * predicate pred returns true (pred receives the item
+ * and the user context "ctx"). The vector is compacted
+ * in a single pass, removed items are freed (and wiped
+ * if the vector has ZV_SEC_WIPE) and the capacity is
+ * adjusted at most once, at the end.
+ * It returns the number of items removed.
+ *
+ * For example, to remove all negative numbers from v:
+ * bool is_negative(const void *item, void *ctx) {
+ *     return *((const int *)item) < 0;
+ * }
+ * vect_remove_if(v, is_negative, NULL);
+ */
+zvect_index vect_remove_if(vector const v, bool (*pred)(const void *item, void *ctx), void *ctx);
+
+/*
+ * vect_retain_if is the opposite of vect_remove_if, it
+ * keeps only the items for which pred returns true and
+ * returns the number of items removed.
+ */
+zvect_index vect_retain_if(vector const v, bool (*pred)(const void *item, void *ctx), void *ctx);
+
+/*
+ * vect_unique removes from an ordered vector all the items
+ * equal to the item before them (f1 is a compare function
+ * like the one used by vect_qsort, which returns 0 for equal
+ * items), so only the first item of every group of equal
+ * items is kept. The vector is compacted in a single pass
+ * and the removed items are freed (and wiped if the vector
+ * has ZV_SEC_WIPE).
+ * It returns the number of items removed.
+ *
+ * For example:
+ * vect_qsort(v, compare_int);
+ * vect_unique(v, compare_int);
+ */
+zvect_index vect_unique(vector const v, int (*f1)(const void *, const void *));
+
+/*
+ * vect_unique_hash is vect_unique for unordered vectors, it
+ * keeps the first occurrence of every item (in the original
+ * order) and finds the duplicates using a temporary hash
+ * set, so it runs in linear time. hash_fn must return the
+ * same hash for items that eq_fn finds equal.
+ *
+ * For example:
+ * vect_unique_hash(v, hash_event_id, same_event_id);
+ */
+zvect_index vect_unique_hash(vector const v, uint64_t (*hash_fn)(const void *item),
+			     bool (*eq_fn)(const void *a, const void *b));
+
 /*
  * vect_qsort allows you to sort a given vector.
  * The algorithm used to sort a vector is Quicksort with
@@ -519,6 +1162,136 @@ void vect_qsort(vector const v, int (*compare_func)(const void *, const void*),
  */
 bool vect_bsearch(vector const v, const void *key, int (*f1)(const void *, const void *), zvect_index *item_index);
 
+/*
+ * vect_bsearch_hint works like vect_bsearch, but the Adaptive
+ * Binary Search hints are stored in the caller-owned "cursor"
+ * instead of being recomputed at every search. When the keys
+ * searched are close to each other (for example sequential or
+ * almost sequential probes) the search starts from where the
+ * previous one ended and it's much faster. The vector is never
+ * modified, so multiple threads can search the same vector at
+ * the same time, each one using its own cursor (as long as no
+ * other thread is modifying the vector).
+ *
+ * For example:
+ * bsearch_cursor c = { 0, 0 };
+ * zvect_index idx;
+ * for (int i = 0; i < 1000; i++)
+ *     if (vect_bsearch_hint(v, &i, my_compare, &c, &idx))
+ *         ...
+ */
+bool vect_bsearch_hint(vector const v, const void *key,
+		       int (*f1)(const void *, const void *),
+		       bsearch_cursor *cursor, zvect_index *item_index);
+
+/*
+ * vect_bsearch_batch searches "nkeys" keys at once in an ordered
+ * vector (keys is an array of pointers to the keys). For each key
+ * out_idx receives the index of the first matching item or
+ * zvect_index_max when the key is not found. The function returns
+ * the number of keys found.
+ * When the keys are sorted too, each search gallops forward from
+ * where the previous one ended, otherwise the keys are searched in
+ * groups, interleaving the searches to hide memory latency. The
+ * choice is made (and revised) automatically while searching.
+ *
+ * For example:
+ * const void *keys[3] = { &k1, &k2, &k3 };
+ * zvect_index idx[3];
+ * zvect_index found = vect_bsearch_batch(v, keys, 3, my_compare, idx);
+ */
+zvect_index vect_bsearch_batch(vector const v, const void * const *keys,
+			       zvect_index nkeys,
+			       int (*f1)(const void *, const void *),
+			       zvect_index *out_idx);
+
+/*
+ * vect_index_build builds a static search index over the
+ * ordered vector v. key_extractor returns the 64 bit key of an
+ * item, and the vector must be ordered by such key (otherwise
+ * NULL is returned and the vector error is set to
+ * ZVERR_OPNOTALLOWED). The keys are copied into a compact
+ * cache-line aligned array in Eytzinger (breadth-first) order,
+ * so searching it touches a few cache lines instead of chasing
+ * two pointers per probe as vect_bsearch does.
+ * The index is a snapshot: rebuild it after changing the vector.
+ *
+ * For example:
+ * uint64_t get_id(const void *item) {
+ *     return ((const struct record *)item)->id;
+ * }
+ * search_index si = vect_index_build(v, get_id);
+ * zvect_index idx;
+ * if (vect_index_find(si, 42, &idx))
+ *     ...
+ * vect_index_destroy(si);
+ */
+search_index vect_index_build(vector const v,
+			      uint64_t (*key_extractor)(const void *item));
+
+/*
+ * vect_index_find searches "key" in the index si and returns
+ * true if it has been found, in which case item_index is set to
+ * the index (in the vector) of the first item with such key.
+ * Searching an index doesn't lock the vector, so many threads
+ * can use the same index at the same time.
+ */
+bool vect_index_find(search_index si, uint64_t key, zvect_index *item_index);
+
+/*
+ * vect_index_destroy releases an index built by
+ * vect_index_build.
+ */
+void vect_index_destroy(search_index si);
+
+/*
+ * vect_hindex_create attaches a hash index to the vector v, so
+ * that items can be found by key with vect_hindex_find in
+ * constant time instead of scanning the vector. hash_fn returns
+ * the hash of an item (or of a key) and eq_fn returns true when
+ * key and item match. If v already has a hash index, it's
+ * replaced. Returns 0 on success or an error code.
+ *
+ * The index is kept up to date by the functions that add, put,
+ * remove and delete items; functions that move items around in
+ * bulk (sort, swap, rotate, copy, insert, move, merge) have it
+ * rebuilt on the next search. If you change the keys of items
+ * in place (for example with vect_apply), call
+ * vect_hindex_create again.
+ *
+ * For example:
+ * uint64_t hash_id(const void *item) {
+ *     return ((const struct record *)item)->id * 0x9E3779B97F4A7C15ULL;
+ * }
+ * bool same_id(const void *key, const void *item) {
+ *     return ((const struct record *)key)->id ==
+ *            ((const struct record *)item)->id;
+ * }
+ * vect_hindex_create(v, hash_id, same_id);
+ */
+zvect_retval vect_hindex_create(vector const v,
+				uint64_t (*hash_fn)(const void *item),
+				bool (*eq_fn)(const void *key, const void *item));
+
+/*
+ * vect_hindex_find searches "key" using the hash index of the
+ * vector v (key is passed to hash_fn and eq_fn like an item).
+ * If found it returns true and sets item_index to the lowest
+ * index of the matching items.
+ *
+ * For example:
+ * struct record key = { .id = 42 };
+ * zvect_index idx;
+ * if (vect_hindex_find(v, &key, &idx))
+ *     ...
+ */
+bool vect_hindex_find(vector const v, const void *key, zvect_index *item_index);
+
+/*
+ * vect_hindex_destroy removes the hash index from the vector v.
+ */
+void vect_hindex_destroy(vector const v);
+
 /*
  * vect_lsearch is a function that performs a
  * traditional linear search over an ordered or non
@@ -550,6 +1323,46 @@ bool vect_lsearch(vector const v, const void *key,
 		  zvect_index maxIterations);
 #endif
 
+/*
+ * vect_lsearch_parallel performs a linear search like
+ * vect_lsearch, but it splits the vector in chunks of
+ * "grain" items and searches them in parallel on ZVector's
+ * worker pool. As soon as a match is found the chunks that
+ * come after it stop searching. If multiple items match, the
+ * one with the lowest index is returned. f1 is called
+ * concurrently from multiple threads, so it must be thread
+ * safe. Set nthreads to 0 to use all the workers available,
+ * and grain to 0 to let ZVector pick the chunk size.
+ *
+ * For example:
+ * int i = 5;
+ * zvect_index idx;
+ * vect_lsearch_parallel(v, &i, my_compare, &idx, 0, 0);
+ */
+bool vect_lsearch_parallel(vector const v, const void *key,
+			   int (*f1)(const void *, const void *),
+			   zvect_index *item_index,
+			   zvect_index nthreads, zvect_index grain);
+
+/*
+ * vect_find_bytes searches for the first item which contains
+ * the "key_len" bytes pointed by "key" at offset "key_offset"
+ * (in bytes) from the beginning of the item. It doesn't use a
+ * user compare function, so it's much faster than
+ * vect_lsearch for plain integer/ID lookups. 4 and 8 bytes
+ * keys are compared with SIMD instructions when available.
+ *
+ * For example, to find the record with id 42 in a vector of
+ * struct record { uint32_t flags; uint32_t id; }:
+ *
+ * uint32_t id = 42;
+ * zvect_index idx;
+ * vect_find_bytes(v, &id, offsetof(struct record, id),
+ *                 sizeof(id), &idx);
+ */
+bool vect_find_bytes(vector const v, const void *key, size_t key_offset,
+		     size_t key_len, zvect_index *item_index);
+
 /*
  * vect_add_ordered allows the insertion of new items in
  * an ordered fashion. Please note that for this to work
@@ -569,6 +1382,110 @@ bool vect_lsearch(vector const v, const void *key,
  */
 void vect_add_ordered(vector const v, const void *value, int (*f1)(const void *, const void *));
 
+/*
+ * vect_add_ordered_n adds "count" items (stored one after the
+ * other in the array "values") to an ordered vector, keeping it
+ * ordered. The new items are sorted once and then merged into the
+ * vector in a single pass (from the end of the vector backward),
+ * so every item is moved only once instead of once per insert as
+ * calling vect_add_ordered for each item would do. New items are
+ * placed after the existing items they compare equal to.
+ *
+ * For example:
+ * int values[4] = { 7, 3, 9, 1 };
+ * vect_add_ordered_n(v, values, 4, my_compare);
+ */
+void vect_add_ordered_n(vector const v, const void *values, zvect_index count,
+			int (*f1)(const void *, const void *));
+
+/*
+ * vect_set_union, vect_set_intersect and vect_set_difference
+ * combine the items of two vectors ordered with the compare
+ * function f1 (the same used for vect_qsort), appending the
+ * ordered result to dst. v1, v2 and dst must have the same
+ * data_size and dst must be a different vector. If dst is a
+ * ZV_BYREF vector it receives the pointers of the items of v1 and
+ * v2, otherwise their copies.
+ * Duplicated items are handled like the C++ standard library
+ * does: an item that appears n times in v1 and m times in v2
+ * appears max(n, m) times in the union, min(n, m) times in the
+ * intersection and max(n - m, 0) times in the difference
+ * (v1 - v2). When the sizes of the two vectors are very different
+ * the runs of items are skipped with a galloping search.
+ * They return 0 on success or an error code.
+ *
+ * For example:
+ * vector u = vect_create(0, sizeof(int), ZV_NONE);
+ * vect_set_union(u, v1, v2, my_compare);
+ */
+zvect_retval vect_set_union(vector const dst, const_vector const v1,
+			    const_vector const v2,
+			    int (*f1)(const void *, const void *));
+zvect_retval vect_set_intersect(vector const dst, const_vector const v1,
+				const_vector const v2,
+				int (*f1)(const void *, const void *));
+zvect_retval vect_set_difference(vector const dst, const_vector const v1,
+				 const_vector const v2,
+				 int (*f1)(const void *, const void *));
+
+/*
+ * vect_merge_sorted merges the k vectors in the array "vectors",
+ * each one ordered with the compare function f1, appending all
+ * their items, in order, to dst (which must be a different vector
+ * with the same data_size). The merge uses a heap, so it costs
+ * O(n log k) for n items, and the space for all the items is
+ * reserved once. Items that compare equal keep the order of the
+ * vectors they come from. The merged vectors are not changed; if
+ * dst is a ZV_BYREF vector it receives the pointers of their items,
+ * otherwise their copies. Returns 0 on success or an error code.
+ *
+ * For example:
+ * vector parts[3] = { v1, v2, v3 };
+ * vect_merge_sorted(dst, parts, 3, my_compare);
+ */
+zvect_retval vect_merge_sorted(vector const dst, vector const vectors[],
+			       zvect_index k,
+			       int (*f1)(const void *, const void *));
+
+/*
+ * vect_view_make returns a view of the "len" items of v starting
+ * at index "start". A view doesn't copy the items, it reads them
+ * directly from the vector storage, and it works with indexes
+ * relative to its first item. Views become stale (and their
+ * functions fail with ZVERR_VIEWSTALE) when the vector storage
+ * is reallocated (for example when the vector grows or shrinks),
+ * compacted, or has lazy deletes or an open gap, so they are
+ * meant to be short lived. A view must be destroyed with vect_view_destroy before
+ * its vector is. vect_view_make returns NULL on error.
+ *
+ * vect_view_get_at returns the item i of the view (or NULL),
+ * vect_view_apply calls f(item, ctx) for every item of the view,
+ * vect_view_lsearch and vect_view_bsearch (which needs an
+ * ordered view) search key with the compare function f1 and
+ * vect_view_qsort sorts only the items of the view.
+ *
+ * For example:
+ * vect_view w = vect_view_make(v, 100, 50);
+ * vect_view_qsort(w, my_compare);
+ * if (vect_view_bsearch(w, &key, my_compare, &i))
+ *     item = vect_view_get_at(w, i);
+ * vect_view_destroy(w);
+ */
+vect_view vect_view_make(vector const v, zvect_index start, zvect_index len);
+void vect_view_destroy(vect_view vw);
+zvect_index vect_view_size(vect_view const vw);
+bool vect_view_is_valid(vect_view const vw);
+void *vect_view_get_at(vect_view const vw, const zvect_index i);
+zvect_retval vect_view_apply(vect_view const vw, void (*f)(void *, void *), void *ctx);
+bool vect_view_lsearch(vect_view const vw, const void *key,
+		       int (*f1)(const void *, const void *),
+		       zvect_index *item_index);
+bool vect_view_bsearch(vect_view const vw, const void *key,
+		       int (*f1)(const void *, const void *),
+		       zvect_index *item_index);
+zvect_retval vect_view_qsort(vect_view const vw,
+			     int (*compare_func)(const void *, const void *));
+
 #endif  // ZVECT_DMF_EXTENSIONS
 
 #ifdef ZVECT_SFMD_EXTENSIONS
@@ -637,6 +1554,184 @@ void vect_apply_if(vector const v1, const_vector const v2,
 
 void vect_apply_range(vector const v, void (*f)(void *), const zvect_index x, const zvect_index y);
 
+/*
+ * vect_apply_parallel works like vect_apply, but it splits
+ * the vector in chunks of "grain" items and processes them
+ * in parallel on ZVector's worker pool (the calling thread
+ * helps too). The function f receives the item and the user
+ * context "ctx". Set nthreads to 0 to use all the workers
+ * available, and grain to 0 to let ZVector pick the chunk
+ * size.
+ * Please note: f is called concurrently from multiple
+ * threads, and the vector is locked for the whole duration,
+ * so f must not call other ZVector functions on the same
+ * vector.
+ *
+ * For example to multiply all the items in a vector called v
+ * by a factor stored in "k", use:
+ *
+ * void scale_item(void *item, void *ctx)
+ * {
+ *  *((int *)item) *= *((int *)ctx);
+ * }
+ *
+ * vect_apply_parallel(v, scale_item, &k, 0, 0);
+ */
+void vect_apply_parallel(vector const v, void (*f)(void *, void *), void *ctx,
+			 zvect_index nthreads, zvect_index grain);
+
+/*
+ * vect_apply_range_parallel is the parallel version of
+ * vect_apply_range, items from x to y (both included) are
+ * processed on ZVector's worker pool.
+ */
+void vect_apply_range_parallel(vector const v, void (*f)(void *, void *), void *ctx,
+			       const zvect_index x, const zvect_index y,
+			       zvect_index nthreads, zvect_index grain);
+
+/*
+ * vect_apply_ctx works like vect_apply, but f also receives
+ * the user context "ctx" as second parameter, so there is
+ * no need to use global variables to pass extra data to f.
+ *
+ * For example to multiply all the items in a vector called v
+ * by a factor stored in "k", use:
+ *
+ * vect_apply_ctx(v, scale_item, &k);
+ *
+ * (see vect_apply_parallel for scale_item definition)
+ */
+void vect_apply_ctx(vector const v, void (*f)(void *, void *), void *ctx);
+
+/*
+ * vect_apply_range_ctx is vect_apply_range with a user
+ * context, items from x to y (both included) are processed.
+ */
+void vect_apply_range_ctx(vector const v, void (*f)(void *, void *), void *ctx,
+			  const zvect_index x, const zvect_index y);
+
+/*
+ * vect_apply_if_ctx is vect_apply_if with a user context,
+ * both f1 and f2 receive "ctx" as their last parameter.
+ */
+void vect_apply_if_ctx(vector const v1, const_vector const v2,
+		       void (*f1)(void *, void *),
+		       bool (*f2)(void *, void *, void *), void *ctx);
+
+/*
+ * vect_apply_batch calls f with contiguous chunks of the
+ * vector items instead of calling it once per item, f
+ * receives the array of item pointers, the number of items
+ * in the array and the user context. This amortises the
+ * cost of the call and allows the compiler to optimise the
+ * loop inside f. f may be called more than once (each time
+ * with the next chunk of items, in order).
+ *
+ * For example:
+ *
+ * void sum_items(void **items, size_t n, void *ctx)
+ * {
+ *  long *sum = (long *)ctx;
+ *  for (size_t i = 0; i < n; i++)
+ *      *sum += *((int *)items[i]);
+ * }
+ *
+ * long sum = 0;
+ * vect_apply_batch(v, sum_items, &sum);
+ */
+void vect_apply_batch(vector const v, void (*f)(void **, size_t, void *),
+		      void *ctx);
+
+/*
+ * vect_apply_range_batch is the batch version of
+ * vect_apply_range, items from x to y (both included) are
+ * passed to f.
+ */
+void vect_apply_range_batch(vector const v, void (*f)(void **, size_t, void *),
+			    void *ctx, const zvect_index x, const zvect_index y);
+
+/*
+ * vect_apply_batch_parallel splits the vector in chunks of
+ * "grain" items and passes each chunk to f on ZVector's
+ * worker pool (so f is called concurrently from multiple
+ * threads). nthreads and grain work like in
+ * vect_apply_parallel.
+ */
+void vect_apply_batch_parallel(vector const v, void (*f)(void **, size_t, void *),
+			       void *ctx, zvect_index nthreads, zvect_index grain);
+
+/*
+ * vect_reduce folds all the items of a vector into the
+ * accumulator "acc": fold is called for every item, in
+ * order, with acc, the item and the user context "ctx".
+ * acc must be initialised by the caller (with the initial
+ * value of the reduction) and holds the result at the end.
+ *
+ * For example to sum all the items of a vector of int:
+ * void sum_int(void *acc, const void *item, void *ctx)
+ * {
+ *  *((long *)acc) += *((const int *)item);
+ * }
+ *
+ * long total = 0;
+ * vect_reduce(v, &total, sum_int, NULL);
+ */
+void vect_reduce(vector const v, void *acc,
+		 void (*fold)(void *acc, const void *item, void *ctx), void *ctx);
+
+/*
+ * vect_reduce_parallel is vect_reduce on ZVector's worker
+ * pool: every chunk of "grain" items is folded into its own
+ * partial accumulator of acc_size bytes (initialised with a
+ * copy of "identity", for example 0 for a sum) and then the
+ * partials are combined into acc, in order, with combine.
+ * combine must be associative (it doesn't need to be
+ * commutative). nthreads and grain work like in
+ * vect_apply_parallel, fold is called concurrently from
+ * multiple threads (but never on the same partial).
+ *
+ * For example:
+ * void add_long(void *acc, const void *partial, void *ctx)
+ * {
+ *  *((long *)acc) += *((const long *)partial);
+ * }
+ *
+ * long total = 0, zero = 0;
+ * vect_reduce_parallel(v, &total, sizeof(long), &zero,
+ *                      sum_int, add_long, NULL, 0, 0);
+ */
+void vect_reduce_parallel(vector const v, void *acc, size_t acc_size, const void *identity,
+			  void (*fold)(void *acc, const void *item, void *ctx),
+			  void (*combine)(void *acc, const void *partial, void *ctx),
+			  void *ctx, zvect_index nthreads, zvect_index grain);
+
+/*
+ * vect_scan computes the inclusive prefix scan of a vector:
+ * "out" is an array of vect_size(v) accumulators of acc_size
+ * bytes each, and out[i] is "init" folded with all the items
+ * from 0 to i.
+ *
+ * For example (running totals of a vector of int):
+ * long *totals = malloc(sizeof(long) * vect_size(v));
+ * long zero = 0;
+ * vect_scan(v, totals, sizeof(long), &zero, sum_int, NULL);
+ */
+void vect_scan(vector const v, void *out, size_t acc_size, const void *init,
+	       void (*fold)(void *acc, const void *item, void *ctx), void *ctx);
+
+/*
+ * vect_scan_parallel is vect_scan on ZVector's worker pool.
+ * It needs the same identity and combine used by
+ * vect_reduce_parallel (every chunk is reduced first, then
+ * every chunk is scanned starting from the combination of
+ * all the chunks before it).
+ */
+void vect_scan_parallel(vector const v, void *out, size_t acc_size,
+			const void *init, const void *identity,
+			void (*fold)(void *acc, const void *item, void *ctx),
+			void (*combine)(void *acc, const void *partial, void *ctx),
+			void *ctx, zvect_index nthreads, zvect_index grain);
+
 // Operations with multiple vectors:
 
 /*
@@ -85,6 +85,21 @@ typedef uintptr_t zvect_retptr;
 // Enable/Disable SFMD Extensions:
 #define ZVECT_SFMD_EXTENSIONS 1
 
+// Worker pool configuration (the pool is used by
+// the parallel functions and requires thread safe
+// code to be enabled):
+// Maximum number of worker threads in the pool:
+#define ZVECT_POOL_MAX_THREADS 64
+// Minimum number of items per parallel chunk, when
+// a range is smaller than this it will be processed
+// directly by the calling thread:
+#define ZVECT_POOL_MIN_GRAIN 4096
+
+// Lazy deletes configuration (for ZV_LAZY_DELETE
+// vectors): percentage of dead items (tombstones)
+// in a vector that triggers its compaction:
+#define ZVECT_LAZY_DELETE_RATIO 25
+
 // Enable/Disable ZVector own error handling:
 #define ZVECT_HANDLE_ERRORS 0
 // Please note: If you disable ZVector error handling
@@ -219,6 +219,52 @@ int main() {
 
 	fflush(stdout);
 
+	printf("Test %s_%d: Remove elements from the middle of a vector and check the others:\n",
+		testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(16, sizeof(int), ZV_NONE);
+		for (i = 0; i < 100; i++)
+			vect_add(v, &i);
+		for (i = 0; i < 40; i++) {
+			int *item = (int *)vect_remove_at(v, 10);
+			assert(*item == 10 + i);
+			free(item);
+		}
+		assert(vect_size(v) == 60);
+		for (i = 0; i < 60; i++)
+			assert(*((int *)vect_get_at(v, i)) == ((i < 10) ? i : i + 40));
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Shrink a vector after deleting most of its elements:\n",
+		testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(16, sizeof(int), ZV_NONE);
+		for (i = 0; i < 1000; i++)
+			vect_add(v, &i);
+		vect_delete_range(v, 100, 999);
+		vect_shrink(v);
+		assert(vect_size(v) == 100);
+		for (i = 0; i < 100; i++)
+			assert(*((int *)vect_get_at(v, i)) == i);
+		i = 100;
+		vect_add(v, &i);
+		vect_add_front(v, &i);
+		assert(vect_size(v) == 102);
+		assert(*((int *)vect_get_at(v, 101)) == 100);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
 	printf("================\n\n");
 
     return 0;
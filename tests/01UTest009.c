@@ -0,0 +1,161 @@
+/*
+ *    Name: UTest009
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+
+void multiply_elements(void *element, void *ctx) {
+	int *number = (int *)element;
+	*number *= *((int *)ctx);
+}
+
+void increment_element(void *element) {
+	int *number = (int *)element;
+	*number += 1;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "009";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_apply_parallel functions\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of 16 elements and using int for the vector data:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(int), ZV_NONE);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Insert %d elements and check if they are stored correctly:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		int i;
+		for (i = 0; i < MAX_ITEMS; i++)
+		{
+			vect_add(v, &i);
+			assert(*((int *)vect_get_at(v, i)) == i);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_SFMD_EXTENSIONS
+	printf("Test %s_%d: Apply function 'multiply_elements' in parallel to the entire vector and verify if it's correct:\n", testGrp, testID);
+	fflush(stdout);
+
+		int factor = 3;
+		vect_apply_parallel(v, multiply_elements, &factor, 0, 0);
+
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_get_at(v, i)) == (i * 3));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply function 'multiply_elements' in parallel using small chunks and 2 threads:\n", testGrp, testID);
+	fflush(stdout);
+
+		factor = 2;
+		vect_apply_parallel(v, multiply_elements, &factor, 2, 1000);
+
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_get_at(v, i)) == (i * 6));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply function 'multiply_elements' in parallel to items from 100 to 200000:\n", testGrp, testID);
+	fflush(stdout);
+
+		factor = -1;
+		vect_apply_range_parallel(v, multiply_elements, &factor, 200000, 100, 0, 1);
+
+		for (i = 0; i < MAX_ITEMS; i++) {
+			int value = *((int *)vect_get_at(v, i));
+			if (i >= 100 && i <= 200000)
+				assert(value == -(i * 6));
+			else
+				assert(value == (i * 6));
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply function 'increment_element' to items from 10 to 20 (sequential):\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_apply_range(v, increment_element, 10, 20);
+
+		for (i = 0; i < 30; i++) {
+			int value = *((int *)vect_get_at(v, i));
+			if (i >= 10 && i <= 20)
+				assert(value == (i * 6) + 1);
+			else
+				assert(value == (i * 6));
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check out of bound ranges are refused:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_apply_range_parallel(v, multiply_elements, &factor, 0, MAX_ITEMS, 0, 0);
+		assert(vect_get_last_error(v) != 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_SFMD_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
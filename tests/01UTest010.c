@@ -0,0 +1,167 @@
+/*
+ *    Name: UTest010
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+
+void add_to_range(vector v, zvect_index start, zvect_index end, void *ctx) {
+	int delta = *((int *)ctx);
+	for (zvect_index i = start; i < end; i++)
+		*((int *)vect_get_at(v, i)) += delta;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "010";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing Worker Pool functions\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of 16 elements and insert %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(int), ZV_NONE);
+
+		int i;
+		for (i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 )
+	printf("Test %s_%d: Configure the pool to use 3 worker threads:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_pool_set_threads(3) == 0);
+		assert(vect_pool_get_threads() == 3);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Submit the whole vector to the pool and verify the result:\n", testGrp, testID);
+	fflush(stdout);
+
+		int delta = 5;
+		assert(vect_pool_submit_range(v, 0, vect_size(v), add_to_range, &delta, 0, 1000) == 0);
+
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_get_at(v, i)) == i + 5);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Pin the workers to CPU 0 and submit a range:\n", testGrp, testID);
+	fflush(stdout);
+
+		int cpus[] = { 0 };
+		zvect_retval rval = vect_pool_set_affinity(cpus, 1);
+		assert(rval == 0 || rval == ZVERR_OPNOTALLOWED);
+
+		delta = -5;
+		assert(vect_pool_submit_range(v, 100, 300000, add_to_range, &delta, 2, 0) == 0);
+
+		for (i = 0; i < MAX_ITEMS; i++) {
+			int value = *((int *)vect_get_at(v, i));
+			if (i >= 100 && i < 300000)
+				assert(value == i);
+			else
+				assert(value == i + 5);
+		}
+
+		vect_pool_set_affinity(NULL, 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Shutdown the pool and check it restarts at the next submit:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_pool_shutdown();
+
+		delta = 1;
+		assert(vect_pool_submit_range(v, 0, vect_size(v), add_to_range, &delta, 0, 0) == 0);
+
+		assert(*((int *)vect_get_at(v, 0)) == 6);
+		assert(*((int *)vect_get_at(v, 200)) == 201);
+		assert(*((int *)vect_get_at(v, MAX_ITEMS - 1)) == MAX_ITEMS + 5);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Configure the pool with 0 workers (everything runs on the calling thread):\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_pool_set_threads(0) == 0);
+		assert(vect_pool_get_threads() == 0);
+
+		delta = -1;
+		assert(vect_pool_submit_range(v, 0, vect_size(v), add_to_range, &delta, 0, 0) == 0);
+
+		assert(*((int *)vect_get_at(v, 0)) == 5);
+		assert(*((int *)vect_get_at(v, 200)) == 200);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check out of bound ranges are refused:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_pool_submit_range(v, 0, MAX_ITEMS + 1, add_to_range, &delta, 0, 0) == ZVERR_IDXOUTOFBOUND);
+		assert(vect_pool_submit_range(v, 10, 5, add_to_range, &delta, 0, 0) == ZVERR_IDXOUTOFBOUND);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+		vect_pool_shutdown();
+#endif // ZVECT_THREAD_SAFE
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ *    Name: UTest011
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100000
+
+void add_to_element(void *element, void *ctx) {
+	*((int *)element) += *((int *)ctx);
+}
+
+bool is_smaller(void *item1, void *item2, void *ctx) {
+	(void)ctx;
+	return *((int *)item1) < *((int *)item2);
+}
+
+struct batch_stats {
+	long long sum;
+	size_t items;
+	size_t calls;
+};
+
+void sum_batch(void **items, size_t n, void *ctx) {
+	struct batch_stats *stats = (struct batch_stats *)ctx;
+	for (size_t i = 0; i < n; i++)
+		stats->sum += *((int *)items[i]);
+	stats->items += n;
+	stats->calls++;
+}
+
+void double_batch(void **items, size_t n, void *ctx) {
+	(void)ctx;
+	for (size_t i = 0; i < n; i++)
+		*((int *)items[i]) *= 2;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "011";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_apply context and batch functions\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create two vectors and insert %d elements in each:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v1, v2;
+		v1 = vect_create(16, sizeof(int), ZV_NONE);
+		v2 = vect_create(16, sizeof(int), ZV_NONE);
+
+		int i;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			vect_add(v1, &i);
+			int value = (i & 1) ? 0 : MAX_ITEMS * 2;
+			vect_add(v2, &value);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_SFMD_EXTENSIONS
+	printf("Test %s_%d: Apply 'add_to_element' with a context to the entire vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		int delta = 10;
+		vect_apply_ctx(v1, add_to_element, &delta);
+
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_get_at(v1, i)) == i + 10);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply 'add_to_element' with a context to items from 50 to 20:\n", testGrp, testID);
+	fflush(stdout);
+
+		delta = -10;
+		vect_apply_range_ctx(v1, add_to_element, &delta, 50, 20);
+
+		for (i = 0; i < 100; i++) {
+			int value = *((int *)vect_get_at(v1, i));
+			if (i >= 20 && i <= 50)
+				assert(value == i);
+			else
+				assert(value == i + 10);
+		}
+
+		vect_apply_range_ctx(v1, add_to_element, &delta, 0, MAX_ITEMS);
+		assert(vect_get_last_error(v1) != 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply 'add_to_element' with a context only to the items smaller than the ones in v2:\n", testGrp, testID);
+	fflush(stdout);
+
+		delta = 1;
+		vect_apply_if_ctx(v1, v2, add_to_element, is_smaller, &delta);
+
+		for (i = 0; i < 100; i++) {
+			int value = *((int *)vect_get_at(v1, i));
+			int expected = (i >= 20 && i <= 50) ? i : i + 10;
+			if (!(i & 1))
+				expected++;
+			assert(value == expected);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum all the items using vect_apply_batch:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_clear(v1);
+		for (i = 0; i < MAX_ITEMS; i++)
+			vect_add(v1, &i);
+
+		struct batch_stats stats = { 0, 0, 0 };
+		vect_apply_batch(v1, sum_batch, &stats);
+
+		assert(stats.items == MAX_ITEMS);
+		assert(stats.calls >= 1);
+		assert(stats.sum == ((long long)MAX_ITEMS * (MAX_ITEMS - 1)) / 2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum items from 10 to 19 using vect_apply_range_batch:\n", testGrp, testID);
+	fflush(stdout);
+
+		stats.sum = 0;
+		stats.items = 0;
+		vect_apply_range_batch(v1, sum_batch, &stats, 19, 10);
+
+		assert(stats.items == 10);
+		assert(stats.sum == 145);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Double all the items using vect_apply_batch_parallel:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_apply_batch_parallel(v1, double_batch, NULL, 0, 1000);
+
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_get_at(v1, i)) == i * 2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_SFMD_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v1);
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
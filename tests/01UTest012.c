@@ -0,0 +1,195 @@
+/*
+ *    Name: UTest012
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100003
+
+struct record {
+	uint32_t flags;
+	uint32_t id;
+	uint64_t key;
+	char name[6];
+};
+
+// Please note: vect_lsearch compare functions return
+// a value different than 0 when the item matches the key
+static int match_id(const void *key, const void *item) {
+	return ((const struct record *)item)->id == *((const uint32_t *)key);
+}
+
+static int match_flags(const void *key, const void *item) {
+	return ((const struct record *)item)->flags == *((const uint32_t *)key);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "012";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_lsearch_parallel and vect_find_bytes\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of records and insert %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(struct record), ZV_NONE);
+
+		uint32_t i;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			struct record r;
+			memset(&r, 0, sizeof(r));
+			r.flags = i % 1000;
+			r.id = i * 3;
+			r.key = ((uint64_t)i << 32) | 7;
+			snprintf(r.name, sizeof(r.name), "%05u", i % 100000);
+			vect_add(v, &r);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Search records in parallel and check the lowest index is returned:\n", testGrp, testID);
+	fflush(stdout);
+
+#	if ( ZVECT_THREAD_SAFE == 1 )
+		vect_pool_set_threads(3);
+#	endif
+
+		zvect_index idx = 0;
+		uint32_t key = 3 * 99999;
+		assert(vect_lsearch_parallel(v, &key, match_id, &idx, 0, 1000));
+		assert(idx == 99999);
+
+		key = 3 * 7;
+		assert(vect_lsearch_parallel(v, &key, match_id, &idx, 0, 1000));
+		assert(idx == 7);
+
+		// Flags repeat every 1000 items:
+		key = 999;
+		assert(vect_lsearch_parallel(v, &key, match_flags, &idx, 0, 100));
+		assert(idx == 999);
+
+		key = 1;
+		assert(!vect_lsearch_parallel(v, &key, match_id, &idx, 0, 0));
+		assert(idx == 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Find records using 4 bytes keys:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (i = 0; i < MAX_ITEMS; i += 997) {
+			key = i * 3;
+			assert(vect_find_bytes(v, &key, offsetof(struct record, id), sizeof(key), &idx));
+			assert(idx == i);
+		}
+
+		// The last items are in the scalar tail:
+		key = (MAX_ITEMS - 1) * 3;
+		assert(vect_find_bytes(v, &key, offsetof(struct record, id), sizeof(key), &idx));
+		assert(idx == MAX_ITEMS - 1);
+
+		key = 1;
+		assert(!vect_find_bytes(v, &key, offsetof(struct record, id), sizeof(key), &idx));
+
+		key = 999;
+		assert(vect_find_bytes(v, &key, offsetof(struct record, flags), sizeof(key), &idx));
+		assert(idx == 999);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Find records using 8 bytes keys:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (i = 0; i < MAX_ITEMS; i += 1001) {
+			uint64_t key64 = ((uint64_t)i << 32) | 7;
+			assert(vect_find_bytes(v, &key64, offsetof(struct record, key), sizeof(key64), &idx));
+			assert(idx == i);
+		}
+
+		uint64_t key64 = ((uint64_t)(MAX_ITEMS - 1) << 32) | 7;
+		assert(vect_find_bytes(v, &key64, offsetof(struct record, key), sizeof(key64), &idx));
+		assert(idx == MAX_ITEMS - 1);
+
+		// Only the lower half matches:
+		key64 = ((uint64_t)MAX_ITEMS << 32) | 7;
+		assert(!vect_find_bytes(v, &key64, offsetof(struct record, key), sizeof(key64), &idx));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Find records using other key sizes:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_find_bytes(v, "12345", offsetof(struct record, name), 5, &idx));
+		assert(idx == 12345);
+
+		assert(vect_find_bytes(v, "00", offsetof(struct record, name), 2, &idx));
+		assert(idx == 0);
+
+		assert(!vect_find_bytes(v, "x", offsetof(struct record, name), 1, &idx));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check keys outside of the item are refused:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(!vect_find_bytes(v, &key64, sizeof(struct record) - 4, sizeof(key64), &idx));
+		assert(vect_get_last_error(v) != 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
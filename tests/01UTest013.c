@@ -0,0 +1,126 @@
+/*
+ *    Name: UTest013
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 10007
+
+static void check_kernels(char *testGrp, uint8_t testID, uint32_t features)
+{
+	uint32_t active = vect_set_cpu_features(features);
+	assert((active & ~features) == 0);
+	assert((active & ~vect_get_cpu_features()) == 0);
+
+	printf("Test %s_%d: Check bulk kernels using features 0x%x (active 0x%x):\n", testGrp, testID, features, active);
+	fflush(stdout);
+
+		vector v = vect_create(16, sizeof(int64_t), ZV_SEC_WIPE);
+
+		int64_t i;
+		for (i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+
+		// Pointer moves:
+		i = -1;
+		vect_add_at(v, &i, 0);
+		vect_add_at(v, &i, 5000);
+		assert(*((int64_t *)vect_get_at(v, 0)) == -1);
+		assert(*((int64_t *)vect_get_at(v, 5000)) == -1);
+		assert(*((int64_t *)vect_get_at(v, 5001)) == 4999);
+		vect_delete_at(v, 5000);
+		vect_delete_at(v, 0);
+		for (i = 0; i < MAX_ITEMS; i++)
+			assert(*((int64_t *)vect_get_at(v, (zvect_index)i)) == i);
+
+		// Moving items to another vector (moves and fill):
+		vector v2 = vect_create(16, sizeof(int64_t), ZV_NONE);
+		vect_move(v2, v, 100, 3001);
+		assert(vect_size(v2) == 3001);
+		assert(vect_size(v) == MAX_ITEMS - 3001);
+		assert(*((int64_t *)vect_get_at(v2, 0)) == 100);
+		assert(*((int64_t *)vect_get_at(v, 100)) == 3101);
+		vect_destroy(v2);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+		// Byte-key search:
+		zvect_index idx;
+		i = 3101;
+		assert(vect_find_bytes(v, &i, 0, sizeof(i), &idx));
+		assert(idx == 100);
+		int32_t low = 9999;
+		assert(vect_find_bytes(v, &low, 0, sizeof(low), &idx));
+		assert(idx == 9999 - 3001);
+		i = 50;
+		assert(!vect_find_bytes(v, &i, 0, sizeof(i), &idx) || idx == 50);
+#endif
+
+		// Secure wipe (items are wiped when removed):
+		while (!vect_is_empty(v))
+			vect_delete(v);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	fflush(stdout);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "013";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing runtime selection of the bulk kernels\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Detect CPU features:\n", testGrp, testID);
+	fflush(stdout);
+
+		uint32_t features = vect_get_cpu_features();
+		printf("Detected features: %s%s%s\n",
+		       (features & ZV_CPU_SSE2) ? "SSE2 " : "",
+		       (features & ZV_CPU_AVX2) ? "AVX2 " : "",
+		       (features & ZV_CPU_AVX512) ? "AVX-512 " : "");
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	check_kernels(testGrp, testID++, ZV_CPU_NONE);
+	check_kernels(testGrp, testID++, ZV_CPU_SSE2);
+	check_kernels(testGrp, testID++, ZV_CPU_SSE2 | ZV_CPU_AVX2);
+	check_kernels(testGrp, testID++, ZV_CPU_ALL);
+
+	printf("Test %s_%d: Check all detected features are used by default:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_set_cpu_features(ZV_CPU_ALL) == features);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ *    Name: UTest014
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100000
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "014";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_bsearch_hint\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of even numbers with %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(int), ZV_NONE);
+
+		int i;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			int value = i * 2;
+			vect_add(v, &value);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Search all items in sequence using a cursor:\n", testGrp, testID);
+	fflush(stdout);
+
+		bsearch_cursor c = { 0, 0 };
+		zvect_index idx = 0;
+		int key;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			key = i * 2;
+			assert(vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+			assert(idx == (zvect_index)i);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search items backward and with random jumps:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (i = MAX_ITEMS - 1; i >= 0; i -= 3) {
+			key = i * 2;
+			assert(vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+			assert(idx == (zvect_index)i);
+		}
+
+		srand(14);
+		for (i = 0; i < 10000; i++) {
+			int j = rand() % MAX_ITEMS;
+			key = j * 2;
+			assert(vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+			assert(idx == (zvect_index)j);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search missing items:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (i = 0; i < MAX_ITEMS; i += 101) {
+			key = i * 2 + 1;
+			assert(!vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+			assert(idx == 0);
+		}
+		key = -1;
+		assert(!vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+		key = MAX_ITEMS * 2;
+		assert(!vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Use independent cursors on the same vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		bsearch_cursor c1 = { 0, 0 };
+		bsearch_cursor c2 = { 0, 0 };
+		for (i = 0; i < MAX_ITEMS / 2; i++) {
+			key = i * 2;
+			assert(vect_bsearch_hint(v, &key, compare_int, &c1, &idx));
+			assert(idx == (zvect_index)i);
+			key = (MAX_ITEMS - 1 - i) * 2;
+			assert(vect_bsearch_hint(v, &key, compare_int, &c2, &idx));
+			assert(idx == (zvect_index)(MAX_ITEMS - 1 - i));
+		}
+
+		// vect_bsearch doesn't need (or change) any cursor:
+		key = 1234;
+		assert(vect_bsearch(v, &key, compare_int, &idx));
+		assert(idx == 617);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Reuse a cursor after the vector shrinks:\n", testGrp, testID);
+	fflush(stdout);
+
+		c.bottom = MAX_ITEMS - 10;
+		c.balance = 0;
+		vect_delete_range(v, 100, MAX_ITEMS - 1);
+		assert(vect_size(v) == 100);
+
+		key = 42;
+		assert(vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+		assert(idx == 21);
+
+		// Single item vectors:
+		vect_delete_range(v, 1, 99);
+		key = 0;
+		assert(vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+		assert(idx == 0);
+		assert(vect_bsearch(v, &key, compare_int, &idx));
+		key = 2;
+		assert(!vect_bsearch_hint(v, &key, compare_int, &c, &idx));
+		assert(!vect_bsearch(v, &key, compare_int, &idx));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ *    Name: UTest015
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 50000
+#define MAX_KEYS 20000
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+// Items are 0, 0, 3, 3, 6, 6, ... so every value is duplicated
+// and only multiples of 3 can be found:
+static zvect_index expected(int key) {
+	if ((key < 0) || (key % 3) || (key / 3 >= MAX_ITEMS / 2))
+		return zvect_index_max;
+	return (zvect_index)((key / 3) * 2);
+}
+
+static int key_values[MAX_KEYS];
+static const void *keys[MAX_KEYS];
+static zvect_index out_idx[MAX_KEYS];
+
+static zvect_index check_results(zvect_index nkeys) {
+	zvect_index found = 0;
+	for (zvect_index i = 0; i < nkeys; i++) {
+		assert(out_idx[i] == expected(key_values[i]));
+		found += (out_idx[i] != zvect_index_max);
+	}
+	return found;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "015";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_bsearch_batch\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create an ordered vector with %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(int), ZV_NONE);
+
+		int i;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			int value = (i / 2) * 3;
+			vect_add(v, &value);
+		}
+
+		for (i = 0; i < MAX_KEYS; i++)
+			keys[i] = &key_values[i];
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Search sorted keys:\n", testGrp, testID);
+	fflush(stdout);
+
+		// Hits, misses and repeated keys:
+		for (i = 0; i < MAX_KEYS; i++)
+			key_values[i] = (i * 7) / 2 - 10;
+
+		zvect_index found = vect_bsearch_batch(v, keys, MAX_KEYS, compare_int, out_idx);
+		assert(found == check_results(MAX_KEYS));
+		assert(found > 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search unsorted keys:\n", testGrp, testID);
+	fflush(stdout);
+
+		srand(15);
+		for (i = 0; i < MAX_KEYS; i++)
+			key_values[i] = rand() % (MAX_ITEMS * 2) - 5;
+
+		found = vect_bsearch_batch(v, keys, MAX_KEYS, compare_int, out_idx);
+		assert(found == check_results(MAX_KEYS));
+		assert(found > 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search keys that switch between sorted and unsorted:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (i = 0; i < MAX_KEYS; i++) {
+			if ((i / 1000) % 2)
+				key_values[i] = rand() % (MAX_ITEMS * 2);
+			else
+				key_values[i] = i * 3;
+		}
+
+		found = vect_bsearch_batch(v, keys, MAX_KEYS, compare_int, out_idx);
+		assert(found == check_results(MAX_KEYS));
+
+		// Descending keys and a partial last group:
+		for (i = 0; i < 1003; i++)
+			key_values[i] = (1003 - i) * 3;
+		found = vect_bsearch_batch(v, keys, 1003, compare_int, out_idx);
+		assert(found == check_results(1003));
+		assert(found == 1003);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search on small and empty vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v2 = vect_create(4, sizeof(int), ZV_NONE);
+		key_values[0] = 3;
+		key_values[1] = 0;
+		assert(vect_bsearch_batch(v2, keys, 2, compare_int, out_idx) == 0);
+		assert(out_idx[0] == zvect_index_max && out_idx[1] == zvect_index_max);
+
+		int value = 3;
+		vect_add(v2, &value);
+		assert(vect_bsearch_batch(v2, keys, 2, compare_int, out_idx) == 1);
+		assert(out_idx[0] == 0 && out_idx[1] == zvect_index_max);
+
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *    Name: UTest016
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100000
+
+struct record {
+	uint64_t id;
+	uint32_t value;
+};
+
+static uint64_t get_id(const void *item) {
+	return ((const struct record *)item)->id;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "016";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_index_build and vect_index_find\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of records ordered by id with %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(struct record), ZV_NONE);
+
+		// ids are 10, 10, 10, 20, 30, 40, ... (the first one is repeated):
+		uint32_t i;
+		struct record r;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			r.id = (i < 3) ? 10 : (uint64_t)(i - 1) * 10;
+			r.value = i;
+			vect_add(v, &r);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Build the index and find every item:\n", testGrp, testID);
+	fflush(stdout);
+
+		search_index si = vect_index_build(v, get_id);
+		assert(si != NULL);
+
+		zvect_index idx;
+		for (i = 3; i < MAX_ITEMS; i++) {
+			assert(vect_index_find(si, (uint64_t)(i - 1) * 10, &idx));
+			assert(idx == i);
+			assert(((struct record *)vect_get_at(v, idx))->value == i);
+		}
+
+		// Duplicated keys return the first item:
+		assert(vect_index_find(si, 10, &idx));
+		assert(idx == 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search missing keys:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(!vect_index_find(si, 0, &idx));
+		assert(!vect_index_find(si, 15, &idx));
+		assert(!vect_index_find(si, (uint64_t)MAX_ITEMS * 10, &idx));
+		assert(!vect_index_find(si, UINT64_MAX, &idx));
+		for (i = 0; i < MAX_ITEMS; i += 97)
+			assert(!vect_index_find(si, (uint64_t)i * 10 + 5, &idx));
+
+		vect_index_destroy(si);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Build indexes on small vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v2 = vect_create(4, sizeof(struct record), ZV_NONE);
+		si = vect_index_build(v2, get_id);
+		assert(si != NULL);
+		assert(!vect_index_find(si, 10, &idx));
+		vect_index_destroy(si);
+
+		for (i = 1; i <= 7; i++) {
+			r.id = i * 2;
+			r.value = i;
+			vect_add(v2, &r);
+			si = vect_index_build(v2, get_id);
+			assert(si != NULL);
+			for (uint32_t j = 1; j <= i; j++) {
+				assert(vect_index_find(si, j * 2, &idx));
+				assert(idx == j - 1);
+				assert(!vect_index_find(si, j * 2 + 1, &idx));
+			}
+			assert(!vect_index_find(si, 1, &idx));
+			vect_index_destroy(si);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Refuse to index unordered vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		r.id = 1;
+		vect_add(v2, &r);
+		si = vect_index_build(v2, get_id);
+		assert(si == NULL);
+		assert(vect_get_last_error(v2) != 0);
+
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ *    Name: UTest017
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 5000
+#define MAX_OPS 20000
+#define MAX_IDS 3000
+
+struct record {
+	uint32_t id;
+	uint32_t payload;
+};
+
+static uint64_t hash_id(const void *item) {
+	return ((const struct record *)item)->id * 0x9E3779B97F4A7C15ULL;
+}
+
+static bool same_id(const void *key, const void *item) {
+	return ((const struct record *)key)->id == ((const struct record *)item)->id;
+}
+
+static int compare_id(const void *a, const void *b) {
+	const struct record *x = (const struct record *)a;
+	const struct record *y = (const struct record *)b;
+	return (x->id > y->id) - (x->id < y->id);
+}
+
+// Reference copy of the ids in the vector:
+static uint32_t model[MAX_ITEMS * 4];
+static zvect_index model_size = 0;
+
+static void check_all(vector v) {
+	zvect_index idx;
+	struct record key;
+
+	assert(vect_size(v) == model_size);
+	for (zvect_index i = 0; i < model_size; i++)
+		assert(((struct record *)vect_get_at(v, i))->id == model[i]);
+
+	for (uint32_t id = 0; id < MAX_IDS; id++) {
+		zvect_index expected = model_size;
+		for (zvect_index i = 0; i < model_size; i++) {
+			if (model[i] == id) {
+				expected = i;
+				break;
+			}
+		}
+		key.id = id;
+		bool found = vect_hindex_find(v, &key, &idx);
+		assert(found == (expected < model_size));
+		if (found)
+			assert(idx == expected);
+	}
+}
+
+static void model_insert(zvect_index i, uint32_t id) {
+	memmove(model + i + 1, model + i, sizeof(uint32_t) * (model_size - i));
+	model[i] = id;
+	model_size++;
+}
+
+static void model_delete(zvect_index i, zvect_index n) {
+	memmove(model + i, model + i + n, sizeof(uint32_t) * (model_size - (i + n)));
+	model_size -= n;
+}
+
+static int compare_u32(const void *a, const void *b) {
+	uint32_t x = *((const uint32_t *)a);
+	uint32_t y = *((const uint32_t *)b);
+	return (x > y) - (x < y);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "017";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_hindex_create and vect_hindex_find\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector with %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v;
+		v = vect_create(16, sizeof(struct record), ZV_NONE);
+
+		struct record r;
+		uint32_t i;
+		for (i = 0; i < MAX_ITEMS; i++) {
+			r.id = (i * 7) % MAX_IDS;
+			r.payload = i;
+			vect_add(v, &r);
+			model[model_size++] = r.id;
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Create the hash index and find all the ids:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_hindex_create(v, hash_id, same_id) == 0);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Keep the index updated during %d random changes:\n", testGrp, testID, MAX_OPS);
+	fflush(stdout);
+
+		srand(17);
+		for (i = 0; i < MAX_OPS; i++) {
+			zvect_index pos = model_size ? (zvect_index)(rand() % model_size) : 0;
+			r.id = rand() % MAX_IDS;
+			r.payload = i;
+
+			switch (rand() % 9) {
+			case 0:
+				vect_add(v, &r);
+				model_insert(model_size, r.id);
+				break;
+			case 1:
+				vect_add_front(v, &r);
+				model_insert(0, r.id);
+				break;
+			case 2:
+				vect_add_at(v, &r, pos);
+				model_insert(pos, r.id);
+				break;
+			case 3:
+				if (model_size > 1) {
+					free(vect_remove_at(v, pos));
+					model_delete(pos, 1);
+				}
+				break;
+			case 4:
+				if (model_size > 1) {
+					vect_delete_front(v);
+					model_delete(0, 1);
+				}
+				break;
+			case 5:
+				if (model_size > 1) {
+					free(vect_pop(v));
+					model_delete(model_size - 1, 1);
+				}
+				break;
+			case 6:
+				if (model_size > 20) {
+					zvect_index n = rand() % 10;
+					if (pos + n >= model_size)
+						pos = model_size - n - 1;
+					vect_delete_range(v, pos, pos + n);
+					model_delete(pos, n + 1);
+				}
+				break;
+			case 7:
+				if (model_size > 0) {
+					vect_put_at(v, &r, pos);
+					model[pos] = r.id;
+				}
+				break;
+			case 8:
+				if (model_size > 1) {
+					zvect_index pos2 = rand() % model_size;
+					vect_swap(v, pos, pos2);
+					uint32_t t = model[pos];
+					model[pos] = model[pos2];
+					model[pos2] = t;
+				}
+				break;
+			}
+
+			if ((i % 2000) == 0)
+				check_all(v);
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort the vector and find all the ids:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_qsort(v, compare_id);
+		qsort(model, model_size, sizeof(uint32_t), compare_u32);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Clear the vector and destroy the index:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index idx;
+		vect_clear(v);
+		model_size = 0;
+		check_all(v);
+
+		r.id = 5;
+		vect_add(v, &r);
+		model[model_size++] = 5;
+		check_all(v);
+
+		vect_hindex_destroy(v);
+		assert(!vect_hindex_find(v, &r, &idx));
+		assert(vect_get_last_error(v) != 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
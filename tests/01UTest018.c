@@ -0,0 +1,192 @@
+/*
+ *    Name: UTest018
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 20000
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+static int a1[MAX_ITEMS];
+static int a2[MAX_ITEMS];
+static int expected[MAX_ITEMS * 2];
+
+// Reference implementation on plain arrays (0 = union,
+// 1 = intersection, 2 = difference):
+static int ref_set_op(const int *x, int nx, const int *y, int ny, int op) {
+	int i = 0, j = 0, n = 0;
+	while (i < nx && j < ny) {
+		if (x[i] < y[j]) {
+			if (op != 1)
+				expected[n++] = x[i];
+			i++;
+		} else if (y[j] < x[i]) {
+			if (op == 0)
+				expected[n++] = y[j];
+			j++;
+		} else {
+			if (op != 2)
+				expected[n++] = x[i];
+			i++;
+			j++;
+		}
+	}
+	while (op != 1 && i < nx)
+		expected[n++] = x[i++];
+	while (op == 0 && j < ny)
+		expected[n++] = y[j++];
+	return n;
+}
+
+static vector make_vector(int *a, int n, int step, int dups, uint32_t flags) {
+	vector v = vect_create(8, sizeof(int), flags);
+	for (int i = 0; i < n; i++) {
+		a[i] = (i / dups) * step;
+		vect_add(v, &a[i]);
+	}
+	return v;
+}
+
+static void check_op(vector v1, const int *x, int n1, vector v2, const int *y, int n2, int op) {
+	vector dst = vect_create(4, sizeof(int), ZV_NONE);
+	zvect_retval rval;
+
+	if (op == 0)
+		rval = vect_set_union(dst, v1, v2, compare_int);
+	else if (op == 1)
+		rval = vect_set_intersect(dst, v1, v2, compare_int);
+	else
+		rval = vect_set_difference(dst, v1, v2, compare_int);
+	assert(rval == 0);
+
+	int n = ref_set_op(x, n1, y, n2, op);
+	assert(vect_size(dst) == (zvect_index)n);
+	for (int i = 0; i < n; i++)
+		assert(*((int *)vect_get_at(dst, i)) == expected[i]);
+
+	vect_destroy(dst);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "018";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_set_union, vect_set_intersect and vect_set_difference\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Combine vectors of similar size:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v1 = make_vector(a1, MAX_ITEMS, 2, 1, ZV_NONE);
+		vector v2 = make_vector(a2, MAX_ITEMS, 3, 1, ZV_NONE);
+		for (int op = 0; op < 3; op++)
+			check_op(v1, a1, MAX_ITEMS, v2, a2, MAX_ITEMS, op);
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Combine vectors of very different sizes (galloping):\n", testGrp, testID);
+	fflush(stdout);
+
+		v2 = make_vector(a2, 100, 397, 1, ZV_NONE);
+		for (int op = 0; op < 3; op++) {
+			check_op(v1, a1, MAX_ITEMS, v2, a2, 100, op);
+			check_op(v2, a2, 100, v1, a1, MAX_ITEMS, op);
+		}
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Combine vectors with duplicated items:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v1);
+		v1 = make_vector(a1, 3000, 1, 3, ZV_NONE);
+		v2 = make_vector(a2, 2000, 2, 2, ZV_NONE);
+		for (int op = 0; op < 3; op++)
+			check_op(v1, a1, 3000, v2, a2, 2000, op);
+		vect_destroy(v2);
+
+		// Empty vectors:
+		v2 = vect_create(4, sizeof(int), ZV_NONE);
+		for (int op = 0; op < 3; op++) {
+			check_op(v1, a1, 3000, v2, a2, 0, op);
+			check_op(v2, a2, 0, v1, a1, 3000, op);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Results are appended and shared by ZV_BYREF vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		int first = -1;
+		vector dst = vect_create(4, sizeof(int), ZV_BYREF);
+		vect_add(dst, &first);
+		assert(vect_set_union(dst, v1, v2, compare_int) == 0);
+		assert(vect_size(dst) == 3001);
+		assert(*((int *)vect_get_at(dst, 0)) == -1);
+		// The items are the ones in v1:
+		assert(vect_get_at(dst, 1) == vect_get_at(v1, 0));
+		assert(vect_get_at(dst, 3000) == vect_get_at(v1, 2999));
+		vect_destroy(dst);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Refuse invalid parameters:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_set_union(v1, v1, v2, compare_int) != 0);
+		vector v3 = vect_create(4, sizeof(char), ZV_NONE);
+		assert(vect_set_intersect(v3, v1, v2, compare_int) != 0);
+		assert(vect_get_last_error(v3) != 0);
+		vect_destroy(v3);
+
+		vect_destroy(v1);
+		vect_destroy(v2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
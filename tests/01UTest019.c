@@ -0,0 +1,160 @@
+/*
+ *    Name: UTest019
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_PARTS 13
+#define MAX_ITEMS 4000
+
+struct record {
+	int key;
+	int part;
+	int seq;
+};
+
+static int compare_key(const void *a, const void *b) {
+	int x = ((const struct record *)a)->key;
+	int y = ((const struct record *)b)->key;
+	return (x > y) - (x < y);
+}
+
+// Checks dst is ordered, stable and contains "total" items:
+static void check_merged(vector dst, zvect_index total) {
+	assert(vect_size(dst) == total);
+	for (zvect_index i = 1; i < total; i++) {
+		struct record *a = (struct record *)vect_get_at(dst, i - 1);
+		struct record *b = (struct record *)vect_get_at(dst, i);
+		assert(a->key <= b->key);
+		if (a->key == b->key) {
+			assert(a->part <= b->part);
+			if (a->part == b->part)
+				assert(a->seq < b->seq);
+		}
+	}
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "019";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_merge_sorted\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Create %d ordered vectors of different sizes:\n", testGrp, testID, MAX_PARTS);
+	fflush(stdout);
+
+		vector parts[MAX_PARTS];
+		zvect_index total = 0;
+		srand(19);
+		for (int p = 0; p < MAX_PARTS; p++) {
+			parts[p] = vect_create(8, sizeof(struct record), ZV_NONE);
+			// Part 5 is left empty:
+			int n = (p == 5) ? 0 : rand() % MAX_ITEMS;
+			struct record r = { 0, p, 0 };
+			for (int i = 0; i < n; i++) {
+				r.key += rand() % 4;
+				r.seq = i;
+				vect_add(parts[p], &r);
+			}
+			total += n;
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Merge all the vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector dst = vect_create(4, sizeof(struct record), ZV_NONE);
+		assert(vect_merge_sorted(dst, parts, MAX_PARTS, compare_key) == 0);
+		check_merged(dst, total);
+
+		// The merged vectors are not changed:
+		for (int p = 0; p < MAX_PARTS; p++) {
+			zvect_index n = vect_size(parts[p]);
+			if (n)
+				assert(((struct record *)vect_get_at(parts[p], n - 1))->seq == (int)(n - 1));
+		}
+		vect_destroy(dst);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Merge one and no vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		dst = vect_create(4, sizeof(struct record), ZV_NONE);
+		assert(vect_merge_sorted(dst, parts, 1, compare_key) == 0);
+		check_merged(dst, vect_size(parts[0]));
+		assert(vect_merge_sorted(dst, parts, 0, compare_key) == 0);
+		assert(vect_size(dst) == vect_size(parts[0]));
+		vect_destroy(dst);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Merge in a ZV_BYREF vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		dst = vect_create(4, sizeof(struct record), ZV_BYREF);
+		assert(vect_merge_sorted(dst, parts + 1, 2, compare_key) == 0);
+		check_merged(dst, vect_size(parts[1]) + vect_size(parts[2]));
+		for (zvect_index i = 0; i < vect_size(dst); i++) {
+			struct record *r = (struct record *)vect_get_at(dst, i);
+			assert(vect_get_at(parts[r->part], r->seq) == r);
+		}
+		vect_destroy(dst);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Refuse invalid parameters:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_merge_sorted(parts[0], parts, 2, compare_key) != 0);
+		dst = vect_create(4, sizeof(int), ZV_NONE);
+		assert(vect_merge_sorted(dst, parts, 2, compare_key) != 0);
+		assert(vect_get_last_error(dst) != 0);
+		vect_destroy(dst);
+
+		for (int p = 0; p < MAX_PARTS; p++)
+			vect_destroy(parts[p]);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ *    Name: UTest020
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 30000
+#define MAX_BATCH 10000
+
+struct record {
+	int key;
+	int seq;
+};
+
+static int compare_key(const void *a, const void *b) {
+	int x = ((const struct record *)a)->key;
+	int y = ((const struct record *)b)->key;
+	return (x > y) - (x < y);
+}
+
+static struct record batch[MAX_BATCH];
+
+// Checks v is ordered and items with the same key are ordered by
+// seq (existing items have lower seq than the new ones):
+static void check_ordered(vector v, zvect_index size) {
+	assert(vect_size(v) == size);
+	for (zvect_index i = 1; i < size; i++) {
+		struct record *a = (struct record *)vect_get_at(v, i - 1);
+		struct record *b = (struct record *)vect_get_at(v, i);
+		assert(a->key <= b->key);
+		if (a->key == b->key)
+			assert(a->seq < b->seq);
+	}
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "020";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_add_ordered_n\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Add batches of items to an empty vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = vect_create(8, sizeof(struct record), ZV_NONE);
+		int seq = 0;
+		srand(20);
+		zvect_index size = 0;
+		for (int b = 0; b < 3; b++) {
+			for (int i = 0; i < MAX_BATCH; i++) {
+				batch[i].key = rand() % (MAX_ITEMS / 2);
+				batch[i].seq = seq++;
+			}
+			vect_add_ordered_n(v, batch, MAX_BATCH, compare_key);
+			size += MAX_BATCH;
+			check_ordered(v, size);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add small batches, batches after the end and before the beginning:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int b = 1; b < 50; b++) {
+			for (int i = 0; i < b; i++) {
+				batch[i].key = rand() % (MAX_ITEMS / 2);
+				batch[i].seq = seq++;
+			}
+			vect_add_ordered_n(v, batch, b, compare_key);
+			size += b;
+		}
+		check_ordered(v, size);
+
+		for (int i = 0; i < 100; i++) {
+			batch[i].key = MAX_ITEMS + 100 - i;
+			batch[i].seq = seq++;
+		}
+		vect_add_ordered_n(v, batch, 100, compare_key);
+		size += 100;
+		check_ordered(v, size);
+		assert(((struct record *)vect_get_at(v, size - 1))->key == MAX_ITEMS + 100);
+
+		for (int i = 0; i < 100; i++) {
+			batch[i].key = -i;
+			batch[i].seq = seq++;
+		}
+		vect_add_ordered_n(v, batch, 100, compare_key);
+		size += 100;
+		check_ordered(v, size);
+		assert(((struct record *)vect_get_at(v, 0))->key == -99);
+
+		// The vector is still usable with the other functions:
+		struct record r = { -1000, seq++ };
+		vect_add_ordered(v, &r, compare_key);
+		vect_add_front(v, &r);
+		vect_delete_front(v);
+		check_ordered(v, size + 1);
+
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add a batch to a ZV_BYREF vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(8, sizeof(struct record), ZV_BYREF);
+		for (int i = 0; i < 1000; i++) {
+			batch[i].key = (i * 37) % 1000;
+			batch[i].seq = i;
+		}
+		vect_add_ordered_n(v, batch, 1000, compare_key);
+		check_ordered(v, 1000);
+		for (int i = 0; i < 1000; i++) {
+			struct record *p = (struct record *)vect_get_at(v, i);
+			assert(p->key == i);
+			assert(p == &batch[(i * 973) % 1000]);
+		}
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ *    Name: UTest021
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100000
+
+static bool is_multiple(const void *item, void *ctx) {
+	return (*((const int *)item) % *((int *)ctx)) == 0;
+}
+
+static bool always(const void *item, void *ctx) {
+	(void)item;
+	(void)ctx;
+	return true;
+}
+
+// Stateful predicate: counts its calls and removes the first
+// *ctx items it's called with:
+static int calls = 0;
+
+static bool first_n(const void *item, void *ctx) {
+	(void)item;
+	calls++;
+	return calls <= *((int *)ctx);
+}
+
+static int wiped = 0;
+
+static void count_wipe(const void *item, size_t size) {
+	(void)item;
+	(void)size;
+	wiped++;
+}
+
+static vector make_vector(uint32_t properties, int *values) {
+	vector v = vect_create(8, sizeof(int), properties);
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		values[i] = i;
+		vect_add(v, &values[i]);
+	}
+	return v;
+}
+
+static int values[MAX_ITEMS];
+
+int main() {
+	// Setup tests:
+	char *testGrp = "021";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_remove_if and vect_retain_if\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Remove all the multiples of 3:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = make_vector(ZV_NONE, values);
+		int k = 3;
+		zvect_index removed = vect_remove_if(v, is_multiple, &k);
+		assert(vect_get_last_error(v) == 0);
+		assert(removed == (MAX_ITEMS + 2) / 3);
+		assert(vect_size(v) == MAX_ITEMS - removed);
+		for (zvect_index i = 0; i < vect_size(v); i++) {
+			int value = *((int *)vect_get_at(v, i));
+			assert(value % 3 != 0);
+			assert(value == (int)(i + (i / 2) + 1));
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Retain only the multiples of 10 (of the items left):\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index size = vect_size(v);
+		k = 10;
+		removed = vect_retain_if(v, is_multiple, &k);
+		assert(vect_size(v) == size - removed);
+		for (zvect_index i = 1; i < vect_size(v); i++) {
+			int a = *((int *)vect_get_at(v, i - 1));
+			int b = *((int *)vect_get_at(v, i));
+			assert(a % 10 == 0 && b % 10 == 0 && a < b);
+		}
+
+		// Nothing to remove:
+		removed = vect_retain_if(v, is_multiple, &k);
+		assert(removed == 0);
+
+		// The vector is still usable after the capacity adjustment:
+		size = vect_size(v);
+		int value = -1;
+		vect_add(v, &value);
+		vect_add_front(v, &value);
+		assert(vect_size(v) == size + 2);
+		assert(*((int *)vect_get_front(v)) == -1);
+		assert(*((int *)vect_get(v)) == -1);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove all the items:\n", testGrp, testID);
+	fflush(stdout);
+
+		removed = vect_remove_if(v, always, NULL);
+		assert(removed == size + 2);
+		assert(vect_is_empty(v));
+		value = 42;
+		vect_add(v, &value);
+		assert(vect_size(v) == 1);
+		assert(*((int *)vect_get_at(v, 0)) == 42);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove items from a ZV_BYREF vector with secure wipe:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = make_vector(ZV_BYREF | ZV_SEC_WIPE, values);
+		vect_set_wipefunct(v, count_wipe);
+		k = 2;
+		removed = vect_remove_if(v, is_multiple, &k);
+		assert(removed == MAX_ITEMS / 2);
+		assert(wiped == MAX_ITEMS / 2);
+		for (zvect_index i = 0; i < vect_size(v); i++)
+			assert(vect_get_at(v, i) == &values[(2 * i) + 1]);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: The predicate is called once per item:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(8, sizeof(int), ZV_NONE);
+		for (int i = 0; i < 10; i++)
+			vect_add(v, &i);
+		k = 2;
+		removed = vect_remove_if(v, first_n, &k);
+		assert(calls == 10);
+		assert(removed == 2);
+		assert(vect_size(v) == 8);
+		for (zvect_index i = 0; i < vect_size(v); i++)
+			assert(*((int *)vect_get_at(v, i)) == (int)i + 2);
+		calls = 0;
+		k = 0;
+		assert(vect_retain_if(v, first_n, &k) == 8);
+		assert(calls == 8);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ *    Name: UTest022
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 50000
+#define MAX_KEY 40000
+
+struct event {
+	int id;
+	int seq;
+};
+
+static int compare_id(const void *a, const void *b) {
+	int x = ((const struct event *)a)->id;
+	int y = ((const struct event *)b)->id;
+	return (x > y) - (x < y);
+}
+
+static uint64_t hash_id(const void *item) {
+	return (uint64_t)((const struct event *)item)->id * 0x9E3779B97F4A7C15ULL;
+}
+
+// Poor hash, to test collisions:
+static uint64_t hash_id_bad(const void *item) {
+	return (uint64_t)(((const struct event *)item)->id % 7);
+}
+
+static bool same_id(const void *a, const void *b) {
+	return ((const struct event *)a)->id == ((const struct event *)b)->id;
+}
+
+static char seen[MAX_KEY];
+
+static vector make_vector(uint32_t seed) {
+	vector v = vect_create(8, sizeof(struct event), ZV_NONE);
+	struct event e;
+	srand(seed);
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		e.id = rand() % MAX_KEY;
+		e.seq = i;
+		vect_add(v, &e);
+	}
+	return v;
+}
+
+// Checks v contains the first occurrence of every id of the
+// sequence generated by make_vector(seed), in the same order:
+static void check_first_occurrences(vector v, uint32_t seed) {
+	zvect_index j = 0;
+	memset(seen, 0, sizeof(seen));
+	srand(seed);
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		int id = rand() % MAX_KEY;
+		if (seen[id])
+			continue;
+		seen[id] = 1;
+		struct event *e = (struct event *)vect_get_at(v, j++);
+		assert(e->id == id);
+		assert(e->seq == i);
+	}
+	assert(vect_size(v) == j);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "022";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_unique and vect_unique_hash\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Remove the duplicates from an ordered vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = make_vector(22);
+		vect_qsort(v, compare_id);
+		zvect_index size = vect_size(v);
+		zvect_index removed = vect_unique(v, compare_id);
+		assert(vect_get_last_error(v) == 0);
+		assert(vect_size(v) == size - removed);
+		memset(seen, 0, sizeof(seen));
+		srand(22);
+		zvect_index distinct = 0;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			int id = rand() % MAX_KEY;
+			if (!seen[id])
+				distinct++;
+			seen[id] = 1;
+		}
+		assert(vect_size(v) == distinct);
+		for (zvect_index i = 1; i < vect_size(v); i++)
+			assert(compare_id(vect_get_at(v, i - 1), vect_get_at(v, i)) < 0);
+
+		// Nothing left to remove:
+		assert(vect_unique(v, compare_id) == 0);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove the duplicates from an unordered vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = make_vector(23);
+		removed = vect_unique_hash(v, hash_id, same_id);
+		assert(vect_get_last_error(v) == 0);
+		assert(removed > 0);
+		check_first_occurrences(v, 23);
+		assert(vect_unique_hash(v, hash_id, same_id) == 0);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove the duplicates using a hash with many collisions:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(8, sizeof(struct event), ZV_NONE);
+		struct event e;
+		for (int i = 0; i < 2000; i++) {
+			e.id = (i * 13) % 500;
+			e.seq = i;
+			vect_add(v, &e);
+		}
+		removed = vect_unique_hash(v, hash_id_bad, same_id);
+		assert(removed == 1500);
+		for (zvect_index i = 0; i < vect_size(v); i++) {
+			struct event *p = (struct event *)vect_get_at(v, i);
+			assert(p->seq == (int)i);
+			assert(p->id == (int)((i * 13) % 500));
+		}
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Vectors of one item and empty vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(8, sizeof(struct event), ZV_NONE);
+		assert(vect_unique(v, compare_id) == 0);
+		assert(vect_unique_hash(v, hash_id, same_id) == 0);
+		e.id = 1;
+		vect_add(v, &e);
+		assert(vect_unique(v, compare_id) == 0);
+		assert(vect_unique_hash(v, hash_id, same_id) == 0);
+		vect_add(v, &e);
+		assert(vect_unique(v, compare_id) == 1);
+		assert(vect_size(v) == 1);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ *    Name: UTest023
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 300000
+
+static void sum_int(void *acc, const void *item, void *ctx) {
+	(void)ctx;
+	*((long long *)acc) += *((const int *)item);
+}
+
+static void add_ll(void *acc, const void *partial, void *ctx) {
+	(void)ctx;
+	*((long long *)acc) += *((const long long *)partial);
+}
+
+// A reduction which is associative but not commutative: it
+// checks the items are seen in order.
+struct run {
+	int first;
+	int last;
+	int count;
+	int ordered;
+};
+
+static void run_fold(void *acc, const void *item, void *ctx) {
+	struct run *r = (struct run *)acc;
+	int value = *((const int *)item);
+	(void)ctx;
+	if (r->count == 0)
+		r->first = value;
+	else if (value <= r->last)
+		r->ordered = 0;
+	r->last = value;
+	r->count++;
+}
+
+static void run_combine(void *acc, const void *partial, void *ctx) {
+	struct run *r = (struct run *)acc;
+	const struct run *p = (const struct run *)partial;
+	(void)ctx;
+	if (p->count == 0)
+		return;
+	if (r->count == 0) {
+		*r = *p;
+		return;
+	}
+	if (p->first <= r->last || !p->ordered)
+		r->ordered = 0;
+	r->last = p->last;
+	r->count += p->count;
+}
+
+static long long out1[MAX_ITEMS];
+static long long out2[MAX_ITEMS];
+
+int main() {
+	// Setup tests:
+	char *testGrp = "023";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_reduce and vect_scan\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_SFMD_EXTENSIONS
+	printf("Test %s_%d: Create a vector of %d elements:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(16, sizeof(int), ZV_NONE);
+		long long expected = 0;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			vect_add(v, &i);
+			expected += i;
+		}
+#if ( ZVECT_THREAD_SAFE == 1 )
+		vect_pool_set_threads(3);
+#endif
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum the items with vect_reduce and vect_reduce_parallel:\n", testGrp, testID);
+	fflush(stdout);
+
+		long long total = 0, zero = 0;
+		vect_reduce(v, &total, sum_int, NULL);
+		assert(total == expected);
+
+		zvect_index grains[] = { 0, 1000, 4096, 4097, MAX_ITEMS, MAX_ITEMS * 2 };
+		for (unsigned int g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+			total = 10;
+			vect_reduce_parallel(v, &total, sizeof(total), &zero, sum_int, add_ll, NULL, 0, grains[g]);
+			assert(vect_get_last_error(v) == 0);
+			assert(total == expected + 10);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: The partials are combined in order:\n", testGrp, testID);
+	fflush(stdout);
+
+		struct run r = { 0, 0, 0, 1 }, empty = { 0, 0, 0, 1 };
+		vect_reduce_parallel(v, &r, sizeof(r), &empty, run_fold, run_combine, NULL, 0, 1000);
+		assert(r.ordered == 1);
+		assert(r.count == MAX_ITEMS);
+		assert(r.first == 0 && r.last == MAX_ITEMS - 1);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Running totals with vect_scan and vect_scan_parallel:\n", testGrp, testID);
+	fflush(stdout);
+
+		long long init = 5;
+		vect_scan(v, out1, sizeof(long long), &init, sum_int, NULL);
+		long long running = init;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			running += i;
+			assert(out1[i] == running);
+		}
+
+		for (unsigned int g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+			for (int i = 0; i < MAX_ITEMS; i++)
+				out2[i] = -1;
+			vect_scan_parallel(v, out2, sizeof(long long), &init, &zero, sum_int, add_ll, NULL, 0, grains[g]);
+			assert(vect_get_last_error(v) == 0);
+			for (int i = 0; i < MAX_ITEMS; i++)
+				assert(out2[i] == out1[i]);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Reduce and scan an empty vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_destroy(v);
+		v = vect_create(16, sizeof(int), ZV_NONE);
+		total = 7;
+		vect_reduce(v, &total, sum_int, NULL);
+		vect_reduce_parallel(v, &total, sizeof(total), &zero, sum_int, add_ll, NULL, 0, 0);
+		assert(total == 7);
+		vect_scan_parallel(v, out2, sizeof(long long), &init, &zero, sum_int, add_ll, NULL, 0, 0);
+		assert(vect_get_last_error(v) == 0);
+		vect_destroy(v);
+#if ( ZVECT_THREAD_SAFE == 1 )
+		vect_pool_shutdown();
+#endif
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_SFMD_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ *    Name: UTest024
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_LEVELS 4
+
+static const uint32_t levels[MAX_LEVELS] = {
+	ZV_CPU_NONE,
+	ZV_CPU_SSE2,
+	ZV_CPU_SSE2 | ZV_CPU_AVX2,
+	ZV_CPU_ALL
+};
+
+static const zvect_index sizes[] = { 1, 2, 7, 15, 16, 17, 33, 100, 1000, 4099 };
+
+// Checks all the typed kernels on vectors of int32_t, int64_t
+// and double (values are small integers, so sums and dot
+// products of doubles are exact):
+#define CHECK_TYPE(ZT, T, SUMT)							\
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {	\
+		zvect_index n = sizes[s];					\
+		typed_vector a = vect_create_typed(ZT, 4);			\
+		typed_vector b = vect_create_typed(ZT, 0);			\
+		SUMT sum = 0, dot = 0;						\
+		T mn = 0, mx = 0, x, y;						\
+		zvect_index amin = 0, amax = 0, lt = 0, eq = 0;			\
+		T limit = 10;							\
+		for (zvect_index i = 0; i < n; i++) {				\
+			x = (T)((rand() % 201) - 100);				\
+			y = (T)((rand() % 21) - 10);				\
+			assert(vect_typed_push(a, &x) == 0);			\
+			vect_typed_append(b, &y, 1);				\
+			sum += (SUMT)x;						\
+			dot += (SUMT)x * (SUMT)y;				\
+			if (i == 0 || x < mn) { mn = x; amin = i; }		\
+			if (i == 0 || x > mx) { mx = x; amax = i; }		\
+			if (x < limit) lt++;					\
+			if (x == limit) eq++;					\
+		}								\
+		assert(vect_typed_size(a) == n);				\
+		SUMT rs;							\
+		T rv;								\
+		assert(vect_typed_sum(a, &rs) == 0 && rs == sum);		\
+		assert(vect_typed_dot(a, b, &rs) == 0 && rs == dot);		\
+		assert(vect_typed_min(a, &rv) == 0 && rv == mn);		\
+		assert(vect_typed_max(a, &rv) == 0 && rv == mx);		\
+		assert(vect_typed_argmin(a) == amin);				\
+		assert(vect_typed_argmax(a) == amax);				\
+		assert(vect_typed_count_if(a, ZV_LT, &limit) == lt);		\
+		assert(vect_typed_count_if(a, ZV_LE, &limit) == lt + eq);	\
+		assert(vect_typed_count_if(a, ZV_EQ, &limit) == eq);		\
+		assert(vect_typed_count_if(a, ZV_NE, &limit) == n - eq);	\
+		assert(vect_typed_count_if(a, ZV_GE, &limit) == n - lt);	\
+		assert(vect_typed_count_if(a, ZV_GT, &limit) == n - lt - eq);	\
+		T factor = 3;							\
+		assert(vect_typed_scale(b, &factor) == 0);			\
+		assert(vect_typed_add(a, b) == 0);				\
+		assert(vect_typed_sum(a, &rs) == 0);				\
+		SUMT bsum;							\
+		vect_typed_sum(b, &bsum);					\
+		assert(rs == sum + bsum);					\
+		vect_typed_destroy(a);						\
+		vect_typed_destroy(b);						\
+	}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "024";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing typed vectors\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a typed vector and add values to it:\n", testGrp, testID);
+	fflush(stdout);
+
+		typed_vector tv = vect_create_typed(ZV_T_F64, 2);
+		assert(tv != NULL);
+		assert(vect_typed_type(tv) == ZV_T_F64);
+		double values[100];
+		for (int i = 0; i < 100; i++)
+			values[i] = i * 0.5;
+		assert(vect_typed_append(tv, values, 100) == 0);
+		double x = -1.25;
+		assert(vect_typed_push(tv, &x) == 0);
+		assert(vect_typed_size(tv) == 101);
+		assert(*((double *)vect_typed_get_at(tv, 10)) == 5.0);
+		assert(((double *)vect_typed_data(tv))[100] == -1.25);
+		assert(((uintptr_t)vect_typed_data(tv) % 64) == 0);
+		assert(vect_typed_get_at(tv, 101) == NULL);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Aggregates of an empty vector and errors:\n", testGrp, testID);
+	fflush(stdout);
+
+		typed_vector empty = vect_create_typed(ZV_T_I32, 0);
+		typed_vector other = vect_create_typed(ZV_T_F32, 0);
+		int64_t isum = -1;
+		int32_t ival;
+		assert(vect_typed_sum(empty, &isum) == 0 && isum == 0);
+		assert(vect_typed_min(empty, &ival) == ZVERR_VECTEMPTY);
+		assert(vect_typed_argmax(empty) == zvect_index_max);
+		double dres;
+		assert(vect_typed_dot(empty, other, &dres) == ZVERR_VECTDATASIZE);
+		assert(vect_typed_add(tv, tv) == 0);
+		assert(vect_typed_add(empty, NULL) == ZVERR_VECTUNDEF);
+		assert(vect_create_typed(0, 10) == NULL);
+		vect_typed_clear(tv);
+		assert(vect_typed_size(tv) == 0);
+		vect_typed_destroy(tv);
+		vect_typed_destroy(empty);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Float values:\n", testGrp, testID);
+	fflush(stdout);
+
+		float fv[50];
+		for (int i = 0; i < 50; i++)
+			fv[i] = (float)(i % 7) - 3.0f;
+		vect_typed_append(other, fv, 50);
+		double fsum;
+		float fmin, fmax;
+		vect_typed_sum(other, &fsum);
+		vect_typed_min(other, &fmin);
+		vect_typed_max(other, &fmax);
+		assert(fsum == -3.0);	// 7 full rounds sum to 0, then -3
+		assert(fmin == -3.0f && fmax == 3.0f);
+		assert(vect_typed_argmin(other) == 0);
+		assert(vect_typed_argmax(other) == 6);
+		vect_typed_destroy(other);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	uint32_t detected = vect_get_cpu_features();
+	srand(24);
+	for (int l = 0; l < MAX_LEVELS; l++) {
+		printf("Test %s_%d: Check the kernels (level %d):\n", testGrp, testID, l);
+		fflush(stdout);
+
+		if (levels[l] & ~detected) {
+			printf("not supported by this CPU, skipped.\n");
+			testID++;
+			continue;
+		}
+		vect_set_cpu_features(levels[l]);
+
+			CHECK_TYPE(ZV_T_I32, int32_t, int64_t)
+			CHECK_TYPE(ZV_T_I64, int64_t, int64_t)
+			CHECK_TYPE(ZV_T_F32, float, double)
+			CHECK_TYPE(ZV_T_F64, double, double)
+
+		printf("done.\n");
+		testID++;
+
+		fflush(stdout);
+	}
+	vect_set_cpu_features(ZV_CPU_ALL);
+
+	printf("Test %s_%d: argmin and argmax of vectors with NaNs stay in range:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int l = 0; l < MAX_LEVELS; l++) {
+			if (levels[l] & ~detected)
+				continue;
+			vect_set_cpu_features(levels[l]);
+			for (int nan_at = 0; nan_at < 40; nan_at += 3) {
+				typed_vector nv = vect_create_typed(ZV_T_F64, 0);
+				double nd[40];
+				for (int i = 0; i < 40; i++)
+					nd[i] = (double)((i * 7) % 13);
+				nd[nan_at] = NAN;
+				vect_typed_append(nv, nd, 40);
+				zvect_index amin = vect_typed_argmin(nv);
+				zvect_index amax = vect_typed_argmax(nv);
+				assert(amin == zvect_index_max || amin < 40);
+				assert(amax == zvect_index_max || amax < 40);
+				vect_typed_clear(nv);
+				for (int i = 0; i < 10; i++)
+					nd[i] = NAN;
+				vect_typed_append(nv, nd, 10);
+				assert(vect_typed_argmin(nv) == zvect_index_max);
+				assert(vect_typed_argmax(nv) == zvect_index_max);
+				vect_typed_destroy(nv);
+			}
+		}
+		vect_set_cpu_features(ZV_CPU_ALL);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
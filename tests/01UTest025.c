@@ -0,0 +1,207 @@
+/*
+ *    Name: UTest025
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000
+
+typedef struct QueueItem {
+	int priority;
+	char name[20];
+	double weight;
+	char padding[8];	// - Not stored by the columnar vector
+} QueueItem;
+
+static const zvect_field fields[] = {
+	{ offsetof(QueueItem, priority), sizeof(int) },
+	{ offsetof(QueueItem, name), sizeof(((QueueItem *)0)->name) },
+	{ offsetof(QueueItem, weight), sizeof(double) }
+};
+
+static QueueItem make_item(int i) {
+	QueueItem item;
+	memset(&item, 0, sizeof(item));
+	item.priority = i % 17;
+	snprintf(item.name, sizeof(item.name), "item %d", i);
+	item.weight = i * 0.25;
+	return item;
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+
+#include <pthread.h>
+
+#define MT_ITEMS 100000
+
+static volatile int writer_done = 0;
+static volatile long bad_records = 0;
+
+// Adds records, so the columns get reallocated while the reader
+// gathers them:
+static void *columnar_writer(void *arg) {
+	columnar_vector cv = (columnar_vector)arg;
+	for (int i = 0; i < MT_ITEMS; i++) {
+		QueueItem item = make_item(i);
+		vect_columnar_add(cv, &item);
+	}
+	writer_done = 1;
+	return NULL;
+}
+
+// Reads the last record while the writer runs, its fields must
+// always belong to the same record:
+static void *columnar_reader(void *arg) {
+	columnar_vector cv = (columnar_vector)arg;
+	QueueItem item;
+	while (!writer_done) {
+		zvect_index n = vect_columnar_size(cv);
+		if (n == 0)
+			continue;
+		if (vect_columnar_get_at(cv, n - 1, &item) != 0) {
+			bad_records++;
+			continue;
+		}
+		QueueItem ref = make_item((int)(n - 1));
+		if ((item.priority != ref.priority) || strcmp(item.name, ref.name) ||
+		    (item.weight != ref.weight))
+			bad_records++;
+	}
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "025";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing columnar vectors\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a columnar vector and add %d records to it:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		columnar_vector cv = vect_create_columnar(sizeof(QueueItem), fields, 3, 4, ZV_NONE);
+		assert(cv != NULL);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			QueueItem item = make_item(i);
+			assert(vect_columnar_add(cv, &item) == 0);
+		}
+		assert(vect_columnar_size(cv) == MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Read the records back and scan the columns:\n", testGrp, testID);
+	fflush(stdout);
+
+		int *priority = (int *)vect_columnar_column(cv, 0);
+		double *weight = (double *)vect_columnar_column(cv, 2);
+		assert(((uintptr_t)priority % 64) == 0 && ((uintptr_t)weight % 64) == 0);
+		zvect_index high = 0;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			QueueItem item, expected = make_item(i);
+			memset(&item, 0, sizeof(item));
+			assert(vect_columnar_get_at(cv, i, &item) == 0);
+			assert(memcmp(&item, &expected, sizeof(item)) == 0);
+			assert(priority[i] == expected.priority);
+			assert(weight[i] == expected.weight);
+			if (priority[i] > 10)
+				high++;
+		}
+		int limit = 10;
+		assert(vect_columnar_count_if(cv, 0, ZV_T_I32, ZV_GT, &limit) == high);
+		assert(vect_columnar_count_if(cv, 0, ZV_T_I64, ZV_GT, &limit) == 0);
+		double wlimit = 100.0;
+		assert(vect_columnar_count_if(cv, 2, ZV_T_F64, ZV_LT, &wlimit) == 400);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Replace and remove records:\n", testGrp, testID);
+	fflush(stdout);
+
+		QueueItem item = make_item(-5);
+		assert(vect_columnar_put_at(cv, 3, &item) == 0);
+		assert(vect_columnar_remove_at(cv, 0) == 0);
+		assert(vect_columnar_size(cv) == MAX_ITEMS - 1);
+		QueueItem got;
+		memset(&got, 0, sizeof(got));
+		vect_columnar_get_at(cv, 2, &got);
+		assert(memcmp(&got, &item, sizeof(got)) == 0);
+		vect_columnar_get_at(cv, MAX_ITEMS - 2, &got);
+		assert(got.weight == (MAX_ITEMS - 1) * 0.25);
+		assert(vect_columnar_get_at(cv, MAX_ITEMS - 1, &got) == ZVERR_IDXOUTOFBOUND);
+		assert(vect_columnar_remove_at(cv, MAX_ITEMS - 1) == ZVERR_IDXOUTOFBOUND);
+		vect_columnar_clear(cv);
+		assert(vect_columnar_size(cv) == 0);
+		vect_columnar_destroy(cv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Invalid field layouts:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_field bad = { sizeof(QueueItem) - 4, 8 };
+		assert(vect_create_columnar(sizeof(QueueItem), &bad, 1, 0, ZV_NONE) == NULL);
+		assert(vect_create_columnar(sizeof(QueueItem), fields, 0, 0, ZV_NONE) == NULL);
+		assert(vect_columnar_add(NULL, &item) == ZVERR_VECTUNDEF);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Add records from one thread while another thread reads them:\n", testGrp, testID);
+	fflush(stdout);
+
+		pthread_t tid[2];
+		cv = vect_create_columnar(sizeof(QueueItem), fields, 3, 0, ZV_NONE);
+		assert(pthread_create(&tid[0], NULL, columnar_reader, cv) == 0);
+		assert(pthread_create(&tid[1], NULL, columnar_writer, cv) == 0);
+		pthread_join(tid[1], NULL);
+		pthread_join(tid[0], NULL);
+		assert(bad_records == 0);
+		assert(vect_columnar_size(cv) == MT_ITEMS);
+		vect_columnar_destroy(cv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ *    Name: UTest026
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_BITS 5000
+
+static bool ref_a[MAX_BITS], ref_b[MAX_BITS];
+
+int main() {
+	// Setup tests:
+	char *testGrp = "026";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing bit vectors\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Push, get, set and pop bits:\n", testGrp, testID);
+	fflush(stdout);
+
+		bit_vector a = vect_create_bits(0, ZV_NONE);
+		bit_vector b = vect_create_bits(10, ZV_NOLOCKING);
+		srand(26);
+		for (int i = 0; i < MAX_BITS; i++) {
+			ref_a[i] = (rand() % 3) == 0;
+			ref_b[i] = (rand() % 2) == 0;
+			assert(vect_bits_push(a, ref_a[i]) == 0);
+			assert(vect_bits_push(b, ref_b[i]) == 0);
+		}
+		assert(vect_bits_size(a) == MAX_BITS);
+		for (int i = 0; i < MAX_BITS; i++)
+			assert(vect_bits_get(a, i) == ref_a[i]);
+		assert(vect_bits_get(a, MAX_BITS) == false);
+		assert(vect_bits_set(a, 100, !ref_a[100]) == 0);
+		ref_a[100] = !ref_a[100];
+		assert(vect_bits_get(a, 100) == ref_a[100]);
+		assert(vect_bits_set(a, MAX_BITS, true) == ZVERR_IDXOUTOFBOUND);
+		vect_bits_push(a, true);
+		assert(vect_bits_pop(a) == true);
+		assert(vect_bits_size(a) == MAX_BITS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Popcount, find, rank and select:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index count = 0;
+		for (int i = 0; i < MAX_BITS; i++) {
+			assert(vect_bits_rank(a, i) == count);
+			if (ref_a[i]) {
+				assert(vect_bits_select(a, count) == (zvect_index)i);
+				count++;
+			}
+		}
+		assert(vect_bits_popcount(a) == count);
+		assert(vect_bits_rank(a, MAX_BITS) == count);
+		assert(vect_bits_select(a, count) == zvect_index_max);
+		zvect_index visited = 0;
+		for (zvect_index i = vect_bits_find_first_set(a, 0); i != zvect_index_max;
+		     i = vect_bits_find_first_set(a, i + 1)) {
+			assert(ref_a[i]);
+			visited++;
+		}
+		assert(visited == count);
+		zvect_index first_clear = 0;
+		while (ref_a[first_clear])
+			first_clear++;
+		assert(vect_bits_find_first_clear(a, 0) == first_clear);
+		assert(vect_bits_find_first_set(a, MAX_BITS) == zvect_index_max);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Bitwise operations:\n", testGrp, testID);
+	fflush(stdout);
+
+		bit_vector c = vect_create_bits(0, ZV_NONE);
+		for (int i = 0; i < MAX_BITS; i++)
+			vect_bits_push(c, ref_a[i]);
+		assert(vect_bits_and(c, b) == 0);
+		for (int i = 0; i < MAX_BITS; i++)
+			assert(vect_bits_get(c, i) == (ref_a[i] && ref_b[i]));
+		assert(vect_bits_or(c, a) == 0);
+		for (int i = 0; i < MAX_BITS; i++)
+			assert(vect_bits_get(c, i) == ref_a[i]);
+		assert(vect_bits_xor(c, b) == 0);
+		for (int i = 0; i < MAX_BITS; i++)
+			assert(vect_bits_get(c, i) == (ref_a[i] != ref_b[i]));
+		assert(vect_bits_andnot(c, c) == 0);
+		assert(vect_bits_popcount(c) == 0);
+		assert(vect_bits_find_first_set(c, 0) == zvect_index_max);
+		vect_bits_pop(c);
+		assert(vect_bits_or(c, a) == ZVERR_OPNOTALLOWED);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Clear the bit vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_bits_clear(a);
+		assert(vect_bits_size(a) == 0);
+		assert(vect_bits_pop(a) == false);
+		vect_bits_push(a, false);
+		assert(vect_bits_popcount(a) == 0);
+		assert(vect_bits_select(a, 0) == zvect_index_max);
+		vect_bits_destroy(a);
+		vect_bits_destroy(b);
+		vect_bits_destroy(c);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
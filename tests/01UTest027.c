@@ -0,0 +1,201 @@
+/*
+ *    Name: UTest027
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 2000
+
+// Item i is the string "item i" repeated (i % 5) times:
+static zvect_index make_item(int i, char *buf) {
+	buf[0] = '\0';
+	for (int r = 0; r < (i % 5); r++)
+		sprintf(buf + strlen(buf), "item %d", i);
+	return (zvect_index)strlen(buf) + 1;
+}
+
+static void check_item(varlen_vector vv, zvect_index idx, int i) {
+	char expected[128];
+	zvect_index len, elen = make_item(i, expected);
+	const char *s = (const char *)vect_get_bytes(vv, idx, &len);
+	assert(s != NULL);
+	assert(len == elen);
+	assert(memcmp(s, expected, len) == 0);
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+
+#include <pthread.h>
+
+#define MT_EDITS 100000
+
+static volatile int writer_done = 0;
+static volatile long bad_items = 0;
+
+// Replaces item 0 with items of different lengths and adds and
+// removes items at the end, so the arena is reallocated and
+// compacted while the reader reads it:
+static void *varlen_writer(void *arg) {
+	varlen_vector vv = (varlen_vector)arg;
+	char buf[128];
+	for (int e = 0; e < MT_EDITS; e++) {
+		zvect_index len = make_item(e, buf);
+		vect_put_bytes(vv, 0, buf, len);
+		vect_add_bytes(vv, buf, len);
+		if (e & 1)
+			vect_varlen_remove_at(vv, vect_varlen_size(vv) - 1);
+	}
+	writer_done = 1;
+	return NULL;
+}
+
+// Reads item 0 (holding the lock while using its bytes), which
+// must always be one of the items written by the writer:
+static void *varlen_reader(void *arg) {
+	varlen_vector vv = (varlen_vector)arg;
+	char expected[128];
+	while (!writer_done) {
+		zvect_index len;
+		vect_varlen_lock(vv);
+		const char *s = (const char *)vect_get_bytes(vv, 0, &len);
+		if ((s == NULL) || (len == 0) || (s[len - 1] != '\0'))
+			bad_items++;
+		else if ((len > 1) && ((strncmp(s, "item ", 5) != 0) ||
+			 (make_item(atoi(s + 5), expected) != len) || strcmp(s, expected)))
+			bad_items++;
+		vect_varlen_unlock(vv);
+	}
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "027";
+	uint8_t testID = 1;
+	char buf[128];
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing variable length items vectors\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d strings (one by one and in bulk):\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		varlen_vector vv = vect_create_varlen(0, 16, ZV_NONE);
+		for (int i = 0; i < MAX_ITEMS / 2; i++) {
+			zvect_index len = make_item(i, buf);
+			assert(vect_add_bytes(vv, buf, len) == 0);
+		}
+		static char bulk[MAX_ITEMS / 2][128];
+		const void *items[MAX_ITEMS / 2];
+		zvect_index lens[MAX_ITEMS / 2];
+		for (int i = 0; i < MAX_ITEMS / 2; i++) {
+			lens[i] = make_item(MAX_ITEMS / 2 + i, bulk[i]);
+			items[i] = bulk[i];
+		}
+		assert(vect_add_bytes_n(vv, items, lens, MAX_ITEMS / 2) == 0);
+		assert(vect_varlen_size(vv) == MAX_ITEMS);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			check_item(vv, i, i);
+		assert(vect_get_bytes(vv, MAX_ITEMS, NULL) == NULL);
+		assert(vect_add_bytes(vv, NULL, 0) == 0);	// - Empty items are allowed
+		zvect_index len = 1;
+		assert(vect_get_bytes(vv, MAX_ITEMS, &len) != NULL && len == 0);
+		assert(vect_varlen_remove_at(vv, MAX_ITEMS) == 0);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Replace items:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_put_bytes(vv, 7, "x", 2) == 0);	// - Smaller, in place
+		assert(vect_varlen_garbage(vv) > 0);
+		memset(buf, 'y', 100);
+		assert(vect_put_bytes(vv, 8, buf, 100) == 0);	// - Larger, at the end
+		const char *s = (const char *)vect_get_bytes(vv, 7, &len);
+		assert(len == 2 && strcmp(s, "x") == 0);
+		s = (const char *)vect_get_bytes(vv, 8, &len);
+		assert(len == 100 && s[0] == 'y' && s[99] == 'y');
+		check_item(vv, 9, 9);
+		assert(vect_put_bytes(vv, MAX_ITEMS, "x", 2) == ZVERR_IDXOUTOFBOUND);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove items and compact the arena:\n", testGrp, testID);
+	fflush(stdout);
+
+		// Remove all the even items (the arena gets compacted on
+		// the way):
+		for (int i = MAX_ITEMS - 2; i >= 10; i -= 2)
+			assert(vect_varlen_remove_at(vv, i) == 0);
+		assert(vect_varlen_size(vv) == (MAX_ITEMS / 2) + 5);
+		for (int i = 11, idx = 10; i < MAX_ITEMS; i += 2, idx++)
+			check_item(vv, idx, i);
+		assert(vect_varlen_compact(vv) == 0);
+		assert(vect_varlen_garbage(vv) == 0);
+		for (int i = 11, idx = 10; i < MAX_ITEMS; i += 2, idx++)
+			check_item(vv, idx, i);
+		check_item(vv, 9, 9);
+		assert(vect_varlen_remove_at(vv, MAX_ITEMS) == ZVERR_IDXOUTOFBOUND);
+		vect_varlen_clear(vv);
+		assert(vect_varlen_size(vv) == 0);
+		assert(vect_add_bytes(vv, "abc", 4) == 0);
+		assert(strcmp((const char *)vect_get_bytes(vv, 0, NULL), "abc") == 0);
+		vect_varlen_destroy(vv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Change items from one thread while another thread reads them:\n", testGrp, testID);
+	fflush(stdout);
+
+		pthread_t tid[2];
+		vv = vect_create_varlen(0, 0, ZV_NONE);
+		assert(vect_add_bytes(vv, "", 1) == 0);
+		assert(pthread_create(&tid[0], NULL, varlen_reader, vv) == 0);
+		assert(pthread_create(&tid[1], NULL, varlen_writer, vv) == 0);
+		pthread_join(tid[1], NULL);
+		pthread_join(tid[0], NULL);
+		assert(bad_items == 0);
+		assert(vect_varlen_size(vv) == 1 + (MT_EDITS / 2));
+		vect_varlen_destroy(vv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ *    Name: UTest028
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 10000
+
+static zvect_handle handles[MAX_ITEMS];
+static bool removed[MAX_ITEMS];
+
+int main() {
+	// Setup tests:
+	char *testGrp = "028";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing slot maps\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Insert %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		slot_map sm = vect_create_slot_map(0, sizeof(int), ZV_NONE);
+		assert(sm != NULL);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			handles[i] = vect_slot_map_insert(sm, &i);
+			assert(handles[i] != 0);
+		}
+		assert(vect_slot_map_size(sm) == MAX_ITEMS);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			assert(*((int *)vect_slot_map_get(sm, handles[i])) == i);
+		assert(vect_slot_map_get(sm, 0) == NULL);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove random items, handles of the others stay valid:\n", testGrp, testID);
+	fflush(stdout);
+
+		srand(28);
+		zvect_index live = MAX_ITEMS;
+		for (int r = 0; r < MAX_ITEMS / 2; r++) {
+			int i = rand() % MAX_ITEMS;
+			if (removed[i]) {
+				assert(vect_slot_map_remove(sm, handles[i]) == ZVERR_IDXOUTOFBOUND);
+				continue;
+			}
+			assert(vect_slot_map_remove(sm, handles[i]) == 0);
+			removed[i] = true;
+			live--;
+		}
+		assert(vect_slot_map_size(sm) == live);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			if (removed[i])
+				assert(!vect_slot_map_contains(sm, handles[i]));
+			else
+				assert(*((int *)vect_slot_map_get(sm, handles[i])) == i);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Reuse the free slots (old handles stay invalid):\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			if (!removed[i])
+				continue;
+			int value = -i;
+			zvect_handle h = vect_slot_map_insert(sm, &value);
+			assert(h != handles[i]);
+			assert(vect_slot_map_get(sm, handles[i]) == NULL || *((int *)vect_slot_map_get(sm, handles[i])) == i);
+			assert(*((int *)vect_slot_map_get(sm, h)) == -i);
+			handles[i] = h;
+		}
+		assert(vect_slot_map_size(sm) == MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Iterate over the items:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector items = vect_slot_map_items(sm);
+		long long sum = 0;
+		for (zvect_index i = 0; i < vect_size(items); i++) {
+			int value = *((int *)vect_get_at(items, i));
+			zvect_handle h = vect_slot_map_handle_at(sm, i);
+			assert(*((int *)vect_slot_map_get(sm, h)) == value);
+			sum += (value < 0) ? -value : value;
+		}
+		assert(sum == ((long long)MAX_ITEMS * (MAX_ITEMS - 1)) / 2);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Clear the slot map:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_slot_map_clear(sm);
+		assert(vect_slot_map_size(sm) == 0);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			assert(!vect_slot_map_contains(sm, handles[i]));
+		int value = 42;
+		zvect_handle h = vect_slot_map_insert(sm, &value);
+		assert(*((int *)vect_slot_map_get(sm, h)) == 42);
+		assert(vect_slot_map_remove(sm, h) == 0);
+		assert(vect_slot_map_size(sm) == 0);
+		vect_slot_map_destroy(sm);
+		assert(vect_create_slot_map(0, sizeof(int), ZV_CIRCULAR) == NULL);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
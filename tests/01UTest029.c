@@ -0,0 +1,356 @@
+/*
+ *    Name: UTest029
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_OPS 20000
+
+// Reference array the gap buffer vector is checked against:
+static int ref[MAX_OPS];
+static zvect_index ref_size = 0;
+
+static void ref_add_at(zvect_index i, int value) {
+	memmove(ref + i + 1, ref + i, (ref_size - i) * sizeof(int));
+	ref[i] = value;
+	ref_size++;
+}
+
+static void ref_delete_at(zvect_index i) {
+	memmove(ref + i, ref + i + 1, (ref_size - i - 1) * sizeof(int));
+	ref_size--;
+}
+
+static void check_all(vector v) {
+	assert(vect_size(v) == ref_size);
+	assert(vect_is_empty(v) == (ref_size == 0));
+	for (zvect_index i = 0; i < ref_size; i++)
+		assert(*((int *)vect_get_at(v, i)) == ref[i]);
+	if (ref_size > 0) {
+		assert(*((int *)vect_get_front(v)) == ref[0]);
+		assert(*((int *)vect_get(v)) == ref[ref_size - 1]);
+	}
+}
+
+static long long sum = 0;
+
+static bool ge_10(const void *item, void *ctx) {
+	(void)ctx;
+	return *((const int *)item) >= 10;
+}
+
+static void sum_item(void *item) {
+	sum += *((int *)item);
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+
+#include <pthread.h>
+
+#define MT_ITEMS 1000
+#define MT_EDITS 100000
+
+static volatile int writer_done = 0;
+static volatile long null_items = 0;
+
+// Adds and deletes items around a cursor, so the vector size
+// doesn't change but the gap moves all the time:
+static void *gap_writer(void *arg) {
+	vector v = (vector)arg;
+	for (int e = 0; e < MT_EDITS; e++) {
+		zvect_index cursor = (zvect_index)((e / 16) % MT_ITEMS);
+		vect_add_at(v, &e, cursor);
+		vect_delete_at(v, cursor + 1);
+	}
+	writer_done = 1;
+	return NULL;
+}
+
+static void check_item(void *item) {
+	if (item == NULL)
+		null_items++;
+}
+
+// Scans the vector while the writer runs, vect_apply must never
+// see the gap:
+static void *gap_reader(void *arg) {
+	vector v = (vector)arg;
+	while (!writer_done)
+		vect_apply(v, check_item);
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "029";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing gap buffer vectors (ZV_GAP_BUFFER vectors)\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add and delete items around a moving cursor:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = vect_create(2, sizeof(int), ZV_GAP_BUFFER);
+		srand(29);
+		zvect_index cursor = 0;
+		for (int op = 0; op < MAX_OPS; op++) {
+			// Mostly local edits, with a jump once in a while:
+			if ((rand() % 50) == 0)
+				cursor = ref_size ? (zvect_index)(rand() % (ref_size + 1)) : 0;
+			if (cursor > ref_size)
+				cursor = ref_size;
+			if ((rand() % 3) || (ref_size == 0)) {
+				vect_add_at(v, &op, cursor);
+				assert(vect_get_last_error(v) == 0);
+				ref_add_at(cursor++, op);
+			} else {
+				if (cursor == ref_size)
+					cursor--;
+				if (op & 1) {
+					int *item = (int *)vect_remove_at(v, cursor);
+					assert(item != NULL && *item == ref[cursor]);
+					free(item);
+				} else {
+					vect_delete_at(v, cursor);
+				}
+				assert(vect_get_last_error(v) == 0);
+				ref_delete_at(cursor);
+			}
+			if ((op % 1000) == 0)
+				check_all(v);
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add items at the front and at the end:\n", testGrp, testID);
+	fflush(stdout);
+
+		int x = -1;
+		vect_add_front(v, &x);
+		ref_add_at(0, x);
+		x = -2;
+		vect_push(v, &x);
+		ref_add_at(ref_size, x);
+		x = -3;
+		vect_add(v, &x);
+		ref_add_at(ref_size, x);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Out of bound edits fail and leave the vector unchanged:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_add_at(v, &x, ref_size + 1);
+		assert(vect_get_last_error(v) != 0);
+		vect_delete_at(v, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		assert(vect_remove_at(v, ref_size + 10) == NULL);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Functions that are not gap aware see a contiguous vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_add_at(v, &x, 7);
+		ref_add_at(7, x);
+		long long ref_sum = 0;
+		for (zvect_index i = 0; i < ref_size; i++)
+			ref_sum += ref[i];
+		vect_apply(v, sum_item);
+		assert(sum == ref_sum);
+		vect_delete_at(v, 3);
+		ref_delete_at(3);
+		x = 1234;
+		vect_put_at(v, &x, 5);
+		ref[5] = x;
+		check_all(v);
+		vect_delete_at(v, 9);
+		ref_delete_at(9);
+		vect_delete_range(v, 10, 19);
+		memmove(ref + 10, ref + 20, (ref_size - 20) * sizeof(int));
+		ref_size -= 10;
+		check_all(v);
+		vect_delete_at(v, 2);
+		ref_delete_at(2);
+		int *item = (int *)vect_pop(v);
+		assert(*item == ref[--ref_size]);
+		free(item);
+		check_all(v);
+		vect_add_at(v, &x, ref_size / 2);
+		ref_add_at(ref_size / 2, x);
+		vect_compact(v);
+		assert(vect_get_last_error(v) == 0);
+		check_all(v);
+		vect_compact(v);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Views become stale when the gap opens:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_view vw = vect_view_make(v, 10, 20);
+		assert(vw != NULL && vect_view_is_valid(vw));
+		assert(*((int *)vect_view_get_at(vw, 0)) == ref[10]);
+		vect_add_at(v, &x, 50);
+		ref_add_at(50, x);
+		assert(!vect_view_is_valid(vw));
+		vect_view_destroy(vw);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	printf("Test %s_%d: Delete every item (the gap gets closed on the way):\n", testGrp, testID);
+	fflush(stdout);
+
+		while (ref_size > 0) {
+			zvect_index i = ref_size / 2;
+			vect_delete_at(v, i);
+			assert(vect_get_last_error(v) == 0);
+			ref_delete_at(i);
+			if ((ref_size % 211) == 0)
+				check_all(v);
+		}
+		check_all(v);
+		vect_delete_at(v, 0);
+		assert(vect_get_last_error(v) != 0);
+		for (int i = 0; i < 100; i++) {
+			vect_add_at(v, &i, (zvect_index)(i / 2));
+			ref_add_at((zvect_index)(i / 2), i);
+		}
+		check_all(v);
+		vect_clear(v);
+		ref_size = 0;
+		check_all(v);
+		x = 42;
+		vect_add_at(v, &x, 0);
+		ref_add_at(0, x);
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Gap buffer on a ZV_BYREF vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		static int items[MAX_OPS];
+		v = vect_create(0, sizeof(int), ZV_GAP_BUFFER | ZV_BYREF);
+		ref_size = 0;
+		for (int i = 0; i < 1000; i++) {
+			items[i] = i;
+			vect_add_at(v, &items[i], (zvect_index)(i / 3));
+			ref_add_at((zvect_index)(i / 3), i);
+		}
+		assert(vect_remove_at(v, 500) == &items[ref[500]]);
+		ref_delete_at(500);
+		assert(vect_remove_at(v, 10) == &items[ref[10]]);
+		ref_delete_at(10);
+		vect_delete_at(v, 900);
+		ref_delete_at(900);
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Fill the gap, then shrink the vector with a function that is not gap aware:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int n = 68; n <= 260; n = (n - 4) * 2 + 4) {
+			v = vect_create(0, sizeof(int), ZV_GAP_BUFFER);
+			ref_size = 0;
+			for (int i = 0; i < n; i++) {
+				vect_add_at(v, &i, (zvect_index)i);
+				ref_add_at((zvect_index)i, i);
+			}
+			assert(vect_remove_if(v, ge_10, NULL) == (zvect_index)(n - 10));
+			ref_size = 10;
+			check_all(v);
+			int *removed = (int *)vect_remove_at(v, 1);
+			assert(removed != NULL && *removed == ref[1]);
+			free(removed);
+			ref_delete_at(1);
+			vect_add_at(v, &n, 3);
+			ref_add_at(3, n);
+			check_all(v);
+			vect_destroy(v);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Edits from one thread while another thread scans the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		pthread_t tid[2];
+		v = vect_create(0, sizeof(int), ZV_GAP_BUFFER);
+		for (int i = 0; i < MT_ITEMS; i++)
+			vect_add(v, &i);
+		assert(pthread_create(&tid[0], NULL, gap_reader, v) == 0);
+		assert(pthread_create(&tid[1], NULL, gap_writer, v) == 0);
+		pthread_join(tid[1], NULL);
+		pthread_join(tid[0], NULL);
+		assert(null_items == 0);
+		assert(vect_size(v) == MT_ITEMS);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,401 @@
+/*
+ *    Name: UTest030
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 100000
+#define MAX_OPS 20000
+
+// Large items, so adding them by value costs more than moving
+// their pointers:
+typedef struct record {
+	int value;
+	char payload[252];
+} record;
+
+// Reference array the tree vector is checked against:
+static int ref[MAX_ITEMS + MAX_OPS];
+static zvect_index ref_size = 0;
+static zvect_index checked = 0;
+
+static void ref_add_at(zvect_index i, int value) {
+	memmove(ref + i + 1, ref + i, (ref_size - i) * sizeof(int));
+	ref[i] = value;
+	ref_size++;
+}
+
+static void ref_delete_range(zvect_index first, zvect_index last) {
+	memmove(ref + first, ref + last + 1, (ref_size - last - 1) * sizeof(int));
+	ref_size -= last - first + 1;
+}
+
+static void check_item(void *item) {
+	assert(((record *)item)->value == ref[checked++]);
+}
+
+// vect_lsearch matches the items for which this returns non zero,
+// vect_bsearch needs the usual ordering:
+static int same_value(const void *a, const void *b) {
+	return ((const record *)a)->value == ((const record *)b)->value;
+}
+
+static int compare_value(const void *a, const void *b) {
+	int x = ((const record *)a)->value;
+	int y = ((const record *)b)->value;
+	return (x > y) - (x < y);
+}
+
+// Checks v against ref only through tree aware functions, so the
+// tree is not flattened:
+static void check_all(vector v) {
+	assert(vect_size(v) == ref_size);
+	assert(vect_is_empty(v) == (ref_size == 0));
+	for (zvect_index i = 0; i < ref_size; i += 7)
+		assert(((record *)vect_get_at(v, i))->value == ref[i]);
+	if (ref_size > 0) {
+		assert(((record *)vect_get_front(v))->value == ref[0]);
+		assert(((record *)vect_get(v))->value == ref[ref_size - 1]);
+	}
+	checked = 0;
+	vect_apply(v, check_item);
+	assert(checked == ref_size);
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+
+#include <pthread.h>
+
+#define MT_EDITS 100000
+
+static volatile int writer_done = 0;
+static volatile long null_items = 0;
+
+// Adds and deletes items at random positions, so the vector size
+// doesn't change but the tree does all the time:
+static void *tree_writer(void *arg) {
+	vector v = (vector)arg;
+	record r;
+	memset(&r, 0, sizeof(r));
+	for (int e = 0; e < MT_EDITS; e++) {
+		zvect_index pos = (zvect_index)((e * 7919) % MAX_ITEMS);
+		r.value = e;
+		vect_add_at(v, &r, pos);
+		vect_delete_at(v, pos + 1);
+	}
+	writer_done = 1;
+	return NULL;
+}
+
+static void check_null(void *item) {
+	if (item == NULL)
+		null_items++;
+}
+
+// Scans the vector while the writer runs, flattening the tree once
+// in a while, vect_apply must never see a missing item:
+static void *tree_reader(void *arg) {
+	vector v = (vector)arg;
+	for (int n = 0; !writer_done; n++) {
+		vect_apply(v, check_null);
+		if (n & 1)
+			vect_compact(v);
+	}
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "030";
+	uint8_t testID = 1;
+	record r;
+	memset(&r, 0, sizeof(r));
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing tree storage (ZV_TREE vectors)\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d items (at the end and in the middle):\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(0, sizeof(record), ZV_TREE);
+		assert(v != NULL);
+		for (int i = 0; i < MAX_ITEMS / 2; i++) {
+			r.value = i;
+			vect_add(v, &r);
+			assert(vect_get_last_error(v) == 0);
+			ref[ref_size++] = i;
+		}
+		srand(30);
+		for (int i = MAX_ITEMS / 2; i < MAX_ITEMS; i++) {
+			zvect_index pos = (zvect_index)(rand() % (ref_size + 1));
+			r.value = i;
+			if (pos == 0)
+				vect_add_front(v, &r);
+			else
+				vect_add_at(v, &r, pos);
+			assert(vect_get_last_error(v) == 0);
+			ref_add_at(pos, i);
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Random adds, deletes, removes and range deletes:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int op = 0; op < MAX_OPS; op++) {
+			int kind = rand() % 10;
+			zvect_index pos = (zvect_index)(rand() % ref_size);
+			if (kind < 5) {
+				r.value = -op;
+				vect_add_at(v, &r, pos);
+				ref_add_at(pos, -op);
+			} else if (kind < 7) {
+				vect_delete_at(v, pos);
+				ref_delete_range(pos, pos);
+			} else if (kind < 9) {
+				record *item = (record *)vect_remove_at(v, pos);
+				assert(item != NULL && item->value == ref[pos]);
+				free(item);
+				ref_delete_range(pos, pos);
+			} else {
+				zvect_index last = pos + (zvect_index)(rand() % 20);
+				if (last >= ref_size)
+					last = ref_size - 1;
+				vect_delete_range(v, pos, last);
+				ref_delete_range(pos, last);
+			}
+			assert(vect_get_last_error(v) == 0);
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Replace items and apply a function to a range:\n", testGrp, testID);
+	fflush(stdout);
+
+		r.value = 12345;
+		vect_put_at(v, &r, 777);
+		assert(vect_get_last_error(v) == 0);
+		ref[777] = 12345;
+		checked = 500;
+		vect_apply_range(v, check_item, 500, 20499);
+		assert(checked == 20500);
+		checked = 100;
+		vect_apply_range(v, check_item, 199, 100);
+		assert(checked == 200);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Search the items of the tree:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int k = 0; k < 50; k++) {
+			zvect_index pos = (zvect_index)(rand() % ref_size);
+			zvect_index first = 0;
+			while (ref[first] != ref[pos])
+				first++;
+			zvect_index idx;
+			r.value = ref[pos];
+			assert(vect_lsearch(v, &r, same_value, &idx) && idx == first);
+		}
+		r.value = MAX_ITEMS * 10;
+		zvect_index idx;
+		assert(!vect_lsearch(v, &r, same_value, &idx));
+		check_all(v);
+
+		vector sv = vect_create(0, sizeof(record), ZV_TREE);
+		for (int i = 0; i < MAX_ITEMS / 4; i++) {
+			r.value = 2 * i;
+			vect_add(sv, &r);
+		}
+		for (int i = 0; i < 1000; i++)
+			vect_delete_at(sv, (zvect_index)(MAX_ITEMS / 8));
+		for (int i = 0; i < MAX_ITEMS / 4; i += 7) {
+			r.value = 2 * i;
+			bool found = vect_bsearch(sv, &r, compare_value, &idx);
+			if ((i >= MAX_ITEMS / 8) && (i < (MAX_ITEMS / 8) + 1000)) {
+				assert(!found);
+			} else {
+				assert(found);
+				assert(idx == (zvect_index)((i < MAX_ITEMS / 8) ? i : i - 1000));
+			}
+			r.value = 2 * i + 1;
+			assert(!vect_bsearch(sv, &r, compare_value, &idx));
+		}
+		vect_destroy(sv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Out of bound edits fail and leave the vector unchanged:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_put_at(v, &r, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		vect_add_at(v, &r, ref_size + 1);
+		assert(vect_get_last_error(v) != 0);
+		vect_delete_at(v, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		vect_delete_range(v, 10, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		assert(vect_remove_at(v, ref_size + 10) == NULL);
+		vect_apply_range(v, check_item, 0, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Functions that are not tree aware see a contiguous vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		record *item = (record *)vect_pop(v);
+		assert(item->value == ref[--ref_size]);
+		free(item);
+		check_all(v);
+		r.value = -1;
+		vect_add_at(v, &r, 1000);
+		ref_add_at(1000, -1);
+		vect_compact(v);
+		assert(vect_get_last_error(v) == 0);
+		check_all(v);
+		vect_compact(v);
+		check_all(v);
+		item = (record *)vect_remove_front(v);
+		assert(item->value == ref[0]);
+		free(item);
+		ref_delete_range(0, 0);
+		vect_delete_at(v, 5);
+		ref_delete_range(5, 5);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete large ranges and clear the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_delete_range(v, 1000, ref_size - 1000);
+		assert(vect_get_last_error(v) == 0);
+		ref_delete_range(1000, ref_size - 1000);
+		check_all(v);
+		while (ref_size > 0) {
+			vect_delete_at(v, ref_size / 2);
+			ref_delete_range(ref_size / 2, ref_size / 2);
+		}
+		check_all(v);
+		vect_delete_at(v, 0);
+		assert(vect_get_last_error(v) != 0);
+		for (int i = 0; i < MAX_ITEMS / 4; i++) {
+			r.value = i;
+			vect_add_at(v, &r, (zvect_index)(i / 2));
+			ref_add_at((zvect_index)(i / 2), i);
+		}
+		check_all(v);
+		vect_clear(v);
+		ref_size = 0;
+		check_all(v);
+		r.value = 1;
+		vect_add(v, &r);
+		ref[ref_size++] = 1;
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Tree storage on a ZV_BYREF vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		static record items[MAX_ITEMS / 4];
+		v = vect_create(0, sizeof(record), ZV_TREE | ZV_BYREF);
+		ref_size = 0;
+		for (int i = 0; i < MAX_ITEMS / 4; i++) {
+			items[i].value = i;
+			vect_add_at(v, &items[i], (zvect_index)(i / 3));
+			ref_add_at((zvect_index)(i / 3), i);
+		}
+		assert(vect_remove_at(v, 500) == &items[ref[500]]);
+		ref_delete_range(500, 500);
+		assert(vect_remove_at(v, 10) == &items[ref[10]]);
+		ref_delete_range(10, 10);
+		vect_put_at(v, &items[0], 900);
+		ref[900] = 0;
+		vect_delete_range(v, 100, 199);
+		ref_delete_range(100, 199);
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Edits from one thread while another thread reads the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		pthread_t tid[2];
+		v = vect_create(0, sizeof(record), ZV_TREE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			r.value = i;
+			vect_add(v, &r);
+		}
+		assert(pthread_create(&tid[0], NULL, tree_reader, v) == 0);
+		assert(pthread_create(&tid[1], NULL, tree_writer, v) == 0);
+		pthread_join(tid[1], NULL);
+		pthread_join(tid[0], NULL);
+		assert(null_items == 0);
+		assert(vect_size(v) == MAX_ITEMS);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,304 @@
+/*
+ *    Name: UTest031
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 10000
+
+// Reference array the lazy delete vector is checked against:
+static int ref[MAX_ITEMS];
+static zvect_index ref_size = 0;
+
+static void ref_delete_at(zvect_index i) {
+	memmove(ref + i, ref + i + 1, (ref_size - i - 1) * sizeof(int));
+	ref_size--;
+}
+
+static void check_all(vector v) {
+	assert(vect_size(v) == ref_size);
+	assert(vect_is_empty(v) == (ref_size == 0));
+	for (zvect_index i = 0; i < ref_size; i++)
+		assert(*((int *)vect_get_at(v, i)) == ref[i]);
+	if (ref_size > 0) {
+		assert(*((int *)vect_get_front(v)) == ref[0]);
+		assert(*((int *)vect_get(v)) == ref[ref_size - 1]);
+	}
+}
+
+static long long sum = 0;
+
+static void sum_item(void *item) {
+	sum += *((int *)item);
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+
+#include <pthread.h>
+
+#define MT_ITEMS 1000
+#define MT_EDITS 100000
+
+static volatile int writer_done = 0;
+static volatile long null_items = 0;
+
+// Deletes lazily and adds an item back (the add settles the
+// tombstones), so the vector size doesn't change:
+static void *lazy_writer(void *arg) {
+	vector v = (vector)arg;
+	for (int e = 0; e < MT_EDITS; e++) {
+		vect_delete_at(v, (zvect_index)(e % (MT_ITEMS - 1)));
+		vect_add(v, &e);
+	}
+	writer_done = 1;
+	return NULL;
+}
+
+static void check_item(void *item) {
+	if (item == NULL)
+		null_items++;
+}
+
+// Scans the vector while the writer runs, vect_apply must never
+// see a tombstone:
+static void *lazy_reader(void *arg) {
+	vector v = (vector)arg;
+	while (!writer_done)
+		vect_apply(v, check_item);
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "031";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing lazy deletes (ZV_LAZY_DELETE vectors)\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a ZV_LAZY_DELETE vector of %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(0, sizeof(int), ZV_LAZY_DELETE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			vect_add(v, &i);
+			ref[ref_size++] = i;
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete and remove scattered items (and read them back):\n", testGrp, testID);
+	fflush(stdout);
+
+		srand(31);
+		for (int e = 0; e < 2000; e++) {
+			zvect_index i = (zvect_index)(rand() % ref_size);
+			if (e & 1) {
+				int *item = (int *)vect_remove_at(v, i);
+				assert(item != NULL && *item == ref[i]);
+				free(item);
+			} else {
+				vect_delete_at(v, i);
+			}
+			assert(vect_get_last_error(v) == 0);
+			ref_delete_at(i);
+			if ((e % 97) == 0)
+				check_all(v);
+		}
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Out of bound deletes fail and leave the vector unchanged:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_delete_at(v, ref_size);
+		assert(vect_get_last_error(v) != 0);
+		assert(vect_remove_at(v, ref_size + 10) == NULL);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Compact the vector explicitly:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_delete_at(v, 0);
+		ref_delete_at(0);
+		vect_delete_at(v, ref_size / 2);
+		ref_delete_at(ref_size / 2);
+		vect_compact(v);
+		assert(vect_get_last_error(v) == 0);
+		check_all(v);
+		vect_compact(v);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Functions that are not tombstones aware see a compacted vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		vect_delete_at(v, 3);
+		ref_delete_at(3);
+		vect_delete_at(v, 5);
+		ref_delete_at(5);
+		int x = -1;
+		vect_add_at(v, &x, 4);
+		memmove(ref + 5, ref + 4, (ref_size - 4) * sizeof(int));
+		ref[4] = x;
+		ref_size++;
+		check_all(v);
+		vect_delete_at(v, 7);
+		ref_delete_at(7);
+		vect_push(v, &x);
+		ref[ref_size++] = x;
+		check_all(v);
+		long long ref_sum = 0;
+		for (zvect_index i = 0; i < ref_size; i++)
+			ref_sum += ref[i];
+		vect_delete_at(v, 1);
+		ref_sum -= ref[1];
+		ref_delete_at(1);
+		vect_apply(v, sum_item);
+		assert(sum == ref_sum);
+		check_all(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete every item (the vector gets compacted on the way):\n", testGrp, testID);
+	fflush(stdout);
+
+		while (ref_size > 0) {
+			zvect_index i = (zvect_index)(rand() % ref_size);
+			vect_delete_at(v, i);
+			assert(vect_get_last_error(v) == 0);
+			ref_delete_at(i);
+			if ((ref_size % 211) == 0)
+				check_all(v);
+		}
+		check_all(v);
+		vect_delete_at(v, 0);
+		assert(vect_get_last_error(v) != 0);
+		x = 42;
+		vect_push(v, &x);
+		ref[ref_size++] = x;
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Lazy deletes on a ZV_BYREF vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		static int items[MAX_ITEMS];
+		v = vect_create(0, sizeof(int), ZV_LAZY_DELETE | ZV_BYREF);
+		ref_size = 0;
+		for (int i = 0; i < 1000; i++) {
+			items[i] = i;
+			vect_add(v, &items[i]);
+			ref[ref_size++] = i;
+		}
+		assert(vect_remove_at(v, 500) == &items[500]);
+		ref_delete_at(500);
+		assert(vect_remove_at(v, 10) == &items[10]);
+		ref_delete_at(10);
+		vect_delete_at(v, 900);
+		ref_delete_at(900);
+		check_all(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Small vectors and vectors without ZV_LAZY_DELETE:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (uint32_t props = 0; props <= ZV_LAZY_DELETE; props += ZV_LAZY_DELETE) {
+			v = vect_create(0, sizeof(int), props);
+			ref_size = 0;
+			for (int i = 0; i < 200; i++) {
+				vect_add(v, &i);
+				ref[ref_size++] = i;
+			}
+			while (ref_size > 0) {
+				vect_delete_at(v, ref_size / 3);
+				ref_delete_at(ref_size / 3);
+				check_all(v);
+			}
+			vect_compact(v);
+			check_all(v);
+			vect_destroy(v);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Lazy deletes from one thread while another thread scans the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		pthread_t tid[2];
+		v = vect_create(0, sizeof(int), ZV_LAZY_DELETE);
+		for (int i = 0; i < MT_ITEMS; i++)
+			vect_add(v, &i);
+		assert(pthread_create(&tid[0], NULL, lazy_reader, v) == 0);
+		assert(pthread_create(&tid[1], NULL, lazy_writer, v) == 0);
+		pthread_join(tid[1], NULL);
+		pthread_join(tid[0], NULL);
+		assert(null_items == 0);
+		assert(vect_size(v) == MT_ITEMS);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *    Name: UTest032
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 5000
+
+static int ref[MAX_ITEMS];
+static int tmp[MAX_ITEMS];
+
+// Rotates ref left of k positions:
+static void ref_rotate_left(zvect_index n, zvect_index k) {
+	k %= n;
+	memcpy(tmp, ref + k, (n - k) * sizeof(int));
+	memcpy(tmp + (n - k), ref, k * sizeof(int));
+	memcpy(ref, tmp, n * sizeof(int));
+}
+
+static void check_all(vector v, zvect_index n) {
+	assert(vect_size(v) == n);
+	for (zvect_index i = 0; i < n; i++)
+		assert(*((int *)vect_get_at(v, i)) == ref[i]);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "032";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing in place rotations and range swaps\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Rotate a vector that doesn't start at the beginning of its storage:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = vect_create(0, sizeof(int), ZV_NONE);
+		for (int i = -2; i < 10; i++)
+			vect_add(v, &i);
+		vect_delete_front(v);
+		vect_delete_front(v);
+		for (int i = 0; i < 10; i++)
+			ref[i] = i;
+		vect_rotate_left(v, 1);
+		ref_rotate_left(10, 1);
+		check_all(v, 10);
+		vect_rotate_right(v, 1);
+		ref_rotate_left(10, 9);
+		check_all(v, 10);
+		vect_rotate_left(v, 13);
+		ref_rotate_left(10, 13);
+		check_all(v, 10);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Rotate vectors of different sizes of every shift:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index sizes[] = { 1, 2, 7, 128, 129, 300, 1000, MAX_ITEMS };
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			zvect_index n = sizes[s];
+			v = vect_create(0, sizeof(int), ZV_NONE);
+			for (int i = 0; i < (int)n; i++) {
+				vect_add(v, &i);
+				ref[i] = i;
+			}
+			zvect_index step = (n > 300) ? 37 : 1;
+			for (zvect_index k = 0; k <= n; k += step) {
+				vect_rotate_left(v, k);
+				ref_rotate_left(n, k);
+				check_all(v, n);
+				vect_rotate_right(v, k + 1);
+				ref_rotate_left(n, n - ((k + 1) % n));
+				check_all(v, n);
+			}
+			vect_destroy(v);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Rotate an empty vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(0, sizeof(int), ZV_NONE);
+		vect_rotate_left(v, 3);
+		vect_rotate_right(v, 3);
+		assert(vect_get_last_error(v) == 0);
+		assert(vect_size(v) == 0);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Swap ranges of items:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(0, sizeof(int), ZV_NONE);
+		for (int i = 0; i < 1000; i++) {
+			vect_add(v, &i);
+			ref[i] = i;
+		}
+		vect_swap_range(v, 10, 20, 30);
+		for (int i = 0; i <= 10; i++) {
+			ref[10 + i] = 30 + i;
+			ref[30 + i] = 10 + i;
+		}
+		check_all(v, 1000);
+		vect_swap_range(v, 0, 399, 500);
+		for (int i = 0; i < 400; i++) {
+			int t = ref[i];
+			ref[i] = ref[500 + i];
+			ref[500 + i] = t;
+		}
+		check_all(v, 1000);
+
+		// Overlapping and out of bound ranges are rejected:
+		vect_swap_range(v, 10, 20, 20);
+		assert(vect_get_last_error(v) != 0);
+		vect_swap_range(v, 10, 20, 990);
+		assert(vect_get_last_error(v) != 0);
+		check_all(v, 1000);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ *    Name: UTest033
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000
+
+static int compare_int(const void *a, const void *b) {
+	return (*((const int *)a) > *((const int *)b)) - (*((const int *)a) < *((const int *)b));
+}
+
+static void sum_item(void *item, void *ctx) {
+	*((long long *)ctx) += *((int *)item);
+}
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 ) && defined(ZVECT_DMF_EXTENSIONS)
+
+#include <pthread.h>
+
+static volatile int writer_done = 0;
+
+// Grows the vector, so its storage gets reallocated (and the
+// views over it become stale):
+static void *view_writer(void *arg) {
+	vector v = (vector)arg;
+	for (int i = 0; i < 200000; i++)
+		vect_add(v, &i);
+	writer_done = 1;
+	return NULL;
+}
+
+#endif // ZVECT_THREAD_SAFE
+
+int main() {
+	// Setup tests:
+	char *testGrp = "033";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vector views\n");
+
+	fflush(stdout);
+
+#ifdef ZVECT_DMF_EXTENSIONS
+	printf("Test %s_%d: Make a view and read its items:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NONE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			int x = MAX_ITEMS - i;
+			vect_add(v, &x);
+		}
+		vect_view w = vect_view_make(v, 100, 200);
+		assert(w != NULL);
+		assert(vect_view_is_valid(w));
+		assert(vect_view_size(w) == 200);
+		for (zvect_index i = 0; i < 200; i++)
+			assert(*((int *)vect_view_get_at(w, i)) == (int)(MAX_ITEMS - 100 - i));
+		assert(vect_view_get_at(w, 200) == NULL);
+
+		// The view reads the vector storage, it doesn't copy it:
+		assert(vect_view_get_at(w, 0) == vect_get_at(v, 100));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Apply a function to the items of a view:\n", testGrp, testID);
+	fflush(stdout);
+
+		long long sum = 0, ref_sum = 0;
+		for (int i = 0; i < 200; i++)
+			ref_sum += MAX_ITEMS - 100 - i;
+		assert(vect_view_apply(w, sum_item, &sum) == 0);
+		assert(sum == ref_sum);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort and search only the items of a view:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index idx = 0;
+		int key = MAX_ITEMS - 150;
+		assert(vect_view_lsearch(w, &key, compare_int, &idx));
+		assert(idx == 50);
+		assert(vect_view_qsort(w, compare_int) == 0);
+		for (zvect_index i = 0; i < 200; i++)
+			assert(*((int *)vect_view_get_at(w, i)) == (int)(MAX_ITEMS - 299 + i));
+		// The items outside of the view are left where they were:
+		assert(*((int *)vect_get_at(v, 99)) == MAX_ITEMS - 99);
+		assert(*((int *)vect_get_at(v, 300)) == MAX_ITEMS - 300);
+		assert(vect_view_bsearch(w, &key, compare_int, &idx));
+		assert(*((int *)vect_view_get_at(w, idx)) == key);
+		key = MAX_ITEMS - 10;
+		assert(!vect_view_bsearch(w, &key, compare_int, &idx));
+		assert(!vect_view_lsearch(w, &key, compare_int, &idx));
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Views survive changes that don't move the storage:\n", testGrp, testID);
+	fflush(stdout);
+
+		int *first = (int *)vect_view_get_at(w, 0);
+		vect_delete_front(v);
+		vect_put_at(v, &key, 0);
+		assert(vect_view_is_valid(w));
+		assert(vect_view_get_at(w, 0) == first);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Views become stale when the vector is reallocated:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int i = 0; i < 4 * MAX_ITEMS; i++)
+			vect_add(v, &i);
+		assert(!vect_view_is_valid(w));
+		assert(vect_view_get_at(w, 0) == NULL);
+		assert(vect_view_apply(w, sum_item, &sum) == ZVERR_VIEWSTALE);
+		assert(vect_view_qsort(w, compare_int) == ZVERR_VIEWSTALE);
+		assert(!vect_view_lsearch(w, &key, compare_int, &idx));
+		vect_view_destroy(w);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Views become stale when their items are deleted:\n", testGrp, testID);
+	fflush(stdout);
+
+		w = vect_view_make(v, vect_size(v) - 10, 10);
+		assert(vect_view_is_valid(w));
+		vect_delete_range(v, 0, vect_size(v) - 5);
+		assert(!vect_view_is_valid(w));
+		vect_view_destroy(w);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Invalid views are rejected:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_view_make(v, 0, vect_size(v) + 1) == NULL);
+		assert(vect_view_make(v, vect_size(v), 1) == NULL);
+		w = vect_view_make(v, vect_size(v), 0);
+		assert(w != NULL && vect_view_size(w) == 0);
+		assert(vect_view_apply(w, sum_item, &sum) == 0);
+		vect_view_destroy(w);
+		vect_destroy(v);
+
+		v = vect_create(MAX_ITEMS, sizeof(int), ZV_LAZY_DELETE);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+		w = vect_view_make(v, 0, 100);
+		vect_delete_at(v, 500);
+		assert(!vect_view_is_valid(w));
+		vect_view_destroy(w);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+#if ( ZVECT_THREAD_SAFE == 1 ) && ( OS_TYPE == 1 )
+	printf("Test %s_%d: Use a view while another thread reallocates the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = vect_create(0, sizeof(int), ZV_NONE);
+		for (int i = 0; i < 100; i++)
+			vect_add(v, &i);
+		w = vect_view_make(v, 0, 100);
+		pthread_t tid;
+		assert(pthread_create(&tid, NULL, view_writer, v) == 0);
+		zvect_retval vrval = 0;
+		while (!writer_done && (vrval == 0)) {
+			long long vsum = 0;
+			vrval = vect_view_apply(w, sum_item, &vsum);
+			assert((vrval == ZVERR_VIEWSTALE) || (vsum == 4950));
+		}
+		pthread_join(tid, NULL);
+		assert(vect_view_apply(w, sum_item, &sum) == ZVERR_VIEWSTALE);
+		vect_view_destroy(w);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+#endif // ZVECT_THREAD_SAFE
+#endif  // ZVECT_DMF_EXTENSIONS
+
+	printf("================\n\n");
+
+	return 0;
+}
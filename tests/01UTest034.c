@@ -0,0 +1,132 @@
+/*
+ *    Name: UTest034
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 200000
+
+static int ref[MAX_ITEMS];
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+// Loads the first n values of ref in a new vector, sorts both
+// and checks they match:
+static void check_sort(int n) {
+	vector v = vect_create(n + 1, sizeof(int), ZV_NONE);
+	for (int i = 0; i < n; i++)
+		vect_add(v, &ref[i]);
+
+	vect_qsort(v, compare_int);
+	qsort(ref, n, sizeof(int), compare_int);
+
+	assert(vect_size(v) == (zvect_index)n);
+	for (int i = 0; i < n; i++)
+		assert(*((int *)vect_get_at(v, i)) == ref[i]);
+	vect_destroy(v);
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "034";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing vect_qsort on ordered and degenerate inputs\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort tiny vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int n = 0; n <= 8; n++) {
+			for (int i = 0; i < n; i++)
+				ref[i] = (i * 5) % 3;
+			check_sort(n);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort random items:\n", testGrp, testID);
+	fflush(stdout);
+
+		srand(34);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = rand();
+		check_sort(MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort ordered and reverse ordered items:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = i;
+		check_sort(MAX_ITEMS);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = MAX_ITEMS - i;
+		check_sort(MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort concatenated ordered runs:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = i % (MAX_ITEMS / 8);
+		check_sort(MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort items that are all (or mostly) equal:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = 7;
+		check_sort(MAX_ITEMS);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			ref[i] = rand() % 3;
+		check_sort(MAX_ITEMS);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ *    Name: UTest035
+ * Purpose: Unit Testing ZVector Library
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 5000
+
+// Reference array the vector is checked against:
+static int ref[MAX_ITEMS];
+static zvect_index ref_first = 0;
+static zvect_index ref_last = 0;
+
+static void check_all(vector v) {
+	assert(vect_size(v) == (ref_last - ref_first));
+	for (zvect_index i = ref_first; i < ref_last; i++)
+		assert(*((int *)vect_get_at(v, i - ref_first)) == ref[i]);
+}
+
+static vector make_vector(int n) {
+	vector v = vect_create(0, sizeof(int), ZV_NONE);
+	for (int i = 0; i < n; i++) {
+		vect_add(v, &i);
+		ref[i] = i;
+	}
+	ref_first = 0;
+	ref_last = (zvect_index)n;
+	return v;
+}
+
+int main() {
+	// Setup tests:
+	char *testGrp = "035";
+	uint8_t testID = 1;
+
+	printf("=== UTest%s ===\n", testGrp);
+	printf("Testing deletes at both ends of a vector (and the capacity shrinks they cause)\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete a range at the front, then pop the items at the end:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = make_vector(64);
+		vect_delete_range(v, 0, 39);
+		assert(vect_get_last_error(v) == 0);
+		ref_first = 40;
+		check_all(v);
+		while (ref_last > ref_first) {
+			int *item = (int *)vect_pop(v);
+			assert(item != NULL && *item == ref[--ref_last]);
+			free(item);
+			check_all(v);
+		}
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete items at the front, then delete the items at the end:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int n = 16; n <= MAX_ITEMS; n *= 5) {
+			v = make_vector(n);
+			while ((ref_last - ref_first) > (zvect_index)(n / 4)) {
+				vect_delete_at(v, 0);
+				assert(vect_get_last_error(v) == 0);
+				ref_first++;
+			}
+			check_all(v);
+			while (ref_last > ref_first) {
+				vect_delete(v);
+				assert(vect_get_last_error(v) == 0);
+				ref_last--;
+				check_all(v);
+			}
+			vect_destroy(v);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Delete items at both ends in turns:\n", testGrp, testID);
+	fflush(stdout);
+
+		v = make_vector(MAX_ITEMS);
+		srand(35);
+		while (ref_last > ref_first) {
+			zvect_index k = (zvect_index)(rand() % 8);
+			if (k >= (ref_last - ref_first))
+				k = ref_last - ref_first - 1;
+			if (rand() & 1) {
+				vect_delete_range(v, 0, k);
+				ref_first += k + 1;
+			} else {
+				vect_delete_at(v, ref_last - ref_first - 1);
+				ref_last--;
+			}
+			assert(vect_get_last_error(v) == 0);
+			check_all(v);
+		}
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ *    Name: PTest006
+ * Purpose: Performance Testing ZVector bulk kernels on every
+ *          instruction set supported by the CPU
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 200000
+#define FILL_ROUNDS 200
+#define FIND_ROUNDS 20
+#define TYPED_ROUNDS 200
+
+// Setup tests:
+char *testGrp = "006";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+#define MAX_LEVELS 4
+#define MAX_KERNELS 6
+
+static const uint32_t levels[MAX_LEVELS] = {
+	ZV_CPU_NONE,
+	ZV_CPU_SSE2,
+	ZV_CPU_SSE2 | ZV_CPU_AVX2,
+	ZV_CPU_ALL
+};
+static const char *level_names[MAX_LEVELS] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+// Pointer moves and secure wipes use the C library memmove and
+// memset at every level, so they are not measured here:
+static const char *kernel_names[MAX_KERNELS] = {
+	"pointer fill (range deletes)",
+	"byte-key search",
+	"typed f64 sum",
+	"typed f64 argmax",
+	"typed f32 dot",
+	"typed i32 count_if"
+};
+
+// Results matrix (seconds, < 0 means not available):
+static double results[MAX_KERNELS][MAX_LEVELS];
+
+struct record {
+	uint32_t flags;
+	uint32_t id;
+};
+
+// Deletes the second half of a ZV_BYREF vector (but its last item),
+// so only one pointer is moved and the rest of the time is spent
+// clearing the leftover slots. The items are added back without
+// measuring it:
+static double bench_fill(void)
+{
+	CCPAL_INIT_LIB;
+	static int64_t item;
+	double total = 0;
+	vector v = vect_create(MAX_ITEMS, sizeof(int64_t), ZV_BYREF);
+
+	for (int i = 0; i < MAX_ITEMS; i++)
+		vect_add(v, &item);
+
+	for (int r = 0; r < FILL_ROUNDS; r++) {
+		CCPAL_START_MEASURING;
+		vect_delete_range(v, MAX_ITEMS / 2, MAX_ITEMS - 2);
+		CCPAL_STOP_MEASURING;
+		total += elaps_s + ((double)elaps_ns) / 1.0e9;
+		while (vect_size(v) < MAX_ITEMS)
+			vect_add(v, &item);
+	}
+
+	vect_destroy(v);
+	return total;
+}
+
+static double bench_find(vector v)
+{
+	CCPAL_INIT_LIB;
+	zvect_index idx;
+	uint32_t key = 1; // Not in the vector, so we scan it all
+
+	CCPAL_START_MEASURING;
+	for (int r = 0; r < FIND_ROUNDS; r++)
+		assert(!vect_find_bytes(v, &key, sizeof(uint32_t), sizeof(key), &idx));
+	CCPAL_STOP_MEASURING;
+
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+// Typed kernels benchmark (op selects the kernel):
+static void sum_f64(void *acc, const void *item, void *ctx)
+{
+	(void)ctx;
+	*((double *)acc) += *((const double *)item);
+}
+
+static double bench_typed(typed_vector a, typed_vector b, int op)
+{
+	CCPAL_INIT_LIB;
+	double dres = 0;
+	volatile zvect_index ires = 0;
+	int32_t limit = MAX_ITEMS / 2;
+
+	CCPAL_START_MEASURING;
+	for (int r = 0; r < TYPED_ROUNDS; r++) {
+		switch (op) {
+			case 0: vect_typed_sum(a, &dres); break;
+			case 1: ires = vect_typed_argmax(a); break;
+			case 2: vect_typed_dot(a, b, &dres); break;
+			default: ires = vect_typed_count_if(a, ZV_GT, &limit); break;
+		}
+	}
+	CCPAL_STOP_MEASURING;
+	(void)ires;
+
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+int main() {
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing bulk kernels PERFORMANCE on every instruction set supported by the CPU\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create the test vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int64_t), ZV_NONE);
+		vector r = vect_create(MAX_ITEMS, sizeof(struct record), ZV_NONE);
+		typed_vector tf64 = vect_create_typed(ZV_T_F64, MAX_ITEMS);
+		typed_vector tf32a = vect_create_typed(ZV_T_F32, MAX_ITEMS);
+		typed_vector tf32b = vect_create_typed(ZV_T_F32, MAX_ITEMS);
+		typed_vector ti32 = vect_create_typed(ZV_T_I32, MAX_ITEMS);
+
+		for (int64_t i = 0; i < MAX_ITEMS; i++) {
+			struct record rec = { (uint32_t)i, (uint32_t)(i * 2) };
+			double d = (double)((i * 7919) % MAX_ITEMS);
+			float f = (float)(i % 100) * 0.5f;
+			int32_t x = (int32_t)((i * 7919) % MAX_ITEMS);
+			vect_add(v, &i);
+			vect_add(r, &rec);
+			vect_typed_push(tf64, &d);
+			vect_typed_push(tf32a, &f);
+			vect_typed_push(tf32b, &f);
+			vect_typed_push(ti32, &x);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	uint32_t detected = vect_get_cpu_features();
+
+	for (int l = 0; l < MAX_LEVELS; l++) {
+		printf("Test %s_%d: Measure the %s kernels:\n", testGrp, testID, level_names[l]);
+		fflush(stdout);
+
+		if (vect_set_cpu_features(levels[l]) != (levels[l] & detected) ||
+		    (levels[l] & ~detected)) {
+			for (int k = 0; k < MAX_KERNELS; k++)
+				results[k][l] = -1;
+			printf("not supported by this CPU, skipped.\n");
+			testID++;
+			continue;
+		}
+
+			results[0][l] = bench_fill();
+			results[1][l] = bench_find(r);
+			results[2][l] = bench_typed(tf64, NULL, 0);
+			results[3][l] = bench_typed(tf64, NULL, 1);
+			results[4][l] = bench_typed(tf32a, tf32b, 2);
+			results[5][l] = bench_typed(ti32, NULL, 3);
+
+		printf("done.\n");
+		testID++;
+
+		fflush(stdout);
+	}
+
+	// Restore the default kernels:
+	vect_set_cpu_features(ZV_CPU_ALL);
+
+	printf("Test %s_%d: Results matrix (seconds):\n", testGrp, testID);
+	fflush(stdout);
+
+		printf("%-32s", "kernel");
+		for (int l = 0; l < MAX_LEVELS; l++)
+			printf("%12s", level_names[l]);
+		printf("\n");
+		for (int k = 0; k < MAX_KERNELS; k++) {
+			printf("%-32s", kernel_names[k]);
+			for (int l = 0; l < MAX_LEVELS; l++) {
+				if (results[k][l] < 0)
+					printf("%12s", "n/a");
+				else
+					printf("%12.6f", results[k][l]);
+			}
+			printf("\n");
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum %d doubles stored in a vector (vect_reduce) and in a typed vector:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector dv = vect_create(MAX_ITEMS, sizeof(double), ZV_NONE);
+		for (zvect_index i = 0; i < MAX_ITEMS; i++)
+			vect_add(dv, vect_typed_get_at(tf64, i));
+		double s1 = 0, s2 = 0;
+		CCPAL_INIT_LIB;
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < TYPED_ROUNDS; i++) {
+			s1 = 0;
+			vect_reduce(dv, &s1, sum_f64, NULL);
+		}
+		CCPAL_STOP_MEASURING;
+		printf("vector:       ");
+		CCPAL_REPORT_ANALYSIS;
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < TYPED_ROUNDS; i++)
+			vect_typed_sum(tf64, &s2);
+		CCPAL_STOP_MEASURING;
+		printf("typed vector: ");
+		CCPAL_REPORT_ANALYSIS;
+		assert(s1 == s2);
+		vect_destroy(dv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check the vectors are still correct:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_size(v) == MAX_ITEMS);
+		assert(*((int64_t *)vect_get_at(v, 0)) == 0);
+
+		vect_destroy(v);
+		vect_destroy(r);
+		vect_typed_destroy(tf64);
+		vect_typed_destroy(tf32a);
+		vect_typed_destroy(tf32b);
+		vect_typed_destroy(ti32);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+
+	printf("================\n\n");
+
+	return 0;
+}
+#endif
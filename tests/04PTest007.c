@@ -0,0 +1,228 @@
+/*
+ *    Name: PTest007
+ * Purpose: Performance Testing ZVector binary search with and
+ *          without a caller-owned search cursor, in batches and
+ *          using a static search index
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+#define PROBES 2000000
+
+// Setup tests:
+char *testGrp = "007";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 ) && defined(ZVECT_DMF_EXTENSIONS)
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+// Probe keys: sequential (each key close to the previous one)
+// and random:
+static int *seq_keys;
+static int *rnd_keys;
+static const void **key_ptrs;
+static zvect_index *out_idx;
+
+static double bench_bsearch(vector v, const int *keys)
+{
+	CCPAL_INIT_LIB;
+	zvect_index idx = 0;
+	uint64_t check = 0;
+
+	CCPAL_START_MEASURING;
+	for (int i = 0; i < PROBES; i++) {
+		if (vect_bsearch(v, &keys[i], compare_int, &idx))
+			check += idx;
+	}
+	CCPAL_STOP_MEASURING;
+
+	assert(check > 0);
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+static double bench_bsearch_hint(vector v, const int *keys)
+{
+	CCPAL_INIT_LIB;
+	bsearch_cursor c = { 0, 0 };
+	zvect_index idx = 0;
+	uint64_t check = 0;
+
+	CCPAL_START_MEASURING;
+	for (int i = 0; i < PROBES; i++) {
+		if (vect_bsearch_hint(v, &keys[i], compare_int, &c, &idx))
+			check += idx;
+	}
+	CCPAL_STOP_MEASURING;
+
+	assert(check > 0);
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+static double bench_bsearch_batch(vector v, const int *keys)
+{
+	CCPAL_INIT_LIB;
+	uint64_t check = 0;
+
+	for (int i = 0; i < PROBES; i++)
+		key_ptrs[i] = &keys[i];
+
+	CCPAL_START_MEASURING;
+	zvect_index found = vect_bsearch_batch(v, key_ptrs, PROBES, compare_int, out_idx);
+	CCPAL_STOP_MEASURING;
+
+	for (int i = 0; i < PROBES; i++)
+		check += out_idx[i];
+	assert(found == PROBES && check > 0);
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+static uint64_t get_key(const void *item) {
+	return (uint64_t)*((const int *)item);
+}
+
+static double bench_index_find(search_index si, const int *keys)
+{
+	CCPAL_INIT_LIB;
+	zvect_index idx = 0;
+	uint64_t check = 0;
+
+	CCPAL_START_MEASURING;
+	for (int i = 0; i < PROBES; i++) {
+		if (vect_index_find(si, (uint64_t)keys[i], &idx))
+			check += idx;
+	}
+	CCPAL_STOP_MEASURING;
+
+	assert(check > 0);
+	return elaps_s + ((double)elaps_ns) / 1.0e9;
+}
+
+int main() {
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing vect_bsearch vs vect_bsearch_hint vs vect_bsearch_batch vs vect_index_find PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a sorted vector with %d elements and the probe keys:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NONE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			int value = i * 2;
+			vect_add(v, &value);
+		}
+
+		seq_keys = malloc(sizeof(int) * PROBES);
+		rnd_keys = malloc(sizeof(int) * PROBES);
+		key_ptrs = malloc(sizeof(void *) * PROBES);
+		out_idx = malloc(sizeof(zvect_index) * PROBES);
+		assert(seq_keys != NULL && rnd_keys != NULL);
+		assert(key_ptrs != NULL && out_idx != NULL);
+
+		search_index si = vect_index_build(v, get_key);
+		assert(si != NULL);
+		srand(7);
+		for (int i = 0; i < PROBES; i++) {
+			// Sequential probes walk the vector twice, a few items at a time:
+			seq_keys[i] = ((i * 3) % MAX_ITEMS) * 2;
+			rnd_keys[i] = (rand() % MAX_ITEMS) * 2;
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sequential probes:\n", testGrp, testID);
+	fflush(stdout);
+
+		double t1 = bench_bsearch(v, seq_keys);
+		double t2 = bench_bsearch_hint(v, seq_keys);
+		double t3 = bench_bsearch_batch(v, seq_keys);
+		double t4 = bench_index_find(si, seq_keys);
+		printf("vect_bsearch: %lf seconds, vect_bsearch_hint: %lf seconds, vect_bsearch_batch: %lf seconds, vect_index_find: %lf seconds\n", t1, t2, t3, t4);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Random probes:\n", testGrp, testID);
+	fflush(stdout);
+
+		t1 = bench_bsearch(v, rnd_keys);
+		t2 = bench_bsearch_hint(v, rnd_keys);
+		t3 = bench_bsearch_batch(v, rnd_keys);
+		t4 = bench_index_find(si, rnd_keys);
+		printf("vect_bsearch: %lf seconds, vect_bsearch_hint: %lf seconds, vect_bsearch_batch: %lf seconds, vect_index_find: %lf seconds\n", t1, t2, t3, t4);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: destroy the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		free(seq_keys);
+		free(rnd_keys);
+		free(key_ptrs);
+		vect_index_destroy(si);
+		free(out_idx);
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ *    Name: PTest008
+ * Purpose: Performance Testing ZVector k-way merge of ordered
+ *          vectors against concatenating and sorting them
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_PARTS 8
+#define PART_ITEMS 250000
+
+// Setup tests:
+char *testGrp = "008";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 ) && defined(ZVECT_DMF_EXTENSIONS)
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+static void check_sorted(vector v) {
+	assert(vect_size(v) == MAX_PARTS * PART_ITEMS);
+	for (zvect_index i = 1; i < vect_size(v); i++)
+		assert(*((int *)vect_get_at(v, i - 1)) <= *((int *)vect_get_at(v, i)));
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing vect_merge_sorted vs concatenation + vect_qsort PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create %d ordered vectors of %d elements:\n", testGrp, testID, MAX_PARTS, PART_ITEMS);
+	fflush(stdout);
+
+		vector parts[MAX_PARTS];
+		srand(8);
+		for (int p = 0; p < MAX_PARTS; p++) {
+			parts[p] = vect_create(PART_ITEMS, sizeof(int), ZV_NONE);
+			int value = 0;
+			for (int i = 0; i < PART_ITEMS; i++) {
+				value += rand() % 16;
+				vect_add(parts[p], &value);
+			}
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Merge the vectors with vect_merge_sorted:\n", testGrp, testID);
+	fflush(stdout);
+
+		vector dst = vect_create(8, sizeof(int), ZV_BYREF);
+		CCPAL_START_MEASURING;
+		vect_merge_sorted(dst, parts, MAX_PARTS, compare_int);
+		CCPAL_STOP_MEASURING;
+		check_sorted(dst);
+		vect_destroy(dst);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Concatenate the vectors and sort them with vect_qsort:\n", testGrp, testID);
+	fflush(stdout);
+
+		dst = vect_create(8, sizeof(int), ZV_BYREF);
+		CCPAL_START_MEASURING;
+		for (int p = 0; p < MAX_PARTS; p++)
+			for (zvect_index i = 0; i < PART_ITEMS; i++)
+				vect_add(dst, vect_get_at(parts[p], i));
+		vect_qsort(dst, compare_int);
+		CCPAL_STOP_MEASURING;
+		check_sorted(dst);
+		vect_destroy(dst);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: destroy the vectors:\n", testGrp, testID);
+	fflush(stdout);
+
+		for (int p = 0; p < MAX_PARTS; p++)
+			vect_destroy(parts[p]);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ *    Name: PTest009
+ * Purpose: Performance Testing ZVector batched ordered inserts
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 200000
+#define BATCH_ITEMS 50000
+
+// Setup tests:
+char *testGrp = "009";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 ) && defined(ZVECT_DMF_EXTENSIONS)
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+static int batch[BATCH_ITEMS];
+
+static vector make_vector(void) {
+	vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NONE);
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		int value = i * 4;
+		vect_add(v, &value);
+	}
+	return v;
+}
+
+static void check_sorted(vector v) {
+	assert(vect_size(v) == MAX_ITEMS + BATCH_ITEMS);
+	for (zvect_index i = 1; i < vect_size(v); i++)
+		assert(*((int *)vect_get_at(v, i - 1)) <= *((int *)vect_get_at(v, i)));
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing vect_add_ordered vs vect_add_ordered_n PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Prepare a batch of %d random items:\n", testGrp, testID, BATCH_ITEMS);
+	fflush(stdout);
+
+		srand(9);
+		for (int i = 0; i < BATCH_ITEMS; i++)
+			batch[i] = rand() % (MAX_ITEMS * 4);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add the batch to an ordered vector of %d items with vect_add_ordered:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = make_vector();
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < BATCH_ITEMS; i++)
+			vect_add_ordered(v, &batch[i], compare_int);
+		CCPAL_STOP_MEASURING;
+		check_sorted(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add the batch to an ordered vector of %d items with vect_add_ordered_n:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		v = make_vector();
+		CCPAL_START_MEASURING;
+		vect_add_ordered_n(v, batch, BATCH_ITEMS, compare_int);
+		CCPAL_STOP_MEASURING;
+		check_sorted(v);
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ *    Name: PTest010
+ * Purpose: Performance Testing ZVector deduplication
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 500000
+
+// Setup tests:
+char *testGrp = "010";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 ) && defined(ZVECT_DMF_EXTENSIONS)
+
+static int compare_int(const void *a, const void *b) {
+	int x = *((const int *)a);
+	int y = *((const int *)b);
+	return (x > y) - (x < y);
+}
+
+static uint64_t hash_int(const void *item) {
+	return (uint64_t)(*((const int *)item)) * 0x9E3779B97F4A7C15ULL;
+}
+
+static bool same_int(const void *a, const void *b) {
+	return *((const int *)a) == *((const int *)b);
+}
+
+// Builds a vector where about 25% of the items are duplicates:
+static vector make_vector(void) {
+	vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NONE);
+	srand(10);
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		int value = ((rand() % 4) == 0) ? rand() % (i + 1) : i;
+		vect_add(v, &value);
+	}
+	return v;
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing vect_unique and vect_unique_hash PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove the duplicates of %d items with vect_qsort + vect_unique:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = make_vector();
+		CCPAL_START_MEASURING;
+		vect_qsort(v, compare_int);
+		zvect_index removed1 = vect_unique(v, compare_int);
+		CCPAL_STOP_MEASURING;
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove the duplicates of %d items with vect_unique_hash:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		v = make_vector();
+		CCPAL_START_MEASURING;
+		zvect_index removed2 = vect_unique_hash(v, hash_int, same_int);
+		CCPAL_STOP_MEASURING;
+		assert(removed1 == removed2);
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
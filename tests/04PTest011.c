@@ -0,0 +1,137 @@
+/*
+ *    Name: PTest011
+ * Purpose: Performance Testing ZVector columnar vectors
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+#define ROUNDS 20
+
+// Setup tests:
+char *testGrp = "011";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+// An 80 bytes record, of which the filters read only 4 bytes:
+typedef struct QueueItem {
+	int priority;
+	char payload[76];
+} QueueItem;
+
+static const zvect_field fields[] = {
+	{ offsetof(QueueItem, priority), sizeof(int) },
+	{ offsetof(QueueItem, payload), sizeof(((QueueItem *)0)->payload) }
+};
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing columnar vectors PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector and a columnar vector of %d records:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(QueueItem), ZV_NONE);
+		columnar_vector cv = vect_create_columnar(sizeof(QueueItem), fields, 2, MAX_ITEMS, ZV_NOLOCKING);
+		QueueItem item;
+		memset(&item, 0, sizeof(item));
+		srand(11);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			item.priority = rand() % 100;
+			vect_add(v, &item);
+			vect_columnar_add(cv, &item);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Count the records with priority > 90 (%d rounds) in the vector:\n", testGrp, testID, ROUNDS);
+	fflush(stdout);
+
+		zvect_index count1 = 0;
+		CCPAL_START_MEASURING;
+		for (int r = 0; r < ROUNDS; r++) {
+			for (zvect_index i = 0; i < MAX_ITEMS; i++)
+				count1 += (((QueueItem *)vect_get_at(v, i))->priority > 90);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Count the records with priority > 90 (%d rounds) in the columnar vector:\n", testGrp, testID, ROUNDS);
+	fflush(stdout);
+
+		zvect_index count2 = 0;
+		int limit = 90;
+		CCPAL_START_MEASURING;
+		for (int r = 0; r < ROUNDS; r++)
+			count2 += vect_columnar_count_if(cv, 0, ZV_T_I32, ZV_GT, &limit);
+		CCPAL_STOP_MEASURING;
+		assert(count1 == count2);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	vect_destroy(v);
+	vect_columnar_destroy(cv);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
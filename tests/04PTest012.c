@@ -0,0 +1,131 @@
+/*
+ *    Name: PTest012
+ * Purpose: Performance Testing ZVector bit vectors
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 4000000
+
+// Setup tests:
+char *testGrp = "012";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing bit vectors PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d flags to a vector of bool:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(bool), ZV_NONE);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			bool flag = (i % 3) == 0;
+			vect_add(v, &flag);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d flags to a bit vector:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		bit_vector bv = vect_create_bits(0, ZV_NONE);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_bits_push(bv, (i % 3) == 0);
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Count the set flags in the vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index count1 = 0;
+		CCPAL_START_MEASURING;
+		for (zvect_index i = 0; i < MAX_ITEMS; i++)
+			count1 += *((bool *)vect_get_at(v, i));
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Count the set flags in the bit vector:\n", testGrp, testID);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		zvect_index count2 = vect_bits_popcount(bv);
+		CCPAL_STOP_MEASURING;
+		assert(count1 == count2);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	vect_destroy(v);
+	vect_bits_destroy(bv);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ *    Name: PTest013
+ * Purpose: Performance Testing ZVector variable length items vectors
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+#define MAX_MSG_SIZE 72
+
+// Setup tests:
+char *testGrp = "013";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+static zvect_index make_msg(int i, char *msg) {
+	return (zvect_index)snprintf(msg, MAX_MSG_SIZE, "message %d for queue %d", i, i % 13) + 1;
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+	char msg[MAX_MSG_SIZE];
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing variable length items vectors PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d strings as fixed %d bytes items:\n", testGrp, testID, MAX_ITEMS, MAX_MSG_SIZE);
+	fflush(stdout);
+
+		vector v1 = vect_create(MAX_ITEMS, MAX_MSG_SIZE, ZV_NOLOCKING);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			make_msg(i, msg);
+			vect_add(v1, msg);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d strings as BYREF items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v2 = vect_create(MAX_ITEMS, sizeof(char *), ZV_BYREF | ZV_NOLOCKING);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			zvect_index len = make_msg(i, msg);
+			char *s = (char *)malloc(len);
+			memcpy(s, msg, len);
+			vect_add(v2, s);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Add %d strings to a varlen vector:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		varlen_vector vv = vect_create_varlen(MAX_ITEMS, 0, ZV_NOLOCKING);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			zvect_index len = make_msg(i, msg);
+			vect_add_bytes(vv, msg, len);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Scan the strings for the queue 7 messages (fixed, BYREF, varlen):\n", testGrp, testID);
+	fflush(stdout);
+
+		zvect_index found1 = 0, found2 = 0, found3 = 0;
+		CCPAL_START_MEASURING;
+		for (zvect_index i = 0; i < MAX_ITEMS; i++)
+			found1 += (strstr((char *)vect_get_at(v1, i), "queue 7") != NULL);
+		CCPAL_STOP_MEASURING;
+		CCPAL_REPORT_ANALYSIS;
+		CCPAL_START_MEASURING;
+		for (zvect_index i = 0; i < MAX_ITEMS; i++)
+			found2 += (strstr((char *)vect_get_at(v2, i), "queue 7") != NULL);
+		CCPAL_STOP_MEASURING;
+		CCPAL_REPORT_ANALYSIS;
+		CCPAL_START_MEASURING;
+		for (zvect_index i = 0; i < MAX_ITEMS; i++)
+			found3 += (strstr((const char *)vect_get_bytes(vv, i, NULL), "queue 7") != NULL);
+		CCPAL_STOP_MEASURING;
+		CCPAL_REPORT_ANALYSIS;
+		assert(found1 == found2 && found2 == found3);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove the last %d strings from the varlen vector (with compaction):\n", testGrp, testID, MAX_ITEMS / 2);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (zvect_index i = MAX_ITEMS - 1; i >= MAX_ITEMS / 2; i--)
+			vect_varlen_remove_at(vv, i);
+		CCPAL_STOP_MEASURING;
+		assert(vect_varlen_size(vv) == MAX_ITEMS / 2);
+		assert(vect_varlen_garbage(vv) < (MAX_ITEMS / 2) * MAX_MSG_SIZE);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	vect_destroy(v1);
+	for (zvect_index i = 0; i < MAX_ITEMS; i++)
+		free(vect_get_at(v2, i));
+	vect_destroy(v2);
+	vect_varlen_destroy(vv);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ *    Name: PTest014
+ * Purpose: Performance Testing ZVector slot maps
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 1000000
+#define MAX_REMOVALS 100000
+#define MAX_VECT_REMOVALS 2000
+
+// Setup tests:
+char *testGrp = "014";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+static zvect_handle handles[MAX_ITEMS];
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing slot maps PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove %d random items from a vector of %d items (by index):\n", testGrp, testID, MAX_VECT_REMOVALS, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NONE);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+		srand(14);
+		CCPAL_START_MEASURING;
+		for (int r = 0; r < MAX_VECT_REMOVALS; r++)
+			vect_delete_at(v, (zvect_index)(rand() % (MAX_ITEMS - r)));
+		CCPAL_STOP_MEASURING;
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Insert %d items in a slot map:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		slot_map sm = vect_create_slot_map(MAX_ITEMS, sizeof(int), ZV_NONE);
+		CCPAL_START_MEASURING;
+		for (int i = 0; i < MAX_ITEMS; i++)
+			handles[i] = vect_slot_map_insert(sm, &i);
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Remove %d random items from the slot map (by handle):\n", testGrp, testID, MAX_REMOVALS);
+	fflush(stdout);
+
+		srand(14);
+		CCPAL_START_MEASURING;
+		for (int r = 0; r < MAX_REMOVALS; r++)
+			vect_slot_map_remove(sm, handles[rand() % MAX_ITEMS]);
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Look up %d random handles in the slot map:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		zvect_index found = 0;
+		CCPAL_START_MEASURING;
+		for (int r = 0; r < MAX_ITEMS; r++)
+			found += (vect_slot_map_get(sm, handles[rand() % MAX_ITEMS]) != NULL);
+		CCPAL_STOP_MEASURING;
+		assert(found > 0);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	vect_slot_map_destroy(sm);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
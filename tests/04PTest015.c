@@ -0,0 +1,142 @@
+/*
+ *    Name: PTest015
+ * Purpose: Performance Testing ZVector gap buffer vectors
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 200000
+#define MAX_EDITS 50000
+
+// Setup tests:
+char *testGrp = "015";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+// Editor like pattern: the cursor moves by a few items between
+// edits and jumps somewhere else once in a while:
+#define NEXT_CURSOR(cursor, size)					\
+	do {								\
+		if ((rand() % 1000) == 0)				\
+			cursor = (zvect_index)(rand() % (size));	\
+		else							\
+			cursor += (zvect_index)(rand() % 3);		\
+		if (cursor >= (size))					\
+			cursor = (size) - 1;				\
+	} while (0)
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing gap buffer vectors PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d edits around a moving cursor in a vector of %d items:\n", testGrp, testID, MAX_EDITS, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+		srand(15);
+		zvect_index cursor = MAX_ITEMS / 2;
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_EDITS; e++) {
+			NEXT_CURSOR(cursor, vect_size(v));
+			if (e & 1)
+				vect_delete_at(v, cursor);
+			else
+				vect_add_at(v, &e, cursor);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d edits around a moving cursor in a ZV_GAP_BUFFER vector of %d items:\n", testGrp, testID, MAX_EDITS, MAX_ITEMS);
+	fflush(stdout);
+
+		vector gv = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING | ZV_GAP_BUFFER);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_add(gv, &i);
+		srand(15);
+		cursor = MAX_ITEMS / 2;
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_EDITS; e++) {
+			NEXT_CURSOR(cursor, vect_size(gv));
+			if (e & 1)
+				vect_delete_at(gv, cursor);
+			else
+				vect_add_at(gv, &e, cursor);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check both vectors have the same items:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_size(v) == vect_size(gv));
+		for (zvect_index i = 0; i < vect_size(v); i++)
+			assert(*((int *)vect_get_at(v, i)) == *((int *)vect_get_at(gv, i)));
+		vect_destroy(v);
+		vect_destroy(gv);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ *    Name: PTest016
+ * Purpose: Performance Testing ZVector tree storage
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 4000000
+#define MAX_EDITS 1000
+#define MAX_TREE_EDITS 1000000
+
+// Setup tests:
+char *testGrp = "016";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+static long long sum2 = 0;
+
+static void sum_item(void *item) {
+	sum2 += *((int *)item);
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing tree storage (ZV_TREE) PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector and a ZV_TREE vector of %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING);
+		vector tv = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING | ZV_TREE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			vect_add(v, &i);
+			vect_add(tv, &i);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d random inserts and deletes in the vector:\n", testGrp, testID, MAX_EDITS);
+	fflush(stdout);
+
+		srand(16);
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_EDITS; e++) {
+			zvect_index pos = (zvect_index)(rand() % MAX_ITEMS);
+			if (e & 1)
+				vect_delete_at(v, pos);
+			else
+				vect_add_at(v, &e, pos);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: The same %d random inserts and deletes in the ZV_TREE vector:\n", testGrp, testID, MAX_EDITS);
+	fflush(stdout);
+
+		srand(16);
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_EDITS; e++) {
+			zvect_index pos = (zvect_index)(rand() % MAX_ITEMS);
+			if (e & 1)
+				vect_delete_at(tv, pos);
+			else
+				vect_add_at(tv, &e, pos);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Scan both vectors and check they are the same:\n", testGrp, testID);
+	fflush(stdout);
+
+		long long sum1 = 0;
+		CCPAL_START_MEASURING;
+		for (zvect_index i = 0; i < vect_size(v); i++)
+			sum1 += *((int *)vect_get_at(v, i));
+		CCPAL_STOP_MEASURING;
+		CCPAL_REPORT_ANALYSIS;
+		CCPAL_START_MEASURING;
+		vect_apply(tv, sum_item);
+		CCPAL_STOP_MEASURING;
+		CCPAL_REPORT_ANALYSIS;
+		assert(sum1 == sum2);
+		assert(vect_size(v) == vect_size(tv));
+		for (zvect_index i = 0; i < vect_size(v); i += 997)
+			assert(*((int *)vect_get_at(v, i)) == *((int *)vect_get_at(tv, i)));
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d random inserts and deletes in the ZV_TREE vector:\n", testGrp, testID, MAX_TREE_EDITS);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_TREE_EDITS; e++) {
+			zvect_index pos = (zvect_index)(rand() % MAX_ITEMS);
+			if (e & 1)
+				vect_delete_at(tv, pos);
+			else
+				vect_add_at(tv, &e, pos);
+		}
+		CCPAL_STOP_MEASURING;
+		assert(vect_size(tv) == MAX_ITEMS);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d random inserts and deletes mixed with reads and replaces in the ZV_TREE vector:\n", testGrp, testID, MAX_TREE_EDITS);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_TREE_EDITS; e++) {
+			zvect_index pos = (zvect_index)(rand() % MAX_ITEMS);
+			switch (e & 3) {
+				case 0: vect_add_at(tv, &e, pos); break;
+				case 1: sum2 += *((int *)vect_get_at(tv, pos)); break;
+				case 2: vect_put_at(tv, &e, pos); break;
+				default: vect_delete_at(tv, pos); break;
+			}
+		}
+		CCPAL_STOP_MEASURING;
+		assert(vect_size(tv) == MAX_ITEMS);
+		vect_destroy(tv);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
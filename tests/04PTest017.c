@@ -0,0 +1,150 @@
+/*
+ *    Name: PTest017
+ * Purpose: Performance Testing ZVector lazy deletes
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 4000000
+#define MAX_DELETES 500
+#define MAX_LAZY_DELETES 200000
+
+// Setup tests:
+char *testGrp = "017";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing lazy deletes PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector and a ZV_LAZY_DELETE vector of %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING);
+		vector lv = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING | ZV_LAZY_DELETE);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			vect_add(v, &i);
+			vect_add(lv, &i);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: A burst of %d scattered deletes in the vector:\n", testGrp, testID, MAX_DELETES);
+	fflush(stdout);
+
+		srand(17);
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_DELETES; e++)
+			vect_delete_at(v, (zvect_index)(rand() % (MAX_ITEMS - e)));
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: The same %d deletes in the ZV_LAZY_DELETE vector (and its compaction):\n", testGrp, testID, MAX_DELETES);
+	fflush(stdout);
+
+		srand(17);
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_DELETES; e++)
+			vect_delete_at(lv, (zvect_index)(rand() % (MAX_ITEMS - e)));
+		vect_compact(lv);
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Check both vectors are the same:\n", testGrp, testID);
+	fflush(stdout);
+
+		assert(vect_size(v) == vect_size(lv));
+		for (zvect_index i = 0; i < vect_size(v); i++)
+			assert(*((int *)vect_get_at(v, i)) == *((int *)vect_get_at(lv, i)));
+		vect_destroy(v);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d scattered deletes, each followed by a read, in the ZV_LAZY_DELETE vector:\n", testGrp, testID, MAX_LAZY_DELETES);
+	fflush(stdout);
+
+		long long sum = 0;
+		CCPAL_START_MEASURING;
+		for (int e = 0; e < MAX_LAZY_DELETES; e++) {
+			zvect_index size = vect_size(lv);
+			vect_delete_at(lv, (zvect_index)(rand() % size));
+			sum += *((int *)vect_get_at(lv, (zvect_index)(rand() % (size - 1))));
+		}
+		vect_compact(lv);
+		CCPAL_STOP_MEASURING;
+		assert(sum > 0);
+		assert(vect_size(lv) == MAX_ITEMS - MAX_DELETES - MAX_LAZY_DELETES);
+		vect_destroy(lv);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
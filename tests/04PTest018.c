@@ -0,0 +1,154 @@
+/*
+ *    Name: PTest018
+ * Purpose: Performance Testing ZVector in place rotations
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 4000000
+#define MAX_TICKS 1000
+#define MAX_ROTATIONS 100
+
+// Setup tests:
+char *testGrp = "018";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing in place rotations PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING);
+		for (int i = 0; i < MAX_ITEMS; i++)
+			vect_add(v, &i);
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d rotations of 1 position to the left:\n", testGrp, testID, MAX_TICKS);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int t = 0; t < MAX_TICKS; t++)
+			vect_rotate_left(v, 1);
+		CCPAL_STOP_MEASURING;
+		assert(*((int *)vect_get_at(v, 0)) == MAX_TICKS);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d rotations of 16 positions to the right:\n", testGrp, testID, MAX_TICKS);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int t = 0; t < MAX_TICKS; t++)
+			vect_rotate_right(v, 16);
+		CCPAL_STOP_MEASURING;
+		assert(*((int *)vect_get_at(v, 0)) == (MAX_ITEMS - 15 * MAX_TICKS));
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d rotations of random (large) shifts:\n", testGrp, testID, MAX_ROTATIONS);
+	fflush(stdout);
+
+		long long shift = MAX_ITEMS - 15 * MAX_TICKS;
+		srand(18);
+		CCPAL_START_MEASURING;
+		for (int t = 0; t < MAX_ROTATIONS; t++) {
+			zvect_index k = (zvect_index)(rand() % MAX_ITEMS);
+			if (t & 1) {
+				vect_rotate_left(v, k);
+				shift += k;
+			} else {
+				vect_rotate_right(v, k);
+				shift -= k;
+			}
+		}
+		CCPAL_STOP_MEASURING;
+		shift = ((shift % MAX_ITEMS) + MAX_ITEMS) % MAX_ITEMS;
+		for (zvect_index i = 0; i < MAX_ITEMS; i += 9973)
+			assert(*((int *)vect_get_at(v, i)) == (int)((shift + i) % MAX_ITEMS));
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: %d swaps of ranges of %d items:\n", testGrp, testID, MAX_ROTATIONS, MAX_ITEMS / 4);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int t = 0; t < MAX_ROTATIONS; t++)
+			vect_swap_range(v, 0, MAX_ITEMS / 4 - 1, MAX_ITEMS / 2);
+		CCPAL_STOP_MEASURING;
+		assert(vect_get_last_error(v) == 0);
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ *    Name: PTest019
+ * Purpose: Performance Testing ZVector vector views
+ *  Author: Paolo Fabio Zaino
+ *  Domain: General
+ * License: Copyright by Paolo Fabio Zaino, all rights reserved
+ *          Distributed under MIT license
+ */
+
+#if __STDC_VERSION__ >= 199901L
+#define _XOPEN_SOURCE 600
+#else
+#define _XOPEN_SOURCE 500
+#endif /* __STDC_VERSION__ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "ccpal.h"
+
+#if (  defined(_MSC_VER) )
+ // Silly stuff that needs to be added for Microsoft compilers
+ // which are still at the MS-DOS age apparently...
+#define ZVECTORH "../src/zvector.h"
+#else
+#define ZVECTORH "zvector.h"
+#endif
+#include ZVECTORH
+
+#define MAX_ITEMS 4000000
+#define MAX_WINDOWS 400
+#define WINDOW_SIZE 10000
+
+// Setup tests:
+char *testGrp = "019";
+uint8_t testID = 1;
+
+#if ( OS_TYPE == 1 )
+
+static int compare_int(const void *a, const void *b) {
+	return (*((const int *)a) > *((const int *)b)) - (*((const int *)a) < *((const int *)b));
+}
+
+static void sum_item(void *item, void *ctx) {
+	*((long long *)ctx) += *((int *)item);
+}
+
+int main() {
+	CCPAL_INIT_LIB;
+
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing vector views PERFORMANCE\n");
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Create a vector of %d items:\n", testGrp, testID, MAX_ITEMS);
+	fflush(stdout);
+
+		vector v = vect_create(MAX_ITEMS, sizeof(int), ZV_NOLOCKING);
+		srand(19);
+		for (int i = 0; i < MAX_ITEMS; i++) {
+			int x = rand();
+			vect_add(v, &x);
+		}
+
+	printf("done.\n");
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum %d windows of %d items copying them into a vector:\n", testGrp, testID, MAX_WINDOWS, WINDOW_SIZE);
+	fflush(stdout);
+
+		long long sum1 = 0, sum2 = 0;
+		CCPAL_START_MEASURING;
+		for (int w = 0; w < MAX_WINDOWS; w++) {
+			// vect_copy copies the items pointers, so c must not own them:
+			vector c = vect_create(WINDOW_SIZE, sizeof(int), ZV_NOLOCKING | ZV_BYREF);
+			vect_copy(c, v, (zvect_index)w * WINDOW_SIZE, WINDOW_SIZE);
+			vect_apply_ctx(c, sum_item, &sum1);
+			vect_destroy(c);
+		}
+		CCPAL_STOP_MEASURING;
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sum the same %d windows with views:\n", testGrp, testID, MAX_WINDOWS);
+	fflush(stdout);
+
+		CCPAL_START_MEASURING;
+		for (int w = 0; w < MAX_WINDOWS; w++) {
+			vect_view vw = vect_view_make(v, (zvect_index)w * WINDOW_SIZE, WINDOW_SIZE);
+			vect_view_apply(vw, sum_item, &sum2);
+			vect_view_destroy(vw);
+		}
+		CCPAL_STOP_MEASURING;
+		assert(sum1 == sum2);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("Test %s_%d: Sort and search %d windows with views:\n", testGrp, testID, MAX_WINDOWS);
+	fflush(stdout);
+
+		zvect_index found = 0;
+		CCPAL_START_MEASURING;
+		for (int w = 0; w < MAX_WINDOWS; w++) {
+			vect_view vw = vect_view_make(v, (zvect_index)w * WINDOW_SIZE, WINDOW_SIZE);
+			vect_view_qsort(vw, compare_int);
+			for (int k = 0; k < 100; k++) {
+				zvect_index idx;
+				int key = *((int *)vect_view_get_at(vw, (zvect_index)(rand() % WINDOW_SIZE)));
+				found += vect_view_bsearch(vw, &key, compare_int, &idx);
+			}
+			vect_view_destroy(vw);
+		}
+		CCPAL_STOP_MEASURING;
+		assert(found == MAX_WINDOWS * 100);
+		vect_destroy(v);
+
+	printf("done.\n");
+	CCPAL_REPORT_ANALYSIS;
+	testID++;
+
+	fflush(stdout);
+
+	printf("================\n\n");
+
+	return 0;
+}
+
+#else
+
+int main()
+{
+	printf("=== PTest%s ===\n", testGrp);
+	printf("Testing ZVector Library PERFORMANCE:\n");
+	fflush(stdout);
+	printf("Skipping test because this OS is not yet supported for perf tests, sorry!\n");
+	fflush(stdout);
+	printf("================\n\n");
+
+	return 0;
+}
+
+#endif